@@ -591,20 +591,231 @@ static uint8_t exchange2ical_exception_from_EmbeddedObj(struct exchange2ical *ex
 	return 0;	
 }
 
+/* Properties fetched through the contents table, after PR_FID and
+   PR_MID. Servers truncate string columns to 255 characters, so free
+   form strings are read from the opened message instead. */
+static const uint32_t exchange2ical_table_props[] = {
+	PidLidGlobalObjectId,
+	PidLidRecurring,
+	PidLidAppointmentStateFlags,
+	PidLidTimeZoneStruct,
+	PidLidAppointmentStartWhole,
+	PidLidAppointmentEndWhole,
+	PidLidAppointmentSubType,
+	PidLidOwnerCriticalChange,
+	PidLidAppointmentSequence,
+	PidLidBusyStatus,
+	PidLidIntendedBusyStatus,
+	PidLidAttendeeCriticalChange,
+	PidLidAppointmentReplyTime,
+	PidLidAppointmentNotAllowPropose,
+	PidLidAllowExternalCheck,
+	PidLidAppointmentLastSequence,
+	PidLidAppointmentSequenceTime,
+	PidLidAutoFillLocation,
+	PidLidAutoStartCheck,
+	PidLidConferencingCheck,
+	PidLidConferencingType,
+	PidLidReminderSet,
+	PidLidReminderDelta,
+	PidLidResponseStatus,
+	PR_MESSAGE_CLASS_UNICODE,
+	PR_SENSITIVITY,
+	PR_CREATION_TIME,
+	PR_LAST_MODIFICATION_TIME,
+	PR_IMPORTANCE,
+	PR_RESPONSE_REQUESTED,
+	PR_OWNER_APPT_ID,
+	PR_MESSAGE_LOCALE_ID,
+	0
+};
+
+/**
+   Build the contents table columns. canonical holds the tags libmapi
+   and exchange2ical_get_properties know about, columns the same tags
+   with named properties mapped to their identifiers in the store.
+   Named properties the store has never seen are left out.
+ */
+static enum MAPISTATUS exchange2ical_get_columns(TALLOC_CTX *mem_ctx, mapi_object_t *obj_folder,
+						 struct SPropTagArray **canonical,
+						 struct SPropTagArray **columns)
+{
+	enum MAPISTATUS		retval;
+	struct mapi_nameid	*nameid;
+	struct SPropTagArray	*named;
+	uint32_t		count;
+	uint32_t		i;
+	uint32_t		j;
+
+	for (count = 0; exchange2ical_table_props[count]; count++);
+
+	*canonical = talloc_zero(mem_ctx, struct SPropTagArray);
+	(*canonical)->aulPropTag = talloc_array(*canonical, enum MAPITAGS, count + 2);
+	*columns = talloc_zero(mem_ctx, struct SPropTagArray);
+	(*columns)->aulPropTag = talloc_array(*columns, enum MAPITAGS, count + 2);
+
+	(*canonical)->aulPropTag[0] = PR_FID;
+	(*canonical)->aulPropTag[1] = PR_MID;
+	for (i = 0; i < count; i++) {
+		(*canonical)->aulPropTag[i + 2] = (enum MAPITAGS) exchange2ical_table_props[i];
+	}
+	(*canonical)->cValues = count + 2;
+	memcpy((*columns)->aulPropTag, (*canonical)->aulPropTag, (count + 2) * sizeof (enum MAPITAGS));
+	(*columns)->cValues = count + 2;
+
+	nameid = mapi_nameid_new(mem_ctx);
+	named = talloc_zero(nameid, struct SPropTagArray);
+	if (mapi_nameid_lookup_SPropTagArray(nameid, *canonical) == MAPI_E_SUCCESS) {
+		retval = mapi_nameid_GetIDsFromNames(nameid, obj_folder, named);
+		if (retval != MAPI_E_SUCCESS) {
+			talloc_free(nameid);
+			return retval;
+		}
+		for (i = 0; i < named->cValues; i++) {
+			for (j = 0; j < (*canonical)->cValues; j++) {
+				if ((*canonical)->aulPropTag[j] == nameid->entries[i].proptag) {
+					(*columns)->aulPropTag[j] = named->aulPropTag[i];
+				}
+			}
+		}
+	}
+	talloc_free(nameid);
+
+	/* Drop the named properties which didn't resolve */
+	for (i = 0, j = 0; i < (*columns)->cValues; i++) {
+		if (!((*columns)->aulPropTag[i] & 0xFFFF0000)) continue;
+		(*canonical)->aulPropTag[j] = (*canonical)->aulPropTag[i];
+		(*columns)->aulPropTag[j] = (*columns)->aulPropTag[i];
+		j++;
+	}
+	(*canonical)->cValues = j;
+	(*columns)->cValues = j;
+
+	return MAPI_E_SUCCESS;
+}
+
+
+static uint32_t exchange2ical_get_column(struct SPropTagArray *canonical, struct SPropTagArray *columns,
+					 uint32_t proptag)
+{
+	uint32_t	i;
+
+	for (i = 0; i < canonical->cValues; i++) {
+		if (canonical->aulPropTag[i] == proptag) {
+			return columns->aulPropTag[i];
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+   Restrict the contents table to appointments which may start within
+   the requested range: (end >= begin AND start <= end) OR recurring.
+   This is a superset of what checkEvent accepts, which still runs on
+   each row. Returns NULL when the table cannot be restricted.
+ */
+static struct mapi_SRestriction *exchange2ical_get_restriction(TALLOC_CTX *mem_ctx,
+							       struct SPropTagArray *canonical,
+							       struct SPropTagArray *columns,
+							       struct exchange2ical_check *exchange2ical_check)
+{
+	struct mapi_SRestriction	*res;
+	struct mapi_SRestriction_and	*bounds;
+	struct mapi_SRestriction_or	*range;
+	uint32_t			startWhole;
+	uint32_t			endWhole;
+	uint32_t			recurring;
+	uint32_t			count = 0;
+
+	startWhole = exchange2ical_get_column(canonical, columns, PidLidAppointmentStartWhole);
+	endWhole = exchange2ical_get_column(canonical, columns, PidLidAppointmentEndWhole);
+	recurring = exchange2ical_get_column(canonical, columns, PidLidRecurring);
+
+	if (!startWhole || !endWhole) return NULL;
+	if (!exchange2ical_check->begin && !exchange2ical_check->end) return NULL;
+
+	bounds = talloc_zero_array(mem_ctx, struct mapi_SRestriction_and, 2);
+	if (exchange2ical_check->begin) {
+		bounds[count].rt = RES_PROPERTY;
+		bounds[count].res.resProperty.relop = RELOP_GE;
+		bounds[count].res.resProperty.ulPropTag = endWhole;
+		bounds[count].res.resProperty.lpProp.ulPropTag = endWhole;
+		bounds[count].res.resProperty.lpProp.value.ft = get_FILETIME_from_tm(exchange2ical_check->begin);
+		count++;
+	}
+	if (exchange2ical_check->end) {
+		bounds[count].rt = RES_PROPERTY;
+		bounds[count].res.resProperty.relop = RELOP_LE;
+		bounds[count].res.resProperty.ulPropTag = startWhole;
+		bounds[count].res.resProperty.lpProp.ulPropTag = startWhole;
+		bounds[count].res.resProperty.lpProp.value.ft = get_FILETIME_from_tm(exchange2ical_check->end);
+		count++;
+	}
+
+	res = talloc_zero(mem_ctx, struct mapi_SRestriction);
+	if (!recurring) {
+		res->rt = RES_AND;
+		res->res.resAnd.cRes = count;
+		res->res.resAnd.res = bounds;
+		return res;
+	}
+
+	range = talloc_zero_array(mem_ctx, struct mapi_SRestriction_or, 2);
+	range[0].rt = RES_AND;
+	range[0].res.resAnd.cRes = count;
+	range[0].res.resAnd.res = bounds;
+	range[1].rt = RES_PROPERTY;
+	range[1].res.resProperty.relop = RELOP_EQ;
+	range[1].res.resProperty.ulPropTag = recurring;
+	range[1].res.resProperty.lpProp.ulPropTag = recurring;
+	range[1].res.resProperty.lpProp.value.b = 1;
+
+	res->rt = RES_OR;
+	res->res.resOr.cRes = 2;
+	res->res.resOr.res = range;
+
+	return res;
+}
+
+
+/**
+   Give the named properties of a table row back their canonical tags,
+   so octool_get_propval() finds them
+ */
+static void exchange2ical_unmap_row(struct SRow *aRow, struct SPropTagArray *canonical)
+{
+	uint32_t	i;
+
+	for (i = 0; i < aRow->cValues && i < canonical->cValues; i++) {
+		if ((aRow->lpProps[i].ulPropTag & 0xFFFF) == PT_ERROR) {
+			aRow->lpProps[i].ulPropTag = (enum MAPITAGS)((canonical->aulPropTag[i] & 0xFFFF0000) | PT_ERROR);
+		} else {
+			aRow->lpProps[i].ulPropTag = canonical->aulPropTag[i];
+		}
+	}
+}
+
+
 icalcomponent * _Exchange2Ical(mapi_object_t *obj_folder, struct exchange2ical_check *exchange2ical_check)
 {
 	TALLOC_CTX			*mem_ctx;
 	enum MAPISTATUS			retval;
 	int				ret;
 	struct SRowSet			SRowSet;
+	struct SRow			*tRow;
 	struct SRow			aRow;
-	struct SRow			aRowT;
 	struct SPropValue		*lpProps;
 	struct SPropTagArray		*SPropTagArray = NULL;
+	struct SPropTagArray		*canonical = NULL;
+	struct SPropTagArray		*columns = NULL;
+	struct mapi_SRestriction	*res;
 	struct exchange2ical		exchange2ical;
 	mapi_object_t			obj_table;
 	uint32_t			count;
-	int				i;
+	uint32_t			i;
+	uint32_t			j;
 
 	mem_ctx = talloc_named(mapi_object_get_session(obj_folder), 0, "exchange2ical");
 	exchange2ical_init(mem_ctx, &exchange2ical);
@@ -623,145 +834,139 @@ icalcomponent * _Exchange2Ical(mapi_object_t *obj_folder, struct exchange2ical_c
 		return NULL;
 	}
 
-	SPropTagArray = set_SPropTagArray(mem_ctx, 0x2,
-					  PR_FID,
-					  PR_MID);
-					  
-	retval = SetColumns(&obj_table, SPropTagArray);
-	MAPIFreeBuffer(SPropTagArray);
+	retval = exchange2ical_get_columns(mem_ctx, obj_folder, &canonical, &columns);
+	if (retval != MAPI_E_SUCCESS) {
+		mapi_errstr("GetIDsFromNames", retval);
+		mapi_object_release(&obj_table);
+		talloc_free(mem_ctx);
+		return NULL;
+	}
+
+	retval = SetColumns(&obj_table, columns);
 	if (retval != MAPI_E_SUCCESS) {
 		mapi_errstr("SetColumns", retval);
+		mapi_object_release(&obj_table);
 		talloc_free(mem_ctx);
 		return NULL;
 	}
-	
-	while ((retval = QueryRows(&obj_table, count, TBL_ADVANCE, &SRowSet)) != MAPI_E_NOT_FOUND && SRowSet.cRows) {
+
+	/* Let the server discard appointments outside the range */
+	if (exchange2ical_check->eFlags & RangeFlag) {
+		res = exchange2ical_get_restriction(mem_ctx, canonical, columns, exchange2ical_check);
+		if (res) {
+			retval = Restrict(&obj_table, res, NULL);
+			if (retval == MAPI_E_SUCCESS) {
+				retval = QueryPosition(&obj_table, NULL, &count);
+			}
+			if (retval != MAPI_E_SUCCESS) {
+				mapi_errstr("Restrict", retval);
+				mapi_object_release(&obj_table);
+				talloc_free(mem_ctx);
+				return NULL;
+			}
+		}
+	}
+
+	/* Multi-valued, large or free form string properties, only read
+	   from the opened message: table columns may be truncated */
+	SPropTagArray = set_SPropTagArray(mem_ctx, 0x11,
+					  PidNameKeywords,
+					  PidLidContacts,
+					  PidLidAppointmentRecur,
+					  PR_BODY_UNICODE,
+					  PR_BODY_HTML_UNICODE,
+					  PidLidTimeZoneDescription,
+					  PidLidLocation,
+					  PidLidNonSendableBcc,
+					  PidLidCollaborateDoc,
+					  PidLidDirectory,
+					  PidLidMeetingWorkspaceUrl,
+					  PidLidNetShowUrl,
+					  PidLidOnlinePassword,
+					  PidLidOrganizerAlias,
+					  PR_SUBJECT_UNICODE,
+					  PR_SENDER_NAME,
+					  PR_SENDER_EMAIL_ADDRESS);
+
+	while (count && (retval = QueryRows(&obj_table, count, TBL_ADVANCE, &SRowSet)) != MAPI_E_NOT_FOUND && SRowSet.cRows) {
 		count -= SRowSet.cRows;
-		for (i = (SRowSet.cRows-1); i >= 0; i--) {
+		for (i = SRowSet.cRows; i > 0; i--) {
+			tRow = &SRowSet.aRow[i - 1];
+			exchange2ical_unmap_row(tRow, canonical);
+
+			/*Get Vcal info if first event*/
+			if (!exchange2ical.vcalendar) {
+				ret = exchange2ical_get_properties(mem_ctx, tRow, &exchange2ical, VcalFlag);
+				/*TODO: exit nicely*/
+				ical_component_VCALENDAR(&exchange2ical);
+			}
+
+			/*Get required properties to check if right event*/
+			ret = exchange2ical_get_properties(mem_ctx, tRow, &exchange2ical, exchange2ical_check->eFlags);
+
+			/*Check to see if event is acceptable*/
+			if (!checkEvent(&exchange2ical, exchange2ical_check, get_tm_from_FILETIME(exchange2ical.apptStartWhole))){
+				continue;
+			}
+
+			/* Only the body, recurrence blob, strings and multi-valued properties need the message */
 			mapi_object_init(&exchange2ical.obj_message);
 			retval = OpenMessage(obj_folder,
-					     SRowSet.aRow[i].lpProps[0].value.d,
-					     SRowSet.aRow[i].lpProps[1].value.d,
+					     tRow->lpProps[0].value.d,
+					     tRow->lpProps[1].value.d,
 					     &exchange2ical.obj_message, 0);
-			if (retval != MAPI_E_NOT_FOUND) {
-				SPropTagArray = set_SPropTagArray(mem_ctx, 0x30,
-								  PidLidGlobalObjectId,
-								  PidNameKeywords,
-								  PidLidRecurring,
-								  PidLidAppointmentRecur,
-								  PidLidAppointmentStateFlags,
-								  PidLidTimeZoneDescription,
-								  PidLidTimeZoneStruct,
-								  PidLidContacts,
-								  PidLidAppointmentStartWhole,
-								  PidLidAppointmentEndWhole,
-								  PidLidAppointmentSubType,
-								  PidLidOwnerCriticalChange,
-								  PidLidLocation,
-								  PidLidNonSendableBcc,
-								  PidLidAppointmentSequence,
-								  PidLidBusyStatus,
-								  PidLidIntendedBusyStatus,
-								  PidLidAttendeeCriticalChange,
-								  PidLidAppointmentReplyTime,
-								  PidLidAppointmentNotAllowPropose,
-								  PidLidAllowExternalCheck,
-								  PidLidAppointmentLastSequence,
-								  PidLidAppointmentSequenceTime,
-								  PidLidAutoFillLocation,
-								  PidLidAutoStartCheck,
-								  PidLidCollaborateDoc,
-								  PidLidConferencingCheck,
-								  PidLidConferencingType,
-								  PidLidDirectory,
-								  PidLidMeetingWorkspaceUrl,
-								  PidLidNetShowUrl,
-								  PidLidOnlinePassword,
-								  PidLidOrganizerAlias,
-								  PidLidReminderSet,
-								  PidLidReminderDelta,
-								  PidLidResponseStatus,
-								  PR_MESSAGE_CLASS_UNICODE,
-								  PR_SENSITIVITY,
-								  PR_BODY_UNICODE,
-								  PR_CREATION_TIME,
-								  PR_LAST_MODIFICATION_TIME,
-								  PR_IMPORTANCE,
-								  PR_RESPONSE_REQUESTED,
-								  PR_SUBJECT_UNICODE,
-								  PR_OWNER_APPT_ID,
-								  PR_SENDER_NAME,
-								  PR_SENDER_EMAIL_ADDRESS,
-								  PR_MESSAGE_LOCALE_ID
-								  );
-								  
-								  
-				retval = GetProps(&exchange2ical.obj_message, MAPI_UNICODE, SPropTagArray, &lpProps, &count);
+			if (retval == MAPI_E_SUCCESS) {
+				retval = GetProps(&exchange2ical.obj_message, MAPI_UNICODE, SPropTagArray, &lpProps, &j);
+			}
+			if (retval != MAPI_E_SUCCESS) {
+				mapi_object_release(&exchange2ical.obj_message);
+				exchange2ical_reset(&exchange2ical);
+				continue;
+			}
 
-				MAPIFreeBuffer(SPropTagArray);
-	
-				if (retval == MAPI_E_SUCCESS) {
-					aRow.ulAdrEntryPad = 0;
-					aRow.cValues = count;
-					aRow.lpProps = lpProps;
-					
-					/*Get Vcal info if first event*/
-					if(i==(SRowSet.cRows-1)){
-						ret = exchange2ical_get_properties(mem_ctx, &aRow, &exchange2ical, VcalFlag);
-						/*TODO: exit nicely*/
-						ical_component_VCALENDAR(&exchange2ical);
-					}
-					
-					
-					/*Get required properties to check if right event*/
-					ret = exchange2ical_get_properties(mem_ctx, &aRow, &exchange2ical, exchange2ical_check->eFlags);
-					
-					/*Check to see if event is acceptable*/
-					if (!checkEvent(&exchange2ical, exchange2ical_check, get_tm_from_FILETIME(exchange2ical.apptStartWhole))){
-						continue;
-					}
-					
-					/*Set RecipientTable*/
-					retval = GetRecipientTable(&exchange2ical.obj_message, 
-							   &exchange2ical.Recipients.SRowSet,
-							   &exchange2ical.Recipients.SPropTagArray);
-					
-					/*Set PR_BODY_HTML for x_alt_desc property*/
-					SPropTagArray = set_SPropTagArray(mem_ctx, 0x1, PR_BODY_HTML_UNICODE);
-					retval = GetProps(&exchange2ical.obj_message, MAPI_UNICODE, SPropTagArray, &lpProps, &count);
-					MAPIFreeBuffer(SPropTagArray);
-					if (retval == MAPI_E_SUCCESS) {
-						aRowT.ulAdrEntryPad = 0;
-						aRowT.cValues = count;
-						aRowT.lpProps = lpProps;
-						exchange2ical.bodyHTML = (const char *)octool_get_propval(&aRowT, PR_BODY_HTML_UNICODE);
-					}
-					
-					/*Get rest of properties*/
-					ret = exchange2ical_get_properties(mem_ctx, &aRow, &exchange2ical, (exchange2ical_check->eFlags | EntireFlag));
-					
-					/*add new vevent*/
-					ical_component_VEVENT(&exchange2ical);
-					
-					/*Exceptions to event*/
-					if(exchange2ical_check->eFlags != EventFlag){
-						ret = exchange2ical_exception_from_EmbeddedObj(&exchange2ical, exchange2ical_check);
-						if (ret){
-							ret=exchange2ical_exception_from_ExceptionInfo(&exchange2ical, exchange2ical_check);
-						}
-					}
-					
-					/*REMOVE once globalobjid is fixed*/
-					exchange2ical.idx++;
-					
-					MAPIFreeBuffer(lpProps);
-					exchange2ical_reset(&exchange2ical);
+			aRow.ulAdrEntryPad = 0;
+			aRow.cValues = tRow->cValues + j;
+			aRow.lpProps = talloc_array(lpProps, struct SPropValue, aRow.cValues);
+			memcpy(aRow.lpProps, tRow->lpProps, tRow->cValues * sizeof (struct SPropValue));
+			memcpy(aRow.lpProps + tRow->cValues, lpProps, j * sizeof (struct SPropValue));
+
+			/*Set RecipientTable*/
+			retval = GetRecipientTable(&exchange2ical.obj_message, 
+						   &exchange2ical.Recipients.SRowSet,
+						   &exchange2ical.Recipients.SPropTagArray);
+
+			/*Set PR_BODY_HTML for x_alt_desc property*/
+			exchange2ical.bodyHTML = (const char *)octool_get_propval(&aRow, PR_BODY_HTML_UNICODE);
+
+			/*Get rest of properties*/
+			ret = exchange2ical_get_properties(mem_ctx, &aRow, &exchange2ical, (exchange2ical_check->eFlags | EntireFlag));
+
+			/*add new vevent*/
+			ical_component_VEVENT(&exchange2ical);
+
+			/*Exceptions to event*/
+			if(exchange2ical_check->eFlags != EventFlag){
+				ret = exchange2ical_exception_from_EmbeddedObj(&exchange2ical, exchange2ical_check);
+				if (ret){
+					ret=exchange2ical_exception_from_ExceptionInfo(&exchange2ical, exchange2ical_check);
 				}
-				
 			}
+
+			/*REMOVE once globalobjid is fixed*/
+			exchange2ical.idx++;
+
+			MAPIFreeBuffer(lpProps);
+			exchange2ical_reset(&exchange2ical);
 			mapi_object_release(&exchange2ical.obj_message);
 		}
 	}
+	MAPIFreeBuffer(SPropTagArray);
+
+	/* An empty range still yields a calendar without any vevent */
+	if (!exchange2ical.vcalendar && (exchange2ical_check->eFlags & RangeFlag)) {
+		exchange2ical.method = ICAL_METHOD_PUBLISH;
+		ical_component_VCALENDAR(&exchange2ical);
+	}
 
 	icalcomponent *icalendar = exchange2ical.vcalendar;
 	exchange2ical_clear(&exchange2ical);
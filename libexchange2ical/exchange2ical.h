@@ -170,6 +170,7 @@ struct icaltimetype get_icaltimetype_from_tm_UTC(struct tm *);
 struct icaltimetype get_icaltimetype_from_tm(struct tm *);
 struct FILETIME get_FILETIME_from_string(const char *);
 struct FILETIME get_FILETIME_from_icaltimetype(icaltimetype *);
+struct FILETIME get_FILETIME_from_tm(struct tm *);
 struct tm get_tm_from_minutes(uint32_t);
 struct tm get_tm_from_minutes_UTC(uint32_t);
 struct icaltimetype get_icaldate_from_GlobalObjectId(struct GlobalObjectId *);
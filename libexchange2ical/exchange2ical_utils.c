@@ -576,6 +576,21 @@ struct FILETIME get_FILETIME_from_icaltimetype(icaltimetype *tt)
 }
 
 
+struct FILETIME get_FILETIME_from_tm(struct tm *tm)
+{
+	struct FILETIME		ft;
+	NTTIME			nttime;
+
+	/* Same local time interpretation as checkEvent */
+	unix_to_nt_time(&nttime, mktime(tm));
+
+	ft.dwHighDateTime=(uint32_t) (nttime>>32);
+	ft.dwLowDateTime=(uint32_t) (nttime);
+
+	return ft;
+}
+
+
 NTTIME FILETIME_to_NTTIME(struct FILETIME ft)
 {
 	NTTIME nt;
@@ -66,6 +66,8 @@ class folder : public object {
 		folder(object& parent_folder, const mapi_id_t folder_id) throw(mapi_exception) 
 		: object(parent_folder.get_session(), "folder"), m_id(folder_id)
 		{
+			boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
 			if (OpenFolder(&parent_folder.data(), folder_id, &m_object) != MAPI_E_SUCCESS)
 				throw mapi_exception(GetLastError(), "folder::folder : OpenFolder");
 		}
@@ -84,6 +86,8 @@ class folder : public object {
 		 */
 		void delete_message(mapi_id_t message_id) throw (mapi_exception)
 		{
+			boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
 			if (DeleteMessage(&m_object, &message_id, 1) != MAPI_E_SUCCESS)
 				throw mapi_exception(GetLastError(), "folder::delete_message : DeleteMessage");
 		}
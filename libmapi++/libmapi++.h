@@ -26,6 +26,7 @@
 #include <libmapi++/message_store.h>
 #include <libmapi++/mapi_exception.h>
 #include <libmapi++/folder.h>
+#include <libmapi++/table.h>
 #include <libmapi++/message.h>
 #include <libmapi++/attachment.h>
 #include <libmapi++/property_container.h>
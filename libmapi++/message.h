@@ -57,6 +57,8 @@ class message : public object {
 		message(session& mapi_session, const mapi_id_t folder_id, const mapi_id_t message_id) throw(mapi_exception) 
 		: object(mapi_session, "message"), m_folder_id(folder_id), m_id(message_id)
 		{
+			boost::mutex::scoped_lock lock(mapi_session.get_transport_mutex());
+
 			if (OpenMessage(&mapi_session.get_message_store().data(), folder_id, message_id, &m_object, 0) != MAPI_E_SUCCESS)
 				throw mapi_exception(GetLastError(), "message::message : OpenMessage");
 		}
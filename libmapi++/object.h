@@ -83,14 +83,7 @@ class object {
 		 *
 		 * Calls mapi_object_release() which releases the handle associated with this object.
 		 */ 
-		virtual ~object() throw()
-		{
-			// TODO: Check for invalid handle in libmapi 0.7
-			// if (m_object.handle != INVALID_HANDLE_VALUE)
-			mapi_object_release(&m_object);
-
-//			std::cout << "destroying object " << m_object_type << std::endl;
-		}
+		virtual ~object() throw();
 
 	protected:
 		mapi_object_t	m_object;
@@ -24,6 +24,8 @@
 #include <stdint.h>
 #include <iostream> // for debugging only.
 
+#include <boost/thread/mutex.hpp>
+
 #include <libmapi++/clibmapi.h>
 #include <libmapi++/mapi_exception.h>
 
@@ -162,9 +164,16 @@ class property_container {
 		typedef property_container_iterator	iterator;
 		typedef const void*			value_type;
 
-		/// Constructor
-		property_container(TALLOC_CTX* memory_ctx, mapi_object_t& mapi_object) : 
-		m_memory_ctx(memory_ctx), m_mapi_object(mapi_object), m_fetched(false), m_property_tag_array(NULL), m_cn_vals(0), m_property_values(0)
+		/**
+		 * \brief Constructor
+		 *
+		 * \param memory_ctx The talloc context used for property allocations.
+		 * \param mapi_object The object the properties are fetched from.
+		 * \param transport_mutex The session mutex to hold while fetching or
+		 * allocating from memory_ctx, if any.
+		 */
+		property_container(TALLOC_CTX* memory_ctx, mapi_object_t& mapi_object, boost::mutex* transport_mutex = NULL) : 
+		m_memory_ctx(memory_ctx), m_mapi_object(mapi_object), m_transport_mutex(transport_mutex), m_fetched(false), m_property_tag_array(NULL), m_cn_vals(0), m_property_values(0)
 		{
 			m_property_value_array.cValues = 0;
 			m_property_value_array.lpProps = NULL;
@@ -177,6 +186,8 @@ class property_container {
 		 */
 		uint32_t fetch()
 		{
+			transport_lock lock(m_transport_mutex);
+
 			if (GetProps(&m_mapi_object, MAPI_UNICODE, m_property_tag_array, &m_property_values, &m_cn_vals) != MAPI_E_SUCCESS)
 				throw mapi_exception(GetLastError(), "property_container::fetch : GetProps");
 
@@ -190,6 +201,8 @@ class property_container {
 		/// \brief Fetches \b ALL properties of the object associated with this container.
 		void fetch_all()
 		{
+			transport_lock lock(m_transport_mutex);
+
 			if (GetPropsAll(&m_mapi_object, MAPI_UNICODE, &m_property_value_array) != MAPI_E_SUCCESS)
 				throw mapi_exception(GetLastError(), "property_container::fetch_all : GetPropsAll");
 
@@ -205,6 +218,8 @@ class property_container {
 		/// \brief Adds a Property Tag to be fetched by fetch().
 		property_container& operator<<(uint32_t property_tag)
 		{
+			transport_lock lock(m_transport_mutex);
+
 			if (!m_property_tag_array) {
 				m_property_tag_array = set_SPropTagArray(m_memory_ctx, 1, property_tag);
 			} else {
@@ -274,12 +289,33 @@ class property_container {
 		/// Destructor
 		~property_container()
 		{
-			if (m_property_tag_array) MAPIFreeBuffer(m_property_tag_array);
+			if (m_property_tag_array) {
+				transport_lock lock(m_transport_mutex);
+				MAPIFreeBuffer(m_property_tag_array);
+			}
 		}
 
 	private:
+		/// Holds the (optional) session mutex for the lifetime of the lock.
+		class transport_lock {
+			public:
+				explicit transport_lock(boost::mutex* transport_mutex) : m_mutex(transport_mutex)
+				{
+					if (m_mutex) m_mutex->lock();
+				}
+
+				~transport_lock()
+				{
+					if (m_mutex) m_mutex->unlock();
+				}
+
+			private:
+				boost::mutex*	m_mutex;
+		};
+
 		TALLOC_CTX*		m_memory_ctx;
 		mapi_object_t&		m_mapi_object;
+		boost::mutex*		m_transport_mutex;
 
 		bool			m_fetched;
 
@@ -28,6 +28,8 @@
 
 #include <iostream> // for debugging
 
+#include <boost/thread/mutex.hpp>
+
 #include <libmapi++/clibmapi.h>
 #include <libmapi++/mapi_exception.h>
 #include <libmapi++/message_store.h>
@@ -104,6 +106,10 @@ class session {
 		 *
 		 * This pointer can be used for subsequent memory allocations, and
 		 * these will be cleaned up when the %session is terminated.
+		 *
+		 * talloc is not thread safe: while a %table may be prefetching in
+		 * the background, allocate from (and free to) this context only
+		 * with get_transport_mutex() held.
 		 */
 		TALLOC_CTX* get_memory_ctx() throw() { return m_memory_ctx; }
 
@@ -122,12 +128,24 @@ class session {
 		 */
 		mapi_session* get_mapi_session() throw() { return m_session; }
 
+		/**
+		 * \brief The mutex serializing transactions on this %session
+		 *
+		 * libmapi is not thread safe for a given mapi_session. Any
+		 * code issuing requests on this %session from more than one
+		 * thread (for example a table prefetching its next page in the
+		 * background) must hold this mutex for the duration of the call,
+		 * and around allocations from get_memory_ctx().
+		 */
+		boost::mutex& get_transport_mutex() throw() { return m_transport_mutex; }
+
 	private:
 		mapi_session		*m_session;
 		struct mapi_context	*m_mapi_context;
 		TALLOC_CTX		*m_memory_ctx;
 		message_store		*m_message_store;
 		std::string		m_profile_name;
+		boost::mutex		m_transport_mutex;
 
 		void uninitialize() throw()
 		{
@@ -26,8 +26,12 @@ namespace libmapipp {
 attachment::attachment(message& mapi_message, const uint32_t attach_num) throw(mapi_exception)
 : object(mapi_message.get_session(), "attachment"), m_attach_num(attach_num), m_bin_data(NULL), m_data_size(0), m_filename("")
 {
-	if (OpenAttach(&mapi_message.data(), attach_num, &m_object) != MAPI_E_SUCCESS)
-		throw mapi_exception(GetLastError(), "attachment::attachment : OpenAttach");
+	{
+		boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+		if (OpenAttach(&mapi_message.data(), attach_num, &m_object) != MAPI_E_SUCCESS)
+			throw mapi_exception(GetLastError(), "attachment::attachment : OpenAttach");
+	}
 
 	property_container properties = get_property_container();
 	properties << PR_ATTACH_FILENAME << PR_ATTACH_LONG_FILENAME << PR_ATTACH_SIZE << PR_ATTACH_DATA_BIN << PR_ATTACH_METHOD;
@@ -57,6 +61,8 @@ attachment::attachment(message& mapi_message, const uint32_t attach_num) throw(m
 		m_bin_data = new uint8_t[m_data_size];
 		memcpy(m_bin_data, attachment_data->lpb, attachment_data->cb);
 	} else {
+		boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
 		mapi_object_t obj_stream;
 		mapi_object_init(&obj_stream);
 		if (OpenStream(&m_object, (enum MAPITAGS)PidTagAttachDataBinary, OpenStream_ReadOnly, &obj_stream) != MAPI_E_SUCCESS)
@@ -19,97 +19,75 @@
 */
 
 #include <libmapi++/folder.h>
+#include <libmapi++/table.h>
 
 namespace libmapipp {
 
 folder::message_container_type folder::fetch_messages() throw(mapi_exception)
 {
-	uint32_t 	contents_table_row_count = 0;
-        mapi_object_t	contents_table;
-
-	mapi_object_init(&contents_table);
-	if (GetContentsTable(&m_object, &contents_table, 0, &contents_table_row_count) != MAPI_E_SUCCESS) {
-		mapi_object_release(&contents_table);
-		throw mapi_exception(GetLastError(), "folder::fetch_messages : GetContentsTable");
-	}
+	table contents_table(*this, table::contents_table);
 
+	// The session memory context is shared with any table of this
+	// session prefetching in the background
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
 	SPropTagArray* property_tag_array = set_SPropTagArray(m_session.get_memory_ctx(), 0x2, PR_FID,
 											       PR_MID);
+	lock.unlock();
 
-	if (SetColumns(&contents_table, property_tag_array) != MAPI_E_SUCCESS) {
+	try {
+		contents_table.set_columns(property_tag_array);
+	} catch(mapi_exception e) {
+		lock.lock();
 		MAPIFreeBuffer(property_tag_array);
-		mapi_object_release(&contents_table);
-		throw mapi_exception(GetLastError(), "folder::fetch_messages : SetColumns");
+		throw;
 	}
 
+	lock.lock();
 	MAPIFreeBuffer(property_tag_array);
-
-	uint32_t rows_to_read = contents_table_row_count;
-	SRowSet  row_set;
+	lock.unlock();
 
 	message_container_type message_container;
-	message_container.reserve(contents_table_row_count);
-
-	while( (QueryRows(&contents_table, rows_to_read, TBL_ADVANCE, &row_set) == MAPI_E_SUCCESS) && row_set.cRows) {
-		rows_to_read -= row_set.cRows;
-		for (unsigned int i = 0; i < row_set.cRows; ++i) {
-			try {
-				message_container.push_back(message_shared_ptr(new message(m_session,
-											   m_id,
-											   row_set.aRow[i].lpProps[1].value.d)));
-			} catch(mapi_exception e) {
-				mapi_object_release(&contents_table);
-				throw;
-			}
-		}
-	}
+	message_container.reserve(contents_table.get_row_count());
 
-	mapi_object_release(&contents_table);
+	// The table keeps the next page in flight while messages are opened
+	for (table::iterator Iter = contents_table.begin(); Iter != contents_table.end(); ++Iter) {
+		message_container.push_back(message_shared_ptr(new message(m_session,
+									   m_id,
+									   Iter->lpProps[1].value.d)));
+	}
 
 	return message_container;
 }
 
 folder::hierarchy_container_type folder::fetch_hierarchy() throw(mapi_exception)
 {
-	mapi_object_t	hierarchy_table;
-	uint32_t	hierarchy_table_row_count = 0;
-
-	mapi_object_init(&hierarchy_table);
-	if (GetHierarchyTable(&m_object, &hierarchy_table, 0, &hierarchy_table_row_count) != MAPI_E_SUCCESS) {
-		mapi_object_release(&hierarchy_table);
-		throw mapi_exception(GetLastError(), "folder::fetch_hierarchy : GetHierarchyTable");
-	}
+	table hierarchy_table(*this, table::hierarchy_table);
 
+	// The session memory context is shared with any table of this
+	// session prefetching in the background
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
 	SPropTagArray* property_tag_array = set_SPropTagArray(m_session.get_memory_ctx(), 0x1, PR_FID);
+	lock.unlock();
 
-	if (SetColumns(&hierarchy_table, property_tag_array)) {
+	try {
+		hierarchy_table.set_columns(property_tag_array);
+	} catch(mapi_exception e) {
+		lock.lock();
 		MAPIFreeBuffer(property_tag_array);
-		mapi_object_release(&hierarchy_table);
-		throw mapi_exception(GetLastError(), "folder::fetch_hierarchy : SetColumns");
+		throw;
 	}
 
+	lock.lock();
 	MAPIFreeBuffer(property_tag_array);
-
-	uint32_t rows_to_read = hierarchy_table_row_count;
-	SRowSet  row_set;
+	lock.unlock();
 
 	hierarchy_container_type hierarchy_container;
-	hierarchy_container.reserve(hierarchy_table_row_count);
-
-	while( (QueryRows(&hierarchy_table, rows_to_read, TBL_ADVANCE, &row_set) == MAPI_E_SUCCESS) && row_set.cRows) {
-		rows_to_read -= row_set.cRows;
-		for (unsigned int i = 0; i < row_set.cRows; ++i) {
-			try {
-				hierarchy_container.push_back(folder_shared_ptr(new folder(*this,
-							      row_set.aRow[i].lpProps[0].value.d)));
-			} catch(mapi_exception e) {
-				mapi_object_release(&hierarchy_table);
-				throw;
-			}
-		}
-	}
+	hierarchy_container.reserve(hierarchy_table.get_row_count());
 
-	mapi_object_release(&hierarchy_table);
+	for (table::iterator Iter = hierarchy_table.begin(); Iter != hierarchy_table.end(); ++Iter) {
+		hierarchy_container.push_back(folder_shared_ptr(new folder(*this,
+					      Iter->lpProps[0].value.d)));
+	}
 
 	return hierarchy_container;
 }
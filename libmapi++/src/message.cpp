@@ -26,6 +26,9 @@ message::attachment_container_type message::fetch_attachments()
 {
 	mapi_object_t   attachment_table;
 
+	// A table of this session may be prefetching in the background
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
 	mapi_object_init(&attachment_table);
 	if (GetAttachmentTable(&m_object, &attachment_table) != MAPI_E_SUCCESS) {
 		mapi_object_release(&attachment_table);
@@ -46,15 +49,19 @@ message::attachment_container_type message::fetch_attachments()
 	attachment_container_type attachment_container;
 
 	while( (QueryRows(&attachment_table, 0x32, TBL_ADVANCE, &row_set) == MAPI_E_SUCCESS) && row_set.cRows) {
+		// attachment::attachment takes the lock itself
+		lock.unlock();
 		for (unsigned int i = 0; i < row_set.cRows; ++i) {
 			try {
 				attachment_container.push_back(attachment_shared_ptr(new attachment(*this, row_set.aRow[i].lpProps[0].value.l)));
 			}
 			catch(mapi_exception e) {
+				lock.lock();
 				mapi_object_release(&attachment_table);
 				throw;
 			}
 		}
+		lock.lock();
 	}
 	mapi_object_release(&attachment_table);
 
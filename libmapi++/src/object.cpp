@@ -26,7 +26,18 @@ namespace libmapipp {
 
 property_container object::get_property_container() 
 { 
-	return property_container(m_session.get_memory_ctx(), m_object); 
+	return property_container(m_session.get_memory_ctx(), m_object, &m_session.get_transport_mutex()); 
+}
+
+object::~object() throw()
+{
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	// TODO: Check for invalid handle in libmapi 0.7
+	// if (m_object.handle != INVALID_HANDLE_VALUE)
+	mapi_object_release(&m_object);
+
+//	std::cout << "destroying object " << m_object_type << std::endl;
 }
 
 } // namespace libmapipp
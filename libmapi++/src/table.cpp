@@ -0,0 +1,345 @@
+/*
+   libmapi C++ Wrapper
+   Table Class implementation.
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+
+#include <libmapi++/table.h>
+
+namespace libmapipp {
+
+// Space available for row data in an EcDoRpc response: the 0x8000
+// transport buffer minus the RPC_HEADER_EXT and QueryRows reply header.
+static const uint32_t	table_transport_buffer_size = 0x7F00;
+static const uint16_t	table_min_page_size = 0x10;
+static const uint16_t	table_max_page_size = 0x1000;
+static const uint16_t	table_initial_page_size = 0x32;
+
+// Wire size of a row, as it is encoded in a QueryRows reply
+static uint32_t get_row_size(const SRow& row)
+{
+	uint32_t size = sizeof (uint8_t); // row flag
+
+	for (uint32_t i = 0; i < row.cValues; ++i) {
+		const SPropValue& prop = row.lpProps[i];
+
+		switch (prop.ulPropTag & 0xFFFF) {
+		case PT_BOOLEAN:
+			size += sizeof (uint8_t);
+			break;
+		case PT_I2:
+			size += sizeof (uint16_t);
+			break;
+		case PT_LONG:
+		case PT_ERROR:
+			size += sizeof (uint32_t);
+			break;
+		case PT_DOUBLE:
+		case PT_I8:
+		case PT_SYSTIME:
+			size += sizeof (uint64_t);
+			break;
+		case PT_STRING8:
+			size += (prop.value.lpszA ? strlen(prop.value.lpszA) : 0) + 1;
+			break;
+		case PT_UNICODE:
+			size += ((prop.value.lpszW ? strlen(prop.value.lpszW) : 0) + 1) * 2;
+			break;
+		case PT_CLSID:
+			size += 16;
+			break;
+		case PT_BINARY:
+			size += sizeof (uint16_t) + prop.value.bin.cb;
+			break;
+		default:
+			size += sizeof (uint32_t);
+			break;
+		}
+	}
+
+	return size;
+}
+
+table_iterator& table_iterator::operator++()
+{
+	if (m_table && !m_table->next_row()) {
+		m_table = NULL;
+	}
+
+	return *this;
+}
+
+const SRow& table_iterator::operator*() const
+{
+	return m_table->m_current.aRow[m_table->m_current_index];
+}
+
+table::table(object& container, const table_type type, const uint8_t table_flags) throw(mapi_exception)
+: object(container.get_session(), "table"), m_row_count(0), m_page_size(table_initial_page_size), m_row_size(0),
+  m_current_index(0), m_pending_status(MAPI_E_SUCCESS)
+{
+	m_current.cRows = 0;
+	m_current.aRow = NULL;
+	m_pending.cRows = 0;
+	m_pending.aRow = NULL;
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (type == hierarchy_table) {
+		if (GetHierarchyTable(&container.data(), &m_object, table_flags, &m_row_count) != MAPI_E_SUCCESS)
+			throw mapi_exception(GetLastError(), "table::table : GetHierarchyTable");
+	} else {
+		if (GetContentsTable(&container.data(), &m_object, table_flags, &m_row_count) != MAPI_E_SUCCESS)
+			throw mapi_exception(GetLastError(), "table::table : GetContentsTable");
+	}
+}
+
+void table::set_columns(SPropTagArray* property_tag_array) throw(mapi_exception)
+{
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (SetColumns(&m_object, property_tag_array) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::set_columns : SetColumns");
+
+	// The previous estimate is meaningless with different columns
+	m_row_size = 0;
+	m_page_size = table_initial_page_size;
+}
+
+void table::sort(SSortOrderSet* sort_order) throw(mapi_exception)
+{
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (SortTable(&m_object, sort_order) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::sort : SortTable");
+}
+
+void table::read_rows(const uint32_t position, const uint16_t row_count, SRowSet& row_set) throw(mapi_exception)
+{
+	uint32_t row = 0;
+
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (SeekRow(&m_object, BOOKMARK_BEGINNING, position, &row) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::read_rows : SeekRow");
+
+	if (QueryRows(&m_object, row_count, TBL_ADVANCE, &row_set) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::read_rows : QueryRows");
+}
+
+uint32_t table::seek(const enum BOOKMARK origin, const int32_t offset) throw(mapi_exception)
+{
+	uint32_t row = 0;
+
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (SeekRow(&m_object, origin, offset, &row) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::seek : SeekRow");
+
+	return row;
+}
+
+uint32_t table::create_bookmark() throw(mapi_exception)
+{
+	uint32_t bookmark = 0;
+
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (CreateBookmark(&m_object, &bookmark) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::create_bookmark : CreateBookmark");
+
+	return bookmark;
+}
+
+uint32_t table::seek_bookmark(const uint32_t bookmark, const int32_t offset) throw(mapi_exception)
+{
+	uint32_t row = 0;
+
+	cancel_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (SeekRowBookmark(&m_object, bookmark, offset, &row) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::seek_bookmark : SeekRowBookmark");
+
+	return row;
+}
+
+void table::free_bookmark(const uint32_t bookmark) throw(mapi_exception)
+{
+	// FreeBookmark does not move the cursor, the prefetched page stays valid
+	wait_prefetch();
+
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	if (FreeBookmark(&m_object, bookmark) != MAPI_E_SUCCESS)
+		throw mapi_exception(GetLastError(), "table::free_bookmark : FreeBookmark");
+}
+
+table::iterator table::begin() throw(mapi_exception)
+{
+	cancel_prefetch();
+
+	fetch_page(m_current, m_pending_status, m_page_size);
+	if (m_pending_status != MAPI_E_SUCCESS)
+		throw mapi_exception(m_pending_status, "table::begin : QueryRows");
+
+	m_current_index = 0;
+	if (!m_current.cRows)
+		return end();
+
+	update_page_size(m_current);
+	start_prefetch();
+
+	return iterator(this);
+}
+
+bool table::next_row() throw(mapi_exception)
+{
+	if (++m_current_index < m_current.cRows)
+		return true;
+
+	wait_prefetch();
+	free_rows(m_current);
+
+	m_current = m_pending;
+	m_current_index = 0;
+	m_pending.cRows = 0;
+	m_pending.aRow = NULL;
+
+	if (m_pending_status != MAPI_E_SUCCESS) {
+		enum MAPISTATUS status = m_pending_status;
+		m_pending_status = MAPI_E_SUCCESS;
+		throw mapi_exception(status, "table::iterator::operator++ : QueryRows");
+	}
+
+	if (!m_current.cRows)
+		return false;
+
+	update_page_size(m_current);
+	start_prefetch();
+
+	return true;
+}
+
+void table::fetch_page(SRowSet& row_set, enum MAPISTATUS& status, const uint16_t row_count)
+{
+	boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+	status = QueryRows(&m_object, row_count, TBL_ADVANCE, &row_set);
+	if (status != MAPI_E_SUCCESS) {
+		row_set.cRows = 0;
+		row_set.aRow = NULL;
+	}
+}
+
+void table::prefetch_page(const uint16_t row_count)
+{
+	fetch_page(m_pending, m_pending_status, row_count);
+}
+
+void table::start_prefetch()
+{
+	m_prefetch_thread = boost::thread(&table::prefetch_page, this, m_page_size);
+}
+
+void table::wait_prefetch()
+{
+	if (m_prefetch_thread.joinable())
+		m_prefetch_thread.join();
+}
+
+void table::cancel_prefetch() throw(mapi_exception)
+{
+	wait_prefetch();
+
+	// Move the cursor back to the row following the one last handed out
+	uint32_t rewind = m_pending.cRows;
+	if (m_current_index < m_current.cRows)
+		rewind += m_current.cRows - (m_current_index + 1);
+
+	free_rows(m_pending);
+	free_rows(m_current);
+	m_current_index = 0;
+	m_pending_status = MAPI_E_SUCCESS;
+
+	if (rewind) {
+		uint32_t row = 0;
+		boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+
+		if (SeekRow(&m_object, BOOKMARK_CURRENT, -(int32_t)rewind, &row) != MAPI_E_SUCCESS)
+			throw mapi_exception(GetLastError(), "table::cancel_prefetch : SeekRow");
+	}
+}
+
+void table::free_rows(SRowSet& row_set)
+{
+	if (row_set.aRow) {
+		// rows are allocated under the table object, which the
+		// prefetching thread may be allocating under too.
+		boost::mutex::scoped_lock lock(m_session.get_transport_mutex());
+		MAPIFreeBuffer(row_set.aRow);
+	}
+
+	row_set.cRows = 0;
+	row_set.aRow = NULL;
+}
+
+void table::update_page_size(const SRowSet& row_set)
+{
+	uint32_t size = 0;
+
+	for (uint32_t i = 0; i < row_set.cRows; ++i) {
+		size += get_row_size(row_set.aRow[i]);
+	}
+
+	uint32_t row_size = size / row_set.cRows;
+	if (!row_size)
+		row_size = 1;
+
+	// Smooth the estimate so a single large row does not collapse the page
+	m_row_size = m_row_size ? (3 * m_row_size + row_size) / 4 : row_size;
+
+	uint32_t page_size = table_transport_buffer_size / m_row_size;
+	if (page_size < table_min_page_size)
+		page_size = table_min_page_size;
+	else if (page_size > table_max_page_size)
+		page_size = table_max_page_size;
+
+	m_page_size = page_size;
+}
+
+table::~table() throw()
+{
+	wait_prefetch();
+	free_rows(m_pending);
+	free_rows(m_current);
+}
+
+} // namespace libmapipp
@@ -0,0 +1,219 @@
+/*
+   libmapi C++ Wrapper
+   Table Class
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBMAPIPP__TABLE_H__
+#define LIBMAPIPP__TABLE_H__
+
+#include <iterator>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <libmapi++/clibmapi.h>
+#include <libmapi++/mapi_exception.h>
+#include <libmapi++/object.h>
+#include <libmapi++/session.h>
+
+namespace libmapipp
+{
+class table;
+
+/**
+ * \brief Input iterator over the rows of a %table
+ *
+ * Dereferencing the iterator yields the current SRow. As with any input
+ * iterator, the row is only valid until the iterator is incremented.
+ */
+class table_iterator : public std::iterator<std::input_iterator_tag, SRow> {
+	public:
+		/// Default Constructor. Creates an end iterator.
+		table_iterator() : m_table(NULL)
+		{}
+
+		explicit table_iterator(table* mapi_table) : m_table(mapi_table)
+		{}
+
+		/// operator++
+		table_iterator& operator++(); // prefix
+
+		/// operator*
+		const SRow& operator*() const;
+
+		/// operator->
+		const SRow* operator->() const { return &(operator*()); }
+
+		/// operator==
+		bool operator==(const table_iterator& rhs) const
+		{
+			return (m_table == rhs.m_table);
+		}
+
+		/// operator!=
+		bool operator!=(const table_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+	private:
+		table*	m_table;
+};
+
+/**
+ * \brief This class represents a contents or hierarchy %table.
+ *
+ * Rows are retrieved page by page with QueryRows. While the caller
+ * processes the current page, the next one is already requested on a
+ * background thread, so iterating a large %table does not stall on
+ * every round trip. The page size is adapted to the measured size of
+ * the rows so that each response approaches the transport buffer limit.
+ *
+ * Requests issued by the prefetching thread are serialized with the
+ * rest of libmapi++ through session::get_transport_mutex().
+ */
+class table : public object {
+	public:
+		typedef table_iterator	iterator;
+
+		/// The kind of %table to open on a container
+		enum table_type {
+			contents_table,
+			hierarchy_table
+		};
+
+		/**
+		 * \brief Constructor
+		 *
+		 * \param container The folder (or other container) to open the %table on.
+		 * \param type Whether to open the contents or the hierarchy %table.
+		 * \param table_flags Flags passed to GetContentsTable/GetHierarchyTable.
+		 */
+		table(object& container, const table_type type = contents_table, const uint8_t table_flags = 0) throw(mapi_exception);
+
+		/**
+		 * \brief Number of rows in the %table when it was opened
+		 */
+		uint32_t get_row_count() const { return m_row_count; }
+
+		/**
+		 * \brief Current QueryRows page size
+		 */
+		uint16_t get_page_size() const { return m_page_size; }
+
+		/**
+		 * \brief Set the columns returned for each row
+		 *
+		 * \param property_tag_array The property tags making up the columns.
+		 */
+		void set_columns(SPropTagArray* property_tag_array) throw(mapi_exception);
+
+		/**
+		 * \brief Ask the server to sort the %table
+		 *
+		 * \param sort_order The sort criteria, passed to SortTable.
+		 */
+		void sort(SSortOrderSet* sort_order) throw(mapi_exception);
+
+		/**
+		 * \brief Read a window of rows at an absolute position
+		 *
+		 * This is meant for random access (for example a view scrolling
+		 * through the %table) and does not prefetch. The caller owns the
+		 * returned rows and must release them with MAPIFreeBuffer(row_set.aRow).
+		 *
+		 * \param position The index of the first row to read.
+		 * \param row_count The maximum number of rows to read.
+		 * \param row_set The rows read.
+		 */
+		void read_rows(const uint32_t position, const uint16_t row_count, SRowSet& row_set) throw(mapi_exception);
+
+		/**
+		 * \brief Move the %table cursor
+		 *
+		 * \param origin BOOKMARK_BEGINNING, BOOKMARK_CURRENT or BOOKMARK_END
+		 * \param offset The number of rows to move, relative to origin.
+		 *
+		 * \return The number of rows actually moved.
+		 */
+		uint32_t seek(const enum BOOKMARK origin, const int32_t offset) throw(mapi_exception);
+
+		/**
+		 * \brief Create a bookmark at the current cursor position
+		 *
+		 * \return The bookmark, to be used with seek_bookmark() and free_bookmark().
+		 */
+		uint32_t create_bookmark() throw(mapi_exception);
+
+		/**
+		 * \brief Move the %table cursor relative to a bookmark
+		 *
+		 * \param bookmark A bookmark returned by create_bookmark().
+		 * \param offset The number of rows to move, relative to bookmark.
+		 *
+		 * \return The number of rows actually moved.
+		 */
+		uint32_t seek_bookmark(const uint32_t bookmark, const int32_t offset) throw(mapi_exception);
+
+		/**
+		 * \brief Release a bookmark
+		 */
+		void free_bookmark(const uint32_t bookmark) throw(mapi_exception);
+
+		/**
+		 * \brief Start iterating over the rows from the current cursor position
+		 *
+		 * Only one iteration can be in progress at a time: calling begin()
+		 * again, or moving the cursor, invalidates existing iterators.
+		 */
+		iterator begin() throw(mapi_exception);
+
+		/// The end iterator
+		iterator end() const { return iterator(); }
+
+		/**
+		 * Destructor
+		 */
+		virtual ~table() throw();
+
+	private:
+		friend class table_iterator;
+
+		uint32_t		m_row_count;
+		uint16_t		m_page_size;
+		uint32_t		m_row_size;	// running estimate, in bytes
+
+		SRowSet			m_current;
+		uint32_t		m_current_index;
+
+		SRowSet			m_pending;
+		enum MAPISTATUS		m_pending_status;
+		boost::thread		m_prefetch_thread;
+
+		void fetch_page(SRowSet& row_set, enum MAPISTATUS& status, const uint16_t row_count);
+		void prefetch_page(const uint16_t row_count);
+		void start_prefetch();
+		void wait_prefetch();
+		void cancel_prefetch() throw(mapi_exception);
+		void free_rows(SRowSet& row_set);
+		void update_page_size(const SRowSet& row_set);
+		bool next_row() throw(mapi_exception);
+};
+
+} // namespace libmapipp
+
+#endif //!LIBMAPIPP__TABLE_H__
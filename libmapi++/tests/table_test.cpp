@@ -0,0 +1,108 @@
+/*
+   libmapi C++ Wrapper
+
+   Sample table test application
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <libmapi++/libmapi++.h>
+
+using namespace std;
+using namespace libmapipp;
+
+static vector<mapi_id_t> read_message_ids(table& contents_table)
+{
+	vector<mapi_id_t> message_ids;
+
+	for (table::iterator Iter = contents_table.begin(); Iter != contents_table.end(); ++Iter) {
+		message_ids.push_back(Iter->lpProps[0].value.d);
+	}
+
+	return message_ids;
+}
+
+int main()
+{
+	try {
+		session mapi_session;
+
+		mapi_session.login();
+
+		mapi_id_t inbox_id = mapi_session.get_message_store().get_default_folder(olFolderInbox);
+		folder inbox_folder(mapi_session.get_message_store(), inbox_id);
+
+		table contents_table(inbox_folder, table::contents_table);
+
+		SPropTagArray* property_tag_array = set_SPropTagArray(mapi_session.get_memory_ctx(), 0x2, PR_MID, PR_SUBJECT_UNICODE);
+		contents_table.set_columns(property_tag_array);
+		MAPIFreeBuffer(property_tag_array);
+
+		// Full iteration must return every row, whatever the page size ends up being
+		vector<mapi_id_t> message_ids = read_message_ids(contents_table);
+		cout << "Inbox rows: " << message_ids.size() << " (row count: " << contents_table.get_row_count()
+		     << ", page size: " << contents_table.get_page_size() << ")" << endl;
+		if (message_ids.size() != contents_table.get_row_count()) {
+			cout << "FAILED: iterated row count does not match table row count" << endl;
+			return 1;
+		}
+
+		// A second pass after seeking back to the beginning must return the same rows
+		contents_table.seek(BOOKMARK_BEGINNING, 0);
+		if (read_message_ids(contents_table) != message_ids) {
+			cout << "FAILED: rows differ after seek to beginning" << endl;
+			return 1;
+		}
+
+		if (message_ids.size() > 1) {
+			// Stop half way: the prefetched page must be given back on seek
+			contents_table.seek(BOOKMARK_BEGINNING, 0);
+			table::iterator Iter = contents_table.begin();
+			size_t half = message_ids.size() / 2;
+			for (size_t i = 1; i < half; ++i) {
+				++Iter;
+			}
+			uint32_t bookmark = contents_table.create_bookmark();
+			contents_table.seek(BOOKMARK_END, 0);
+			contents_table.seek_bookmark(bookmark, 0);
+			contents_table.free_bookmark(bookmark);
+
+			vector<mapi_id_t> tail = read_message_ids(contents_table);
+			if (!std::equal(tail.begin(), tail.end(), message_ids.begin() + half) || tail.size() != message_ids.size() - half) {
+				cout << "FAILED: rows differ after seeking to bookmark" << endl;
+				return 1;
+			}
+		}
+
+		cout << "table test passed" << endl;
+	}
+	catch (mapi_exception e)
+	{
+		cout << "MAPI Exception @ main: " <<  e.what() << endl;
+		return 1;
+	}
+	catch (std::runtime_error e)
+	{
+		cout << "std::runtime_error exception @ main: " << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -827,6 +827,360 @@ _PUBLIC_ enum MAPISTATUS FXGetBuffer(mapi_object_t *obj_source_context, uint16_t
 	return MAPI_E_SUCCESS;
 }
 
+/* Room taken by the FastTransferSourceGetBuffer replies of a
+   multiplexed request in the EcDoRpc response buffer: each reply
+   carries a 15 bytes header and a handle next to its buffer */
+#define	FXGETBUFFERS_RESPONSE_SIZE	0x7800
+#define	FXGETBUFFERS_REPLY_SIZE		(15 + sizeof (uint32_t))
+#define	FXGETBUFFERS_MIN_BUFFER_SIZE	0x400
+
+/**
+    Get the next buffer of several fast transfer contexts in a single
+    request
+
+    One FastTransferSourceGetBuffer ROP is sent for each source
+    context, so that contexts opened on different folders (e.g. with
+    ICSSyncConfigure) are served by the same EcDoRpc round trip. The
+    contexts must belong to the same session, and the buffers they
+    request must fit together in the response buffer: count times
+    bufferSize plus 19 bytes should stay below 0x7800.
+
+    Passing 0xBABE as bufferSize lets the server size the buffers from
+    the space left in its response: each context asks for at most an
+    even share of the response buffer, except the last one which may
+    take whatever the previous replies did not use.
+
+    \param mem_ctx the memory context to allocate the buffers on
+    \param count the number of source contexts
+    \param obj_source_contexts array of count source objects
+    \param bufferSize the size requested for each buffer (pass 0xBABE
+    to let the server fill its response buffer)
+    \param retvals array of count return values, one per context
+    \param transferStatus array of count transfer results
+    \param progressStepCount array of count approximate numbers of
+    steps completed
+    \param totalStepCount array of count approximate numbers of steps
+    \param blobs array of count parts of the transfers
+
+   \return MAPI_E_SUCCESS when the request went through, otherwise
+   MAPI error. The result of each context is stored in retvals.
+
+   \note Developers may also call GetLastError() to retrieve the last
+   MAPI error code. Possible MAPI error codes are:
+   - MAPI_E_NOT_INITIALIZED: MAPI subsystem has not been initialized
+   - MAPI_E_INVALID_PARAMETER: one of the function parameters is
+     invalid
+   - MAPI_E_CALL_FAILED: A network problem was encountered during the
+   transaction
+
+   \sa FXGetBuffer
+*/
+_PUBLIC_ enum MAPISTATUS FXGetBuffers(TALLOC_CTX *mem_ctx, uint32_t count, mapi_object_t **obj_source_contexts,
+				      uint16_t bufferSize, enum MAPISTATUS *retvals, enum TransferStatus *transferStatus,
+				      uint16_t *progressStepCount, uint16_t *totalStepCount, DATA_BLOB *blobs)
+{
+	struct mapi_request				*mapi_request;
+	struct mapi_response				*mapi_response;
+	struct EcDoRpc_MAPI_REQ				*mapi_req;
+	struct EcDoRpc_MAPI_REPL			*mapi_repl;
+	struct FastTransferSourceGetBuffer_repl		*reply;
+	struct mapi_session				*session;
+	NTSTATUS					status;
+	enum MAPISTATUS					retval;
+	uint32_t					size = 0;
+	TALLOC_CTX					*local_mem_ctx;
+	uint8_t 					logon_id = 0;
+	uint16_t					maximumBufferSize = 0;
+	uint32_t					i;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!count || count > 0xFF, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!obj_source_contexts || !retvals || !blobs, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!transferStatus || !progressStepCount || !totalStepCount, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!bufferSize, MAPI_E_INVALID_PARAMETER, NULL);
+
+	if (bufferSize == 0xBABE) {
+		maximumBufferSize = FXGETBUFFERS_RESPONSE_SIZE / count - FXGETBUFFERS_REPLY_SIZE;
+	}
+
+	session = mapi_object_get_session(obj_source_contexts[0]);
+	OPENCHANGE_RETVAL_IF(!session, MAPI_E_INVALID_PARAMETER, NULL);
+
+	local_mem_ctx = talloc_named(session, 0, "FXGetBuffers");
+	size = sizeof(uint16_t);
+
+	/* Fill one GetBuffer operation per source context */
+	mapi_req = talloc_zero_array(local_mem_ctx, struct EcDoRpc_MAPI_REQ, count);
+	mapi_request = talloc_zero(local_mem_ctx, struct mapi_request);
+	mapi_request->handles = talloc_array(local_mem_ctx, uint32_t, count);
+	for (i = 0; i < count; i++) {
+		OPENCHANGE_RETVAL_IF(mapi_object_get_session(obj_source_contexts[i]) != session,
+				     MAPI_E_INVALID_PARAMETER, local_mem_ctx);
+		retval = mapi_object_get_logon_id(obj_source_contexts[i], &logon_id);
+		OPENCHANGE_RETVAL_IF(retval, retval, local_mem_ctx);
+
+		mapi_req[i].opnum = op_MAPI_FastTransferSourceGetBuffer;
+		mapi_req[i].logon_id = logon_id;
+		mapi_req[i].handle_idx = i;
+		mapi_req[i].u.mapi_FastTransferSourceGetBuffer.BufferSize = bufferSize;
+		size += 3 + sizeof(uint16_t);
+		if (bufferSize == 0xBABE) {
+			if (i == count - 1) {
+				maximumBufferSize = FXGETBUFFERS_RESPONSE_SIZE - FXGETBUFFERS_REPLY_SIZE;
+			}
+			mapi_req[i].u.mapi_FastTransferSourceGetBuffer.MaximumBufferSize.MaximumBufferSize = maximumBufferSize;
+			size += sizeof(uint16_t);
+		}
+
+		mapi_request->handles[i] = mapi_object_get_handle(obj_source_contexts[i]);
+
+		retvals[i] = MAPI_E_CALL_FAILED;
+		blobs[i].data = NULL;
+		blobs[i].length = 0;
+	}
+
+	/* Fill the mapi_request structure */
+	mapi_request->mapi_len = size + count * sizeof (uint32_t);
+	mapi_request->length = (uint16_t)size;
+	mapi_request->mapi_req = mapi_req;
+
+	status = emsmdb_transaction_wrapper(session, local_mem_ctx, mapi_request, &mapi_response);
+	OPENCHANGE_RETVAL_IF(!NT_STATUS_IS_OK(status), MAPI_E_CALL_FAILED, local_mem_ctx);
+	OPENCHANGE_RETVAL_IF(!mapi_response->mapi_repl, MAPI_E_CALL_FAILED, local_mem_ctx);
+
+	/* Replies are matched with their context through the handle index */
+	for (mapi_repl = mapi_response->mapi_repl; mapi_repl->opnum; mapi_repl++) {
+		if (mapi_repl->opnum != op_MAPI_FastTransferSourceGetBuffer || mapi_repl->handle_idx >= count) {
+			continue;
+		}
+		i = mapi_repl->handle_idx;
+		retvals[i] = mapi_repl->error_code;
+		if (retvals[i] != MAPI_E_SUCCESS) {
+			continue;
+		}
+
+		reply = &mapi_repl->u.mapi_FastTransferSourceGetBuffer;
+		transferStatus[i] = reply->TransferStatus;
+		progressStepCount[i] = reply->InProgressCount;
+		totalStepCount[i] = reply->TotalStepCount;
+		blobs[i].length = reply->TransferBufferSize;
+		blobs[i].data = (uint8_t *)talloc_memdup(mem_ctx, reply->TransferBuffer.data, blobs[i].length);
+	}
+
+	talloc_free(mapi_response);
+	talloc_free(local_mem_ctx);
+
+	return MAPI_E_SUCCESS;
+}
+
+struct fxmultiplex_stream {
+	mapi_object_t			*obj_source_context;
+	struct fx_parser_context	*parser;
+	enum MAPISTATUS			retval;
+	bool				done;
+};
+
+struct fxmultiplex_context {
+	uint16_t			maxSize;
+	uint32_t			count;
+	uint32_t			next;
+	struct fxmultiplex_stream	*streams;
+};
+
+/**
+   \details Initialise a fast transfer multiplexer
+
+   A multiplexer downloads several fast transfer streams over one
+   session: each request carries one GetBuffer operation per pending
+   stream, and each returned buffer is handed to the parser of its
+   stream.
+
+   \param mem_ctx the memory context to allocate the multiplexer on
+   \param maxSize the size requested for each buffer (pass 0 to let
+   the server share its response buffer between the pending streams)
+
+   \return an allocated multiplexer on success, otherwise NULL
+ */
+_PUBLIC_ struct fxmultiplex_context *fxmultiplex_init(TALLOC_CTX *mem_ctx, uint16_t maxSize)
+{
+	struct fxmultiplex_context	*fxmux;
+
+	fxmux = talloc_zero(mem_ctx, struct fxmultiplex_context);
+	if (!fxmux) return NULL;
+
+	fxmux->maxSize = maxSize;
+
+	return fxmux;
+}
+
+/**
+   \details Add a fast transfer stream to a multiplexer
+
+   \param fxmux pointer to the multiplexer
+   \param obj_source_context the source object (from ICSSyncConfigure,
+   FXCopyTo, FXCopyProperties, FXCopyFolder or FXCopyMessages)
+   \param parser the parser the buffers of this stream are handed to
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error.
+ */
+_PUBLIC_ enum MAPISTATUS fxmultiplex_add(struct fxmultiplex_context *fxmux, mapi_object_t *obj_source_context,
+					 struct fx_parser_context *parser)
+{
+	struct fxmultiplex_stream	*stream;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!fxmux || !obj_source_context || !parser, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(fxmux->count && mapi_object_get_session(obj_source_context) !=
+			     mapi_object_get_session(fxmux->streams[0].obj_source_context),
+			     MAPI_E_INVALID_PARAMETER, NULL);
+
+	fxmux->streams = talloc_realloc(fxmux, fxmux->streams, struct fxmultiplex_stream, fxmux->count + 1);
+	OPENCHANGE_RETVAL_IF(!fxmux->streams, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+
+	stream = &fxmux->streams[fxmux->count];
+	stream->obj_source_context = obj_source_context;
+	stream->parser = parser;
+	stream->retval = MAPI_E_SUCCESS;
+	stream->done = false;
+	fxmux->count++;
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details Get the next buffer of the pending streams of a
+   multiplexer in a single request
+
+   When the pending streams cannot all be served by one request, they
+   are served in turn by the next ones. A stream is complete when the
+   server reports the end of its transfer, or on error.
+
+   \param fxmux pointer to the multiplexer
+   \param pending pointer to the number of streams still pending
+   after the request
+
+   \return MAPI_E_SUCCESS on success, otherwise the MAPI error of the
+   request or of the first stream which failed.
+ */
+_PUBLIC_ enum MAPISTATUS fxmultiplex_step(struct fxmultiplex_context *fxmux, uint32_t *pending)
+{
+	TALLOC_CTX			*mem_ctx;
+	struct fxmultiplex_stream	*stream;
+	mapi_object_t			**obj_source_contexts;
+	uint32_t			*indexes;
+	enum MAPISTATUS			*retvals;
+	enum TransferStatus		*transferStatus;
+	uint16_t			*progressStepCount;
+	uint16_t			*totalStepCount;
+	DATA_BLOB			*blobs;
+	enum MAPISTATUS			retval;
+	enum MAPISTATUS			first_error = MAPI_E_SUCCESS;
+	uint32_t			max_count, count, i, j;
+	uint16_t			bufferSize;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!fxmux || !pending, MAPI_E_INVALID_PARAMETER, NULL);
+
+	*pending = 0;
+	if (!fxmux->count) return MAPI_E_SUCCESS;
+
+	mem_ctx = talloc_named(fxmux, 0, "fxmultiplex_step");
+	obj_source_contexts = talloc_array(mem_ctx, mapi_object_t *, fxmux->count);
+	indexes = talloc_array(mem_ctx, uint32_t, fxmux->count);
+
+	/* Step 1. Pick the streams served by this request, in turn */
+	max_count = FXGETBUFFERS_RESPONSE_SIZE / (FXGETBUFFERS_MIN_BUFFER_SIZE + FXGETBUFFERS_REPLY_SIZE);
+	for (i = 0, count = 0; i < fxmux->count && count < max_count; i++) {
+		j = (fxmux->next + i) % fxmux->count;
+		if (fxmux->streams[j].done) continue;
+		obj_source_contexts[count] = fxmux->streams[j].obj_source_context;
+		indexes[count] = j;
+		count++;
+	}
+	if (!count) {
+		talloc_free(mem_ctx);
+		return MAPI_E_SUCCESS;
+	}
+	fxmux->next = (indexes[count - 1] + 1) % fxmux->count;
+
+	if (fxmux->maxSize) {
+		bufferSize = FXGETBUFFERS_RESPONSE_SIZE / count - FXGETBUFFERS_REPLY_SIZE;
+		if (fxmux->maxSize < bufferSize) {
+			bufferSize = fxmux->maxSize;
+		}
+	}
+	else {
+		bufferSize = 0xBABE;
+	}
+
+	/* Step 2. Retrieve one buffer per stream */
+	retvals = talloc_array(mem_ctx, enum MAPISTATUS, count);
+	transferStatus = talloc_array(mem_ctx, enum TransferStatus, count);
+	progressStepCount = talloc_array(mem_ctx, uint16_t, count);
+	totalStepCount = talloc_array(mem_ctx, uint16_t, count);
+	blobs = talloc_array(mem_ctx, DATA_BLOB, count);
+	retval = FXGetBuffers(mem_ctx, count, obj_source_contexts, bufferSize, retvals,
+			      transferStatus, progressStepCount, totalStepCount, blobs);
+	OPENCHANGE_RETVAL_IF(retval, retval, mem_ctx);
+
+	/* Step 3. Hand each buffer to the parser of its stream */
+	for (i = 0; i < count; i++) {
+		stream = &fxmux->streams[indexes[i]];
+		if (retvals[i] == MAPI_E_SUCCESS) {
+			retvals[i] = fxparser_parse(stream->parser, &blobs[i]);
+		}
+		if (retvals[i] == MAPI_E_SUCCESS && transferStatus[i] == TransferStatus_Error) {
+			retvals[i] = MAPI_E_CALL_FAILED;
+		}
+
+		if (retvals[i] != MAPI_E_SUCCESS) {
+			stream->retval = retvals[i];
+			stream->done = true;
+			if (first_error == MAPI_E_SUCCESS) {
+				first_error = retvals[i];
+			}
+		}
+		else if (transferStatus[i] != TransferStatus_Partial && transferStatus[i] != TransferStatus_NoRoom) {
+			stream->done = true;
+		}
+	}
+
+	for (i = 0; i < fxmux->count; i++) {
+		if (!fxmux->streams[i].done) {
+			(*pending)++;
+		}
+	}
+
+	talloc_free(mem_ctx);
+
+	OPENCHANGE_RETVAL_IF(first_error, first_error, NULL);
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details Download the streams of a multiplexer until they are
+   all complete
+
+   \param fxmux pointer to the multiplexer
+
+   \return MAPI_E_SUCCESS on success, otherwise the MAPI error of the
+   first request or stream which failed. The other streams are left
+   where they stopped and can be resumed with fxmultiplex_step.
+ */
+_PUBLIC_ enum MAPISTATUS fxmultiplex_run(struct fxmultiplex_context *fxmux)
+{
+	enum MAPISTATUS	retval;
+	uint32_t	pending;
+
+	do {
+		retval = fxmultiplex_step(fxmux, &pending);
+		OPENCHANGE_RETVAL_IF(retval, retval, NULL);
+	} while (pending);
+
+	return MAPI_E_SUCCESS;
+}
+
 /**
     Send data to a destination fast transfer object
 
@@ -104,7 +104,7 @@ _PUBLIC_ enum MAPISTATUS GetProps(mapi_object_t *obj,
 		if (retval == MAPI_E_SUCCESS) {
 			named = true;
 			SPropTagArray2 = talloc_zero(mem_ctx, struct SPropTagArray);
-			retval = GetIDsFromNames(obj, nameid->count, nameid->nameid, 0, &SPropTagArray2);
+			retval = mapi_nameid_cache_GetIDsFromNames(obj, nameid->count, nameid->nameid, SPropTagArray2);
 			OPENCHANGE_RETVAL_IF(retval, retval, mem_ctx);		
 			mapi_nameid_map_SPropTagArray(nameid, SPropTagArray, SPropTagArray2);
 			MAPIFreeBuffer(SPropTagArray2);
@@ -234,7 +234,7 @@ _PUBLIC_ enum MAPISTATUS SetProps(mapi_object_t *obj,
 		if (retval == MAPI_E_SUCCESS) {
 			named = true;
 			SPropTagArray = talloc_zero(mem_ctx, struct SPropTagArray);
-			retval = GetIDsFromNames(obj, nameid->count, nameid->nameid, 0, &SPropTagArray);
+			retval = mapi_nameid_cache_GetIDsFromNames(obj, nameid->count, nameid->nameid, SPropTagArray);
 			OPENCHANGE_RETVAL_IF(retval, retval, mem_ctx);
 			mapi_nameid_map_SPropValue(nameid, lpProps, PropCount, SPropTagArray);
 			MAPIFreeBuffer(SPropTagArray);
@@ -705,7 +705,7 @@ _PUBLIC_ enum MAPISTATUS SetPropertiesNoReplicate(mapi_object_t *obj,
 		if (retval == MAPI_E_SUCCESS) {
 			named = true;
 			SPropTagArray = talloc_zero(mem_ctx, struct SPropTagArray);
-			retval = GetIDsFromNames(obj, nameid->count, nameid->nameid, 0, &SPropTagArray);
+			retval = mapi_nameid_cache_GetIDsFromNames(obj, nameid->count, nameid->nameid, SPropTagArray);
 			OPENCHANGE_RETVAL_IF(retval, retval, mem_ctx);
 			mapi_nameid_map_SPropValue(nameid, lpProps, PropCount, SPropTagArray);
 			MAPIFreeBuffer(SPropTagArray);
@@ -410,6 +410,11 @@ _PUBLIC_ NTSTATUS emsmdb_transaction(struct emsmdb_context *emsmdb_ctx,
 	NTSTATUS		status;
 	struct EcDoRpc_MAPI_REQ	*multi_req;
 	uint8_t			i = 0;
+	uint32_t		j;
+	uint32_t		count;
+
+	/* requests carrying several operations are allocated as arrays */
+	count = talloc_array_length(req->mapi_req);
 
 start:
 	r.in.handle = r.out.handle = &emsmdb_ctx->handle;
@@ -424,16 +429,18 @@ start:
 
 	/* process cached data */
 	if (emsmdb_ctx->cache_count) {
-		multi_req = talloc_array(mem_ctx, struct EcDoRpc_MAPI_REQ, emsmdb_ctx->cache_count + 2);
+		multi_req = talloc_array(mem_ctx, struct EcDoRpc_MAPI_REQ, emsmdb_ctx->cache_count + count + 1);
 		for (i = 0; i < emsmdb_ctx->cache_count; i++) {
 			multi_req[i] = *emsmdb_ctx->cache_requests[i];
 		}
-		multi_req[i] = req->mapi_req[0];
+		for (j = 0; j < count; j++) {
+			multi_req[i + j] = req->mapi_req[j];
+		}
 		req->mapi_req = multi_req;
 	}
 
-	req->mapi_req = talloc_realloc(mem_ctx, req->mapi_req, struct EcDoRpc_MAPI_REQ, emsmdb_ctx->cache_count + 2);
-	req->mapi_req[i+1].opnum = 0;
+	req->mapi_req = talloc_realloc(mem_ctx, req->mapi_req, struct EcDoRpc_MAPI_REQ, emsmdb_ctx->cache_count + count + 1);
+	req->mapi_req[emsmdb_ctx->cache_count + count].opnum = 0;
 
 	r.in.mapi_request = req;
 	r.in.mapi_request->mapi_len += emsmdb_ctx->cache_size;
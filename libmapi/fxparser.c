@@ -612,6 +612,14 @@ _PUBLIC_ enum MAPISTATUS fxparser_parse(struct fx_parser_context *parser, DATA_B
 					case EndAttach:
 					case StartEmbed:
 					case EndEmbed:
+					case IncrSyncChg:
+					case IncrSyncChgPartial:
+					case IncrSyncDel:
+					case IncrSyncEnd:
+					case IncrSyncRead:
+					case IncrSyncStateBegin:
+					case IncrSyncStateEnd:
+					case IncrSyncMessage:
 						if (parser->op_marker) {
 							ms = parser->op_marker(parser->tag, parser->priv);
 						}
@@ -631,6 +639,15 @@ _PUBLIC_ enum MAPISTATUS fxparser_parse(struct fx_parser_context *parser, DATA_B
 						}
 						break;
 					}
+					case MetaTagIdsetGiven:
+					{
+						/* declared as PtypInteger32 but serialized as
+						   PtypBinary [MS-OXCFXICS] - 2.2.1.1.1 */
+						parser->lpProp.ulPropTag = (enum MAPITAGS) ((MetaTagIdsetGiven & 0xFFFF0000) | PT_BINARY);
+						parser->lpProp.dwAlignPad = 0;
+						parser->state = ParserState_HavePropTag;
+						break;
+					}
 					default:
 					{
 						/* standard property thing */
@@ -936,56 +936,91 @@ _PUBLIC_ bool IDSET_includes_guid_glob(const struct idset *idset, struct GUID *r
 	return false;
 }
 
-static void IDSET_ranges_remove_globcnt(struct idset *idset, uint64_t eid) {
-	struct globset_range *range, *new_range;
-	bool done = false;
-	uint64_t work_eid;
-
-	work_eid = exchange_globcnt(eid);
+/**
+  \details subtract a sorted array of globcnts from the ranges of an idset
 
-	range = idset->ranges;
-	while (!done && range) {
-		if (range->low == eid) {
-			if (range->high == eid) {
-				DLIST_REMOVE(idset->ranges, range);
-				idset->range_count--;
-				if (range->next == NULL && idset->ranges != NULL) {
-					idset->ranges->prev = range->prev;
-				}
-				talloc_free(range);
+  The ranges are walked once along with the array and the resulting
+  ranges are written back into the existing list elements, which are
+  only allocated or released when the number of ranges changes.
+*/
+static void IDSET_ranges_remove_globcnts(struct idset *idset, const uint64_t *globcnts, uint32_t count)
+{
+	struct globset_range	*range, *next_range;
+	uint64_t		*bounds;
+	uint64_t		low, high, current, removed;
+	uint32_t		i, j, bounds_count;
+
+	if (!idset->ranges || !count) return;
+
+	IDSET_reorder_ranges(idset);
+	IDSET_compact_ranges(idset);
+
+	/* a range is split at most once per removed id */
+	bounds = talloc_array(NULL, uint64_t, 2 * (idset->range_count + count));
+	bounds_count = 0;
+
+	j = 0;
+	for (range = idset->ranges; range; range = range->next) {
+		low = exchange_globcnt(range->low);
+		high = exchange_globcnt(range->high);
+		while (j < count && exchange_globcnt(globcnts[j]) < low) {
+			j++;
+		}
+		current = low;
+		for (; j < count && (removed = exchange_globcnt(globcnts[j])) <= high; j++) {
+			if (removed > current) {
+				bounds[bounds_count++] = current;
+				bounds[bounds_count++] = removed - 1;
 			}
-			else {
-				range->low = exchange_globcnt(work_eid + 1);
+			if (removed + 1 > current) {
+				current = removed + 1;
 			}
-			done = true;
 		}
-		else if (range->high == eid) {
-			range->high = exchange_globcnt(work_eid + 1);
-			done = true;
+		if (current <= high) {
+			bounds[bounds_count++] = current;
+			bounds[bounds_count++] = high;
 		}
-		else if ((exchange_globcnt(range->low) < work_eid) && (exchange_globcnt(range->high) > work_eid)) {
-			new_range = talloc_zero(idset, struct globset_range);
-			new_range->low = exchange_globcnt(work_eid + 1);
-			new_range->high = range->high;
-			range->high = exchange_globcnt(work_eid - 1);
-			new_range->next = range->next;
-			range->next = new_range;
-			if (new_range->next == NULL) {
-				idset->ranges->prev = new_range;
-			}
-			idset->range_count++;
-			done = true;
+	}
+
+	/* rewrite the list in place */
+	range = idset->ranges;
+	for (i = 0; i < bounds_count; i += 2) {
+		if (!range) {
+			range = talloc_zero(idset, struct globset_range);
+			DLIST_ADD_END(idset->ranges, range, void);
+		}
+		range->low = exchange_globcnt(bounds[i]);
+		range->high = exchange_globcnt(bounds[i+1]);
+		range = range->next;
+	}
+	if (range) {
+		if (range == idset->ranges) {
+			idset->ranges = NULL;
 		}
 		else {
-			range = range->next;
+			range->prev->next = NULL;
+			idset->ranges->prev = range->prev;
+		}
+		while (range) {
+			next_range = range->next;
+			talloc_free(range);
+			range = next_range;
 		}
 	}
+	idset->range_count = bounds_count / 2;
+
+	talloc_free(bounds);
 }
 
+/**
+  \details remove the ids of a rawidset from the ranges of an idset
+
+  Only the first replica of the rawidset is taken into account.
+*/
 _PUBLIC_ void IDSET_remove_rawidset(struct idset *idset, const struct rawidset *rawidset)
 {
 	struct idset *current_idset;
-	int i;
+	uint64_t *globcnts;
 
 	if (!idset || !rawidset) {
 		return;
@@ -1015,10 +1050,11 @@ _PUBLIC_ void IDSET_remove_rawidset(struct idset *idset, const struct rawidset *
 		}
 	}
 
-	if (current_idset) {
-		for (i = 0; i < rawidset->count; i++) {
-			IDSET_ranges_remove_globcnt(current_idset, rawidset->globcnts[i]);
-		}
+	if (current_idset && rawidset->count > 0) {
+		globcnts = talloc_memdup(NULL, rawidset->globcnts, sizeof(uint64_t) * rawidset->count);
+		qsort(globcnts, rawidset->count, sizeof(uint64_t), IDSET_globcnt_compar);
+		IDSET_ranges_remove_globcnts(current_idset, globcnts, rawidset->count);
+		talloc_free(globcnts);
 	}
 
 	check_idset(idset);
@@ -1136,6 +1172,20 @@ static struct rawidset *RAWIDSET_find_by_GUID(struct rawidset *rawidset, const s
 	return NULL;
 }
 
+/**
+  \details double the capacity of the globcnt array of a rawidset
+*/
+static void RAWIDSET_grow(struct rawidset *rawidset)
+{
+	if (rawidset->max_count < 256) {
+		rawidset->max_count = 256;
+	}
+	else {
+		rawidset->max_count *= 2;
+	}
+	rawidset->globcnts = talloc_realloc(rawidset, rawidset->globcnts, uint64_t, rawidset->max_count);
+}
+
 _PUBLIC_ void RAWIDSET_push_eid(struct rawidset *rawidset, uint64_t eid)
 {
 	struct rawidset *glob_idset, *last_glob_idset = NULL;
@@ -1160,8 +1210,7 @@ _PUBLIC_ void RAWIDSET_push_eid(struct rawidset *rawidset, uint64_t eid)
 	}
 
 	if (glob_idset->count + 1 > glob_idset->max_count) {
-		glob_idset->max_count += 256;
-		glob_idset->globcnts = talloc_realloc(glob_idset, glob_idset->globcnts, uint64_t, glob_idset->max_count);
+		RAWIDSET_grow(glob_idset);
 	}
 	glob_idset->globcnts[glob_idset->count] = eid_globcnt;
 	glob_idset->count++;
@@ -1201,8 +1250,7 @@ _PUBLIC_ void RAWIDSET_push_guid_glob(struct rawidset *rawidset, const struct GU
 	}
 
 	if (glob_idset->count + 1 > glob_idset->max_count) {
-		glob_idset->max_count += 256;
-		glob_idset->globcnts = talloc_realloc(glob_idset, glob_idset->globcnts, uint64_t, glob_idset->max_count);
+		RAWIDSET_grow(glob_idset);
 	}
 	glob_idset->globcnts[glob_idset->count] = globcnt;
 	glob_idset->count++;
@@ -484,6 +484,7 @@ enum MAPISTATUS		FXCopyMessages(mapi_object_t *, mapi_id_array_t *, uint8_t, uin
 enum MAPISTATUS		FXCopyTo(mapi_object_t *, uint8_t, uint32_t, uint8_t, struct SPropTagArray *, mapi_object_t *);
 enum MAPISTATUS		FXCopyProperties(mapi_object_t *, uint8_t, uint32_t, uint8_t, struct SPropTagArray *, mapi_object_t *);
 enum MAPISTATUS		FXGetBuffer(mapi_object_t *obj_source_context, uint16_t maxSize, enum TransferStatus *, uint16_t *, uint16_t *, DATA_BLOB *);
+enum MAPISTATUS		FXGetBuffers(TALLOC_CTX *, uint32_t, mapi_object_t **, uint16_t, enum MAPISTATUS *, enum TransferStatus *, uint16_t *, uint16_t *, DATA_BLOB *);
 enum MAPISTATUS		FXPutBuffer(mapi_object_t *obj_dest_context, DATA_BLOB *blob, uint16_t *usedSize);
 enum MAPISTATUS		ICSSyncConfigure(mapi_object_t *, enum SynchronizationType, uint8_t, uint16_t, uint32_t, DATA_BLOB, struct SPropTagArray*, mapi_object_t *);
 enum MAPISTATUS		ICSSyncUploadStateBegin(mapi_object_t *, enum StateProperty, uint32_t);
@@ -492,6 +493,12 @@ enum MAPISTATUS		ICSSyncUploadStateEnd(mapi_object_t *);
 enum MAPISTATUS		SetLocalReplicaMidsetDeleted(mapi_object_t *, const struct GUID, const uint8_t GlobalCountLow[6], const uint8_t GlobalCountHigh[6]);
 enum MAPISTATUS		ICSSyncOpenCollector(mapi_object_t *, bool, mapi_object_t *);
 enum MAPISTATUS		ICSSyncGetTransferState(mapi_object_t *, mapi_object_t *);
+struct fxmultiplex_context;
+struct fx_parser_context;
+struct fxmultiplex_context *fxmultiplex_init(TALLOC_CTX *, uint16_t);
+enum MAPISTATUS		fxmultiplex_add(struct fxmultiplex_context *, mapi_object_t *, struct fx_parser_context *);
+enum MAPISTATUS		fxmultiplex_step(struct fxmultiplex_context *, uint32_t *);
+enum MAPISTATUS		fxmultiplex_run(struct fxmultiplex_context *);
 
 /* The following public definitions come from libmapi/freebusy.c */
 enum MAPISTATUS		GetUserFreeBusyData(mapi_object_t *, const char *, struct SRow *);
@@ -99,6 +99,10 @@ void			mapi_object_set_handle(mapi_object_t *, mapi_handle_t);
 void			mapi_object_table_init(TALLOC_CTX *, mapi_object_t *);
 enum MAPISTATUS		mapi_object_bookmark_find(mapi_object_t *, uint32_t,struct SBinary_short *);
 
+/* The following private definitions come from libmapi/mapi_nameid.c */
+enum MAPISTATUS		mapi_nameid_cache_GetIDsFromNames(mapi_object_t *, uint16_t, struct MAPINAMEID *, struct SPropTagArray *);
+void			mapi_nameid_cache_release(struct mapi_session *, uint8_t);
+
 /* The following private definitions come from libmapi/property.c */
 enum MAPITAGS		*get_MAPITAGS_SRow(TALLOC_CTX *, struct SRow *, uint32_t *);
 uint32_t		MAPITAGS_delete_entries(enum MAPITAGS *, uint32_t, uint32_t, ...);
@@ -952,8 +952,8 @@ _PUBLIC_ enum MAPISTATUS mapi_nameid_GetIDsFromNames(struct mapi_nameid *mapi_na
 	OPENCHANGE_RETVAL_IF(!mapi_nameid, MAPI_E_INVALID_PARAMETER, NULL);
 	OPENCHANGE_RETVAL_IF(!SPropTagArray, MAPI_E_INVALID_PARAMETER, NULL);
 
-	retval = GetIDsFromNames(obj, mapi_nameid->count, mapi_nameid->nameid, 0,
-				 &SPropTagArray);
+	retval = mapi_nameid_cache_GetIDsFromNames(obj, mapi_nameid->count, mapi_nameid->nameid,
+						   SPropTagArray);
 	OPENCHANGE_RETVAL_IF(retval, GetLastError(), NULL);
 
 	for (i = 0; i < SPropTagArray->cValues; i++) {
@@ -964,6 +964,197 @@ _PUBLIC_ enum MAPISTATUS mapi_nameid_GetIDsFromNames(struct mapi_nameid *mapi_na
 	return MAPI_E_SUCCESS;
 }
 
+/**
+   \details Named property identifiers resolved on a store
+
+   Named property identifiers are assigned per store by the server
+   and never change for the lifetime of the logon. GetProps, SetProps
+   and the mapi_nameid helpers go through this cache rather than
+   issuing a GetIDsFromNames call for each operation. Entries are
+   only added for names the server knows about.
+ */
+struct mapi_nameid_cache_entry {
+	struct GUID		lpguid;
+	uint8_t			ulKind;
+	uint16_t		lid;
+	const char		*Name;
+	uint16_t		propID;
+};
+
+struct mapi_nameid_cache {
+	uint32_t			count;
+	struct mapi_nameid_cache_entry	*entries;
+};
+
+
+static struct mapi_nameid_cache_entry *mapi_nameid_cache_lookup(struct mapi_nameid_cache *cache,
+								 struct MAPINAMEID *nameid)
+{
+	struct mapi_nameid_cache_entry	*entry;
+	uint32_t			i;
+
+	for (i = 0; i < cache->count; i++) {
+		entry = &cache->entries[i];
+		if (entry->ulKind != nameid->ulKind) continue;
+		switch (nameid->ulKind) {
+		case MNID_ID:
+			if (entry->lid != nameid->kind.lid) continue;
+			break;
+		case MNID_STRING:
+			if (strcmp(entry->Name, nameid->kind.lpwstr.Name)) continue;
+			break;
+		default:
+			continue;
+		}
+		if (GUID_equal(&entry->lpguid, &nameid->lpguid)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+
+static void mapi_nameid_cache_add(struct mapi_nameid_cache *cache,
+				  struct MAPINAMEID *nameid,
+				  uint16_t propID)
+{
+	struct mapi_nameid_cache_entry	*entries;
+	struct mapi_nameid_cache_entry	*entry;
+
+	if (nameid->ulKind != MNID_ID && nameid->ulKind != MNID_STRING) return;
+	if (mapi_nameid_cache_lookup(cache, nameid)) return;
+
+	entries = talloc_realloc(cache, cache->entries, struct mapi_nameid_cache_entry, cache->count + 1);
+	if (!entries) return;
+	cache->entries = entries;
+
+	entry = &cache->entries[cache->count];
+	entry->lpguid = nameid->lpguid;
+	entry->ulKind = nameid->ulKind;
+	entry->lid = 0;
+	entry->Name = NULL;
+	if (nameid->ulKind == MNID_ID) {
+		entry->lid = nameid->kind.lid;
+	}
+	else {
+		entry->Name = talloc_strdup(cache->entries, nameid->kind.lpwstr.Name);
+		if (!entry->Name) return;
+	}
+	entry->propID = propID;
+	cache->count++;
+}
+
+
+/**
+   \details Resolve property names into property identifiers using the
+   named property cache of the store the object belongs to.
+
+   Names missing from the cache are resolved with a single
+   GetIDsFromNames call and added to the cache.
+
+   \param obj the object we are retrieving the identifiers from
+   \param count count of property names pointed to by nameid
+   \param nameid pointer to an array of property names
+   \param SPropTagArray pointer to the array of property tags to fill,
+   property types are set to PT_UNSPECIFIED
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error.
+
+   \sa GetIDsFromNames, mapi_nameid_cache_release
+ */
+enum MAPISTATUS mapi_nameid_cache_GetIDsFromNames(mapi_object_t *obj,
+						  uint16_t count,
+						  struct MAPINAMEID *nameid,
+						  struct SPropTagArray *SPropTagArray)
+{
+	enum MAPISTATUS			retval;
+	struct mapi_session		*session;
+	struct mapi_nameid_cache	*cache;
+	struct mapi_nameid_cache_entry	*entry;
+	struct MAPINAMEID		*misses;
+	struct SPropTagArray		*resolved;
+	uint16_t			*positions;
+	uint16_t			miss_count = 0;
+	uint16_t			propID;
+	uint8_t				logon_id;
+	uint32_t			i;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!obj, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!count, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!nameid, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!SPropTagArray, MAPI_E_INVALID_PARAMETER, NULL);
+
+	session = mapi_object_get_session(obj);
+	OPENCHANGE_RETVAL_IF(!session, MAPI_E_INVALID_PARAMETER, NULL);
+
+	retval = mapi_object_get_logon_id(obj, &logon_id);
+	OPENCHANGE_RETVAL_IF(retval, retval, NULL);
+
+	cache = session->nameid_cache[logon_id];
+	if (!cache) {
+		cache = talloc_zero((TALLOC_CTX *)session, struct mapi_nameid_cache);
+		OPENCHANGE_RETVAL_IF(!cache, MAPI_E_NOT_ENOUGH_RESOURCES, NULL);
+		session->nameid_cache[logon_id] = cache;
+	}
+
+	SPropTagArray->cValues = count;
+	SPropTagArray->aulPropTag = (enum MAPITAGS *) talloc_array((TALLOC_CTX *)SPropTagArray, uint32_t, count);
+	OPENCHANGE_RETVAL_IF(!SPropTagArray->aulPropTag, MAPI_E_NOT_ENOUGH_RESOURCES, NULL);
+
+	misses = talloc_array((TALLOC_CTX *)SPropTagArray, struct MAPINAMEID, count);
+	positions = talloc_array((TALLOC_CTX *)misses, uint16_t, count);
+	OPENCHANGE_RETVAL_IF(!misses || !positions, MAPI_E_NOT_ENOUGH_RESOURCES, misses);
+
+	for (i = 0; i < count; i++) {
+		entry = mapi_nameid_cache_lookup(cache, &nameid[i]);
+		if (entry) {
+			SPropTagArray->aulPropTag[i] = (enum MAPITAGS)(((int)entry->propID << 16) | PT_UNSPECIFIED);
+		}
+		else {
+			misses[miss_count] = nameid[i];
+			positions[miss_count] = i;
+			miss_count++;
+		}
+	}
+
+	/* Resolve all the misses in one round trip */
+	if (miss_count) {
+		resolved = talloc_zero((TALLOC_CTX *)misses, struct SPropTagArray);
+		retval = GetIDsFromNames(obj, miss_count, misses, 0, &resolved);
+		OPENCHANGE_RETVAL_IF(retval, retval, misses);
+		OPENCHANGE_RETVAL_IF(resolved->cValues != miss_count, MAPI_E_CALL_FAILED, misses);
+
+		for (i = 0; i < miss_count; i++) {
+			SPropTagArray->aulPropTag[positions[i]] = resolved->aulPropTag[i];
+			propID = (resolved->aulPropTag[i] & 0xFFFF0000) >> 16;
+			if (propID) {
+				mapi_nameid_cache_add(cache, &misses[i], propID);
+			}
+		}
+	}
+	talloc_free(misses);
+
+	return MAPI_E_SUCCESS;
+}
+
+
+/**
+   \details Drop the named property cache of a store
+
+   \param session pointer to the MAPI session
+   \param logon_id the logon identifier of the store
+ */
+void mapi_nameid_cache_release(struct mapi_session *session, uint8_t logon_id)
+{
+	if (!session) return;
+
+	talloc_free(session->nameid_cache[logon_id]);
+	session->nameid_cache[logon_id] = NULL;
+}
+
+
 _PUBLIC_ const char *get_namedid_name(uint32_t proptag)
 {
 	uint32_t idx;
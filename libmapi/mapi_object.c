@@ -105,6 +105,7 @@ _PUBLIC_ void mapi_object_release(mapi_object_t *obj)
 
 	if (obj->store == true && obj->session) {
 		obj->session->logon_ids[obj->logon_id] = 0;
+		mapi_nameid_cache_release(obj->session, obj->logon_id);
 	}
 
 	mapi_object_reset(obj);
@@ -26,6 +26,7 @@
 struct mapi_object;
 struct mapi_profile;
 struct mapi_notify_ctx;
+struct mapi_nameid_cache;
 
 enum PROVIDER_ID {
 	PROVIDER_ID_EMSMDB = 0x1,
@@ -52,6 +53,7 @@ struct mapi_session {
 	struct mapi_objects		*objects;
 	struct mapi_context		*mapi_ctx;
 	uint8_t				logon_ids[255];
+	struct mapi_nameid_cache	*nameid_cache[255];
 
 	struct mapi_session		*next;
 	struct mapi_session		*prev;
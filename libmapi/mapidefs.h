@@ -23,6 +23,7 @@
 
 #define PROP_TAG(type, id) (((id << 16))| (type))
 #define MV_FLAG			0x1000
+#define MV_INSTANCE		0x2000
 
 /* UNICODE flags */
 #define	MAPI_UNICODE		0x80000000
@@ -71,6 +71,7 @@ struct SPropValue *ocpf_get_SPropValue(uint32_t, uint32_t *);
 enum MAPISTATUS ocpf_OpenFolder(uint32_t, mapi_object_t *, mapi_object_t *);
 enum MAPISTATUS ocpf_set_Recipients(TALLOC_CTX *, uint32_t, mapi_object_t *);
 enum MAPISTATUS ocpf_clear_props (uint32_t context_id);
+enum MAPISTATUS ocpf_bulk_import(mapi_object_t *, uint32_t, const char **, uint32_t, enum MAPISTATUS *);
 
 /* The following public definitions come from libocpf/ocpf_server.c */
 enum MAPISTATUS ocpf_server_set_type(uint32_t, const char *);
@@ -94,6 +94,7 @@ struct ocpf_context
 	struct ocpf_nprop	nprop;
 	unsigned int		lineno;
 	int			result;
+	int			error_count;
 	/* ocpf */
 	const char		*type;
 	struct ocpf_var		*vars;
@@ -104,6 +105,9 @@ struct ocpf_context
 	struct SPropValue	*lpProps;
 	uint32_t		cValues;
 	uint64_t		folder;
+	/* write */
+	struct ocpf_oleguid	*custom_guids;
+	int			custom_guid_count;
 	/* context */
 	FILE			*fp;
 	const char		*filename;
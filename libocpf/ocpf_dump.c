@@ -55,7 +55,7 @@ _PUBLIC_ void ocpf_dump_type(uint32_t context_id)
 {
 	struct ocpf_context	*ctx;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "TYPE", OCPF_DUMP_TOPLEVEL);
@@ -76,7 +76,7 @@ _PUBLIC_ void ocpf_dump_folder(uint32_t context_id)
 {
 	struct ocpf_context	*ctx;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "FOLDER", OCPF_DUMP_TOPLEVEL);
@@ -100,7 +100,7 @@ _PUBLIC_ void ocpf_dump_recipients(uint32_t context_id)
 	struct SPropValue	*lpProps;
 	uint32_t		*RecipClass;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "RECIPIENTS", OCPF_DUMP_TOPLEVEL);
@@ -142,7 +142,7 @@ _PUBLIC_ void ocpf_dump_oleguid(uint32_t context_id)
 	struct ocpf_context	*ctx;
 	struct ocpf_oleguid	*element;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "OLEGUID", OCPF_DUMP_TOPLEVEL);
@@ -160,7 +160,7 @@ _PUBLIC_ void ocpf_dump_variable(uint32_t context_id)
 	struct ocpf_context	*ctx;
 	struct ocpf_var		*element;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "VARIABLE", OCPF_DUMP_TOPLEVEL);
@@ -178,7 +178,7 @@ _PUBLIC_ void ocpf_dump_property(uint32_t context_id)
 	struct ocpf_property	*element;
 	const char		*proptag;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "PROPERTIES", OCPF_DUMP_TOPLEVEL);
@@ -199,7 +199,7 @@ _PUBLIC_ void ocpf_dump_named_property(uint32_t context_id)
 	struct ocpf_context	*ctx;
 	struct ocpf_nproperty	*element;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return;
 
 	OCPF_DUMP_TITLE(indent, "NAMED PROPERTIES", OCPF_DUMP_TOPLEVEL);
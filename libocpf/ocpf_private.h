@@ -24,6 +24,10 @@
 #include <stdlib.h>
 #include <libocpf/ocpf.tab.h>
 
+#if defined(HAVE_PTHREADS)
+#include <pthread.h>
+#endif
+
 #ifndef HAVE_COMPARISON_FN_T
 #define HAVE_COMPARISON_FN_T
 typedef int (*comparison_fn_t)(const void *, const void *);
@@ -69,6 +73,9 @@ int ocpf_binary_add(struct ocpf_context *, const char *, struct Binary_r *);
 /* The following private definitions come from libocpf/ocpf_write.c */
 char *ocpf_write_unescape_string(TALLOC_CTX *, const char *);
 
+/* The following private definitions come from libocpf/ocpf_public.c */
+struct ocpf_context *ocpf_context_get(uint32_t);
+
 /* The following private definitions come from libocpf/ocpf_context.c */
 struct ocpf_context *ocpf_context_init(TALLOC_CTX *, const char *, uint8_t, uint32_t);
 struct ocpf_context *ocpf_context_add(struct ocpf *, const char *, uint32_t *, uint8_t, bool *);
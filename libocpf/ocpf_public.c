@@ -28,14 +28,23 @@
 #include "libocpf/ocpf.h"
 #include "libocpf/ocpf_api.h"
 
-int ocpf_yylex_init(void *);
 int ocpf_yylex_init_extra(struct ocpf_context *, void *);
 void ocpf_yyset_in(FILE *, void *);
 int ocpf_yylex_destroy(void *);
 int ocpf_yyparse(struct ocpf_context *, void *);
 
 struct ocpf	*ocpf;
-int		error_flag;
+
+/* Serializes changes to the global context list. Each context is
+   otherwise only touched by the thread working on it. */
+#if defined(HAVE_PTHREADS)
+static pthread_mutex_t	ocpf_lock = PTHREAD_MUTEX_INITIALIZER;
+#define	OCPF_LOCK()	pthread_mutex_lock(&ocpf_lock)
+#define	OCPF_UNLOCK()	pthread_mutex_unlock(&ocpf_lock)
+#else
+#define	OCPF_LOCK()
+#define	OCPF_UNLOCK()
+#endif
 
 
 /**
@@ -50,8 +59,12 @@ int		error_flag;
 _PUBLIC_ int ocpf_init(void)
 {
 	TALLOC_CTX	*mem_ctx;
-	
-	OCPF_RETVAL_IF(ocpf, NULL, OCPF_INITIALIZED, NULL);
+
+	OCPF_LOCK();
+	if (ocpf) {
+		OCPF_UNLOCK();
+		OCPF_RETVAL_IF(true, NULL, OCPF_INITIALIZED, NULL);
+	}
 
 	mem_ctx = talloc_named(NULL, 0, "ocpf");
 	ocpf = talloc_zero(mem_ctx, struct ocpf);
@@ -60,6 +73,7 @@ _PUBLIC_ int ocpf_init(void)
 	ocpf->context = talloc_zero(mem_ctx, struct ocpf_context);
 	ocpf->free_id = talloc_zero(mem_ctx, struct ocpf_freeid);
 	ocpf->last_id = 1;
+	OCPF_UNLOCK();
 
 	return OCPF_SUCCESS;
 }
@@ -76,15 +90,44 @@ _PUBLIC_ int ocpf_init(void)
  */
 _PUBLIC_ int ocpf_release(void)
 {
-	OCPF_RETVAL_IF(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL);	
+	OCPF_LOCK();
+	if (!ocpf || !ocpf->mem_ctx) {
+		OCPF_UNLOCK();
+		OCPF_RETVAL_IF(true, NULL, OCPF_NOT_INITIALIZED, NULL);
+	}
 
 	talloc_free(ocpf->mem_ctx);
 	ocpf = NULL;
+	OCPF_UNLOCK();
 
 	return OCPF_SUCCESS;
 }
 
 
+/**
+   \details Search a context given its identifier
+
+   The search is serialized with the creation and deletion of
+   contexts.
+
+   \param context_id the context identifier to use for search
+
+   \return pointer to valid ocpf context on success, otherwise NULL
+ */
+struct ocpf_context *ocpf_context_get(uint32_t context_id)
+{
+	struct ocpf_context	*ctx = NULL;
+
+	OCPF_LOCK();
+	if (ocpf && ocpf->mem_ctx) {
+		ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	}
+	OCPF_UNLOCK();
+
+	return ctx;
+}
+
+
 /**
    \details Create a new OCPF context
 
@@ -99,17 +142,24 @@ _PUBLIC_ int ocpf_new_context(const char *filename, uint32_t *context_id, uint8_
 	struct ocpf_context	*ctx;
 	bool			existing = false;
 
-	OCPF_RETVAL_IF(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL);
+	OCPF_LOCK();
+	if (!ocpf || !ocpf->mem_ctx) {
+		OCPF_UNLOCK();
+		OCPF_RETVAL_IF(true, NULL, OCPF_NOT_INITIALIZED, NULL);
+	}
 
 	ctx = ocpf_context_add(ocpf, filename, context_id, flags, &existing);
 	if (!ctx) {
+		OCPF_UNLOCK();
 		return OCPF_ERROR;
 	}
 
 	if (existing == false) {
 		DLIST_ADD_END(ocpf->context, ctx, struct ocpf_context *);
+		OCPF_UNLOCK();
 		return OCPF_SUCCESS;
 	} 
+	OCPF_UNLOCK();
 
 	return OCPF_E_EXIST;
 }
@@ -129,13 +179,21 @@ _PUBLIC_ int ocpf_del_context(uint32_t context_id)
 	struct ocpf_context	*ctx;
 
 	/* Sanity checks */
-	OCPF_RETVAL_IF(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL);
+	OCPF_LOCK();
+	if (!ocpf || !ocpf->mem_ctx) {
+		OCPF_UNLOCK();
+		OCPF_RETVAL_IF(true, NULL, OCPF_NOT_INITIALIZED, NULL);
+	}
 
 	/* Search the context */
 	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
-	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
+	if (!ctx) {
+		OCPF_UNLOCK();
+		OCPF_RETVAL_IF(true, NULL, OCPF_INVALID_CONTEXT, NULL);
+	}
 
 	ret = ocpf_context_delete(ocpf, ctx);
+	OCPF_UNLOCK();
 	if (ret == -1) return OCPF_ERROR;
 
 	return OCPF_SUCCESS;
@@ -164,11 +222,13 @@ _PUBLIC_ int ocpf_parse(uint32_t context_id)
 	OCPF_RETVAL_IF(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL);
 
 	/* Step 1. Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 
-	ret = ocpf_yylex_init(&scanner);
+	/* Scanner and parser state live in scanner and ctx only, so
+	   different contexts can be parsed concurrently */
 	ret = ocpf_yylex_init_extra(ctx, &scanner);
+	OCPF_RETVAL_IF(ret, ctx, OCPF_FATAL_ERROR, NULL);
 	ocpf_yyset_in(ctx->fp, scanner);
 	ret = ocpf_yyparse(ctx, scanner);
 	ocpf_yylex_destroy(scanner);
@@ -267,7 +327,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_set_SPropValue(TALLOC_CTX *mem_ctx,
 	MAPI_RETVAL_IF(!obj_folder, MAPI_E_INVALID_PARAMETER, NULL);
 	
 	/* Step 0. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 
 	if (!mem_ctx) {
@@ -362,7 +422,7 @@ enum MAPISTATUS ocpf_clear_props (uint32_t context_id)
 	MAPI_RETVAL_IF(!ocpf->mem_ctx, MAPI_E_NOT_INITIALIZED, NULL);
 
 	/* Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	MAPI_RETVAL_IF(!ctx, MAPI_E_NOT_FOUND, NULL);
 
 	if (ctx->props) {
@@ -395,7 +455,7 @@ _PUBLIC_ struct SPropValue *ocpf_get_SPropValue(uint32_t context_id, uint32_t *c
 	OCPF_RETVAL_TYPE(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL, NULL);
 
 	/* Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_TYPE(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL, NULL);
 
 	OCPF_RETVAL_TYPE(!ctx->lpProps || !ctx->cValues, ctx, OCPF_INVALID_PROPARRAY, NULL, NULL);
@@ -495,7 +555,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_OpenFolder(uint32_t context_id,
 	MAPI_RETVAL_IF(!obj_store, MAPI_E_INVALID_PARAMETER, NULL);
 
 	/* Step 1. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	MAPI_RETVAL_IF(!ctx, MAPI_E_INVALID_PARAMETER, NULL);
 	MAPI_RETVAL_IF(!ctx->folder, MAPI_E_NOT_FOUND, NULL);
 
@@ -612,7 +672,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_set_Recipients(TALLOC_CTX *mem_ctx,
 	MAPI_RETVAL_IF(!obj_message, MAPI_E_INVALID_PARAMETER, NULL);
 
 	/* Step 1. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	MAPI_RETVAL_IF(!ctx, MAPI_E_INVALID_PARAMETER, NULL);
 
 	MAPI_RETVAL_IF(!ctx->recipients->cRows, MAPI_E_NOT_FOUND, NULL);
@@ -701,7 +761,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_get_recipients(TALLOC_CTX *mem_ctx,
 	MAPI_RETVAL_IF(!SRowSet, MAPI_E_INVALID_PARAMETER, NULL);
 
 	/* Step 1. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	MAPI_RETVAL_IF(!ctx, MAPI_E_INVALID_PARAMETER, NULL);
 	MAPI_RETVAL_IF(!ctx->recipients->cRows, MAPI_E_NOT_FOUND, NULL);
 
@@ -709,3 +769,197 @@ _PUBLIC_ enum MAPISTATUS ocpf_get_recipients(TALLOC_CTX *mem_ctx,
 
 	return MAPI_E_SUCCESS;
 }
+
+
+/**
+   \details Import a single OCPF file: parse it in a new context and
+   create the message it describes in the folder it references.
+ */
+static enum MAPISTATUS ocpf_import_file(mapi_object_t *obj_store,
+					const char *filename)
+{
+	enum MAPISTATUS		retval;
+	TALLOC_CTX		*mem_ctx;
+	mapi_object_t		obj_folder;
+	mapi_object_t		obj_message;
+	struct SPropValue	*lpProps;
+	uint32_t		cValues = 0;
+	uint32_t		context_id;
+	int			ret;
+
+	ret = ocpf_new_context(filename, &context_id, OCPF_FLAGS_READ);
+	if (ret == OCPF_E_EXIST) {
+		/* the same file is already being processed */
+		ocpf_del_context(context_id);
+		return MAPI_E_COLLISION;
+	}
+	MAPI_RETVAL_IF(ret != OCPF_SUCCESS, MAPI_E_NOT_FOUND, NULL);
+
+	if (ocpf_parse(context_id)) {
+		ocpf_del_context(context_id);
+		return MAPI_E_CORRUPT_DATA;
+	}
+
+	mem_ctx = talloc_named(NULL, 0, "ocpf_import_file");
+	mapi_object_init(&obj_folder);
+	mapi_object_init(&obj_message);
+
+	retval = ocpf_OpenFolder(context_id, obj_store, &obj_folder);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	retval = CreateMessage(&obj_folder, &obj_message);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	retval = ocpf_set_Recipients(mem_ctx, context_id, &obj_message);
+	if (retval != MAPI_E_SUCCESS && retval != MAPI_E_NOT_FOUND) goto end;
+
+	retval = ocpf_set_SPropValue(mem_ctx, context_id, &obj_folder, &obj_message);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	lpProps = ocpf_get_SPropValue(context_id, &cValues);
+	if (lpProps) {
+		retval = SetProps(&obj_message, 0, lpProps, cValues);
+		if (retval != MAPI_E_SUCCESS) goto end;
+	}
+
+	retval = SaveChangesMessage(&obj_folder, &obj_message, KeepOpenReadOnly);
+
+end:
+	mapi_object_release(&obj_message);
+	mapi_object_release(&obj_folder);
+	talloc_free(mem_ctx);
+	ocpf_del_context(context_id);
+
+	return retval;
+}
+
+struct ocpf_bulk_import {
+	const char		**filenames;
+	uint32_t		file_count;
+	uint32_t		next;
+	enum MAPISTATUS		*results;
+#if defined(HAVE_PTHREADS)
+	pthread_mutex_t		lock;
+#endif
+};
+
+struct ocpf_bulk_worker {
+	struct ocpf_bulk_import	*import;
+	mapi_object_t		*obj_store;
+};
+
+static void *ocpf_bulk_import_worker(void *data)
+{
+	struct ocpf_bulk_worker	*worker = (struct ocpf_bulk_worker *) data;
+	struct ocpf_bulk_import	*import = worker->import;
+	uint32_t		i;
+
+	for (;;) {
+#if defined(HAVE_PTHREADS)
+		pthread_mutex_lock(&import->lock);
+#endif
+		i = import->next++;
+#if defined(HAVE_PTHREADS)
+		pthread_mutex_unlock(&import->lock);
+#endif
+		if (i >= import->file_count) break;
+
+		import->results[i] = ocpf_import_file(worker->obj_store, import->filenames[i]);
+	}
+
+	return NULL;
+}
+
+
+/**
+   \details Import a set of OCPF files in parallel
+
+   Files are spread over the given message stores, with one thread
+   per store: each thread takes the next pending file, parses it in
+   its own context and creates the message it describes.
+
+   Every store must be opened on a session of its own, and these
+   sessions must not be used by the caller until the function
+   returns. ocpf_init() must have been called first.
+
+   \param obj_stores array of opened message stores
+   \param store_count the number of stores in obj_stores
+   \param filenames the OCPF files to import
+   \param file_count the number of files in filenames
+   \param results array of file_count elements receiving the outcome
+   of each import
+
+   \return MAPI_E_SUCCESS if every file was imported, otherwise the
+   error of the first file which failed
+
+   \sa ocpf_init
+ */
+_PUBLIC_ enum MAPISTATUS ocpf_bulk_import(mapi_object_t *obj_stores,
+					  uint32_t store_count,
+					  const char **filenames,
+					  uint32_t file_count,
+					  enum MAPISTATUS *results)
+{
+	TALLOC_CTX		*mem_ctx;
+	struct ocpf_bulk_import	import;
+	struct ocpf_bulk_worker	*workers;
+	uint32_t		i;
+#if defined(HAVE_PTHREADS)
+	pthread_t		*threads;
+	uint32_t		started = 0;
+#endif
+
+	/* Sanity checks */
+	MAPI_RETVAL_IF(!ocpf, MAPI_E_NOT_INITIALIZED, NULL);
+	MAPI_RETVAL_IF(!obj_stores || !store_count, MAPI_E_INVALID_PARAMETER, NULL);
+	MAPI_RETVAL_IF(!filenames || !results, MAPI_E_INVALID_PARAMETER, NULL);
+
+	if (store_count > file_count) {
+		store_count = file_count;
+	}
+
+	mem_ctx = talloc_named(NULL, 0, "ocpf_bulk_import");
+
+	import.filenames = filenames;
+	import.file_count = file_count;
+	import.next = 0;
+	import.results = results;
+
+	workers = talloc_array(mem_ctx, struct ocpf_bulk_worker, store_count);
+	for (i = 0; i < store_count; i++) {
+		workers[i].import = &import;
+		workers[i].obj_store = &obj_stores[i];
+	}
+
+#if defined(HAVE_PTHREADS)
+	pthread_mutex_init(&import.lock, NULL);
+
+	/* The calling thread takes the first store */
+	threads = talloc_array(mem_ctx, pthread_t, store_count);
+	for (i = 1; i < store_count; i++) {
+		if (pthread_create(&threads[started], NULL, ocpf_bulk_import_worker, &workers[i]) == 0) {
+			started++;
+		}
+	}
+	if (store_count) {
+		ocpf_bulk_import_worker(&workers[0]);
+	}
+	for (i = 0; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&import.lock);
+#else
+	if (store_count) {
+		ocpf_bulk_import_worker(&workers[0]);
+	}
+#endif
+
+	talloc_free(mem_ctx);
+
+	for (i = 0; i < file_count; i++) {
+		MAPI_RETVAL_IF(results[i] != MAPI_E_SUCCESS, results[i], NULL);
+	}
+
+	return MAPI_E_SUCCESS;
+}
@@ -45,7 +45,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_server_set_type(uint32_t context_id,
 	MAPI_RETVAL_IF(!ocpf, MAPI_E_NOT_INITIALIZED, NULL);
 
 	/* Step 1. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 
 	return ocpf_type_add(ctx, type);
@@ -66,7 +66,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_server_set_folderID(uint32_t context_id,
 {
 	struct ocpf_context	*ctx;
 
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	if (!ctx) return MAPI_E_INVALID_PARAMETER;
 
 	ctx->folder = folderID;
@@ -104,7 +104,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_server_set_SPropValue(TALLOC_CTX *mem_ctx,
 	MAPI_RETVAL_IF(!ocpf, MAPI_E_NOT_INITIALIZED, NULL);
 
 	/* Step 1. Search for the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 
 	/* Step 2. Allocate SPropValue */
@@ -165,7 +165,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_server_add_SPropValue(uint32_t context_id,
 	MAPI_RETVAL_IF(!lpProps, MAPI_E_INVALID_PARAMETER, NULL);
 
 	/* Step 1. Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 
 	if (ctx->props && ctx->props->next) {
@@ -219,7 +219,7 @@ _PUBLIC_ enum MAPISTATUS ocpf_server_sync(uint32_t context_id)
 	MAPI_RETVAL_IF(!ocpf, MAPI_E_NOT_INITIALIZED, NULL);
 
 	/* Step 1. Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);	
 
 	if (ctx->flags == OCPF_FLAGS_CREATE) {
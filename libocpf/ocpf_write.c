@@ -59,36 +59,30 @@ static const struct ocpf_guid ocpf_guid[] = {
 static char *ocpf_write_get_guid_name(struct ocpf_context *ctx, const char *oleguid)
 {
 	uint32_t			i;
-	static int			idx = 0;
-	static struct ocpf_oleguid	*guid = NULL;
 	struct ocpf_oleguid		*element;
-	char				*name;
 
 	if (!oleguid) return NULL;
 
-	if (!guid) {
-		guid = talloc_zero(ctx, struct ocpf_oleguid);
-	}
-
 	for (i = 0; ocpf_guid[i].oleguid; i++) {
 		if (!strcmp(oleguid, ocpf_guid[i].oleguid)) {
 			return ocpf_guid[i].name;
 		}
 	}
 
-	for (element = guid; element->next; element = element->next) {
+	/* Custom GUIDs are numbered per context */
+	for (element = ctx->custom_guids; element; element = element->next) {
 		if (!strcmp(oleguid, element->guid)) {
 			return (char *)element->name;
 		}
 	}
 
-	element->name = talloc_asprintf(ctx, "PSETID_Custom_%d", idx);
-	element->guid = talloc_strdup(ctx, oleguid);
-	DLIST_ADD(guid, element);
-	name = talloc_strdup(ctx, element->name);
-	idx++;
+	element = talloc_zero(ctx, struct ocpf_oleguid);
+	element->name = talloc_asprintf(element, "PSETID_Custom_%d", ctx->custom_guid_count);
+	element->guid = talloc_strdup(element, oleguid);
+	DLIST_ADD_END(ctx->custom_guids, element, struct ocpf_oleguid *);
+	ctx->custom_guid_count++;
 
-	return name;
+	return (char *)element->name;
 }
 
 struct ocpf_proptype {
@@ -152,14 +146,14 @@ static char *ocpf_write_systime(struct ocpf_context *ctx, const struct FILETIME
 	char		tempTime[60];
 	NTTIME		nt;
 	time_t		t;
-	struct tm	*tm;
+	struct tm	tm;
 
 	nt = ft->dwHighDateTime;
 	nt = (nt << 32) | ft->dwLowDateTime;
 	t = nt_time_to_unix(nt);
-	tm = localtime(&t);
+	localtime_r(&t, &tm);
 
-	strftime(tempTime, sizeof(tempTime)-1, "T%Y-%m-%d %H:%M:%S\n", tm);
+	strftime(tempTime, sizeof(tempTime)-1, "T%Y-%m-%d %H:%M:%S\n", &tm);
 	line = talloc_strdup(ctx, tempTime);
 
 	return line;
@@ -506,7 +500,7 @@ _PUBLIC_ int ocpf_write_init(uint32_t context_id,
 	OCPF_RETVAL_IF(!ocpf || !ocpf->mem_ctx, NULL, OCPF_NOT_INITIALIZED, NULL);
 
 	/* Search the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);	
 
 	ctx->folder = folder_id;
@@ -555,7 +549,7 @@ _PUBLIC_ int ocpf_write_auto(uint32_t context_id,
 	OCPF_RETVAL_IF(!mapi_lpProps, NULL, OCPF_INVALID_PROPARRAY, NULL);
 	
 	/* Find the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 	OCPF_RETVAL_IF(!ctx->filename, ctx, OCPF_WRITE_NOT_INITIALIZED, NULL);
 
@@ -645,7 +639,7 @@ _PUBLIC_ int ocpf_write_commit(uint32_t context_id)
 	char			*definition = NULL;
 
 	/* Find the context */
-	ctx = ocpf_context_search_by_context_id(ocpf->context, context_id);
+	ctx = ocpf_context_get(context_id);
 	OCPF_RETVAL_IF(!ctx, NULL, OCPF_INVALID_CONTEXT, NULL);
 	OCPF_RETVAL_IF(!ctx->filename, ctx, OCPF_WRITE_NOT_INITIALIZED, NULL);
 	OCPF_RETVAL_IF(ctx->flags == OCPF_FLAGS_READ, ctx, OCPF_WRITE_NOT_INITIALIZED, NULL);
@@ -129,12 +129,19 @@ struct mapi_handles_context {
 	struct mapi_handles    	*handles;
 };
 
+enum openchangedb_table_row_status {
+	OPENCHANGEDB_TABLE_ROW_UNKNOWN	= 0x0,
+	OPENCHANGEDB_TABLE_ROW_MATCH	= 0x1,
+	OPENCHANGEDB_TABLE_ROW_NO_MATCH	= 0x2
+};
+
 struct openchangedb_table {
 	uint64_t			folderID;
 	uint8_t				table_type;
 	struct SSortOrderSet		*lpSortCriteria;
 	struct mapi_SRestriction	*restrictions;
 	struct ldb_result		*res;
+	uint8_t				*row_status;	/* live-filtered rows, enum openchangedb_table_row_status */
 };
 
 enum openchangedb_message_status {
@@ -233,6 +240,8 @@ enum MAPISTATUS openchangedb_get_distinguishedName(TALLOC_CTX *, struct ldb_cont
 enum MAPISTATUS openchangedb_get_mailboxDN(TALLOC_CTX *, struct ldb_context *, uint64_t, char **);
 enum MAPISTATUS	openchangedb_get_MailboxGuid(struct ldb_context *, const char *, struct GUID *);
 enum MAPISTATUS	openchangedb_get_MailboxReplica(struct ldb_context *, const char *, uint16_t *, struct GUID *);
+enum MAPISTATUS	openchangedb_get_ProvisioningFingerprint(struct ldb_context *, const char *, uint64_t *);
+enum MAPISTATUS	openchangedb_set_ProvisioningFingerprint(struct ldb_context *, const char *, uint64_t);
 enum MAPISTATUS openchangedb_get_PublicFolderReplica(struct ldb_context *, uint16_t *, struct GUID *);
 enum MAPISTATUS openchangedb_get_parent_fid(struct ldb_context *, uint64_t, uint64_t *, bool);
 enum MAPISTATUS openchangedb_get_MAPIStoreURIs(struct ldb_context *, const char *, TALLOC_CTX *, struct StringArrayW_r **);
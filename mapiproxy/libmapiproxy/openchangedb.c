@@ -307,6 +307,95 @@ _PUBLIC_ enum MAPISTATUS openchangedb_get_MailboxReplica(struct ldb_context *ldb
 	return MAPI_E_SUCCESS;
 }
 
+/**
+   \details Retrieve the provisioning fingerprint stored on the mailbox
+   of given recipient
+
+   The fingerprint summarizes the mapistore contexts the mailbox was
+   last provisioned against, see emsmdbp_mailbox_provision().
+
+   \param ldb_ctx pointer to the OpenChange LDB context
+   \param recipient the mailbox username
+   \param fingerprint pointer to the fingerprint the function returns
+
+   \return MAPI_E_SUCCESS on success, MAPI_E_NOT_FOUND if the mailbox
+   does not exist or was never fingerprinted, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS openchangedb_get_ProvisioningFingerprint(struct ldb_context *ldb_ctx,
+								  const char *recipient,
+								  uint64_t *fingerprint)
+{
+	TALLOC_CTX			*mem_ctx;
+	struct ldb_result		*res = NULL;
+	const char * const		attrs[] = { "ProvisioningFingerprint", NULL };
+	int				ret;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!ldb_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!recipient, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!fingerprint, MAPI_E_INVALID_PARAMETER, NULL);
+
+	mem_ctx = talloc_named(NULL, 0, "get_ProvisioningFingerprint");
+
+	/* Step 1. Search Mailbox DN */
+	ret = ldb_search(ldb_ctx, mem_ctx, &res, ldb_get_default_basedn(ldb_ctx),
+			 LDB_SCOPE_SUBTREE, attrs, "CN=%s", recipient);
+	OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS || !res->count, MAPI_E_NOT_FOUND, mem_ctx);
+
+	/* Step 2. Retrieve ProvisioningFingerprint attribute's value */
+	OPENCHANGE_RETVAL_IF(!ldb_msg_find_element(res->msgs[0], "ProvisioningFingerprint"), MAPI_E_NOT_FOUND, mem_ctx);
+	*fingerprint = ldb_msg_find_attr_as_uint64(res->msgs[0], "ProvisioningFingerprint", 0);
+
+	talloc_free(mem_ctx);
+
+	return MAPI_E_SUCCESS;
+}
+
+
+/**
+   \details Store the provisioning fingerprint on the mailbox of given
+   recipient
+
+   \param ldb_ctx pointer to the OpenChange LDB context
+   \param recipient the mailbox username
+   \param fingerprint the fingerprint to store
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS openchangedb_set_ProvisioningFingerprint(struct ldb_context *ldb_ctx,
+								  const char *recipient,
+								  uint64_t fingerprint)
+{
+	TALLOC_CTX			*mem_ctx;
+	struct ldb_result		*res = NULL;
+	struct ldb_message		*msg;
+	const char * const		attrs[] = { "distinguishedName", NULL };
+	int				ret;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!ldb_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!recipient, MAPI_E_INVALID_PARAMETER, NULL);
+
+	mem_ctx = talloc_named(NULL, 0, "set_ProvisioningFingerprint");
+
+	/* Step 1. Search Mailbox DN */
+	ret = ldb_search(ldb_ctx, mem_ctx, &res, ldb_get_default_basedn(ldb_ctx),
+			 LDB_SCOPE_SUBTREE, attrs, "CN=%s", recipient);
+	OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS || !res->count, MAPI_E_NOT_FOUND, mem_ctx);
+
+	/* Step 2. Replace the ProvisioningFingerprint attribute */
+	msg = ldb_msg_new(mem_ctx);
+	msg->dn = ldb_dn_copy(msg, res->msgs[0]->dn);
+	ldb_msg_add_fmt(msg, "ProvisioningFingerprint", "%"PRIu64, fingerprint);
+	msg->elements[0].flags = LDB_FLAG_MOD_REPLACE;
+	ret = ldb_modify(ldb_ctx, msg);
+	OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS, MAPI_E_NO_SUPPORT, mem_ctx);
+
+	talloc_free(mem_ctx);
+
+	return MAPI_E_SUCCESS;
+}
+
 /**
    \details Retrieve the public folder replica identifier and GUID
    from the openchange dispatcher database
@@ -10,586 +10,607 @@ struct pidtags {
 	const char	*pidtag;
 };
 
+/* sorted by property tag */
 static struct pidtags pidtags[] = {
-	{ PidTagAccess,                                                       "PidTagAccess" },
-	{ PidTagAccessControlListData,                                        "PidTagAccessControlListData" },
-	{ PidTagAccessLevel,                                                  "PidTagAccessLevel" },
-	{ PidTagAccount,                                                      "PidTagAccount" },
-	{ PidTagAdditionalRenEntryIds,                                        "PidTagAdditionalRenEntryIds" },
-	{ PidTagAdditionalRenEntryIdsEx,                                      "PidTagAdditionalRenEntryIdsEx" },
-	{ PidTagAddressBookAuthorizedSenders,                                 "PidTagAddressBookAuthorizedSenders" },
-	{ PidTagAddressBookContainerId,                                       "PidTagAddressBookContainerId" },
-	{ PidTagAddressBookDeliveryContentLength,                             "PidTagAddressBookDeliveryContentLength" },
-	{ PidTagAddressBookDisplayNamePrintable,                              "PidTagAddressBookDisplayNamePrintable" },
-	{ PidTagAddressBookDisplayTypeExtended,                               "PidTagAddressBookDisplayTypeExtended" },
-	{ PidTagAddressBookDistributionListExternalMemberCount,               "PidTagAddressBookDistributionListExternalMemberCount" },
-	{ PidTagAddressBookDistributionListMemberCount,                       "PidTagAddressBookDistributionListMemberCount" },
-	{ PidTagAddressBookDistributionListMemberSubmitAccepted,              "PidTagAddressBookDistributionListMemberSubmitAccepted" },
-	{ PidTagAddressBookDistributionListMemberSubmitRejected,              "PidTagAddressBookDistributionListMemberSubmitRejected" },
-	{ PidTagAddressBookDistributionListRejectMessagesFromDLMembers,       "PidTagAddressBookDistributionListRejectMessagesFromDLMembers" },
-	{ PidTagAddressBookEntryId,                                           "PidTagAddressBookEntryId" },
-	{ PidTagAddressBookExtensionAttribute1,                               "PidTagAddressBookExtensionAttribute1" },
-	{ PidTagAddressBookExtensionAttribute10,                              "PidTagAddressBookExtensionAttribute10" },
-	{ PidTagAddressBookExtensionAttribute11,                              "PidTagAddressBookExtensionAttribute11" },
-	{ PidTagAddressBookExtensionAttribute12,                              "PidTagAddressBookExtensionAttribute12" },
-	{ PidTagAddressBookExtensionAttribute13,                              "PidTagAddressBookExtensionAttribute13" },
-	{ PidTagAddressBookExtensionAttribute14,                              "PidTagAddressBookExtensionAttribute14" },
-	{ PidTagAddressBookExtensionAttribute15,                              "PidTagAddressBookExtensionAttribute15" },
-	{ PidTagAddressBookExtensionAttribute2,                               "PidTagAddressBookExtensionAttribute2" },
-	{ PidTagAddressBookExtensionAttribute3,                               "PidTagAddressBookExtensionAttribute3" },
-	{ PidTagAddressBookExtensionAttribute4,                               "PidTagAddressBookExtensionAttribute4" },
-	{ PidTagAddressBookExtensionAttribute5,                               "PidTagAddressBookExtensionAttribute5" },
-	{ PidTagAddressBookExtensionAttribute6,                               "PidTagAddressBookExtensionAttribute6" },
-	{ PidTagAddressBookExtensionAttribute7,                               "PidTagAddressBookExtensionAttribute7" },
-	{ PidTagAddressBookExtensionAttribute8,                               "PidTagAddressBookExtensionAttribute8" },
-	{ PidTagAddressBookExtensionAttribute9,                               "PidTagAddressBookExtensionAttribute9" },
-	{ PidTagAddressBookFolderPathname,                                    "PidTagAddressBookFolderPathname" },
-	{ PidTagAddressBookHierarchicalChildDepartments,                      "PidTagAddressBookHierarchicalChildDepartments" },
-	{ PidTagAddressBookHierarchicalDepartmentMembers,                     "PidTagAddressBookHierarchicalDepartmentMembers" },
-	{ PidTagAddressBookHierarchicalIsHierarchicalGroup,                   "PidTagAddressBookHierarchicalIsHierarchicalGroup" },
-	{ PidTagAddressBookHierarchicalParentDepartment,                      "PidTagAddressBookHierarchicalParentDepartment" },
-	{ PidTagAddressBookHierarchicalRootDepartment,                        "PidTagAddressBookHierarchicalRootDepartment" },
-	{ PidTagAddressBookHierarchicalShowInDepartments,                     "PidTagAddressBookHierarchicalShowInDepartments" },
-	{ PidTagAddressBookHomeMessageDatabase,                               "PidTagAddressBookHomeMessageDatabase" },
-	{ PidTagAddressBookIsMaster,                                          "PidTagAddressBookIsMaster" },
-	{ PidTagAddressBookIsMemberOfDistributionList,                        "PidTagAddressBookIsMemberOfDistributionList" },
-	{ PidTagAddressBookManageDistributionList,                            "PidTagAddressBookManageDistributionList" },
-	{ PidTagAddressBookManager,                                           "PidTagAddressBookManager" },
-	{ PidTagAddressBookManagerDistinguishedName,                          "PidTagAddressBookManagerDistinguishedName" },
-	{ PidTagAddressBookMember,                                            "PidTagAddressBookMember" },
-	{ PidTagAddressBookMessageId,                                         "PidTagAddressBookMessageId" },
-	{ PidTagAddressBookModerationEnabled,                                 "PidTagAddressBookModerationEnabled" },
-	{ PidTagAddressBookNetworkAddress,                                    "PidTagAddressBookNetworkAddress" },
-	{ PidTagAddressBookObjectDistinguishedName,                           "PidTagAddressBookObjectDistinguishedName" },
-	{ PidTagAddressBookObjectGuid,                                        "PidTagAddressBookObjectGuid" },
-	{ PidTagAddressBookOrganizationalUnitRootDistinguishedName,           "PidTagAddressBookOrganizationalUnitRootDistinguishedName" },
-	{ PidTagAddressBookOwner,                                             "PidTagAddressBookOwner" },
-	{ PidTagAddressBookOwnerBackLink,                                     "PidTagAddressBookOwnerBackLink" },
-	{ PidTagAddressBookParentEntryId,                                     "PidTagAddressBookParentEntryId" },
-	{ PidTagAddressBookPhoneticCompanyName,                               "PidTagAddressBookPhoneticCompanyName" },
-	{ PidTagAddressBookPhoneticDepartmentName,                            "PidTagAddressBookPhoneticDepartmentName" },
-	{ PidTagAddressBookPhoneticDisplayName,                               "PidTagAddressBookPhoneticDisplayName" },
-	{ PidTagAddressBookPhoneticGivenName,                                 "PidTagAddressBookPhoneticGivenName" },
-	{ PidTagAddressBookPhoneticSurname,                                   "PidTagAddressBookPhoneticSurname" },
-	{ PidTagAddressBookProxyAddresses,                                    "PidTagAddressBookProxyAddresses" },
-	{ PidTagAddressBookPublicDelegates,                                   "PidTagAddressBookPublicDelegates" },
-	{ PidTagAddressBookReports,                                           "PidTagAddressBookReports" },
-	{ PidTagAddressBookRoomCapacity,                                      "PidTagAddressBookRoomCapacity" },
-	{ PidTagAddressBookRoomContainers,                                    "PidTagAddressBookRoomContainers" },
-	{ PidTagAddressBookRoomDescription,                                   "PidTagAddressBookRoomDescription" },
-	{ PidTagAddressBookSenderHintTranslations,                            "PidTagAddressBookSenderHintTranslations" },
-	{ PidTagAddressBookSeniorityIndex,                                    "PidTagAddressBookSeniorityIndex" },
-	{ PidTagAddressBookTargetAddress,                                     "PidTagAddressBookTargetAddress" },
-	{ PidTagAddressBookUnauthorizedSenders,                               "PidTagAddressBookUnauthorizedSenders" },
-	{ PidTagAddressBookX509Certificate,                                   "PidTagAddressBookX509Certificate" },
-	{ PidTagAddressType,                                                  "PidTagAddressType" },
+	{ PidTagTemplateData,                                                 "PidTagTemplateData" },
 	{ PidTagAlternateRecipientAllowed,                                    "PidTagAlternateRecipientAllowed" },
-	{ PidTagAnr,                                                          "PidTagAnr" },
-	{ PidTagArchiveDate,                                                  "PidTagArchiveDate" },
-	{ PidTagArchivePeriod,                                                "PidTagArchivePeriod" },
-	{ PidTagArchiveTag,                                                   "PidTagArchiveTag" },
-	{ PidTagAssistant,                                                    "PidTagAssistant" },
-	{ PidTagAssistantTelephoneNumber,                                     "PidTagAssistantTelephoneNumber" },
-	{ PidTagAssociated,                                                   "PidTagAssociated" },
-	{ PidTagAttachAdditionalInformation,                                  "PidTagAttachAdditionalInformation" },
-	{ PidTagAttachContentBase,                                            "PidTagAttachContentBase" },
-	{ PidTagAttachContentId,                                              "PidTagAttachContentId" },
-	{ PidTagAttachContentLocation,                                        "PidTagAttachContentLocation" },
-	{ PidTagAttachDataBinary,                                             "PidTagAttachDataBinary" },
-	{ PidTagAttachDataObject,                                             "PidTagAttachDataObject" },
-	{ PidTagAttachEncoding,                                               "PidTagAttachEncoding" },
-	{ PidTagAttachExtension,                                              "PidTagAttachExtension" },
-	{ PidTagAttachFilename,                                               "PidTagAttachFilename" },
-	{ PidTagAttachFlags,                                                  "PidTagAttachFlags" },
-	{ PidTagAttachLongFilename,                                           "PidTagAttachLongFilename" },
-	{ PidTagAttachLongPathname,                                           "PidTagAttachLongPathname" },
-	{ PidTagAttachMethod,                                                 "PidTagAttachMethod" },
-	{ PidTagAttachMimeTag,                                                "PidTagAttachMimeTag" },
-	{ PidTagAttachNumber,                                                 "PidTagAttachNumber" },
-	{ PidTagAttachPathname,                                               "PidTagAttachPathname" },
-	{ PidTagAttachPayloadClass,                                           "PidTagAttachPayloadClass" },
-	{ PidTagAttachPayloadProviderGuidString,                              "PidTagAttachPayloadProviderGuidString" },
-	{ PidTagAttachRendering,                                              "PidTagAttachRendering" },
-	{ PidTagAttachSize,                                                   "PidTagAttachSize" },
-	{ PidTagAttachTag,                                                    "PidTagAttachTag" },
-	{ PidTagAttachTransportName,                                          "PidTagAttachTransportName" },
-	{ PidTagAttachmentContactPhoto,                                       "PidTagAttachmentContactPhoto" },
-	{ PidTagAttachmentFlags,                                              "PidTagAttachmentFlags" },
-	{ PidTagAttachmentHidden,                                             "PidTagAttachmentHidden" },
-	{ PidTagAttachmentLinkId,                                             "PidTagAttachmentLinkId" },
-	{ PidTagAttributeHidden,                                              "PidTagAttributeHidden" },
-	{ PidTagAttributeReadOnly,                                            "PidTagAttributeReadOnly" },
 	{ PidTagAutoForwardComment,                                           "PidTagAutoForwardComment" },
+	{ PidTagScriptData,                                                   "PidTagScriptData" },
 	{ PidTagAutoForwarded,                                                "PidTagAutoForwarded" },
-	{ PidTagAutoResponseSuppress,                                         "PidTagAutoResponseSuppress" },
-	{ PidTagBirthday,                                                     "PidTagBirthday" },
-	{ PidTagBlockStatus,                                                  "PidTagBlockStatus" },
-	{ PidTagBody,                                                         "PidTagBody" },
-	{ PidTagBodyContentId,                                                "PidTagBodyContentId" },
-	{ PidTagBodyContentLocation,                                          "PidTagBodyContentLocation" },
-	{ PidTagBodyHtml,                                                     "PidTagBodyHtml" },
-	{ PidTagBusiness2TelephoneNumber,                                     "PidTagBusiness2TelephoneNumber" },
-	{ PidTagBusiness2TelephoneNumbers,                                    "PidTagBusiness2TelephoneNumbers" },
-	{ PidTagBusinessFaxNumber,                                            "PidTagBusinessFaxNumber" },
-	{ PidTagBusinessHomePage,                                             "PidTagBusinessHomePage" },
-	{ PidTagBusinessTelephoneNumber,                                      "PidTagBusinessTelephoneNumber" },
-	{ PidTagCallId,                                                       "PidTagCallId" },
-	{ PidTagCallbackTelephoneNumber,                                      "PidTagCallbackTelephoneNumber" },
-	{ PidTagCarTelephoneNumber,                                           "PidTagCarTelephoneNumber" },
-	{ PidTagCdoRecurrenceid,                                              "PidTagCdoRecurrenceid" },
-	{ PidTagChangeKey,                                                    "PidTagChangeKey" },
-	{ PidTagChangeNumber,                                                 "PidTagChangeNumber" },
-	{ PidTagChildrensNames,                                               "PidTagChildrensNames" },
-	{ PidTagClientActions,                                                "PidTagClientActions" },
+	{ PidTagDeferredDeliveryTime,                                         "PidTagDeferredDeliveryTime" },
+	{ PidTagDeliverTime,                                                  "PidTagDeliverTime" },
+	{ PidTagExpiryTime,                                                   "PidTagExpiryTime" },
+	{ PidTagImportance,                                                   "PidTagImportance" },
+	{ PidTagMessageClass,                                                 "PidTagMessageClass" },
+	{ PidTagOriginatorDeliveryReportRequested,                            "PidTagOriginatorDeliveryReportRequested" },
+	{ PidTagParentKey,                                                    "PidTagParentKey" },
+	{ PidTagPriority,                                                     "PidTagPriority" },
+	{ PidTagReadReceiptRequested,                                         "PidTagReadReceiptRequested" },
+	{ PidTagReceiptTime,                                                  "PidTagReceiptTime" },
+	{ PidTagRecipientReassignmentProhibited,                              "PidTagRecipientReassignmentProhibited" },
+	{ PidTagOriginalSensitivity,                                          "PidTagOriginalSensitivity" },
+	{ PidTagReplyTime,                                                    "PidTagReplyTime" },
+	{ PidTagReportTag,                                                    "PidTagReportTag" },
+	{ PidTagReportTime,                                                   "PidTagReportTime" },
+	{ PidTagSensitivity,                                                  "PidTagSensitivity" },
+	{ PidTagSubject,                                                      "PidTagSubject" },
 	{ PidTagClientSubmitTime,                                             "PidTagClientSubmitTime" },
-	{ PidTagCodePageId,                                                   "PidTagCodePageId" },
-	{ PidTagComment,                                                      "PidTagComment" },
-	{ PidTagCompanyMainTelephoneNumber,                                   "PidTagCompanyMainTelephoneNumber" },
-	{ PidTagCompanyName,                                                  "PidTagCompanyName" },
-	{ PidTagComputerNetworkName,                                          "PidTagComputerNetworkName" },
-	{ PidTagConflictEntryId,                                              "PidTagConflictEntryId" },
-	{ PidTagContainerClass,                                               "PidTagContainerClass" },
-	{ PidTagContainerContents,                                            "PidTagContainerContents" },
-	{ PidTagContainerFlags,                                               "PidTagContainerFlags" },
-	{ PidTagContainerHierarchy,                                           "PidTagContainerHierarchy" },
-	{ PidTagContentCount,                                                 "PidTagContentCount" },
-	{ PidTagContentFilterSpamConfidenceLevel,                             "PidTagContentFilterSpamConfidenceLevel" },
-	{ PidTagContentUnreadCount,                                           "PidTagContentUnreadCount" },
-	{ PidTagConversationId,                                               "PidTagConversationId" },
-	{ PidTagConversationIndex,                                            "PidTagConversationIndex" },
-	{ PidTagConversationIndexTracking,                                    "PidTagConversationIndexTracking" },
+	{ PidTagReportName,                                                   "PidTagReportName" },
+	{ PidTagSentRepresentingSearchKey,                                    "PidTagSentRepresentingSearchKey" },
+	{ PidTagSubjectPrefix,                                                "PidTagSubjectPrefix" },
+	{ PidTagReceivedByEntryId,                                            "PidTagReceivedByEntryId" },
+	{ PidTagReceivedByName,                                               "PidTagReceivedByName" },
+	{ PidTagSentRepresentingEntryId,                                      "PidTagSentRepresentingEntryId" },
+	{ PidTagSentRepresentingName,                                         "PidTagSentRepresentingName" },
+	{ PidTagReceivedRepresentingEntryId,                                  "PidTagReceivedRepresentingEntryId" },
+	{ PidTagReceivedRepresentingName,                                     "PidTagReceivedRepresentingName" },
+	{ PidTagReportEntryId,                                                "PidTagReportEntryId" },
+	{ PidTagReadReceiptEntryId,                                           "PidTagReadReceiptEntryId" },
+	{ PidTagMessageSubmissionId,                                          "PidTagMessageSubmissionId" },
+	{ PidTagOriginalSubject,                                              "PidTagOriginalSubject" },
+	{ PidTagOriginalMessageClass,                                         "PidTagOriginalMessageClass" },
+	{ PidTagOriginalAuthorEntryId,                                        "PidTagOriginalAuthorEntryId" },
+	{ PidTagOriginalAuthorName,                                           "PidTagOriginalAuthorName" },
+	{ PidTagOriginalSubmitTime,                                           "PidTagOriginalSubmitTime" },
+	{ PidTagReplyRecipientEntries,                                        "PidTagReplyRecipientEntries" },
+	{ PidTagReplyRecipientNames,                                          "PidTagReplyRecipientNames" },
+	{ PidTagReceivedBySearchKey,                                          "PidTagReceivedBySearchKey" },
+	{ PidTagReceivedRepresentingSearchKey,                                "PidTagReceivedRepresentingSearchKey" },
+	{ PidTagReadReceiptSearchKey,                                         "PidTagReadReceiptSearchKey" },
+	{ PidTagReportSearchKey,                                              "PidTagReportSearchKey" },
+	{ PidTagOriginalDeliveryTime,                                         "PidTagOriginalDeliveryTime" },
+	{ PidTagMessageToMe,                                                  "PidTagMessageToMe" },
+	{ PidTagMessageCcMe,                                                  "PidTagMessageCcMe" },
+	{ PidTagMessageRecipientMe,                                           "PidTagMessageRecipientMe" },
+	{ PidTagOriginalSenderName,                                           "PidTagOriginalSenderName" },
+	{ PidTagOriginalSenderEntryId,                                        "PidTagOriginalSenderEntryId" },
+	{ PidTagOriginalSenderSearchKey,                                      "PidTagOriginalSenderSearchKey" },
+	{ PidTagOriginalSentRepresentingName,                                 "PidTagOriginalSentRepresentingName" },
+	{ PidTagOriginalSentRepresentingEntryId,                              "PidTagOriginalSentRepresentingEntryId" },
+	{ PidTagOriginalSentRepresentingSearchKey,                            "PidTagOriginalSentRepresentingSearchKey" },
+	{ PidTagStartDate,                                                    "PidTagStartDate" },
+	{ PidTagEndDate,                                                      "PidTagEndDate" },
+	{ PidTagOwnerAppointmentId,                                           "PidTagOwnerAppointmentId" },
+	{ PidTagResponseRequested,                                            "PidTagResponseRequested" },
+	{ PidTagSentRepresentingAddressType,                                  "PidTagSentRepresentingAddressType" },
+	{ PidTagSentRepresentingEmailAddress,                                 "PidTagSentRepresentingEmailAddress" },
+	{ PidTagOriginalSenderAddressType,                                    "PidTagOriginalSenderAddressType" },
+	{ PidTagOriginalSenderEmailAddress,                                   "PidTagOriginalSenderEmailAddress" },
+	{ PidTagOriginalSentRepresentingAddressType,                          "PidTagOriginalSentRepresentingAddressType" },
+	{ PidTagOriginalSentRepresentingEmailAddress,                         "PidTagOriginalSentRepresentingEmailAddress" },
 	{ PidTagConversationTopic,                                            "PidTagConversationTopic" },
-	{ PidTagCountry,                                                      "PidTagCountry" },
-	{ PidTagCreationTime,                                                 "PidTagCreationTime" },
-	{ PidTagCreatorEntryId,                                               "PidTagCreatorEntryId" },
-	{ PidTagCreatorName,                                                  "PidTagCreatorName" },
-	{ PidTagCustomerId,                                                   "PidTagCustomerId" },
-	{ PidTagDamBackPatched,                                               "PidTagDamBackPatched" },
-	{ PidTagDamOriginalEntryId,                                           "PidTagDamOriginalEntryId" },
-	{ PidTagDefaultPostMessageClass,                                      "PidTagDefaultPostMessageClass" },
-	{ PidTagDeferredActionMessageOriginalEntryId,                         "PidTagDeferredActionMessageOriginalEntryId" },
-	{ PidTagDeferredDeliveryTime,                                         "PidTagDeferredDeliveryTime" },
-	{ PidTagDeferredSendNumber,                                           "PidTagDeferredSendNumber" },
-	{ PidTagDeferredSendTime,                                             "PidTagDeferredSendTime" },
-	{ PidTagDeferredSendUnits,                                            "PidTagDeferredSendUnits" },
-	{ PidTagDelegateFlags,                                                "PidTagDelegateFlags" },
-	{ PidTagDelegatedByRule,                                              "PidTagDelegatedByRule" },
+	{ PidTagConversationIndex,                                            "PidTagConversationIndex" },
+	{ PidTagOriginalDisplayBcc,                                           "PidTagOriginalDisplayBcc" },
+	{ PidTagOriginalDisplayCc,                                            "PidTagOriginalDisplayCc" },
+	{ PidTagOriginalDisplayTo,                                            "PidTagOriginalDisplayTo" },
+	{ PidTagReceivedByAddressType,                                        "PidTagReceivedByAddressType" },
+	{ PidTagReceivedByEmailAddress,                                       "PidTagReceivedByEmailAddress" },
+	{ PidTagReceivedRepresentingAddressType,                              "PidTagReceivedRepresentingAddressType" },
+	{ PidTagReceivedRepresentingEmailAddress,                             "PidTagReceivedRepresentingEmailAddress" },
+	{ PidTagTransportMessageHeaders,                                      "PidTagTransportMessageHeaders" },
+	{ PidTagTnefCorrelationKey,                                           "PidTagTnefCorrelationKey" },
+	{ PidTagReportDisposition,                                            "PidTagReportDisposition" },
+	{ PidTagReportDispositionMode,                                        "PidTagReportDispositionMode" },
+	{ PidTagAddressBookRoomCapacity,                                      "PidTagAddressBookRoomCapacity" },
+	{ PidTagAddressBookRoomDescription,                                   "PidTagAddressBookRoomDescription" },
+	{ PidTagNonDeliveryReportReasonCode,                                  "PidTagNonDeliveryReportReasonCode" },
+	{ PidTagNonDeliveryReportDiagCode,                                    "PidTagNonDeliveryReportDiagCode" },
+	{ PidTagOriginatorNonDeliveryReportRequested,                         "PidTagOriginatorNonDeliveryReportRequested" },
+	{ PidTagRecipientType,                                                "PidTagRecipientType" },
+	{ PidTagReplyRequested,                                               "PidTagReplyRequested" },
+	{ PidTagSenderEntryId,                                                "PidTagSenderEntryId" },
+	{ PidTagSenderName,                                                   "PidTagSenderName" },
+	{ PidTagSupplementaryInfo,                                            "PidTagSupplementaryInfo" },
+	{ PidTagSenderSearchKey,                                              "PidTagSenderSearchKey" },
+	{ PidTagSenderAddressType,                                            "PidTagSenderAddressType" },
+	{ PidTagSenderEmailAddress,                                           "PidTagSenderEmailAddress" },
+	{ PidTagNonDeliveryReportStatusCode,                                  "PidTagNonDeliveryReportStatusCode" },
+	{ PidTagRemoteMessageTransferAgent,                                   "PidTagRemoteMessageTransferAgent" },
 	{ PidTagDeleteAfterSubmit,                                            "PidTagDeleteAfterSubmit" },
-	{ PidTagDeletedCountTotal,                                            "PidTagDeletedCountTotal" },
-	{ PidTagDeletedOn,                                                    "PidTagDeletedOn" },
-	{ PidTagDeliverTime,                                                  "PidTagDeliverTime" },
-	{ PidTagDepartmentName,                                               "PidTagDepartmentName" },
-	{ PidTagDepth,                                                        "PidTagDepth" },
 	{ PidTagDisplayBcc,                                                   "PidTagDisplayBcc" },
 	{ PidTagDisplayCc,                                                    "PidTagDisplayCc" },
-	{ PidTagDisplayName,                                                  "PidTagDisplayName" },
-	{ PidTagDisplayNamePrefix,                                            "PidTagDisplayNamePrefix" },
 	{ PidTagDisplayTo,                                                    "PidTagDisplayTo" },
-	{ PidTagDisplayType,                                                  "PidTagDisplayType" },
-	{ PidTagDisplayTypeEx,                                                "PidTagDisplayTypeEx" },
-	{ PidTagEmailAddress,                                                 "PidTagEmailAddress" },
-	{ PidTagEndDate,                                                      "PidTagEndDate" },
-	{ PidTagEntryId,                                                      "PidTagEntryId" },
-	{ PidTagExceptionEndTime,                                             "PidTagExceptionEndTime" },
-	{ PidTagExceptionReplaceTime,                                         "PidTagExceptionReplaceTime" },
-	{ PidTagExceptionStartTime,                                           "PidTagExceptionStartTime" },
+	{ PidTagMessageDeliveryTime,                                          "PidTagMessageDeliveryTime" },
+	{ PidTagMessageFlags,                                                 "PidTagMessageFlags" },
+	{ PidTagMessageSize,                                                  "PidTagMessageSize" },
+	{ PidTagMessageSizeExtended,                                          "PidTagMessageSizeExtended" },
+	{ PidTagParentEntryId,                                                "PidTagParentEntryId" },
+	{ PidTagResponsibility,                                               "PidTagResponsibility" },
+	{ PidTagMessageRecipients,                                            "PidTagMessageRecipients" },
+	{ PidTagMessageAttachments,                                           "PidTagMessageAttachments" },
+	{ PidTagMessageStatus,                                                "PidTagMessageStatus" },
+	{ PidTagHasAttachments,                                               "PidTagHasAttachments" },
+	{ PidTagNormalizedSubject,                                            "PidTagNormalizedSubject" },
+	{ PidTagRtfInSync,                                                    "PidTagRtfInSync" },
+	{ PidTagAttachSize,                                                   "PidTagAttachSize" },
+	{ PidTagAttachNumber,                                                 "PidTagAttachNumber" },
+	{ PidTagPrimarySendAccount,                                           "PidTagPrimarySendAccount" },
+	{ PidTagNextSendAcct,                                                 "PidTagNextSendAcct" },
+	{ PidTagToDoItemFlags,                                                "PidTagToDoItemFlags" },
+	{ PidTagSwappedToDoStore,                                             "PidTagSwappedToDoStore" },
+	{ PidTagSwappedToDoData,                                              "PidTagSwappedToDoData" },
+	{ PidTagRead,                                                         "PidTagRead" },
+	{ PidTagSecurityDescriptorAsXml,                                      "PidTagSecurityDescriptorAsXml" },
+	{ PidTagTrustSender,                                                  "PidTagTrustSender" },
 	{ PidTagExchangeNTSecurityDescriptor,                                 "PidTagExchangeNTSecurityDescriptor" },
-	{ PidTagExpiryNumber,                                                 "PidTagExpiryNumber" },
-	{ PidTagExpiryTime,                                                   "PidTagExpiryTime" },
-	{ PidTagExpiryUnits,                                                  "PidTagExpiryUnits" },
-	{ PidTagExtendedFolderFlags,                                          "PidTagExtendedFolderFlags" },
 	{ PidTagExtendedRuleMessageActions,                                   "PidTagExtendedRuleMessageActions" },
 	{ PidTagExtendedRuleMessageCondition,                                 "PidTagExtendedRuleMessageCondition" },
 	{ PidTagExtendedRuleSizeLimit,                                        "PidTagExtendedRuleSizeLimit" },
-	{ PidTagFaxNumberOfPages,                                             "PidTagFaxNumberOfPages" },
-	{ PidTagFlagCompleteTime,                                             "PidTagFlagCompleteTime" },
+	{ PidTagAccess,                                                       "PidTagAccess" },
+	{ PidTagRowType,                                                      "PidTagRowType" },
+	{ PidTagInstanceKey,                                                  "PidTagInstanceKey" },
+	{ PidTagAccessLevel,                                                  "PidTagAccessLevel" },
+	{ PidTagMappingSignature,                                             "PidTagMappingSignature" },
+	{ PidTagRecordKey,                                                    "PidTagRecordKey" },
+	{ PidTagStoreEntryId,                                                 "PidTagStoreEntryId" },
+	{ PidTagObjectType,                                                   "PidTagObjectType" },
+	{ PidTagEntryId,                                                      "PidTagEntryId" },
+	{ PidTagBody,                                                         "PidTagBody" },
+	{ PidTagReportText,                                                   "PidTagReportText" },
+	{ PidTagRtfCompressed,                                                "PidTagRtfCompressed" },
+	{ PidTagBodyHtml,                                                     "PidTagBodyHtml" },
+	{ PidTagHtml,                                                         "PidTagHtml" },
+	{ PidTagBodyContentLocation,                                          "PidTagBodyContentLocation" },
+	{ PidTagBodyContentId,                                                "PidTagBodyContentId" },
+	{ PidTagNativeBody,                                                   "PidTagNativeBody" },
+	{ PidTagInternetMessageId,                                            "PidTagInternetMessageId" },
+	{ PidTagInternetReferences,                                           "PidTagInternetReferences" },
+	{ PidTagInReplyToId,                                                  "PidTagInReplyToId" },
+	{ PidTagListHelp,                                                     "PidTagListHelp" },
+	{ PidTagListSubscribe,                                                "PidTagListSubscribe" },
+	{ PidTagListUnsubscribe,                                              "PidTagListUnsubscribe" },
+	{ PidTagOriginalMessageId,                                            "PidTagOriginalMessageId" },
+	{ PidTagIconIndex,                                                    "PidTagIconIndex" },
+	{ PidTagLastVerbExecuted,                                             "PidTagLastVerbExecuted" },
+	{ PidTagLastVerbExecutionTime,                                        "PidTagLastVerbExecutionTime" },
 	{ PidTagFlagStatus,                                                   "PidTagFlagStatus" },
-	{ PidTagFlatUrlName,                                                  "PidTagFlatUrlName" },
-	{ PidTagFolderAssociatedContents,                                     "PidTagFolderAssociatedContents" },
-	{ PidTagFolderId,                                                     "PidTagFolderId" },
-	{ PidTagFolderType,                                                   "PidTagFolderType" },
+	{ PidTagFlagCompleteTime,                                             "PidTagFlagCompleteTime" },
 	{ PidTagFollowupIcon,                                                 "PidTagFollowupIcon" },
-	{ PidTagFreeBusyCountMonths,                                          "PidTagFreeBusyCountMonths" },
-	{ PidTagFreeBusyEntryIds,                                             "PidTagFreeBusyEntryIds" },
-	{ PidTagFreeBusyMessageEmailAddress,                                  "PidTagFreeBusyMessageEmailAddress" },
-	{ PidTagFreeBusyPublishEnd,                                           "PidTagFreeBusyPublishEnd" },
-	{ PidTagFreeBusyPublishStart,                                         "PidTagFreeBusyPublishStart" },
-	{ PidTagFreeBusyRangeTimestamp,                                       "PidTagFreeBusyRangeTimestamp" },
-	{ PidTagFtpSite,                                                      "PidTagFtpSite" },
-	{ PidTagGatewayNeedsToRefresh,                                        "PidTagGatewayNeedsToRefresh" },
-	{ PidTagGender,                                                       "PidTagGender" },
-	{ PidTagGeneration,                                                   "PidTagGeneration" },
-	{ PidTagGivenName,                                                    "PidTagGivenName" },
-	{ PidTagGovernmentIdNumber,                                           "PidTagGovernmentIdNumber" },
-	{ PidTagHasAttachments,                                               "PidTagHasAttachments" },
-	{ PidTagHasDeferredActionMessages,                                    "PidTagHasDeferredActionMessages" },
-	{ PidTagHasNamedProperties,                                           "PidTagHasNamedProperties" },
-	{ PidTagHasRules,                                                     "PidTagHasRules" },
-	{ PidTagHierarchyChangeNumber,                                        "PidTagHierarchyChangeNumber" },
-	{ PidTagHobbies,                                                      "PidTagHobbies" },
-	{ PidTagHome2TelephoneNumber,                                         "PidTagHome2TelephoneNumber" },
-	{ PidTagHome2TelephoneNumbers,                                        "PidTagHome2TelephoneNumbers" },
-	{ PidTagHomeAddressCity,                                              "PidTagHomeAddressCity" },
-	{ PidTagHomeAddressCountry,                                           "PidTagHomeAddressCountry" },
-	{ PidTagHomeAddressPostOfficeBox,                                     "PidTagHomeAddressPostOfficeBox" },
-	{ PidTagHomeAddressPostalCode,                                        "PidTagHomeAddressPostalCode" },
-	{ PidTagHomeAddressStateOrProvince,                                   "PidTagHomeAddressStateOrProvince" },
-	{ PidTagHomeAddressStreet,                                            "PidTagHomeAddressStreet" },
-	{ PidTagHomeFaxNumber,                                                "PidTagHomeFaxNumber" },
-	{ PidTagHomeTelephoneNumber,                                          "PidTagHomeTelephoneNumber" },
-	{ PidTagHtml,                                                         "PidTagHtml" },
+	{ PidTagBlockStatus,                                                  "PidTagBlockStatus" },
+	{ PidTagICalendarStartTime,                                           "PidTagICalendarStartTime" },
 	{ PidTagICalendarEndTime,                                             "PidTagICalendarEndTime" },
+	{ PidTagCdoRecurrenceid,                                              "PidTagCdoRecurrenceid" },
 	{ PidTagICalendarReminderNextTime,                                    "PidTagICalendarReminderNextTime" },
-	{ PidTagICalendarStartTime,                                           "PidTagICalendarStartTime" },
-	{ PidTagIconIndex,                                                    "PidTagIconIndex" },
-	{ PidTagImportance,                                                   "PidTagImportance" },
-	{ PidTagInConflict,                                                   "PidTagInConflict" },
-	{ PidTagInReplyToId,                                                  "PidTagInReplyToId" },
-	{ PidTagInitialDetailsPane,                                           "PidTagInitialDetailsPane" },
-	{ PidTagInitials,                                                     "PidTagInitials" },
-	{ PidTagInstID,                                                       "PidTagInstID" },
-	{ PidTagInstanceKey,                                                  "PidTagInstanceKey" },
-	{ PidTagInstanceNum,                                                  "PidTagInstanceNum" },
-	{ PidTagInternetCodepage,                                             "PidTagInternetCodepage" },
-	{ PidTagInternetMailOverrideFormat,                                   "PidTagInternetMailOverrideFormat" },
-	{ PidTagInternetMessageId,                                            "PidTagInternetMessageId" },
-	{ PidTagInternetReferences,                                           "PidTagInternetReferences" },
+	{ PidTagAttributeHidden,                                              "PidTagAttributeHidden" },
+	{ PidTagAttributeReadOnly,                                            "PidTagAttributeReadOnly" },
+	{ PidTagRowid,                                                        "PidTagRowid" },
+	{ PidTagDisplayName,                                                  "PidTagDisplayName" },
+	{ PidTagAddressType,                                                  "PidTagAddressType" },
+	{ PidTagEmailAddress,                                                 "PidTagEmailAddress" },
+	{ PidTagComment,                                                      "PidTagComment" },
+	{ PidTagDepth,                                                        "PidTagDepth" },
+	{ PidTagCreationTime,                                                 "PidTagCreationTime" },
+	{ PidTagLastModificationTime,                                         "PidTagLastModificationTime" },
+	{ PidTagSearchKey,                                                    "PidTagSearchKey" },
+	{ PidTagTargetEntryId,                                                "PidTagTargetEntryId" },
+	{ PidTagConversationId,                                               "PidTagConversationId" },
+	{ PidTagConversationIndexTracking,                                    "PidTagConversationIndexTracking" },
+	{ PidTagArchiveTag,                                                   "PidTagArchiveTag" },
+	{ PidTagPolicyTag,                                                    "PidTagPolicyTag" },
+	{ PidTagRetentionPeriod,                                              "PidTagRetentionPeriod" },
+	{ PidTagStartDateEtc,                                                 "PidTagStartDateEtc" },
+	{ PidTagRetentionDate,                                                "PidTagRetentionDate" },
+	{ PidTagRetentionFlags,                                               "PidTagRetentionFlags" },
+	{ PidTagArchivePeriod,                                                "PidTagArchivePeriod" },
+	{ PidTagArchiveDate,                                                  "PidTagArchiveDate" },
+	{ PidTagStoreSupportMask,                                             "PidTagStoreSupportMask" },
+	{ PidTagStoreState,                                                   "PidTagStoreState" },
+	{ PidTagContainerFlags,                                               "PidTagContainerFlags" },
+	{ PidTagFolderType,                                                   "PidTagFolderType" },
+	{ PidTagContentCount,                                                 "PidTagContentCount" },
+	{ PidTagContentUnreadCount,                                           "PidTagContentUnreadCount" },
+	{ PidTagSelectable,                                                   "PidTagSelectable" },
+	{ PidTagSubfolders,                                                   "PidTagSubfolders" },
+	{ PidTagAnr,                                                          "PidTagAnr" },
+	{ PidTagContainerHierarchy,                                           "PidTagContainerHierarchy" },
+	{ PidTagContainerContents,                                            "PidTagContainerContents" },
+	{ PidTagFolderAssociatedContents,                                     "PidTagFolderAssociatedContents" },
+	{ PidTagContainerClass,                                               "PidTagContainerClass" },
 	{ PidTagIpmAppointmentEntryId,                                        "PidTagIpmAppointmentEntryId" },
 	{ PidTagIpmContactEntryId,                                            "PidTagIpmContactEntryId" },
-	{ PidTagIpmDraftsEntryId,                                             "PidTagIpmDraftsEntryId" },
 	{ PidTagIpmJournalEntryId,                                            "PidTagIpmJournalEntryId" },
 	{ PidTagIpmNoteEntryId,                                               "PidTagIpmNoteEntryId" },
 	{ PidTagIpmTaskEntryId,                                               "PidTagIpmTaskEntryId" },
-	{ PidTagIsdnNumber,                                                   "PidTagIsdnNumber" },
-	{ PidTagJunkAddRecipientsToSafeSendersList,                           "PidTagJunkAddRecipientsToSafeSendersList" },
-	{ PidTagJunkIncludeContacts,                                          "PidTagJunkIncludeContacts" },
-	{ PidTagJunkPermanentlyDelete,                                        "PidTagJunkPermanentlyDelete" },
-	{ PidTagJunkPhishingEnableLinks,                                      "PidTagJunkPhishingEnableLinks" },
-	{ PidTagJunkThreshold,                                                "PidTagJunkThreshold" },
-	{ PidTagKeyword,                                                      "PidTagKeyword" },
-	{ PidTagLanguage,                                                     "PidTagLanguage" },
-	{ PidTagLastModificationTime,                                         "PidTagLastModificationTime" },
-	{ PidTagLastModifierEntryId,                                          "PidTagLastModifierEntryId" },
-	{ PidTagLastModifierName,                                             "PidTagLastModifierName" },
-	{ PidTagLastVerbExecuted,                                             "PidTagLastVerbExecuted" },
-	{ PidTagLastVerbExecutionTime,                                        "PidTagLastVerbExecutionTime" },
-	{ PidTagListHelp,                                                     "PidTagListHelp" },
-	{ PidTagListSubscribe,                                                "PidTagListSubscribe" },
-	{ PidTagListUnsubscribe,                                              "PidTagListUnsubscribe" },
-	{ PidTagLocalCommitTime,                                              "PidTagLocalCommitTime" },
-	{ PidTagLocalCommitTimeMax,                                           "PidTagLocalCommitTimeMax" },
-	{ PidTagLocaleId,                                                     "PidTagLocaleId" },
-	{ PidTagLocality,                                                     "PidTagLocality" },
-	{ PidTagLocation,                                                     "PidTagLocation" },
-	{ PidTagMailboxOwnerEntryId,                                          "PidTagMailboxOwnerEntryId" },
-	{ PidTagMailboxOwnerName,                                             "PidTagMailboxOwnerName" },
-	{ PidTagManagerName,                                                  "PidTagManagerName" },
-	{ PidTagMappingSignature,                                             "PidTagMappingSignature" },
-	{ PidTagMaximumSubmitMessageSize,                                     "PidTagMaximumSubmitMessageSize" },
-	{ PidTagMemberId,                                                     "PidTagMemberId" },
-	{ PidTagMemberName,                                                   "PidTagMemberName" },
-	{ PidTagMemberRights,                                                 "PidTagMemberRights" },
-	{ PidTagMessageAttachments,                                           "PidTagMessageAttachments" },
-	{ PidTagMessageCcMe,                                                  "PidTagMessageCcMe" },
-	{ PidTagMessageClass,                                                 "PidTagMessageClass" },
-	{ PidTagMessageCodepage,                                              "PidTagMessageCodepage" },
-	{ PidTagMessageDeliveryTime,                                          "PidTagMessageDeliveryTime" },
-	{ PidTagMessageEditorFormat,                                          "PidTagMessageEditorFormat" },
-	{ PidTagMessageFlags,                                                 "PidTagMessageFlags" },
-	{ PidTagMessageHandlingSystemCommonName,                              "PidTagMessageHandlingSystemCommonName" },
-	{ PidTagMessageLocaleId,                                              "PidTagMessageLocaleId" },
-	{ PidTagMessageRecipientMe,                                           "PidTagMessageRecipientMe" },
-	{ PidTagMessageRecipients,                                            "PidTagMessageRecipients" },
-	{ PidTagMessageSize,                                                  "PidTagMessageSize" },
-	{ PidTagMessageSizeExtended,                                          "PidTagMessageSizeExtended" },
-	{ PidTagMessageStatus,                                                "PidTagMessageStatus" },
-	{ PidTagMessageSubmissionId,                                          "PidTagMessageSubmissionId" },
-	{ PidTagMessageToMe,                                                  "PidTagMessageToMe" },
-	{ PidTagMid,                                                          "PidTagMid" },
-	{ PidTagMiddleName,                                                   "PidTagMiddleName" },
-	{ PidTagMimeSkeleton,                                                 "PidTagMimeSkeleton" },
-	{ PidTagMobileTelephoneNumber,                                        "PidTagMobileTelephoneNumber" },
-	{ PidTagNativeBody,                                                   "PidTagNativeBody" },
-	{ PidTagNextSendAcct,                                                 "PidTagNextSendAcct" },
-	{ PidTagNickname,                                                     "PidTagNickname" },
-	{ PidTagNonDeliveryReportDiagCode,                                    "PidTagNonDeliveryReportDiagCode" },
-	{ PidTagNonDeliveryReportReasonCode,                                  "PidTagNonDeliveryReportReasonCode" },
-	{ PidTagNonDeliveryReportStatusCode,                                  "PidTagNonDeliveryReportStatusCode" },
-	{ PidTagNormalizedSubject,                                            "PidTagNormalizedSubject" },
-	{ PidTagObjectType,                                                   "PidTagObjectType" },
-	{ PidTagOfficeLocation,                                               "PidTagOfficeLocation" },
-	{ PidTagOfflineAddressBookContainerGuid,                              "PidTagOfflineAddressBookContainerGuid" },
-	{ PidTagOfflineAddressBookDistinguishedName,                          "PidTagOfflineAddressBookDistinguishedName" },
-	{ PidTagOfflineAddressBookMessageClass,                               "PidTagOfflineAddressBookMessageClass" },
-	{ PidTagOfflineAddressBookName,                                       "PidTagOfflineAddressBookName" },
-	{ PidTagOfflineAddressBookSequence,                                   "PidTagOfflineAddressBookSequence" },
-	{ PidTagOfflineAddressBookTruncatedProperties,                        "PidTagOfflineAddressBookTruncatedProperties" },
+	{ PidTagRemindersOnlineEntryId,                                       "PidTagRemindersOnlineEntryId" },
+	{ PidTagIpmDraftsEntryId,                                             "PidTagIpmDraftsEntryId" },
+	{ PidTagAdditionalRenEntryIds,                                        "PidTagAdditionalRenEntryIds" },
+	{ PidTagAdditionalRenEntryIdsEx,                                      "PidTagAdditionalRenEntryIdsEx" },
+	{ PidTagExtendedFolderFlags,                                          "PidTagExtendedFolderFlags" },
 	{ PidTagOrdinalMost,                                                  "PidTagOrdinalMost" },
+	{ PidTagFreeBusyEntryIds,                                             "PidTagFreeBusyEntryIds" },
+	{ PidTagDefaultPostMessageClass,                                      "PidTagDefaultPostMessageClass" },
+	{ PidTagAttachDataObject,                                             "PidTagAttachDataObject" },
+	{ PidTagAttachDataBinary,                                             "PidTagAttachDataBinary" },
+	{ PidTagAttachEncoding,                                               "PidTagAttachEncoding" },
+	{ PidTagAttachExtension,                                              "PidTagAttachExtension" },
+	{ PidTagAttachFilename,                                               "PidTagAttachFilename" },
+	{ PidTagAttachMethod,                                                 "PidTagAttachMethod" },
+	{ PidTagAttachLongFilename,                                           "PidTagAttachLongFilename" },
+	{ PidTagAttachPathname,                                               "PidTagAttachPathname" },
+	{ PidTagAttachRendering,                                              "PidTagAttachRendering" },
+	{ PidTagAttachTag,                                                    "PidTagAttachTag" },
+	{ PidTagRenderingPosition,                                            "PidTagRenderingPosition" },
+	{ PidTagAttachTransportName,                                          "PidTagAttachTransportName" },
+	{ PidTagAttachLongPathname,                                           "PidTagAttachLongPathname" },
+	{ PidTagAttachMimeTag,                                                "PidTagAttachMimeTag" },
+	{ PidTagAttachAdditionalInformation,                                  "PidTagAttachAdditionalInformation" },
+	{ PidTagAttachContentBase,                                            "PidTagAttachContentBase" },
+	{ PidTagAttachContentId,                                              "PidTagAttachContentId" },
+	{ PidTagAttachContentLocation,                                        "PidTagAttachContentLocation" },
+	{ PidTagAttachFlags,                                                  "PidTagAttachFlags" },
+	{ PidTagAttachPayloadProviderGuidString,                              "PidTagAttachPayloadProviderGuidString" },
+	{ PidTagAttachPayloadClass,                                           "PidTagAttachPayloadClass" },
+	{ PidTagTextAttachmentCharset,                                        "PidTagTextAttachmentCharset" },
+	{ PidTagDisplayType,                                                  "PidTagDisplayType" },
+	{ PidTagTemplateid,                                                   "PidTagTemplateid" },
+	{ PidTagDisplayTypeEx,                                                "PidTagDisplayTypeEx" },
+	{ PidTagSmtpAddress,                                                  "PidTagSmtpAddress" },
+	{ PidTagAddressBookDisplayNamePrintable,                              "PidTagAddressBookDisplayNamePrintable" },
+	{ PidTagAccount,                                                      "PidTagAccount" },
+	{ PidTagCallbackTelephoneNumber,                                      "PidTagCallbackTelephoneNumber" },
+	{ PidTagGeneration,                                                   "PidTagGeneration" },
+	{ PidTagGivenName,                                                    "PidTagGivenName" },
+	{ PidTagGovernmentIdNumber,                                           "PidTagGovernmentIdNumber" },
+	{ PidTagBusinessTelephoneNumber,                                      "PidTagBusinessTelephoneNumber" },
+	{ PidTagHomeTelephoneNumber,                                          "PidTagHomeTelephoneNumber" },
+	{ PidTagInitials,                                                     "PidTagInitials" },
+	{ PidTagKeyword,                                                      "PidTagKeyword" },
+	{ PidTagLanguage,                                                     "PidTagLanguage" },
+	{ PidTagLocation,                                                     "PidTagLocation" },
+	{ PidTagMessageHandlingSystemCommonName,                              "PidTagMessageHandlingSystemCommonName" },
 	{ PidTagOrganizationalIdNumber,                                       "PidTagOrganizationalIdNumber" },
-	{ PidTagOriginalAuthorEntryId,                                        "PidTagOriginalAuthorEntryId" },
-	{ PidTagOriginalAuthorName,                                           "PidTagOriginalAuthorName" },
-	{ PidTagOriginalDeliveryTime,                                         "PidTagOriginalDeliveryTime" },
-	{ PidTagOriginalDisplayBcc,                                           "PidTagOriginalDisplayBcc" },
-	{ PidTagOriginalDisplayCc,                                            "PidTagOriginalDisplayCc" },
-	{ PidTagOriginalDisplayTo,                                            "PidTagOriginalDisplayTo" },
+	{ PidTagSurname,                                                      "PidTagSurname" },
 	{ PidTagOriginalEntryId,                                              "PidTagOriginalEntryId" },
-	{ PidTagOriginalMessageClass,                                         "PidTagOriginalMessageClass" },
-	{ PidTagOriginalMessageId,                                            "PidTagOriginalMessageId" },
-	{ PidTagOriginalSenderAddressType,                                    "PidTagOriginalSenderAddressType" },
-	{ PidTagOriginalSenderEmailAddress,                                   "PidTagOriginalSenderEmailAddress" },
-	{ PidTagOriginalSenderEntryId,                                        "PidTagOriginalSenderEntryId" },
-	{ PidTagOriginalSenderName,                                           "PidTagOriginalSenderName" },
-	{ PidTagOriginalSenderSearchKey,                                      "PidTagOriginalSenderSearchKey" },
-	{ PidTagOriginalSensitivity,                                          "PidTagOriginalSensitivity" },
-	{ PidTagOriginalSentRepresentingAddressType,                          "PidTagOriginalSentRepresentingAddressType" },
-	{ PidTagOriginalSentRepresentingEmailAddress,                         "PidTagOriginalSentRepresentingEmailAddress" },
-	{ PidTagOriginalSentRepresentingEntryId,                              "PidTagOriginalSentRepresentingEntryId" },
-	{ PidTagOriginalSentRepresentingName,                                 "PidTagOriginalSentRepresentingName" },
-	{ PidTagOriginalSentRepresentingSearchKey,                            "PidTagOriginalSentRepresentingSearchKey" },
-	{ PidTagOriginalSubject,                                              "PidTagOriginalSubject" },
-	{ PidTagOriginalSubmitTime,                                           "PidTagOriginalSubmitTime" },
-	{ PidTagOriginatorDeliveryReportRequested,                            "PidTagOriginatorDeliveryReportRequested" },
-	{ PidTagOriginatorNonDeliveryReportRequested,                         "PidTagOriginatorNonDeliveryReportRequested" },
-	{ PidTagOscSyncEnabled,                                               "PidTagOscSyncEnabled" },
+	{ PidTagPostalAddress,                                                "PidTagPostalAddress" },
+	{ PidTagCompanyName,                                                  "PidTagCompanyName" },
+	{ PidTagTitle,                                                        "PidTagTitle" },
+	{ PidTagDepartmentName,                                               "PidTagDepartmentName" },
+	{ PidTagOfficeLocation,                                               "PidTagOfficeLocation" },
+	{ PidTagPrimaryTelephoneNumber,                                       "PidTagPrimaryTelephoneNumber" },
+	{ PidTagBusiness2TelephoneNumber,                                     "PidTagBusiness2TelephoneNumber" },
+	{ PidTagBusiness2TelephoneNumbers,                                    "PidTagBusiness2TelephoneNumbers" },
+	{ PidTagMobileTelephoneNumber,                                        "PidTagMobileTelephoneNumber" },
+	{ PidTagRadioTelephoneNumber,                                         "PidTagRadioTelephoneNumber" },
+	{ PidTagCarTelephoneNumber,                                           "PidTagCarTelephoneNumber" },
+	{ PidTagOtherTelephoneNumber,                                         "PidTagOtherTelephoneNumber" },
+	{ PidTagTransmittableDisplayName,                                     "PidTagTransmittableDisplayName" },
+	{ PidTagPagerTelephoneNumber,                                         "PidTagPagerTelephoneNumber" },
+	{ PidTagUserCertificate,                                              "PidTagUserCertificate" },
+	{ PidTagPrimaryFaxNumber,                                             "PidTagPrimaryFaxNumber" },
+	{ PidTagBusinessFaxNumber,                                            "PidTagBusinessFaxNumber" },
+	{ PidTagHomeFaxNumber,                                                "PidTagHomeFaxNumber" },
+	{ PidTagCountry,                                                      "PidTagCountry" },
+	{ PidTagLocality,                                                     "PidTagLocality" },
+	{ PidTagStateOrProvince,                                              "PidTagStateOrProvince" },
+	{ PidTagStreetAddress,                                                "PidTagStreetAddress" },
+	{ PidTagPostalCode,                                                   "PidTagPostalCode" },
+	{ PidTagPostOfficeBox,                                                "PidTagPostOfficeBox" },
+	{ PidTagTelexNumber,                                                  "PidTagTelexNumber" },
+	{ PidTagIsdnNumber,                                                   "PidTagIsdnNumber" },
+	{ PidTagAssistantTelephoneNumber,                                     "PidTagAssistantTelephoneNumber" },
+	{ PidTagHome2TelephoneNumber,                                         "PidTagHome2TelephoneNumber" },
+	{ PidTagHome2TelephoneNumbers,                                        "PidTagHome2TelephoneNumbers" },
+	{ PidTagAssistant,                                                    "PidTagAssistant" },
+	{ PidTagSendRichInfo,                                                 "PidTagSendRichInfo" },
+	{ PidTagWeddingAnniversary,                                           "PidTagWeddingAnniversary" },
+	{ PidTagBirthday,                                                     "PidTagBirthday" },
+	{ PidTagHobbies,                                                      "PidTagHobbies" },
+	{ PidTagMiddleName,                                                   "PidTagMiddleName" },
+	{ PidTagDisplayNamePrefix,                                            "PidTagDisplayNamePrefix" },
+	{ PidTagProfession,                                                   "PidTagProfession" },
+	{ PidTagReferredByName,                                               "PidTagReferredByName" },
+	{ PidTagSpouseName,                                                   "PidTagSpouseName" },
+	{ PidTagComputerNetworkName,                                          "PidTagComputerNetworkName" },
+	{ PidTagCustomerId,                                                   "PidTagCustomerId" },
+	{ PidTagTelecommunicationsDeviceForDeafTelephoneNumber,               "PidTagTelecommunicationsDeviceForDeafTelephoneNumber" },
+	{ PidTagFtpSite,                                                      "PidTagFtpSite" },
+	{ PidTagGender,                                                       "PidTagGender" },
+	{ PidTagManagerName,                                                  "PidTagManagerName" },
+	{ PidTagNickname,                                                     "PidTagNickname" },
+	{ PidTagPersonalHomePage,                                             "PidTagPersonalHomePage" },
+	{ PidTagBusinessHomePage,                                             "PidTagBusinessHomePage" },
+	{ PidTagCompanyMainTelephoneNumber,                                   "PidTagCompanyMainTelephoneNumber" },
+	{ PidTagChildrensNames,                                               "PidTagChildrensNames" },
+	{ PidTagHomeAddressCity,                                              "PidTagHomeAddressCity" },
+	{ PidTagHomeAddressCountry,                                           "PidTagHomeAddressCountry" },
+	{ PidTagHomeAddressPostalCode,                                        "PidTagHomeAddressPostalCode" },
+	{ PidTagHomeAddressStateOrProvince,                                   "PidTagHomeAddressStateOrProvince" },
+	{ PidTagHomeAddressStreet,                                            "PidTagHomeAddressStreet" },
+	{ PidTagHomeAddressPostOfficeBox,                                     "PidTagHomeAddressPostOfficeBox" },
 	{ PidTagOtherAddressCity,                                             "PidTagOtherAddressCity" },
 	{ PidTagOtherAddressCountry,                                          "PidTagOtherAddressCountry" },
-	{ PidTagOtherAddressPostOfficeBox,                                    "PidTagOtherAddressPostOfficeBox" },
 	{ PidTagOtherAddressPostalCode,                                       "PidTagOtherAddressPostalCode" },
 	{ PidTagOtherAddressStateOrProvince,                                  "PidTagOtherAddressStateOrProvince" },
 	{ PidTagOtherAddressStreet,                                           "PidTagOtherAddressStreet" },
-	{ PidTagOtherTelephoneNumber,                                         "PidTagOtherTelephoneNumber" },
-	{ PidTagOutOfOfficeState,                                             "PidTagOutOfOfficeState" },
-	{ PidTagOwnerAppointmentId,                                           "PidTagOwnerAppointmentId" },
-	{ PidTagPagerTelephoneNumber,                                         "PidTagPagerTelephoneNumber" },
-	{ PidTagParentEntryId,                                                "PidTagParentEntryId" },
-	{ PidTagParentFolderId,                                               "PidTagParentFolderId" },
-	{ PidTagParentKey,                                                    "PidTagParentKey" },
-	{ PidTagParentSourceKey,                                              "PidTagParentSourceKey" },
-	{ PidTagPersonalHomePage,                                             "PidTagPersonalHomePage" },
-	{ PidTagPolicyTag,                                                    "PidTagPolicyTag" },
-	{ PidTagPostOfficeBox,                                                "PidTagPostOfficeBox" },
-	{ PidTagPostalAddress,                                                "PidTagPostalAddress" },
-	{ PidTagPostalCode,                                                   "PidTagPostalCode" },
-	{ PidTagPredecessorChangeList,                                        "PidTagPredecessorChangeList" },
-	{ PidTagPrimaryFaxNumber,                                             "PidTagPrimaryFaxNumber" },
-	{ PidTagPrimarySendAccount,                                           "PidTagPrimarySendAccount" },
-	{ PidTagPrimaryTelephoneNumber,                                       "PidTagPrimaryTelephoneNumber" },
-	{ PidTagPriority,                                                     "PidTagPriority" },
-	{ PidTagProcessed,                                                    "PidTagProcessed" },
-	{ PidTagProfession,                                                   "PidTagProfession" },
-	{ PidTagProhibitReceiveQuota,                                         "PidTagProhibitReceiveQuota" },
-	{ PidTagProhibitSendQuota,                                            "PidTagProhibitSendQuota" },
-	{ PidTagPurportedSenderDomain,                                        "PidTagPurportedSenderDomain" },
-	{ PidTagRadioTelephoneNumber,                                         "PidTagRadioTelephoneNumber" },
-	{ PidTagRead,                                                         "PidTagRead" },
+	{ PidTagOtherAddressPostOfficeBox,                                    "PidTagOtherAddressPostOfficeBox" },
+	{ PidTagUserX509Certificate,                                          "PidTagUserX509Certificate" },
+	{ PidTagSendInternetEncoding,                                         "PidTagSendInternetEncoding" },
+	{ PidTagInitialDetailsPane,                                           "PidTagInitialDetailsPane" },
+	{ PidTagInternetCodepage,                                             "PidTagInternetCodepage" },
+	{ PidTagAutoResponseSuppress,                                         "PidTagAutoResponseSuppress" },
+	{ PidTagAccessControlListData,                                        "PidTagAccessControlListData" },
+	{ PidTagDelegatedByRule,                                              "PidTagDelegatedByRule" },
+	{ PidTagResolveMethod,                                                "PidTagResolveMethod" },
+	{ PidTagHasDeferredActionMessages,                                    "PidTagHasDeferredActionMessages" },
+	{ PidTagDeferredSendNumber,                                           "PidTagDeferredSendNumber" },
+	{ PidTagDeferredSendUnits,                                            "PidTagDeferredSendUnits" },
+	{ PidTagExpiryNumber,                                                 "PidTagExpiryNumber" },
+	{ PidTagExpiryUnits,                                                  "PidTagExpiryUnits" },
+	{ PidTagDeferredSendTime,                                             "PidTagDeferredSendTime" },
+	{ PidTagConflictEntryId,                                              "PidTagConflictEntryId" },
+	{ PidTagMessageLocaleId,                                              "PidTagMessageLocaleId" },
+	{ PidTagCreatorName,                                                  "PidTagCreatorName" },
+	{ PidTagCreatorEntryId,                                               "PidTagCreatorEntryId" },
+	{ PidTagLastModifierName,                                             "PidTagLastModifierName" },
+	{ PidTagLastModifierEntryId,                                          "PidTagLastModifierEntryId" },
+	{ PidTagMessageCodepage,                                              "PidTagMessageCodepage" },
+	{ PidTagSentRepresentingFlags,                                        "PidTagSentRepresentingFlags" },
 	{ PidTagReadReceiptAddressType,                                       "PidTagReadReceiptAddressType" },
 	{ PidTagReadReceiptEmailAddress,                                      "PidTagReadReceiptEmailAddress" },
-	{ PidTagReadReceiptEntryId,                                           "PidTagReadReceiptEntryId" },
 	{ PidTagReadReceiptName,                                              "PidTagReadReceiptName" },
-	{ PidTagReadReceiptRequested,                                         "PidTagReadReceiptRequested" },
-	{ PidTagReadReceiptSearchKey,                                         "PidTagReadReceiptSearchKey" },
+	{ PidTagContentFilterSpamConfidenceLevel,                             "PidTagContentFilterSpamConfidenceLevel" },
+	{ PidTagSenderIdStatus,                                               "PidTagSenderIdStatus" },
+	{ PidTagPurportedSenderDomain,                                        "PidTagPurportedSenderDomain" },
+	{ PidTagInternetMailOverrideFormat,                                   "PidTagInternetMailOverrideFormat" },
+	{ PidTagMessageEditorFormat,                                          "PidTagMessageEditorFormat" },
+	{ PidTagSenderSmtpAddress,                                            "PidTagSenderSmtpAddress" },
+	{ PidTagSentRepresentingSmtpAddress,                                  "PidTagSentRepresentingSmtpAddress" },
 	{ PidTagReadReceiptSmtpAddress,                                       "PidTagReadReceiptSmtpAddress" },
-	{ PidTagReceiptTime,                                                  "PidTagReceiptTime" },
-	{ PidTagReceivedByAddressType,                                        "PidTagReceivedByAddressType" },
-	{ PidTagReceivedByEmailAddress,                                       "PidTagReceivedByEmailAddress" },
-	{ PidTagReceivedByEntryId,                                            "PidTagReceivedByEntryId" },
-	{ PidTagReceivedByName,                                               "PidTagReceivedByName" },
-	{ PidTagReceivedBySearchKey,                                          "PidTagReceivedBySearchKey" },
 	{ PidTagReceivedBySmtpAddress,                                        "PidTagReceivedBySmtpAddress" },
-	{ PidTagReceivedRepresentingAddressType,                              "PidTagReceivedRepresentingAddressType" },
-	{ PidTagReceivedRepresentingEmailAddress,                             "PidTagReceivedRepresentingEmailAddress" },
-	{ PidTagReceivedRepresentingEntryId,                                  "PidTagReceivedRepresentingEntryId" },
-	{ PidTagReceivedRepresentingName,                                     "PidTagReceivedRepresentingName" },
-	{ PidTagReceivedRepresentingSearchKey,                                "PidTagReceivedRepresentingSearchKey" },
 	{ PidTagReceivedRepresentingSmtpAddress,                              "PidTagReceivedRepresentingSmtpAddress" },
-	{ PidTagRecipientDisplayName,                                         "PidTagRecipientDisplayName" },
-	{ PidTagRecipientEntryId,                                             "PidTagRecipientEntryId" },
-	{ PidTagRecipientFlags,                                               "PidTagRecipientFlags" },
 	{ PidTagRecipientOrder,                                               "PidTagRecipientOrder" },
 	{ PidTagRecipientProposed,                                            "PidTagRecipientProposed" },
-	{ PidTagRecipientProposedEndTime,                                     "PidTagRecipientProposedEndTime" },
 	{ PidTagRecipientProposedStartTime,                                   "PidTagRecipientProposedStartTime" },
-	{ PidTagRecipientReassignmentProhibited,                              "PidTagRecipientReassignmentProhibited" },
-	{ PidTagRecipientTrackStatus,                                         "PidTagRecipientTrackStatus" },
+	{ PidTagRecipientProposedEndTime,                                     "PidTagRecipientProposedEndTime" },
+	{ PidTagRecipientDisplayName,                                         "PidTagRecipientDisplayName" },
+	{ PidTagRecipientEntryId,                                             "PidTagRecipientEntryId" },
 	{ PidTagRecipientTrackStatusTime,                                     "PidTagRecipientTrackStatusTime" },
-	{ PidTagRecipientType,                                                "PidTagRecipientType" },
-	{ PidTagRecordKey,                                                    "PidTagRecordKey" },
-	{ PidTagReferredByName,                                               "PidTagReferredByName" },
-	{ PidTagRemindersOnlineEntryId,                                       "PidTagRemindersOnlineEntryId" },
-	{ PidTagRemoteMessageTransferAgent,                                   "PidTagRemoteMessageTransferAgent" },
-	{ PidTagRenderingPosition,                                            "PidTagRenderingPosition" },
-	{ PidTagReplyRecipientEntries,                                        "PidTagReplyRecipientEntries" },
-	{ PidTagReplyRecipientNames,                                          "PidTagReplyRecipientNames" },
-	{ PidTagReplyRequested,                                               "PidTagReplyRequested" },
+	{ PidTagRecipientFlags,                                               "PidTagRecipientFlags" },
+	{ PidTagRecipientTrackStatus,                                         "PidTagRecipientTrackStatus" },
+	{ PidTagJunkIncludeContacts,                                          "PidTagJunkIncludeContacts" },
+	{ PidTagJunkThreshold,                                                "PidTagJunkThreshold" },
+	{ PidTagJunkPermanentlyDelete,                                        "PidTagJunkPermanentlyDelete" },
+	{ PidTagJunkAddRecipientsToSafeSendersList,                           "PidTagJunkAddRecipientsToSafeSendersList" },
+	{ PidTagJunkPhishingEnableLinks,                                      "PidTagJunkPhishingEnableLinks" },
+	{ PidTagMimeSkeleton,                                                 "PidTagMimeSkeleton" },
 	{ PidTagReplyTemplateId,                                              "PidTagReplyTemplateId" },
-	{ PidTagReplyTime,                                                    "PidTagReplyTime" },
-	{ PidTagReportDisposition,                                            "PidTagReportDisposition" },
-	{ PidTagReportDispositionMode,                                        "PidTagReportDispositionMode" },
-	{ PidTagReportEntryId,                                                "PidTagReportEntryId" },
-	{ PidTagReportName,                                                   "PidTagReportName" },
-	{ PidTagReportSearchKey,                                              "PidTagReportSearchKey" },
-	{ PidTagReportTag,                                                    "PidTagReportTag" },
-	{ PidTagReportText,                                                   "PidTagReportText" },
-	{ PidTagReportTime,                                                   "PidTagReportTime" },
-	{ PidTagReportingMessageTransferAgent,                                "PidTagReportingMessageTransferAgent" },
-	{ PidTagResolveMethod,                                                "PidTagResolveMethod" },
-	{ PidTagResponseRequested,                                            "PidTagResponseRequested" },
-	{ PidTagResponsibility,                                               "PidTagResponsibility" },
-	{ PidTagRetentionDate,                                                "PidTagRetentionDate" },
-	{ PidTagRetentionFlags,                                               "PidTagRetentionFlags" },
-	{ PidTagRetentionPeriod,                                              "PidTagRetentionPeriod" },
+	{ PidTagSourceKey,                                                    "PidTagSourceKey" },
+	{ PidTagParentSourceKey,                                              "PidTagParentSourceKey" },
+	{ PidTagChangeKey,                                                    "PidTagChangeKey" },
+	{ PidTagPredecessorChangeList,                                        "PidTagPredecessorChangeList" },
+	{ PidTagRuleMessageState,                                             "PidTagRuleMessageState" },
+	{ PidTagRuleMessageUserFlags,                                         "PidTagRuleMessageUserFlags" },
+	{ PidTagRuleMessageProvider,                                          "PidTagRuleMessageProvider" },
+	{ PidTagRuleMessageName,                                              "PidTagRuleMessageName" },
+	{ PidTagRuleMessageLevel,                                             "PidTagRuleMessageLevel" },
+	{ PidTagRuleMessageProviderData,                                      "PidTagRuleMessageProviderData" },
+	{ PidTagRuleMessageSequence,                                          "PidTagRuleMessageSequence" },
+	{ PidTagUserEntryId,                                                  "PidTagUserEntryId" },
+	{ PidTagMailboxOwnerEntryId,                                          "PidTagMailboxOwnerEntryId" },
+	{ PidTagMailboxOwnerName,                                             "PidTagMailboxOwnerName" },
+	{ PidTagOutOfOfficeState,                                             "PidTagOutOfOfficeState" },
+	{ PidTagSchedulePlusFreeBusyEntryId,                                  "PidTagSchedulePlusFreeBusyEntryId" },
 	{ PidTagRights,                                                       "PidTagRights" },
-	{ PidTagRoamingDatatypes,                                             "PidTagRoamingDatatypes" },
-	{ PidTagRoamingDictionary,                                            "PidTagRoamingDictionary" },
-	{ PidTagRoamingXmlStream,                                             "PidTagRoamingXmlStream" },
-	{ PidTagRowType,                                                      "PidTagRowType" },
-	{ PidTagRowid,                                                        "PidTagRowid" },
-	{ PidTagRtfCompressed,                                                "PidTagRtfCompressed" },
-	{ PidTagRtfInSync,                                                    "PidTagRtfInSync" },
-	{ PidTagRuleActionNumber,                                             "PidTagRuleActionNumber" },
-	{ PidTagRuleActionType,                                               "PidTagRuleActionType" },
-	{ PidTagRuleActions,                                                  "PidTagRuleActions" },
-	{ PidTagRuleCondition,                                                "PidTagRuleCondition" },
+	{ PidTagHasRules,                                                     "PidTagHasRules" },
+	{ PidTagAddressBookEntryId,                                           "PidTagAddressBookEntryId" },
+	{ PidTagHierarchyChangeNumber,                                        "PidTagHierarchyChangeNumber" },
+	{ PidTagClientActions,                                                "PidTagClientActions" },
+	{ PidTagDamOriginalEntryId,                                           "PidTagDamOriginalEntryId" },
+	{ PidTagDamBackPatched,                                               "PidTagDamBackPatched" },
 	{ PidTagRuleError,                                                    "PidTagRuleError" },
+	{ PidTagRuleActionType,                                               "PidTagRuleActionType" },
+	{ PidTagHasNamedProperties,                                           "PidTagHasNamedProperties" },
+	{ PidTagRuleActionNumber,                                             "PidTagRuleActionNumber" },
 	{ PidTagRuleFolderEntryId,                                            "PidTagRuleFolderEntryId" },
+	{ PidTagProhibitReceiveQuota,                                         "PidTagProhibitReceiveQuota" },
+	{ PidTagInConflict,                                                   "PidTagInConflict" },
+	{ PidTagMaximumSubmitMessageSize,                                     "PidTagMaximumSubmitMessageSize" },
+	{ PidTagProhibitSendQuota,                                            "PidTagProhibitSendQuota" },
+	{ PidTagMemberId,                                                     "PidTagMemberId" },
+	{ PidTagMemberName,                                                   "PidTagMemberName" },
+	{ PidTagMemberRights,                                                 "PidTagMemberRights" },
 	{ PidTagRuleId,                                                       "PidTagRuleId" },
 	{ PidTagRuleIds,                                                      "PidTagRuleIds" },
-	{ PidTagRuleLevel,                                                    "PidTagRuleLevel" },
-	{ PidTagRuleMessageLevel,                                             "PidTagRuleMessageLevel" },
-	{ PidTagRuleMessageName,                                              "PidTagRuleMessageName" },
-	{ PidTagRuleMessageProvider,                                          "PidTagRuleMessageProvider" },
-	{ PidTagRuleMessageProviderData,                                      "PidTagRuleMessageProviderData" },
-	{ PidTagRuleMessageSequence,                                          "PidTagRuleMessageSequence" },
-	{ PidTagRuleMessageState,                                             "PidTagRuleMessageState" },
-	{ PidTagRuleMessageUserFlags,                                         "PidTagRuleMessageUserFlags" },
-	{ PidTagRuleName,                                                     "PidTagRuleName" },
-	{ PidTagRuleProvider,                                                 "PidTagRuleProvider" },
-	{ PidTagRuleProviderData,                                             "PidTagRuleProviderData" },
 	{ PidTagRuleSequence,                                                 "PidTagRuleSequence" },
 	{ PidTagRuleState,                                                    "PidTagRuleState" },
 	{ PidTagRuleUserFlags,                                                "PidTagRuleUserFlags" },
+	{ PidTagRuleCondition,                                                "PidTagRuleCondition" },
+	{ PidTagRuleActions,                                                  "PidTagRuleActions" },
+	{ PidTagRuleProvider,                                                 "PidTagRuleProvider" },
+	{ PidTagRuleName,                                                     "PidTagRuleName" },
+	{ PidTagRuleLevel,                                                    "PidTagRuleLevel" },
+	{ PidTagRuleProviderData,                                             "PidTagRuleProviderData" },
+	{ PidTagDeletedOn,                                                    "PidTagDeletedOn" },
+	{ PidTagLocaleId,                                                     "PidTagLocaleId" },
+	{ PidTagCodePageId,                                                   "PidTagCodePageId" },
+	{ PidTagAddressBookManageDistributionList,                            "PidTagAddressBookManageDistributionList" },
+	{ PidTagSortLocaleId,                                                 "PidTagSortLocaleId" },
+	{ PidTagLocalCommitTime,                                              "PidTagLocalCommitTime" },
+	{ PidTagLocalCommitTimeMax,                                           "PidTagLocalCommitTimeMax" },
+	{ PidTagDeletedCountTotal,                                            "PidTagDeletedCountTotal" },
+	{ PidTagFlatUrlName,                                                  "PidTagFlatUrlName" },
+	{ PidTagSentMailSvrEID,                                               "PidTagSentMailSvrEID" },
+	{ PidTagDeferredActionMessageOriginalEntryId,                         "PidTagDeferredActionMessageOriginalEntryId" },
+	{ PidTagFolderId,                                                     "PidTagFolderId" },
+	{ PidTagParentFolderId,                                               "PidTagParentFolderId" },
+	{ PidTagMid,                                                          "PidTagMid" },
+	{ PidTagInstID,                                                       "PidTagInstID" },
+	{ PidTagInstanceNum,                                                  "PidTagInstanceNum" },
+	{ PidTagAddressBookMessageId,                                         "PidTagAddressBookMessageId" },
+	{ PidTagChangeNumber,                                                 "PidTagChangeNumber" },
+	{ PidTagAssociated,                                                   "PidTagAssociated" },
+	{ PidTagOfflineAddressBookName,                                       "PidTagOfflineAddressBookName" },
+	{ PidTagOfflineAddressBookSequence,                                   "PidTagOfflineAddressBookSequence" },
+	{ PidTagOfflineAddressBookContainerGuid,                              "PidTagOfflineAddressBookContainerGuid" },
+	{ PidTagSenderTelephoneNumber,                                        "PidTagSenderTelephoneNumber" },
 	{ PidTagRwRulesStream,                                                "PidTagRwRulesStream" },
-	{ PidTagScheduleInfoAppointmentTombstone,                             "PidTagScheduleInfoAppointmentTombstone" },
-	{ PidTagScheduleInfoAutoAcceptAppointments,                           "PidTagScheduleInfoAutoAcceptAppointments" },
-	{ PidTagScheduleInfoDelegateEntryIds,                                 "PidTagScheduleInfoDelegateEntryIds" },
-	{ PidTagScheduleInfoDelegateNames,                                    "PidTagScheduleInfoDelegateNames" },
-	{ PidTagScheduleInfoDelegateNamesW,                                   "PidTagScheduleInfoDelegateNamesW" },
-	{ PidTagScheduleInfoDelegatorWantsCopy,                               "PidTagScheduleInfoDelegatorWantsCopy" },
-	{ PidTagScheduleInfoDelegatorWantsInfo,                               "PidTagScheduleInfoDelegatorWantsInfo" },
-	{ PidTagScheduleInfoDisallowOverlappingAppts,                         "PidTagScheduleInfoDisallowOverlappingAppts" },
-	{ PidTagScheduleInfoDisallowRecurringAppts,                           "PidTagScheduleInfoDisallowRecurringAppts" },
-	{ PidTagScheduleInfoDontMailDelegates,                                "PidTagScheduleInfoDontMailDelegates" },
-	{ PidTagScheduleInfoFreeBusy,                                         "PidTagScheduleInfoFreeBusy" },
-	{ PidTagScheduleInfoFreeBusyAway,                                     "PidTagScheduleInfoFreeBusyAway" },
-	{ PidTagScheduleInfoFreeBusyBusy,                                     "PidTagScheduleInfoFreeBusyBusy" },
-	{ PidTagScheduleInfoFreeBusyMerged,                                   "PidTagScheduleInfoFreeBusyMerged" },
-	{ PidTagScheduleInfoFreeBusyTentative,                                "PidTagScheduleInfoFreeBusyTentative" },
-	{ PidTagScheduleInfoMonthsAway,                                       "PidTagScheduleInfoMonthsAway" },
-	{ PidTagScheduleInfoMonthsBusy,                                       "PidTagScheduleInfoMonthsBusy" },
-	{ PidTagScheduleInfoMonthsMerged,                                     "PidTagScheduleInfoMonthsMerged" },
-	{ PidTagScheduleInfoMonthsTentative,                                  "PidTagScheduleInfoMonthsTentative" },
-	{ PidTagScheduleInfoResourceType,                                     "PidTagScheduleInfoResourceType" },
-	{ PidTagSchedulePlusFreeBusyEntryId,                                  "PidTagSchedulePlusFreeBusyEntryId" },
-	{ PidTagScriptData,                                                   "PidTagScriptData" },
-	{ PidTagSearchFolderDefinition,                                       "PidTagSearchFolderDefinition" },
+	{ PidTagOfflineAddressBookMessageClass,                               "PidTagOfflineAddressBookMessageClass" },
+	{ PidTagVoiceMessageSenderName,                                       "PidTagVoiceMessageSenderName" },
+	{ PidTagFaxNumberOfPages,                                             "PidTagFaxNumberOfPages" },
+	{ PidTagOfflineAddressBookDistinguishedName,                          "PidTagOfflineAddressBookDistinguishedName" },
+	{ PidTagVoiceMessageAttachmentOrder,                                  "PidTagVoiceMessageAttachmentOrder" },
+	{ PidTagOfflineAddressBookTruncatedProperties,                        "PidTagOfflineAddressBookTruncatedProperties" },
+	{ PidTagCallId,                                                       "PidTagCallId" },
+	{ PidTagReportingMessageTransferAgent,                                "PidTagReportingMessageTransferAgent" },
+	{ PidTagSearchFolderLastUsed,                                         "PidTagSearchFolderLastUsed" },
 	{ PidTagSearchFolderExpiration,                                       "PidTagSearchFolderExpiration" },
+	{ PidTagScheduleInfoResourceType,                                     "PidTagScheduleInfoResourceType" },
+	{ PidTagScheduleInfoDelegatorWantsCopy,                               "PidTagScheduleInfoDelegatorWantsCopy" },
+	{ PidTagWlinkGroupHeaderID,                                           "PidTagWlinkGroupHeaderID" },
 	{ PidTagSearchFolderId,                                               "PidTagSearchFolderId" },
-	{ PidTagSearchFolderLastUsed,                                         "PidTagSearchFolderLastUsed" },
+	{ PidTagScheduleInfoDontMailDelegates,                                "PidTagScheduleInfoDontMailDelegates" },
 	{ PidTagSearchFolderRecreateInfo,                                     "PidTagSearchFolderRecreateInfo" },
+	{ PidTagScheduleInfoDelegateNames,                                    "PidTagScheduleInfoDelegateNames" },
+	{ PidTagSearchFolderDefinition,                                       "PidTagSearchFolderDefinition" },
+	{ PidTagScheduleInfoDelegateEntryIds,                                 "PidTagScheduleInfoDelegateEntryIds" },
 	{ PidTagSearchFolderStorageType,                                      "PidTagSearchFolderStorageType" },
-	{ PidTagSearchKey,                                                    "PidTagSearchKey" },
-	{ PidTagSecurityDescriptorAsXml,                                      "PidTagSecurityDescriptorAsXml" },
-	{ PidTagSelectable,                                                   "PidTagSelectable" },
-	{ PidTagSendInternetEncoding,                                         "PidTagSendInternetEncoding" },
-	{ PidTagSendRichInfo,                                                 "PidTagSendRichInfo" },
-	{ PidTagSenderAddressType,                                            "PidTagSenderAddressType" },
-	{ PidTagSenderEmailAddress,                                           "PidTagSenderEmailAddress" },
-	{ PidTagSenderEntryId,                                                "PidTagSenderEntryId" },
-	{ PidTagSenderIdStatus,                                               "PidTagSenderIdStatus" },
-	{ PidTagSenderName,                                                   "PidTagSenderName" },
-	{ PidTagSenderSearchKey,                                              "PidTagSenderSearchKey" },
-	{ PidTagSenderSmtpAddress,                                            "PidTagSenderSmtpAddress" },
-	{ PidTagSenderTelephoneNumber,                                        "PidTagSenderTelephoneNumber" },
-	{ PidTagSensitivity,                                                  "PidTagSensitivity" },
-	{ PidTagSentMailSvrEID,                                               "PidTagSentMailSvrEID" },
-	{ PidTagSentRepresentingAddressType,                                  "PidTagSentRepresentingAddressType" },
-	{ PidTagSentRepresentingEmailAddress,                                 "PidTagSentRepresentingEmailAddress" },
-	{ PidTagSentRepresentingEntryId,                                      "PidTagSentRepresentingEntryId" },
-	{ PidTagSentRepresentingFlags,                                        "PidTagSentRepresentingFlags" },
-	{ PidTagSentRepresentingName,                                         "PidTagSentRepresentingName" },
-	{ PidTagSentRepresentingSearchKey,                                    "PidTagSentRepresentingSearchKey" },
-	{ PidTagSentRepresentingSmtpAddress,                                  "PidTagSentRepresentingSmtpAddress" },
-	{ PidTagSmtpAddress,                                                  "PidTagSmtpAddress" },
-	{ PidTagSortLocaleId,                                                 "PidTagSortLocaleId" },
-	{ PidTagSourceKey,                                                    "PidTagSourceKey" },
-	{ PidTagSpokenName,                                                   "PidTagSpokenName" },
-	{ PidTagSpouseName,                                                   "PidTagSpouseName" },
-	{ PidTagStartDate,                                                    "PidTagStartDate" },
-	{ PidTagStartDateEtc,                                                 "PidTagStartDateEtc" },
-	{ PidTagStateOrProvince,                                              "PidTagStateOrProvince" },
-	{ PidTagStoreEntryId,                                                 "PidTagStoreEntryId" },
-	{ PidTagStoreState,                                                   "PidTagStoreState" },
-	{ PidTagStoreSupportMask,                                             "PidTagStoreSupportMask" },
-	{ PidTagStreetAddress,                                                "PidTagStreetAddress" },
-	{ PidTagSubfolders,                                                   "PidTagSubfolders" },
-	{ PidTagSubject,                                                      "PidTagSubject" },
-	{ PidTagSubjectPrefix,                                                "PidTagSubjectPrefix" },
-	{ PidTagSupplementaryInfo,                                            "PidTagSupplementaryInfo" },
-	{ PidTagSurname,                                                      "PidTagSurname" },
-	{ PidTagSwappedToDoData,                                              "PidTagSwappedToDoData" },
-	{ PidTagSwappedToDoStore,                                             "PidTagSwappedToDoStore" },
-	{ PidTagTargetEntryId,                                                "PidTagTargetEntryId" },
-	{ PidTagTelecommunicationsDeviceForDeafTelephoneNumber,               "PidTagTelecommunicationsDeviceForDeafTelephoneNumber" },
-	{ PidTagTelexNumber,                                                  "PidTagTelexNumber" },
-	{ PidTagTemplateData,                                                 "PidTagTemplateData" },
-	{ PidTagTemplateid,                                                   "PidTagTemplateid" },
-	{ PidTagTextAttachmentCharset,                                        "PidTagTextAttachmentCharset" },
-	{ PidTagThumbnailPhoto,                                               "PidTagThumbnailPhoto" },
-	{ PidTagTitle,                                                        "PidTagTitle" },
-	{ PidTagTnefCorrelationKey,                                           "PidTagTnefCorrelationKey" },
-	{ PidTagToDoItemFlags,                                                "PidTagToDoItemFlags" },
-	{ PidTagTransmittableDisplayName,                                     "PidTagTransmittableDisplayName" },
-	{ PidTagTransportMessageHeaders,                                      "PidTagTransportMessageHeaders" },
-	{ PidTagTrustSender,                                                  "PidTagTrustSender" },
-	{ PidTagUserCertificate,                                              "PidTagUserCertificate" },
-	{ PidTagUserEntryId,                                                  "PidTagUserEntryId" },
-	{ PidTagUserX509Certificate,                                          "PidTagUserX509Certificate" },
-	{ PidTagViewDescriptorBinary,                                         "PidTagViewDescriptorBinary" },
-	{ PidTagViewDescriptorName,                                           "PidTagViewDescriptorName" },
-	{ PidTagViewDescriptorStrings,                                        "PidTagViewDescriptorStrings" },
-	{ PidTagViewDescriptorVersion,                                        "PidTagViewDescriptorVersion" },
-	{ PidTagVoiceMessageAttachmentOrder,                                  "PidTagVoiceMessageAttachmentOrder" },
-	{ PidTagVoiceMessageSenderName,                                       "PidTagVoiceMessageSenderName" },
-	{ PidTagWeddingAnniversary,                                           "PidTagWeddingAnniversary" },
-	{ PidTagWlinkAddressBookEID,                                          "PidTagWlinkAddressBookEID" },
-	{ PidTagWlinkAddressBookStoreEID,                                     "PidTagWlinkAddressBookStoreEID" },
-	{ PidTagWlinkCalendarColor,                                           "PidTagWlinkCalendarColor" },
-	{ PidTagWlinkClientID,                                                "PidTagWlinkClientID" },
-	{ PidTagWlinkEntryId,                                                 "PidTagWlinkEntryId" },
+	{ PidTagGatewayNeedsToRefresh,                                        "PidTagGatewayNeedsToRefresh" },
+	{ PidTagFreeBusyPublishStart,                                         "PidTagFreeBusyPublishStart" },
+	{ PidTagFreeBusyPublishEnd,                                           "PidTagFreeBusyPublishEnd" },
+	{ PidTagWlinkType,                                                    "PidTagWlinkType" },
+	{ PidTagFreeBusyMessageEmailAddress,                                  "PidTagFreeBusyMessageEmailAddress" },
 	{ PidTagWlinkFlags,                                                   "PidTagWlinkFlags" },
+	{ PidTagScheduleInfoDelegateNamesW,                                   "PidTagScheduleInfoDelegateNamesW" },
+	{ PidTagScheduleInfoDelegatorWantsInfo,                               "PidTagScheduleInfoDelegatorWantsInfo" },
+	{ PidTagWlinkOrdinal,                                                 "PidTagWlinkOrdinal" },
+	{ PidTagWlinkEntryId,                                                 "PidTagWlinkEntryId" },
+	{ PidTagWlinkRecordKey,                                               "PidTagWlinkRecordKey" },
+	{ PidTagWlinkStoreEntryId,                                            "PidTagWlinkStoreEntryId" },
 	{ PidTagWlinkFolderType,                                              "PidTagWlinkFolderType" },
+	{ PidTagScheduleInfoMonthsMerged,                                     "PidTagScheduleInfoMonthsMerged" },
 	{ PidTagWlinkGroupClsid,                                              "PidTagWlinkGroupClsid" },
-	{ PidTagWlinkGroupHeaderID,                                           "PidTagWlinkGroupHeaderID" },
+	{ PidTagScheduleInfoFreeBusyMerged,                                   "PidTagScheduleInfoFreeBusyMerged" },
 	{ PidTagWlinkGroupName,                                               "PidTagWlinkGroupName" },
-	{ PidTagWlinkOrdinal,                                                 "PidTagWlinkOrdinal" },
-	{ PidTagWlinkROGroupType,                                             "PidTagWlinkROGroupType" },
-	{ PidTagWlinkRecordKey,                                               "PidTagWlinkRecordKey" },
+	{ PidTagScheduleInfoMonthsTentative,                                  "PidTagScheduleInfoMonthsTentative" },
 	{ PidTagWlinkSection,                                                 "PidTagWlinkSection" },
-	{ PidTagWlinkStoreEntryId,                                            "PidTagWlinkStoreEntryId" },
-	{ PidTagWlinkType,                                                    "PidTagWlinkType" },
+	{ PidTagScheduleInfoFreeBusyTentative,                                "PidTagScheduleInfoFreeBusyTentative" },
+	{ PidTagWlinkCalendarColor,                                           "PidTagWlinkCalendarColor" },
+	{ PidTagScheduleInfoMonthsBusy,                                       "PidTagScheduleInfoMonthsBusy" },
+	{ PidTagWlinkAddressBookEID,                                          "PidTagWlinkAddressBookEID" },
+	{ PidTagScheduleInfoFreeBusyBusy,                                     "PidTagScheduleInfoFreeBusyBusy" },
+	{ PidTagScheduleInfoMonthsAway,                                       "PidTagScheduleInfoMonthsAway" },
+	{ PidTagScheduleInfoFreeBusyAway,                                     "PidTagScheduleInfoFreeBusyAway" },
+	{ PidTagFreeBusyRangeTimestamp,                                       "PidTagFreeBusyRangeTimestamp" },
+	{ PidTagFreeBusyCountMonths,                                          "PidTagFreeBusyCountMonths" },
+	{ PidTagScheduleInfoAppointmentTombstone,                             "PidTagScheduleInfoAppointmentTombstone" },
+	{ PidTagDelegateFlags,                                                "PidTagDelegateFlags" },
+	{ PidTagScheduleInfoFreeBusy,                                         "PidTagScheduleInfoFreeBusy" },
+	{ PidTagScheduleInfoAutoAcceptAppointments,                           "PidTagScheduleInfoAutoAcceptAppointments" },
+	{ PidTagScheduleInfoDisallowRecurringAppts,                           "PidTagScheduleInfoDisallowRecurringAppts" },
+	{ PidTagScheduleInfoDisallowOverlappingAppts,                         "PidTagScheduleInfoDisallowOverlappingAppts" },
+	{ PidTagWlinkClientID,                                                "PidTagWlinkClientID" },
+	{ PidTagWlinkAddressBookStoreEID,                                     "PidTagWlinkAddressBookStoreEID" },
+	{ PidTagWlinkROGroupType,                                             "PidTagWlinkROGroupType" },
+	{ PidTagViewDescriptorBinary,                                         "PidTagViewDescriptorBinary" },
+	{ PidTagViewDescriptorStrings,                                        "PidTagViewDescriptorStrings" },
+	{ PidTagViewDescriptorName,                                           "PidTagViewDescriptorName" },
+	{ PidTagViewDescriptorVersion,                                        "PidTagViewDescriptorVersion" },
+	{ PidTagRoamingDatatypes,                                             "PidTagRoamingDatatypes" },
+	{ PidTagRoamingDictionary,                                            "PidTagRoamingDictionary" },
+	{ PidTagRoamingXmlStream,                                             "PidTagRoamingXmlStream" },
+	{ PidTagOscSyncEnabled,                                               "PidTagOscSyncEnabled" },
+	{ PidTagProcessed,                                                    "PidTagProcessed" },
+	{ PidTagExceptionReplaceTime,                                         "PidTagExceptionReplaceTime" },
+	{ PidTagAttachmentLinkId,                                             "PidTagAttachmentLinkId" },
+	{ PidTagExceptionStartTime,                                           "PidTagExceptionStartTime" },
+	{ PidTagExceptionEndTime,                                             "PidTagExceptionEndTime" },
+	{ PidTagAttachmentFlags,                                              "PidTagAttachmentFlags" },
+	{ PidTagAttachmentHidden,                                             "PidTagAttachmentHidden" },
+	{ PidTagAttachmentContactPhoto,                                       "PidTagAttachmentContactPhoto" },
+	{ PidTagAddressBookFolderPathname,                                    "PidTagAddressBookFolderPathname" },
+	{ PidTagAddressBookManager,                                           "PidTagAddressBookManager" },
+	{ PidTagAddressBookManagerDistinguishedName,                          "PidTagAddressBookManagerDistinguishedName" },
+	{ PidTagAddressBookHomeMessageDatabase,                               "PidTagAddressBookHomeMessageDatabase" },
+	{ PidTagAddressBookIsMemberOfDistributionList,                        "PidTagAddressBookIsMemberOfDistributionList" },
+	{ PidTagAddressBookMember,                                            "PidTagAddressBookMember" },
+	{ PidTagAddressBookOwner,                                             "PidTagAddressBookOwner" },
+	{ PidTagAddressBookReports,                                           "PidTagAddressBookReports" },
+	{ PidTagAddressBookProxyAddresses,                                    "PidTagAddressBookProxyAddresses" },
+	{ PidTagAddressBookTargetAddress,                                     "PidTagAddressBookTargetAddress" },
+	{ PidTagAddressBookPublicDelegates,                                   "PidTagAddressBookPublicDelegates" },
+	{ PidTagAddressBookOwnerBackLink,                                     "PidTagAddressBookOwnerBackLink" },
+	{ PidTagAddressBookExtensionAttribute1,                               "PidTagAddressBookExtensionAttribute1" },
+	{ PidTagAddressBookExtensionAttribute2,                               "PidTagAddressBookExtensionAttribute2" },
+	{ PidTagAddressBookExtensionAttribute3,                               "PidTagAddressBookExtensionAttribute3" },
+	{ PidTagAddressBookExtensionAttribute4,                               "PidTagAddressBookExtensionAttribute4" },
+	{ PidTagAddressBookExtensionAttribute5,                               "PidTagAddressBookExtensionAttribute5" },
+	{ PidTagAddressBookExtensionAttribute6,                               "PidTagAddressBookExtensionAttribute6" },
+	{ PidTagAddressBookExtensionAttribute7,                               "PidTagAddressBookExtensionAttribute7" },
+	{ PidTagAddressBookExtensionAttribute8,                               "PidTagAddressBookExtensionAttribute8" },
+	{ PidTagAddressBookExtensionAttribute9,                               "PidTagAddressBookExtensionAttribute9" },
+	{ PidTagAddressBookExtensionAttribute10,                              "PidTagAddressBookExtensionAttribute10" },
+	{ PidTagAddressBookObjectDistinguishedName,                           "PidTagAddressBookObjectDistinguishedName" },
+	{ PidTagAddressBookDeliveryContentLength,                             "PidTagAddressBookDeliveryContentLength" },
+	{ PidTagAddressBookDistributionListMemberSubmitAccepted,              "PidTagAddressBookDistributionListMemberSubmitAccepted" },
+	{ PidTagAddressBookNetworkAddress,                                    "PidTagAddressBookNetworkAddress" },
+	{ PidTagAddressBookExtensionAttribute11,                              "PidTagAddressBookExtensionAttribute11" },
+	{ PidTagAddressBookExtensionAttribute12,                              "PidTagAddressBookExtensionAttribute12" },
+	{ PidTagAddressBookExtensionAttribute13,                              "PidTagAddressBookExtensionAttribute13" },
+	{ PidTagAddressBookExtensionAttribute14,                              "PidTagAddressBookExtensionAttribute14" },
+	{ PidTagAddressBookExtensionAttribute15,                              "PidTagAddressBookExtensionAttribute15" },
+	{ PidTagAddressBookX509Certificate,                                   "PidTagAddressBookX509Certificate" },
+	{ PidTagAddressBookObjectGuid,                                        "PidTagAddressBookObjectGuid" },
+	{ PidTagAddressBookPhoneticGivenName,                                 "PidTagAddressBookPhoneticGivenName" },
+	{ PidTagAddressBookPhoneticSurname,                                   "PidTagAddressBookPhoneticSurname" },
+	{ PidTagAddressBookPhoneticDepartmentName,                            "PidTagAddressBookPhoneticDepartmentName" },
+	{ PidTagAddressBookPhoneticCompanyName,                               "PidTagAddressBookPhoneticCompanyName" },
+	{ PidTagAddressBookPhoneticDisplayName,                               "PidTagAddressBookPhoneticDisplayName" },
+	{ PidTagAddressBookDisplayTypeExtended,                               "PidTagAddressBookDisplayTypeExtended" },
+	{ PidTagAddressBookHierarchicalShowInDepartments,                     "PidTagAddressBookHierarchicalShowInDepartments" },
+	{ PidTagAddressBookRoomContainers,                                    "PidTagAddressBookRoomContainers" },
+	{ PidTagAddressBookHierarchicalDepartmentMembers,                     "PidTagAddressBookHierarchicalDepartmentMembers" },
+	{ PidTagAddressBookHierarchicalRootDepartment,                        "PidTagAddressBookHierarchicalRootDepartment" },
+	{ PidTagAddressBookHierarchicalParentDepartment,                      "PidTagAddressBookHierarchicalParentDepartment" },
+	{ PidTagAddressBookHierarchicalChildDepartments,                      "PidTagAddressBookHierarchicalChildDepartments" },
+	{ PidTagThumbnailPhoto,                                               "PidTagThumbnailPhoto" },
+	{ PidTagAddressBookSeniorityIndex,                                    "PidTagAddressBookSeniorityIndex" },
+	{ PidTagAddressBookOrganizationalUnitRootDistinguishedName,           "PidTagAddressBookOrganizationalUnitRootDistinguishedName" },
+	{ PidTagAddressBookSenderHintTranslations,                            "PidTagAddressBookSenderHintTranslations" },
+	{ PidTagAddressBookModerationEnabled,                                 "PidTagAddressBookModerationEnabled" },
+	{ PidTagSpokenName,                                                   "PidTagSpokenName" },
+	{ PidTagAddressBookAuthorizedSenders,                                 "PidTagAddressBookAuthorizedSenders" },
+	{ PidTagAddressBookUnauthorizedSenders,                               "PidTagAddressBookUnauthorizedSenders" },
+	{ PidTagAddressBookDistributionListMemberSubmitRejected,              "PidTagAddressBookDistributionListMemberSubmitRejected" },
+	{ PidTagAddressBookDistributionListRejectMessagesFromDLMembers,       "PidTagAddressBookDistributionListRejectMessagesFromDLMembers" },
+	{ PidTagAddressBookHierarchicalIsHierarchicalGroup,                   "PidTagAddressBookHierarchicalIsHierarchicalGroup" },
+	{ PidTagAddressBookDistributionListMemberCount,                       "PidTagAddressBookDistributionListMemberCount" },
+	{ PidTagAddressBookDistributionListExternalMemberCount,               "PidTagAddressBookDistributionListExternalMemberCount" },
+	{ PidTagAddressBookIsMaster,                                          "PidTagAddressBookIsMaster" },
+	{ PidTagAddressBookParentEntryId,                                     "PidTagAddressBookParentEntryId" },
+	{ PidTagAddressBookContainerId,                                       "PidTagAddressBookContainerId" },
 	{ 0,                                                                   NULL         }
 };
 
+#define	PIDTAGS_COUNT	(ARRAY_SIZE(pidtags) - 1)
+
+/**
+   \details Return the LDB attribute name used to store a property
+
+   pidtags[] is sorted by property tag, so the lookup is a
+   binary search.
+
+   \param proptag the property tag to look up
+
+   \return the attribute name on success, otherwise NULL
+ */
 _PUBLIC_ const char *openchangedb_property_get_attribute(uint32_t proptag)
 {
-	uint32_t i;
-	
-	for (i = 0; pidtags[i].pidtag; i++) {
-		if (pidtags[i].proptag == proptag) {
-			return pidtags[i].pidtag;
+	uint32_t	low = 0;
+	uint32_t	high = PIDTAGS_COUNT;
+	uint32_t	middle;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (pidtags[middle].proptag == proptag) {
+			return pidtags[middle].pidtag;
+		}
+		if (pidtags[middle].proptag < proptag) {
+			low = middle + 1;
+		} else {
+			high = middle;
 		}
 	}
-	DEBUG(0, ("[%s:%d]: Unsupported property tag '0x%.8x'\n", __FUNCTION__, __LINE__, proptag));
-	
+	DEBUG(5, ("[%s:%d]: Unsupported property tag '0x%.8x'\n", __FUNCTION__, __LINE__, proptag));
+
 	return NULL;
 }
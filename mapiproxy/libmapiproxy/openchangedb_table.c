@@ -60,6 +60,7 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_init(TALLOC_CTX *mem_ctx, uint8_t ta
 	table->lpSortCriteria = NULL;
 	table->restrictions = NULL;
 	table->res = NULL;
+	table->row_status = NULL;
 
 	*table_object = (void *)table;
 
@@ -89,6 +90,7 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_set_sort_order(void *table_object,
 	if (table->res) {
 		talloc_free(table->res);
 		table->res = NULL;
+		table->row_status = NULL;
 	}
 
 	if (table->lpSortCriteria) {
@@ -112,20 +114,133 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_set_sort_order(void *table_object,
 }
 
 
+/**
+   \details Deep copy a restriction tree
+
+   Restriction types the table cannot evaluate (sub-object, comment)
+   are copied without their content and never match.
+
+   \param mem_ctx pointer to the memory context to use for allocation
+   \param dst pointer to the restriction to fill
+   \param src pointer to the restriction to copy
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+static enum MAPISTATUS openchangedb_table_copy_restriction(TALLOC_CTX *mem_ctx,
+							   struct mapi_SRestriction *dst,
+							   struct mapi_SRestriction *src)
+{
+	struct mapi_SPropValue	*lpProp = NULL;
+	uint32_t		i;
+	enum MAPISTATUS		retval;
+
+	dst->rt = src->rt;
+
+	switch (src->rt) {
+	case RES_AND:
+		dst->res.resAnd.cRes = src->res.resAnd.cRes;
+		dst->res.resAnd.res = talloc_array(mem_ctx, struct mapi_SRestriction_and, src->res.resAnd.cRes);
+		OPENCHANGE_RETVAL_IF(!dst->res.resAnd.res, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		for (i = 0; i < src->res.resAnd.cRes; i++) {
+			retval = openchangedb_table_copy_restriction(dst->res.resAnd.res,
+								     (struct mapi_SRestriction *) &dst->res.resAnd.res[i],
+								     (struct mapi_SRestriction *) &src->res.resAnd.res[i]);
+			OPENCHANGE_RETVAL_IF(retval, retval, NULL);
+		}
+		return MAPI_E_SUCCESS;
+	case RES_OR:
+		dst->res.resOr.cRes = src->res.resOr.cRes;
+		dst->res.resOr.res = talloc_array(mem_ctx, struct mapi_SRestriction_or, src->res.resOr.cRes);
+		OPENCHANGE_RETVAL_IF(!dst->res.resOr.res, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		for (i = 0; i < src->res.resOr.cRes; i++) {
+			retval = openchangedb_table_copy_restriction(dst->res.resOr.res,
+								     (struct mapi_SRestriction *) &dst->res.resOr.res[i],
+								     (struct mapi_SRestriction *) &src->res.resOr.res[i]);
+			OPENCHANGE_RETVAL_IF(retval, retval, NULL);
+		}
+		return MAPI_E_SUCCESS;
+	case RES_NOT:
+		return openchangedb_table_copy_restriction(mem_ctx,
+							   (struct mapi_SRestriction *) &dst->res.resNot.res,
+							   (struct mapi_SRestriction *) &src->res.resNot.res);
+	case RES_CONTENT:
+		dst->res.resContent.fuzzy = src->res.resContent.fuzzy;
+		dst->res.resContent.ulPropTag = src->res.resContent.ulPropTag;
+		dst->res.resContent.lpProp = src->res.resContent.lpProp;
+		lpProp = &dst->res.resContent.lpProp;
+		break;
+	case RES_PROPERTY:
+		dst->res.resProperty.relop = src->res.resProperty.relop;
+		dst->res.resProperty.ulPropTag = src->res.resProperty.ulPropTag;
+		dst->res.resProperty.lpProp = src->res.resProperty.lpProp;
+		lpProp = &dst->res.resProperty.lpProp;
+		break;
+	case RES_BITMASK:
+		dst->res.resBitmask = src->res.resBitmask;
+		return MAPI_E_SUCCESS;
+	case RES_EXIST:
+		dst->res.resExist = src->res.resExist;
+		return MAPI_E_SUCCESS;
+	default:
+		DEBUG(5, ("[%s:%d] Unsupported restriction type: 0x%x\n", __FUNCTION__, __LINE__, src->rt));
+		return MAPI_E_SUCCESS;
+	}
+
+	/* Duplicate the value the restriction compares against */
+	switch (lpProp->ulPropTag & 0xFFFF) {
+	case PT_STRING8:
+		lpProp->value.lpszA = talloc_strdup(mem_ctx, lpProp->value.lpszA);
+		OPENCHANGE_RETVAL_IF(!lpProp->value.lpszA, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		break;
+	case PT_UNICODE:
+		lpProp->value.lpszW = talloc_strdup(mem_ctx, lpProp->value.lpszW);
+		OPENCHANGE_RETVAL_IF(!lpProp->value.lpszW, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		break;
+	case PT_BINARY:
+		lpProp->value.bin.lpb = talloc_memdup(mem_ctx, lpProp->value.bin.lpb, lpProp->value.bin.cb);
+		OPENCHANGE_RETVAL_IF(lpProp->value.bin.cb && !lpProp->value.bin.lpb, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		break;
+	case PT_BOOLEAN:
+	case PT_I2:
+	case PT_LONG:
+	case PT_I8:
+	case PT_SYSTIME:
+		break;
+	default:
+		DEBUG(5, ("[%s:%d] Unsupported property type for restriction: 0x%.4x\n", __FUNCTION__, __LINE__, (lpProp->ulPropTag & 0xFFFF)));
+		lpProp->ulPropTag = (lpProp->ulPropTag & 0xFFFF0000) | PT_NULL;
+		break;
+	}
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details Set restrictions to specified openchangedb table object
+
+   The whole restriction tree is kept and evaluated against the rows
+   fetched from openchange.ldb, see openchangedb_table_match_restriction.
+
+   \param table_object pointer to the table object
+   \param res pointer to the restrictions to apply, NULL to reset them
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
 _PUBLIC_ enum MAPISTATUS openchangedb_table_set_restrictions(void *table_object,
 							     struct mapi_SRestriction *res)
 {
 	struct openchangedb_table	*table;
+	enum MAPISTATUS			retval;
 
 	/* Sanity checks */
 	MAPI_RETVAL_IF(!table_object, MAPI_E_NOT_INITIALIZED, NULL);
-	MAPI_RETVAL_IF(!res, MAPI_E_INVALID_PARAMETER, NULL);
 
 	table = (struct openchangedb_table *) table_object;
 
 	if (table->res) {
 		talloc_free(table->res);
 		table->res = NULL;
+		table->row_status = NULL;
 	}
 
 	if (table->restrictions) {
@@ -136,86 +251,284 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_set_restrictions(void *table_object,
 	MAPI_RETVAL_IF(!res, MAPI_E_SUCCESS, NULL);
 
 	table->restrictions = talloc_zero((TALLOC_CTX *)table_object, struct mapi_SRestriction);
+	MAPI_RETVAL_IF(!table->restrictions, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
 
-	switch (res->rt) {
-	case RES_PROPERTY:
-		table->restrictions->rt = res->rt;
-		table->restrictions->res.resProperty.relop = res->res.resProperty.relop;
-		table->restrictions->res.resProperty.ulPropTag = res->res.resProperty.ulPropTag;
-		table->restrictions->res.resProperty.lpProp.ulPropTag = res->res.resProperty.lpProp.ulPropTag;
+	retval = openchangedb_table_copy_restriction(table->restrictions, table->restrictions, res);
+	if (retval) {
+		talloc_free(table->restrictions);
+		table->restrictions = NULL;
+	}
 
-		switch (table->restrictions->res.resProperty.lpProp.ulPropTag & 0xFFFF) {
+	return retval;
+}
+
+/**
+   \details Compare a row value with the value of a property restriction
+
+   \return -1, 0 or 1 as the row value is lower, equal or greater than
+   the restriction value, 2 if both cannot be compared
+ */
+static int openchangedb_table_compare_value(struct ldb_message *msg, const char *PidTagAttr,
+					    uint32_t proptag, struct mapi_SPropValue *lpProp)
+{
+	TALLOC_CTX	*local_mem_ctx;
+	const char	*str;
+	const char	*ref = NULL;
+	struct Binary_r	*bin;
+	uint64_t	value;
+	uint64_t	ref_value;
+	int		cmp;
+
+	switch (proptag & 0xFFFF) {
+	case PT_STRING8:
+	case PT_UNICODE:
+		switch (lpProp->ulPropTag & 0xFFFF) {
 		case PT_STRING8:
-			table->restrictions->res.resProperty.lpProp.value.lpszA = talloc_strdup((TALLOC_CTX *)table->restrictions, res->res.resProperty.lpProp.value.lpszA);
+			ref = lpProp->value.lpszA;
 			break;
 		case PT_UNICODE:
-			table->restrictions->res.resProperty.lpProp.value.lpszW = talloc_strdup((TALLOC_CTX *)table->restrictions, res->res.resProperty.lpProp.value.lpszW);
-			break;
-		default:
-			DEBUG(0, ("Unsupported property type for RES_PROPERTY restriction\n"));
+			ref = lpProp->value.lpszW;
 			break;
 		}
+		if (!ref) return 2;
+
+		local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+		str = openchangedb_get_property_data_message(local_mem_ctx, msg, proptag, PidTagAttr);
+		cmp = str ? strcmp(str, ref) : 2;
+		talloc_free(local_mem_ctx);
+		if (cmp == 2) return 2;
+		return (cmp > 0) - (cmp < 0);
+	case PT_BINARY:
+		if ((lpProp->ulPropTag & 0xFFFF) != PT_BINARY) return 2;
+
+		local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+		bin = openchangedb_get_property_data_message(local_mem_ctx, msg, proptag, PidTagAttr);
+		if (!bin) {
+			talloc_free(local_mem_ctx);
+			return 2;
+		}
+		cmp = memcmp(bin->lpb, lpProp->value.bin.lpb, MIN(bin->cb, lpProp->value.bin.cb));
+		if (cmp == 0) {
+			cmp = (int)bin->cb - (int)lpProp->value.bin.cb;
+		}
+		talloc_free(local_mem_ctx);
+		return (cmp > 0) - (cmp < 0);
+	case PT_BOOLEAN:
+		value = ldb_msg_find_attr_as_bool(msg, PidTagAttr, 0x0) ? 1 : 0;
+		break;
+	case PT_I2:
+	case PT_LONG:
+		value = ldb_msg_find_attr_as_uint(msg, PidTagAttr, 0x0);
+		break;
+	case PT_I8:
+	case PT_SYSTIME:
+		value = ldb_msg_find_attr_as_uint64(msg, PidTagAttr, 0x0);
 		break;
 	default:
-		DEBUG(0, ("Unsupported restriction type: 0x%x\n", res->rt));
+		return 2;
 	}
 
-	return MAPI_E_SUCCESS;
+	switch (lpProp->ulPropTag & 0xFFFF) {
+	case PT_BOOLEAN:
+		ref_value = lpProp->value.b ? 1 : 0;
+		break;
+	case PT_I2:
+		ref_value = lpProp->value.i;
+		break;
+	case PT_LONG:
+		ref_value = lpProp->value.l;
+		break;
+	case PT_I8:
+		ref_value = lpProp->value.d;
+		break;
+	case PT_SYSTIME:
+		ref_value = ((uint64_t) lpProp->value.ft.dwHighDateTime << 32) | lpProp->value.ft.dwLowDateTime;
+		break;
+	default:
+		return 2;
+	}
+
+	return (value > ref_value) - (value < ref_value);
 }
 
-static char *openchangedb_table_build_filter(TALLOC_CTX *mem_ctx, struct openchangedb_table *table, uint64_t row_fmid, struct mapi_SRestriction *restrictions)
+/**
+   \details Check whether a content restriction matches a row
+ */
+static bool openchangedb_table_match_content(struct ldb_message *msg, const char *PidTagAttr,
+					     struct mapi_SContentRestriction *resContent)
 {
-	char		*filter = NULL;
-	const char	*PidTagAttr = NULL;
-
-	switch (table->table_type) {
-	case 0x3 /* EMSMDBP_TABLE_FAI_TYPE */:
-		filter = talloc_asprintf(mem_ctx, "(&(objectClass=faiMessage)(PidTagParentFolderId=%"PRIu64")(PidTagMessageId=", table->folderID);
+	TALLOC_CTX	*local_mem_ctx;
+	const char	*str;
+	const char	*ref = NULL;
+	size_t		len;
+	bool		ignorecase;
+	bool		match = false;
+
+	switch (resContent->lpProp.ulPropTag & 0xFFFF) {
+	case PT_STRING8:
+		ref = resContent->lpProp.value.lpszA;
 		break;
-	case 0x2 /* EMSMDBP_TABLE_MESSAGE_TYPE */:
-		filter = talloc_asprintf(mem_ctx, "(&(objectClass=systemMessage)(PidTagParentFolderId=%"PRIu64")(PidTagMessageId=", table->folderID);
+	case PT_UNICODE:
+		ref = resContent->lpProp.value.lpszW;
 		break;
-	case 0x1 /* EMSMDBP_TABLE_FOLDER_TYPE */:
-		filter = talloc_asprintf(mem_ctx, "(&(PidTagParentFolderId=%"PRIu64")(PidTagFolderId=", table->folderID);
+	}
+	switch (resContent->ulPropTag & 0xFFFF) {
+	case PT_STRING8:
+	case PT_UNICODE:
 		break;
+	default:
+		ref = NULL;
+	}
+	if (!ref) return false;
+
+	local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+	str = openchangedb_get_property_data_message(local_mem_ctx, msg, resContent->ulPropTag, PidTagAttr);
+	if (str) {
+		ignorecase = (resContent->fuzzy & FL_IGNORECASE) ? true : false;
+		len = strlen(ref);
+		switch (resContent->fuzzy & 0xFFFF) {
+		case FL_SUBSTRING:
+			match = (ignorecase ? strcasestr(str, ref) : strstr(str, ref)) != NULL;
+			break;
+		case FL_PREFIX:
+			match = (ignorecase ? strncasecmp(str, ref, len) : strncmp(str, ref, len)) == 0;
+			break;
+		default:
+			match = (ignorecase ? strcasecmp(str, ref) : strcmp(str, ref)) == 0;
+			break;
+		}
 	}
+	talloc_free(local_mem_ctx);
 
-	if (row_fmid == 0) {
-		filter = talloc_asprintf_append(filter, "*)");
+	return match;
+}
+
+/**
+   \details Evaluate a restriction tree against a row fetched from
+   openchange.ldb
+
+   \param msg pointer to the LDB message holding the row
+   \param res pointer to the restriction to evaluate
+
+   \return true if the row matches the restriction, otherwise false
+ */
+static bool openchangedb_table_match_restriction(struct ldb_message *msg, struct mapi_SRestriction *res)
+{
+	const char	*PidTagAttr;
+	uint32_t	i;
+	int		cmp;
+
+	switch (res->rt) {
+	case RES_AND:
+		for (i = 0; i < res->res.resAnd.cRes; i++) {
+			if (!openchangedb_table_match_restriction(msg, (struct mapi_SRestriction *) &res->res.resAnd.res[i])) {
+				return false;
+			}
+		}
+		return true;
+	case RES_OR:
+		for (i = 0; i < res->res.resOr.cRes; i++) {
+			if (openchangedb_table_match_restriction(msg, (struct mapi_SRestriction *) &res->res.resOr.res[i])) {
+				return true;
+			}
+		}
+		return false;
+	case RES_NOT:
+		return !openchangedb_table_match_restriction(msg, (struct mapi_SRestriction *) &res->res.resNot.res);
+	case RES_CONTENT:
+		PidTagAttr = openchangedb_property_get_attribute(res->res.resContent.ulPropTag);
+		if (!PidTagAttr || !ldb_msg_find_element(msg, PidTagAttr)) return false;
+		return openchangedb_table_match_content(msg, PidTagAttr, &res->res.resContent);
+	case RES_PROPERTY:
+		PidTagAttr = openchangedb_property_get_attribute(res->res.resProperty.ulPropTag);
+		if (!PidTagAttr || !ldb_msg_find_element(msg, PidTagAttr)) return false;
+		cmp = openchangedb_table_compare_value(msg, PidTagAttr, res->res.resProperty.ulPropTag,
+						       &res->res.resProperty.lpProp);
+		if (cmp == 2) return false;
+		switch (res->res.resProperty.relop) {
+		case RELOP_LT: return cmp < 0;
+		case RELOP_LE: return cmp <= 0;
+		case RELOP_GT: return cmp > 0;
+		case RELOP_GE: return cmp >= 0;
+		case RELOP_EQ: return cmp == 0;
+		case RELOP_NE: return cmp != 0;
+		default: return false;
+		}
+	case RES_BITMASK:
+		PidTagAttr = openchangedb_property_get_attribute(res->res.resBitmask.ulPropTag);
+		if (!PidTagAttr || !ldb_msg_find_element(msg, PidTagAttr)) return false;
+		if (res->res.resBitmask.relMBR == BMR_EQZ) {
+			return (ldb_msg_find_attr_as_uint(msg, PidTagAttr, 0x0) & res->res.resBitmask.ulMask) == 0;
+		}
+		return (ldb_msg_find_attr_as_uint(msg, PidTagAttr, 0x0) & res->res.resBitmask.ulMask) != 0;
+	case RES_EXIST:
+		PidTagAttr = openchangedb_property_get_attribute(res->res.resExist.ulPropTag);
+		return (PidTagAttr && ldb_msg_find_element(msg, PidTagAttr));
+	default:
+		return false;
 	}
-	else {
-		filter = talloc_asprintf_append(filter, "%"PRIu64")", row_fmid);
+}
+
+static char *openchangedb_table_build_filter(TALLOC_CTX *mem_ctx, struct openchangedb_table *table)
+{
+	switch (table->table_type) {
+	case 0x3 /* EMSMDBP_TABLE_FAI_TYPE */:
+		return talloc_asprintf(mem_ctx, "(&(objectClass=faiMessage)(PidTagParentFolderId=%"PRIu64")(PidTagMessageId=*))", table->folderID);
+	case 0x2 /* EMSMDBP_TABLE_MESSAGE_TYPE */:
+		return talloc_asprintf(mem_ctx, "(&(objectClass=systemMessage)(PidTagParentFolderId=%"PRIu64")(PidTagMessageId=*))", table->folderID);
+	case 0x1 /* EMSMDBP_TABLE_FOLDER_TYPE */:
+		return talloc_asprintf(mem_ctx, "(&(PidTagParentFolderId=%"PRIu64")(PidTagFolderId=*))", table->folderID);
 	}
 
-	if (restrictions) {
-		switch (restrictions->rt) {
-		case RES_PROPERTY:
-			/* Retrieve PidTagName */
-			PidTagAttr = openchangedb_property_get_attribute(restrictions->res.resProperty.ulPropTag);
-			if (!PidTagAttr) {
-				talloc_free(filter);
-				return NULL;
-			}
-			filter = talloc_asprintf_append(filter, "(%s=", PidTagAttr);
-			switch (restrictions->res.resProperty.ulPropTag & 0xFFFF) {
-			case PT_STRING8:
-				filter = talloc_asprintf_append(filter, "%s)", restrictions->res.resProperty.lpProp.value.lpszA);
-				break;
-			case PT_UNICODE:
-				filter = talloc_asprintf_append(filter, "%s)", restrictions->res.resProperty.lpProp.value.lpszW);
-				break;
-			default:
-				DEBUG(0, ("Unsupported RES_PROPERTY property type: 0x%.4x\n", (restrictions->res.resProperty.ulPropTag & 0xFFFF)));
-				talloc_free(filter);
-				return NULL;
+	return NULL;
+}
+
+/**
+   \details Fetch the rows of an openchangedb table
+
+   The LDB search only selects the children of the folder. Restrictions
+   are evaluated in memory: a pre-filtered table drops the rows that do
+   not match straight away, a live-filtered table keeps them all and
+   records the verdict of each row the first time it is read.
+ */
+static enum MAPISTATUS openchangedb_table_fetch_rows(struct openchangedb_table *table,
+						     struct ldb_context *ldb_ctx,
+						     bool live_filtered)
+{
+	struct ldb_result	*res;
+	const char * const	attrs[] = { "*", NULL };
+	char			*ldb_filter;
+	uint32_t		i, count;
+	int			ret;
+
+	ldb_filter = openchangedb_table_build_filter(NULL, table);
+	OPENCHANGE_RETVAL_IF(!ldb_filter, MAPI_E_TOO_COMPLEX, NULL);
+	DEBUG(5, ("[%s:%d] ldb_filter = %s\n", __FUNCTION__, __LINE__, ldb_filter));
+	ret = ldb_search(ldb_ctx, (TALLOC_CTX *)table, &res, ldb_get_default_basedn(ldb_ctx), LDB_SCOPE_SUBTREE, attrs, ldb_filter, NULL);
+	talloc_free(ldb_filter);
+	OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS, MAPI_E_INVALID_OBJECT, NULL);
+
+	if (table->restrictions) {
+		if (live_filtered) {
+			table->row_status = talloc_zero_array(res, uint8_t, res->count + 1);
+			OPENCHANGE_RETVAL_IF(!table->row_status, MAPI_E_NOT_ENOUGH_MEMORY, res);
+		}
+		else {
+			for (i = 0, count = 0; i < res->count; i++) {
+				if (openchangedb_table_match_restriction(res->msgs[i], table->restrictions)) {
+					res->msgs[count++] = res->msgs[i];
+				}
+				else {
+					talloc_free(res->msgs[i]);
+				}
 			}
+			res->count = count;
 		}
 	}
 
-	/* Close filter */
-	filter = talloc_asprintf_append(filter, ")");
+	table->res = res;
 
-	return filter;
+	return MAPI_E_SUCCESS;
 }
 
 _PUBLIC_ enum MAPISTATUS openchangedb_table_get_property(TALLOC_CTX *mem_ctx,
@@ -227,12 +540,9 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_get_property(TALLOC_CTX *mem_ctx,
 							 void **data)
 {
 	struct openchangedb_table	*table;
-	char				*ldb_filter = NULL;
-	struct ldb_result		*res = NULL, *live_res = NULL;
-	const char * const		attrs[] = { "*", NULL };
-	const char			*PidTagAttr = NULL, *childIdAttr;
-	uint64_t			*row_fmid;
-	int				ret;
+	struct ldb_result		*res = NULL;
+	const char			*PidTagAttr = NULL;
+	enum MAPISTATUS			retval;
 
 	/* Sanity checks */
 	OPENCHANGE_RETVAL_IF(!table_object, MAPI_E_NOT_INITIALIZED, NULL);
@@ -243,55 +553,23 @@ _PUBLIC_ enum MAPISTATUS openchangedb_table_get_property(TALLOC_CTX *mem_ctx,
 
 	/* Fetch results */
 	if (!table->res) {
-		/* Build ldb filter */
-		if (live_filtered) {
-			ldb_filter = openchangedb_table_build_filter(NULL, table, 0, NULL);
-			DEBUG(0, ("(live-filtered) ldb_filter = %s\n", ldb_filter));
-		}
-		else {
-			ldb_filter = openchangedb_table_build_filter(NULL, table, 0, table->restrictions);
-			DEBUG(0, ("(pre-filtered) ldb_filter = %s\n", ldb_filter));
-		}
-		OPENCHANGE_RETVAL_IF(!ldb_filter, MAPI_E_TOO_COMPLEX, NULL);
-		ret = ldb_search(ldb_ctx, (TALLOC_CTX *)table_object, &table->res, ldb_get_default_basedn(ldb_ctx), LDB_SCOPE_SUBTREE, attrs, ldb_filter, NULL);
-		talloc_free(ldb_filter);
-		OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS, MAPI_E_INVALID_OBJECT, NULL);
+		retval = openchangedb_table_fetch_rows(table, ldb_ctx, live_filtered);
+		OPENCHANGE_RETVAL_IF(retval, retval, NULL);
 	}
 	res = table->res;
 
 	/* Ensure position is within search results range */
 	OPENCHANGE_RETVAL_IF(pos >= res->count, MAPI_E_INVALID_OBJECT, NULL);
 
-	/* If live filtering, make sure the specified row match the restrictions */
-	if (live_filtered) {
-		TALLOC_CTX *local_mem_ctx;
-
-		switch (table->table_type) {
-		case 0x3 /* EMSMDBP_TABLE_FAI_TYPE */:
-		case 0x2 /* EMSMDBP_TABLE_MESSAGE_TYPE */:
-			childIdAttr = "PidTagMessageId";
-			break;
-		case 0x1 /* EMSMDBP_TABLE_FOLDER_TYPE */:
-			childIdAttr = "PidTagFolderId";
-			break;
-		default:
-			DEBUG(0, ("unsupported table type for openchangedb: %d\n", table->table_type));
-			abort();
-		}
-		row_fmid = openchangedb_get_property_data(mem_ctx, res, pos, PR_MID, childIdAttr);
-		if (!row_fmid || !*row_fmid) {
-			DEBUG(0, ("ldb object must have a '%s' field\n", childIdAttr));
-			abort();
+	/* If live filtering, make sure the specified row match the
+	 * restrictions. The row is only evaluated for the first column
+	 * read from it. */
+	if (live_filtered && table->row_status) {
+		if (table->row_status[pos] == OPENCHANGEDB_TABLE_ROW_UNKNOWN) {
+			table->row_status[pos] = openchangedb_table_match_restriction(res->msgs[pos], table->restrictions)
+				? OPENCHANGEDB_TABLE_ROW_MATCH : OPENCHANGEDB_TABLE_ROW_NO_MATCH;
 		}
-
-		local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
-
-		ldb_filter = openchangedb_table_build_filter(local_mem_ctx, table, *row_fmid, table->restrictions);
-		OPENCHANGE_RETVAL_IF(!ldb_filter, MAPI_E_TOO_COMPLEX, NULL);
-		DEBUG(0, ("  row ldb_filter = %s\n", ldb_filter));
-		ret = ldb_search(ldb_ctx, local_mem_ctx, &live_res, ldb_get_default_basedn(ldb_ctx), LDB_SCOPE_SUBTREE, attrs, ldb_filter, NULL);
-		OPENCHANGE_RETVAL_IF(ret != LDB_SUCCESS || live_res->count == 0, MAPI_E_INVALID_OBJECT, local_mem_ctx);
-		talloc_free(local_mem_ctx);
+		OPENCHANGE_RETVAL_IF(table->row_status[pos] != OPENCHANGEDB_TABLE_ROW_MATCH, MAPI_E_INVALID_OBJECT, NULL);
 	}
 
 	/* hacks for some attributes specific to tables */
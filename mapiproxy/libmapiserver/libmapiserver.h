@@ -199,6 +199,20 @@
  */
 #define	SIZE_DFLT_ROPSEEKROW			5
 
+/**
+   \details SeekRowBookmarkRop has fixed response size for:
+   -# RowNoLongerVisible: uint8_t
+   -# HasSoughtLess: uint8_t
+   -# RowsSought: uint32_t
+ */
+#define	SIZE_DFLT_ROPSEEKROWBOOKMARK		6
+
+/**
+   \details CreateBookmarkRop has fixed response size for:
+   -# BookmarkSize: uint16_t
+ */
+#define	SIZE_DFLT_ROPCREATEBOOKMARK		2
+
 /**
    \details CreateFolderRop has fixed response size for:
    -# folder_id: uint64_t
@@ -283,6 +297,19 @@
  */
 #define	SIZE_DFLT_ROPFINDROW			2
 
+/**
+   \details ExpandRow has fixed response size for:
+   -# ExpandedRowCount: uint32_t
+   -# RowCount: uint16_t
+ */
+#define	SIZE_DFLT_ROPEXPANDROW			6
+
+/**
+   \details CollapseRow has fixed response size for:
+   -# CollapsedRowCount: uint32_t
+ */
+#define	SIZE_DFLT_ROPCOLLAPSEROW		4
+
 /**
    \details GetNamesFromIDs has fixed response size for:
    -# PropertyNameCount: uint16_t
@@ -515,6 +542,8 @@ uint16_t libmapiserver_RecipientRow_size(struct RecipientRow);
 uint16_t libmapiserver_LongTermId_size(void);
 uint16_t libmapiserver_PropertyName_size(struct MAPINAMEID *);
 uint16_t libmapiserver_mapi_SPropValue_size(uint16_t, struct mapi_SPropValue *);
+enum ndr_err_code libmapiserver_push_PropertyRow(struct ndr_push *, uint16_t, enum MAPITAGS *, void **, enum MAPISTATUS *);
+uint16_t libmapiserver_PropertyRow_size(uint16_t, enum MAPITAGS *, void **, enum MAPISTATUS *);
 
 /* definitions from libmapiserver_oxcprpt.c */
 uint16_t libmapiserver_RopSetProperties_size(struct EcDoRpc_MAPI_REPL *);
@@ -533,6 +562,7 @@ uint16_t libmapiserver_RopGetNamesFromIDs_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopGetPropertyIdsFromNames_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopDeletePropertiesNoReplicate_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopCopyTo_size(struct EcDoRpc_MAPI_REPL *);
+enum ndr_err_code libmapiserver_push_property_ndr(struct ndr_push *, uint32_t, const void *, uint8_t, uint8_t, uint8_t);
 int libmapiserver_push_property(TALLOC_CTX *, uint32_t, const void *, DATA_BLOB *, uint8_t, uint8_t, uint8_t);
 struct SRow *libmapiserver_ROP_request_to_properties(TALLOC_CTX *, void *, uint8_t);
 
@@ -556,8 +586,13 @@ uint16_t libmapiserver_RopRestrict_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopQueryRows_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopQueryPosition_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopSeekRow_size(struct EcDoRpc_MAPI_REPL *);
+uint16_t libmapiserver_RopSeekRowBookmark_size(struct EcDoRpc_MAPI_REPL *);
+uint16_t libmapiserver_RopCreateBookmark_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopFindRow_size(struct EcDoRpc_MAPI_REPL *);
 uint16_t libmapiserver_RopResetTable_size(struct EcDoRpc_MAPI_REPL *);
+uint16_t libmapiserver_RopFreeBookmark_size(struct EcDoRpc_MAPI_REPL *);
+uint16_t libmapiserver_RopExpandRow_size(struct EcDoRpc_MAPI_REPL *);
+uint16_t libmapiserver_RopCollapseRow_size(struct EcDoRpc_MAPI_REPL *);
 
 /* definitions from libmapiserver_oxomsg.c */
 uint16_t libmapiserver_RopSubmitMessage_size(struct EcDoRpc_MAPI_REPL *);
@@ -27,6 +27,7 @@
 
 #include "libmapiserver.h"
 #include "libmapi/mapidefs.h"
+#include "gen_ndr/ndr_exchange.h"
 #include <util/debug.h>
 
 /**
@@ -182,87 +183,121 @@ _PUBLIC_ uint16_t libmapiserver_PropertyName_size(struct MAPINAMEID *property_na
 /**
    \details Calculate the size of a mapi_SPropValue array structure
 
+   The values are encoded into a scratch push context and the size is
+   read from its offset, so strings are sized with their actual UTF-16
+   length and every type the IDL knows is handled.
+
+   \param cValues number of values
+   \param lpProps array of values
+
    \return Size of mapi_SPropValue structure
  */
 _PUBLIC_ uint16_t libmapiserver_mapi_SPropValue_size(uint16_t cValues, struct mapi_SPropValue *lpProps)
 {
+	struct ndr_push	*ndr;
 	uint16_t	size = 0;
-	int		i = 0;
-	int		j = 0;
+	uint16_t	i;
 
+	ndr = ndr_push_init_ctx(NULL);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
 	for (i = 0; i < cValues; i++) {
-		size += 4; /* ulPropTag */
-
-		switch (lpProps[i].ulPropTag & 0xFFFF) {
-		case PT_I2: /* Equivalent to PT_SHORT */
-			size += sizeof (uint16_t);
-			break;
-		case PT_LONG:
-			size += sizeof (uint32_t);
-			break;
-		case PT_DOUBLE:
-			size += sizeof (double);
-			break;
-		case PT_ERROR:
-			size += sizeof (uint32_t);
-			break;
-		case PT_BOOLEAN:
-			size += sizeof (uint8_t); 
-			break;
-		case PT_I8:
-			size += sizeof (int64_t);
-			break;
-		case PT_STRING8:
-			size += strlen(lpProps[i].value.lpszA) + 1;
-			break;
-		case PT_UNICODE:
-			size += strlen(lpProps[i].value.lpszW) * 2 + 2;
-			break;
-		case PT_SYSTIME:
-			size += sizeof (uint32_t) * 2;
-			break;
-		case PT_CLSID:
-			size += sizeof (struct GUID);
+		if (ndr_push_mapi_SPropValue(ndr, NDR_SCALARS, &lpProps[i]) != NDR_ERR_SUCCESS) {
+			DEBUG(5, ("[%s:%d]: unable to encode property 0x%.8x\n", __FUNCTION__, __LINE__, lpProps[i].ulPropTag));
 			break;
-		case PT_SRESTRICT:
-		case PT_ACTIONS:
-			break;
-		case PT_BINARY:
-		case PT_SVREID:
-			size += sizeof (uint16_t);
-			size += lpProps[i].value.bin.cb;
-			break;
-		case PT_MV_LONG:
-			size += sizeof (uint32_t);
-			size += lpProps[i].value.MVl.cValues * sizeof (uint32_t);
-			break;
-		case PT_MV_STRING8:
-			size += sizeof (uint32_t);
-			for (j = 0; j < lpProps[i].value.MVszA.cValues; j++) {
-				size += strlen(lpProps[i].value.MVszA.strings[j].lppszA) + 1;
-			}
-			break;
-		case PT_MV_UNICODE:
-			size += sizeof (uint32_t);
-			for (j = 0; j < lpProps[i].value.MVszW.cValues; j++) {
-				size += strlen(lpProps[i].value.MVszW.strings[j].lppszW) * 2 + 2;
-			}
-			break;
-		case PT_MV_CLSID:
-			size += sizeof (uint32_t);
-			size += lpProps[i].value.MVguid.cValues * sizeof (struct GUID);
-			break;
-		case PT_MV_BINARY:
-			size += sizeof (uint32_t);
-			for (j = 0; j < lpProps[i].value.MVbin.cValues; j++) {
-				size += 2;
-				size += lpProps[i].value.MVbin.bin[j].cb;
+		}
+	}
+	size = ndr->offset;
+	talloc_free(ndr);
+
+	return size;
+}
+
+/**
+   \details Encode a PropertyRow structure at the current position of
+   a NDR push context. The row is flagged when at least one of the
+   values could not be retrieved, in which case the failing columns
+   are encoded as PT_ERROR values.
+
+   Rows are written directly into the reply buffer: callers
+   building a whole QueryRows reply push all rows into the same
+   context and take the RowData length from its offset, instead of
+   sizing each value first and copying it afterwards.
+
+   \param ndr pointer to the NDR push context, with LIBNDR_FLAG_NOALIGN set
+   \param num_props number of columns in the row
+   \param properties array of column property tags
+   \param data_pointers array of column values
+   \param retvals array of column retrieval status
+
+   \return NDR_ERR_SUCCESS on success, otherwise NDR error
+ */
+_PUBLIC_ enum ndr_err_code libmapiserver_push_PropertyRow(struct ndr_push *ndr,
+							  uint16_t num_props,
+							  enum MAPITAGS *properties,
+							  void **data_pointers,
+							  enum MAPISTATUS *retvals)
+{
+	uint16_t	i;
+	uint8_t		flagged = 0;
+	uint32_t	property;
+	uint32_t	retval;
+	const void	*data;
+
+	for (i = 0; !flagged && i < num_props; i++) {
+		if (retvals[i] != MAPI_E_SUCCESS) {
+			flagged = 1;
+		}
+	}
+
+	NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, flagged));
+
+	for (i = 0; i < num_props; i++) {
+		property = properties[i];
+		retval = retvals[i];
+		if (retval != MAPI_E_SUCCESS) {
+			property = (property & 0xFFFF0000) + PT_ERROR;
+			data = &retval;
+		}
+		else {
+			data = data_pointers[i];
+			/* Multi-valued instance columns hold one of the values */
+			if (property & MV_INSTANCE) {
+				property &= ~(MV_FLAG | MV_INSTANCE);
 			}
-			break;
-		default:
-			abort();
 		}
+		NDR_CHECK(libmapiserver_push_property_ndr(ndr, property, data, flagged ? PT_ERROR : 0, flagged, 0));
 	}
-	
+
+	return NDR_ERR_SUCCESS;
+}
+
+/**
+   \details Calculate the size of a PropertyRow structure
+
+   \param num_props number of columns in the row
+   \param properties array of column property tags
+   \param data_pointers array of column values
+   \param retvals array of column retrieval status
+
+   \note This is a compatibility wrapper around
+   libmapiserver_push_PropertyRow: the row is encoded into a scratch
+   buffer and its size read from the write cursor.
+
+   \return Size of the PropertyRow structure
+ */
+_PUBLIC_ uint16_t libmapiserver_PropertyRow_size(uint16_t num_props,
+						 enum MAPITAGS *properties,
+						 void **data_pointers,
+						 enum MAPISTATUS *retvals)
+{
+	struct ndr_push	*ndr;
+	uint16_t	size;
+
+	ndr = ndr_push_init_ctx(NULL);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	libmapiserver_push_PropertyRow(ndr, num_props, properties, data_pointers, retvals);
+	size = ndr->offset;
+	talloc_free(ndr);
+
 	return size;
 }
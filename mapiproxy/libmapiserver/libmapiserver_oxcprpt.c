@@ -62,6 +62,10 @@ _PUBLIC_ uint16_t libmapiserver_RopGetPropertiesSpecific_size(struct EcDoRpc_MAP
 
    \param request pointer to the GetPropertiesAll EcDoRpc_MAPI_REPL structure
 
+   \note The properties are a mapi_SPropValue_array serialized with
+   the rest of the mapi_response, not a blob: their size is taken from
+   the cursor of a scratch encoding.
+
    \return Size of GetPropsAll response
  */
 _PUBLIC_ uint16_t libmapiserver_RopGetPropertiesAll_size(struct EcDoRpc_MAPI_REPL *response)
@@ -388,68 +392,55 @@ _PUBLIC_ uint16_t libmapiserver_RopDeletePropertiesNoReplicate_size(struct EcDoR
 
 
 /**
-   \details Add a property value to a DATA blob. This convenient
-   function should be used when creating a GetPropertiesSpecific reply
-   response blob.
-
-   \param mem_ctx pointer to the memory context
-   \param property the property tag which value is meant to be
-   appended to the blob
+   \details Encode a property value at the current position of a NDR
+   push context. This is the single-pass encoder used to build
+   PropertyRow and GetPropertiesSpecific blobs: values are written
+   directly into the reply buffer and the encoded size is given by
+   the push context offset.
+
+   \param ndr pointer to the NDR push context, with LIBNDR_FLAG_NOALIGN set
+   \param property the property tag which value is meant to be encoded
    \param value generic pointer on the property value
-   \param blob the data blob the function uses to return the blob
    \param layout whether values should be prefixed by a layout
    \param flagged define if the properties are flagged or not
+   \param untyped define if the property type must be encoded first
 
-   \note blob.length must be set to 0 before this function is called
-   the first time. Also the function only supports a limited set of
-   property types at the moment.
+   \note the function only supports a limited set of property types
+   at the moment.
 
-   \return 0 on success;
+   \return NDR_ERR_SUCCESS on success, otherwise NDR error
  */
-_PUBLIC_ int libmapiserver_push_property(TALLOC_CTX *mem_ctx,
-					 uint32_t property, 
-					 const void *value, 
-					 DATA_BLOB *blob,
-					 uint8_t layout, 
-					 uint8_t flagged,
-					 uint8_t untyped)
+_PUBLIC_ enum ndr_err_code libmapiserver_push_property_ndr(struct ndr_push *ndr,
+							   uint32_t property,
+							   const void *value,
+							   uint8_t layout,
+							   uint8_t flagged,
+							   uint8_t untyped)
 {
-	struct ndr_push		*ndr;
         struct SBinary_short    bin;
         struct BinaryArray_r    *bin_array;
+	uint32_t		_flags_save;
 	uint32_t		i;
-	
-	ndr = ndr_push_init_ctx(mem_ctx);
-	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
-	ndr->offset = 0;
-	if (blob->length) {
-		talloc_free(ndr->data);
-		ndr->data = blob->data;
-		ndr->offset = blob->length;
-	}
 
 	/* Step 1. Is the property typed */
 	if (untyped) {
-		ndr_push_uint16(ndr, NDR_SCALARS, property & 0xFFFF);
+		NDR_CHECK(ndr_push_uint16(ndr, NDR_SCALARS, property & 0xFFFF));
 	}
 
-
-
 	/* Step 2. Is the property flagged */
 	if (flagged) {
 		switch (property & 0xFFFF) {
 		case PT_ERROR:
 			switch (layout) {
 			case 0x1:
-				ndr_push_uint8(ndr, NDR_SCALARS, layout);
-				goto end;
+				return ndr_push_uint8(ndr, NDR_SCALARS, layout);
 			case PT_ERROR:
-				ndr_push_uint8(ndr, NDR_SCALARS, PT_ERROR);
+				NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, PT_ERROR));
 				break;
 			}
 			break;
 		default:
-			ndr_push_uint8(ndr, NDR_SCALARS, 0x0);
+			NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, 0x0));
 			break;
 		}
 	} else {
@@ -457,70 +448,71 @@ _PUBLIC_ int libmapiserver_push_property(TALLOC_CTX *mem_ctx,
 		if (layout) {
 			switch (property & 0xFFFF) {
 			case PT_ERROR:
-				ndr_push_uint8(ndr, NDR_SCALARS, PT_ERROR);
+				NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, PT_ERROR));
 				break;
 			default:
-				ndr_push_uint8(ndr, NDR_SCALARS, 0x0);
+				NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, 0x0));
 			}
 		}
 	}
 
 	/* Step 3. Push property data if supported */
+	_flags_save = ndr->flags;
 	switch (property & 0xFFFF) {
 	case PT_I2:
-		ndr_push_uint16(ndr, NDR_SCALARS, *(uint16_t *) value);
+		NDR_CHECK(ndr_push_uint16(ndr, NDR_SCALARS, *(uint16_t *) value));
 		break;
 	case PT_LONG:
 	case PT_ERROR:
 	case PT_OBJECT:
-		ndr_push_uint32(ndr, NDR_SCALARS, *(uint32_t *) value);
+		NDR_CHECK(ndr_push_uint32(ndr, NDR_SCALARS, *(uint32_t *) value));
 		break;
 	case PT_DOUBLE:
-		ndr_push_double(ndr, NDR_SCALARS, *(double *) value);
+		NDR_CHECK(ndr_push_double(ndr, NDR_SCALARS, *(double *) value));
 		break;
 	case PT_I8:
-		ndr_push_dlong(ndr, NDR_SCALARS, *(uint64_t *) value);
+		NDR_CHECK(ndr_push_dlong(ndr, NDR_SCALARS, *(uint64_t *) value));
 		break;
 	case PT_BOOLEAN:
-		ndr_push_uint8(ndr, NDR_SCALARS, *(uint8_t *) value);
+		NDR_CHECK(ndr_push_uint8(ndr, NDR_SCALARS, *(uint8_t *) value));
 		break;
 	case PT_STRING8:
 		ndr_set_flags(&ndr->flags, LIBNDR_FLAG_STR_NULLTERM|LIBNDR_FLAG_STR_ASCII);
-		ndr_push_string(ndr, NDR_SCALARS, (char *) value);
+		NDR_CHECK(ndr_push_string(ndr, NDR_SCALARS, (char *) value));
 		break;
 	case PT_UNICODE:
 		ndr_set_flags(&ndr->flags, LIBNDR_FLAG_STR_NULLTERM);
-		ndr_push_string(ndr, NDR_SCALARS, (char *) value);
+		NDR_CHECK(ndr_push_string(ndr, NDR_SCALARS, (char *) value));
 		break;
 	case PT_BINARY:
 	case PT_SVREID:
                 /* PropertyRow expect a 16 bit header for BLOB in RopQueryRows and RopGetPropertiesSpecific */
 		bin.cb = ((struct Binary_r *) value)->cb;
 		bin.lpb = ((struct Binary_r *) value)->lpb;
-		ndr_push_SBinary_short(ndr, NDR_SCALARS, &bin);
+		NDR_CHECK(ndr_push_SBinary_short(ndr, NDR_SCALARS, &bin));
 		break;
 	case PT_CLSID:
-		ndr_push_GUID(ndr, NDR_SCALARS, (struct GUID *) value);
+		NDR_CHECK(ndr_push_GUID(ndr, NDR_SCALARS, (struct GUID *) value));
 		break;
 	case PT_SYSTIME:
-		ndr_push_FILETIME(ndr, NDR_SCALARS, (struct FILETIME *) value);
+		NDR_CHECK(ndr_push_FILETIME(ndr, NDR_SCALARS, (struct FILETIME *) value));
 		break;
 
 	case PT_MV_LONG:
-		ndr_push_mapi_MV_LONG_STRUCT(ndr, NDR_SCALARS, (struct mapi_MV_LONG_STRUCT *) value);
+		NDR_CHECK(ndr_push_mapi_MV_LONG_STRUCT(ndr, NDR_SCALARS, (struct mapi_MV_LONG_STRUCT *) value));
 		break;
 
 	case PT_MV_UNICODE:
-                ndr_push_mapi_SLPSTRArrayW(ndr, NDR_SCALARS, (struct mapi_SLPSTRArrayW *) value);
+                NDR_CHECK(ndr_push_mapi_SLPSTRArrayW(ndr, NDR_SCALARS, (struct mapi_SLPSTRArrayW *) value));
 		break;
 
 	case PT_MV_BINARY:
 		bin_array = (struct BinaryArray_r *) value;
-		ndr_push_uint32(ndr, NDR_SCALARS, bin_array->cValues);
+		NDR_CHECK(ndr_push_uint32(ndr, NDR_SCALARS, bin_array->cValues));
 		for (i = 0; i < bin_array->cValues; i++) {
 			bin.cb = bin_array->lpbin[i].cb;
 			bin.lpb = bin_array->lpbin[i].lpb;
-			ndr_push_SBinary_short(ndr, NDR_SCALARS, &bin);
+			NDR_CHECK(ndr_push_SBinary_short(ndr, NDR_SCALARS, &bin));
 		}
 		break;
 	default:
@@ -530,8 +522,55 @@ _PUBLIC_ int libmapiserver_push_property(TALLOC_CTX *mem_ctx,
 		}
 		break;
 	}
-end:
-	/* Step 4. Steal ndr context */
+	/* string flags must not leak into the next property */
+	ndr->flags = _flags_save;
+
+	return NDR_ERR_SUCCESS;
+}
+
+
+/**
+   \details Add a property value to a DATA blob. This convenient
+   function should be used when creating a GetPropertiesSpecific reply
+   response blob.
+
+   \param mem_ctx pointer to the memory context
+   \param property the property tag which value is meant to be
+   appended to the blob
+   \param value generic pointer on the property value
+   \param blob the data blob the function uses to return the blob
+   \param layout whether values should be prefixed by a layout
+   \param flagged define if the properties are flagged or not
+
+   \note blob.length must be set to 0 before this function is called
+   the first time. Every call sets up a new push context around the
+   blob: callers encoding several values should rather push them with
+   libmapiserver_push_property_ndr into a single context.
+
+   \return 0 on success;
+ */
+_PUBLIC_ int libmapiserver_push_property(TALLOC_CTX *mem_ctx,
+					 uint32_t property, 
+					 const void *value, 
+					 DATA_BLOB *blob,
+					 uint8_t layout, 
+					 uint8_t flagged,
+					 uint8_t untyped)
+{
+	struct ndr_push		*ndr;
+	
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	ndr->offset = 0;
+	if (blob->length) {
+		talloc_free(ndr->data);
+		ndr->data = blob->data;
+		ndr->offset = blob->length;
+	}
+
+	libmapiserver_push_property_ndr(ndr, property, value, layout, flagged, untyped);
+
+	/* Steal ndr context */
 	blob->data = ndr->data;
 	talloc_steal(mem_ctx, blob->data);
 	blob->length = ndr->offset;
@@ -160,6 +160,51 @@ _PUBLIC_ uint16_t libmapiserver_RopSeekRow_size(struct EcDoRpc_MAPI_REPL *respon
 }
 
 
+/**
+   \details Calculate SeekRowBookmark Rop size
+
+   \param response pointer to the SeekRowBookmark EcDoRpc_MAPI_REPL
+   structure
+
+   \return Size of SeekRowBookmark response
+ */
+_PUBLIC_ uint16_t libmapiserver_RopSeekRowBookmark_size(struct EcDoRpc_MAPI_REPL *response)
+{
+	uint16_t	size = SIZE_DFLT_MAPI_RESPONSE;
+
+	if (!response || response->error_code) {
+		return size;
+	}
+
+	size += SIZE_DFLT_ROPSEEKROWBOOKMARK;
+
+	return size;
+}
+
+
+/**
+   \details Calculate CreateBookmark Rop size
+
+   \param response pointer to the CreateBookmark EcDoRpc_MAPI_REPL
+   structure
+
+   \return Size of CreateBookmark response
+ */
+_PUBLIC_ uint16_t libmapiserver_RopCreateBookmark_size(struct EcDoRpc_MAPI_REPL *response)
+{
+	uint16_t	size = SIZE_DFLT_MAPI_RESPONSE;
+
+	if (!response || response->error_code) {
+		return size;
+	}
+
+	size += SIZE_DFLT_ROPCREATEBOOKMARK;
+	size += response->u.mapi_CreateBookmark.bookmark.cb;
+
+	return size;
+}
+
+
 /**
    \details Calculate FindRow Rop size
 
@@ -196,3 +241,62 @@ _PUBLIC_ uint16_t libmapiserver_RopResetTable_size(struct EcDoRpc_MAPI_REPL *res
 {
 	return SIZE_DFLT_MAPI_RESPONSE;
 }
+
+
+/**
+   \details Calculate FreeBookmark (0x89) Rop size
+
+   \param response pointer to the FreeBookmark EcDoRpc_MAPI_REPL
+   structure
+
+   \return Size of FreeBookmark response
+ */
+_PUBLIC_ uint16_t libmapiserver_RopFreeBookmark_size(struct EcDoRpc_MAPI_REPL *response)
+{
+	return SIZE_DFLT_MAPI_RESPONSE;
+}
+
+
+/**
+   \details Calculate ExpandRow (0x59) Rop size
+
+   \param response pointer to the ExpandRow EcDoRpc_MAPI_REPL
+   structure
+
+   \return Size of ExpandRow response
+ */
+_PUBLIC_ uint16_t libmapiserver_RopExpandRow_size(struct EcDoRpc_MAPI_REPL *response)
+{
+	uint16_t	size = SIZE_DFLT_MAPI_RESPONSE;
+
+	if (!response || response->error_code) {
+		return size;
+	}
+
+	size += SIZE_DFLT_ROPEXPANDROW;
+	size += response->u.mapi_ExpandRow.RowData.length;
+
+	return size;
+}
+
+
+/**
+   \details Calculate CollapseRow (0x5a) Rop size
+
+   \param response pointer to the CollapseRow EcDoRpc_MAPI_REPL
+   structure
+
+   \return Size of CollapseRow response
+ */
+_PUBLIC_ uint16_t libmapiserver_RopCollapseRow_size(struct EcDoRpc_MAPI_REPL *response)
+{
+	uint16_t	size = SIZE_DFLT_MAPI_RESPONSE;
+
+	if (!response || response->error_code) {
+		return size;
+	}
+
+	size += SIZE_DFLT_ROPCOLLAPSEROW;
+
+	return size;
+}
@@ -183,10 +183,12 @@ struct mapistore_backend {
  		enum mapistore_error	(*copy_folder)(void *, void *, TALLOC_CTX *, bool, const char *);
 		enum mapistore_error	(*get_deleted_fmids)(void *, TALLOC_CTX *, enum mapistore_table_type, uint64_t, struct UI8Array_r **, uint64_t *);
 		enum mapistore_error	(*get_child_count)(void *, enum mapistore_table_type, uint32_t *);
+		enum mapistore_error	(*get_child_fmids)(void *, TALLOC_CTX *, enum mapistore_table_type, uint64_t **, uint32_t *);
                 enum mapistore_error	(*open_table)(void *, TALLOC_CTX *, enum mapistore_table_type, uint32_t, void **, uint32_t *);
 		enum mapistore_error	(*modify_permissions)(void *, uint8_t, uint16_t, struct PermissionData *);
 
 		enum mapistore_error	(*preload_message_bodies)(void *, enum mapistore_table_type, const struct UI8Array_r *);
+		enum mapistore_error	(*save_messages)(void *, TALLOC_CTX *, uint32_t, void **);
         } folder;
 
         /** oxcmsg operations */
@@ -230,6 +232,7 @@ struct mapistore_backend {
 };
 
 struct indexing_context_list;
+struct mapistore_table_view;
 
 struct backend_context {
 	const struct mapistore_backend	*backend;
@@ -248,16 +251,22 @@ struct backend_context_list {
 };
 
 struct processing_context;
+struct backend_context_index;
+struct mapistore_freebusy_cache;
 
 struct mapistore_context {
 	struct processing_context		*processing_ctx;
 	struct backend_context_list		*context_list;
+	struct backend_context_index		*context_index;
+	struct mapistore_freebusy_cache		*freebusy_cache;
 	struct indexing_context_list		*indexing_list;
+	struct mapistore_table_view		*table_views;
 	struct replica_mapping_context_list	*replica_mapping_list;
 	struct mapistore_subscription_list	*subscriptions;
 	struct mapistore_notification_list	*notifications;
 	struct ldb_context			*nprops_ctx;
 	struct mapistore_connection_info	*conn_info;
+	uint32_t				indexing_write_back;
 #if 0
 	mqd_t					mq_ipc;
 #endif
@@ -319,10 +328,13 @@ enum mapistore_error mapistore_folder_copy_folder(struct mapistore_context *, ui
 enum mapistore_error mapistore_folder_get_deleted_fmids(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, enum mapistore_table_type, uint64_t, struct UI8Array_r **, uint64_t *);
 enum mapistore_error mapistore_folder_get_child_count(struct mapistore_context *, uint32_t, void *, enum mapistore_table_type, uint32_t *);
 enum mapistore_error mapistore_folder_get_child_fmids(struct mapistore_context *, uint32_t, void *, enum mapistore_table_type, TALLOC_CTX *, uint64_t **, uint32_t *);
+enum mapistore_error mapistore_folder_get_child_fmids_from_table(struct mapistore_context *, uint32_t, void *, enum mapistore_table_type, TALLOC_CTX *, uint64_t **, uint32_t *);
 enum mapistore_error mapistore_folder_get_child_fid_by_name(struct mapistore_context *, uint32_t, void *, const char *, uint64_t *);
 enum mapistore_error mapistore_folder_open_table(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, enum mapistore_table_type, uint32_t, void **, uint32_t *);
 enum mapistore_error mapistore_folder_modify_permissions(struct mapistore_context *, uint32_t, void *, uint8_t, uint16_t, struct PermissionData *);
 enum mapistore_error mapistore_folder_preload_message_bodies(struct mapistore_context *, uint32_t, void *, enum mapistore_table_type, const struct UI8Array_r *);
+bool mapistore_folder_can_save_messages(struct mapistore_context *, uint32_t);
+enum mapistore_error mapistore_folder_save_messages(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, uint32_t, void **);
 enum mapistore_error mapistore_folder_fetch_freebusy_properties(struct mapistore_context *, uint32_t, void *, struct tm *, struct tm *, TALLOC_CTX *, struct mapistore_freebusy_properties **);
 
 enum mapistore_error mapistore_message_get_message_data(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, struct mapistore_message **);
@@ -342,6 +354,8 @@ enum mapistore_error mapistore_table_set_restrictions(struct mapistore_context *
 enum mapistore_error mapistore_table_set_sort_order(struct mapistore_context *, uint32_t, void *, struct SSortOrderSet *, uint8_t *);
 enum mapistore_error mapistore_table_get_row(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, enum mapistore_query_type, uint32_t, struct mapistore_property_data **);
 enum mapistore_error mapistore_table_get_row_count(struct mapistore_context *, uint32_t, void *, enum mapistore_query_type, uint32_t *);
+enum mapistore_error mapistore_table_expand_row(struct mapistore_context *, uint32_t, void *, uint64_t, uint32_t *, uint32_t *);
+enum mapistore_error mapistore_table_collapse_row(struct mapistore_context *, uint32_t, void *, uint64_t, uint32_t *, uint32_t *);
 enum mapistore_error mapistore_table_handle_destructor(struct mapistore_context *, uint32_t, void *, uint32_t);
 
 enum mapistore_error mapistore_properties_get_available_properties(struct mapistore_context *, uint32_t, void *, TALLOC_CTX *, struct SPropTagArray **);
@@ -358,8 +372,8 @@ enum mapistore_error mapistore_set_mapping_path(const char *);
 enum mapistore_error mapistore_backend_register(const void *);
 const char	*mapistore_backend_get_installdir(void);
 init_backend_fn	*mapistore_backend_load(TALLOC_CTX *, const char *);
-struct backend_context *mapistore_backend_lookup(struct backend_context_list *, uint32_t);
-struct backend_context *mapistore_backend_lookup_by_uri(struct backend_context_list *, const char *);
+struct backend_context *mapistore_backend_lookup(struct mapistore_context *, uint32_t);
+struct backend_context *mapistore_backend_lookup_by_uri(struct mapistore_context *, const char *);
 struct backend_context *mapistore_backend_lookup_by_name(TALLOC_CTX *, const char *);
 bool		mapistore_backend_run_init(init_backend_fn *);
 
@@ -367,12 +381,18 @@ bool		mapistore_backend_run_init(init_backend_fn *);
 enum mapistore_error mapistore_backend_init_defaults(struct mapistore_backend *);
 
 /* definitions from mapistore_indexing.c */
+enum mapistore_error mapistore_indexing_transaction_start(struct mapistore_context *, const char *);
+enum mapistore_error mapistore_indexing_transaction_commit(struct mapistore_context *, const char *);
+enum mapistore_error mapistore_indexing_transaction_cancel(struct mapistore_context *, const char *);
+enum mapistore_error mapistore_indexing_flush(struct mapistore_context *, bool);
 enum mapistore_error mapistore_indexing_record_add_fid(struct mapistore_context *, uint32_t, const char *, uint64_t);
 enum mapistore_error mapistore_indexing_record_del_fid(struct mapistore_context *, uint32_t, const char *, uint64_t, uint8_t);
 enum mapistore_error mapistore_indexing_record_add_mid(struct mapistore_context *, uint32_t, const char *, uint64_t);
 enum mapistore_error mapistore_indexing_record_del_mid(struct mapistore_context *, uint32_t, const char *, uint64_t, uint8_t);
 enum mapistore_error mapistore_indexing_record_get_uri(struct mapistore_context *, const char *, TALLOC_CTX *, uint64_t, char **, bool *);
 enum mapistore_error mapistore_indexing_record_get_fmid(struct mapistore_context *, const char *, const char *, bool, uint64_t *, bool *);
+enum mapistore_error mapistore_indexing_record_set_group_cns(struct mapistore_context *, const char *, uint64_t, uint32_t, uint32_t, uint64_t);
+enum mapistore_error mapistore_indexing_record_get_group_cns(struct mapistore_context *, const char *, TALLOC_CTX *, uint64_t, struct UI8Array_r **);
 
 /* definitions from mapistore_replica_mapping.c */
 enum mapistore_error mapistore_replica_mapping_add(struct mapistore_context *, const char *, struct replica_mapping_context_list **);
@@ -432,52 +432,233 @@ _PUBLIC_ enum mapistore_error mapistore_backend_delete_context(struct backend_co
 }
 
 
+#define	MAPISTORE_CONTEXT_INDEX_MIN	16
+
+static uint32_t mapistore_backend_uri_hash(const char *uri)
+{
+	uint32_t	hash = 2166136261U;
+
+	/* FNV-1a */
+	for (; *uri; uri++) {
+		hash ^= (uint8_t) *uri;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
 /**
-   \details find the context matching given context identifier
+   \details Resize the URI hash table of the context index
 
-   \param backend_list_ctx pointer to the backend context list
-   \param context_id the context identifier to search
+   \param index pointer to the context index
+   \param size the new number of buckets, a power of 2
 
-   \return Pointer to the mapistore_backend context on success, otherwise NULL
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
  */
-_PUBLIC_ struct backend_context *mapistore_backend_lookup(struct backend_context_list *backend_list_ctx,
-							  uint32_t context_id)
+static enum mapistore_error mapistore_backend_index_rehash(struct backend_context_index *index, uint32_t size)
 {
+	struct backend_context_list	**by_uri;
 	struct backend_context_list	*el;
+	uint32_t			i, bucket;
+
+	by_uri = talloc_zero_array(index, struct backend_context_list *, size);
+	MAPISTORE_RETVAL_IF(!by_uri, MAPISTORE_ERR_NO_MEMORY, NULL);
+
+	for (i = 0; i < index->uri_size; i++) {
+		while ((el = index->by_uri[i])) {
+			DLIST_REMOVE(index->by_uri[i], el);
+			bucket = mapistore_backend_uri_hash(el->ctx->uri) & (size - 1);
+			DLIST_ADD_END(by_uri[bucket], el, struct backend_context_list *);
+		}
+	}
+
+	talloc_free(index->by_uri);
+	index->by_uri = by_uri;
+	index->uri_size = size;
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Index a context newly added to the mapistore context list
+
+   Contexts are indexed by identifier in an array, context identifiers
+   being allocated densely by mapistore_get_context_id, and by URI in a
+   hash table.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_list the context list element to index
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_backend_index_add(struct mapistore_context *mstore_ctx,
+						 struct backend_context_list *backend_list)
+{
+	struct backend_context_index	*index;
+	struct backend_context_list	**by_id;
+	struct backend_context_list	*el;
+	uint32_t			context_id;
+	uint32_t			size;
+	uint32_t			bucket;
+	enum mapistore_error		retval;
 
 	/* Sanity checks */
-	if (!backend_list_ctx) return NULL;
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!backend_list || !backend_list->ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
-	for (el = backend_list_ctx; el; el = el->next) {
-		if (el->ctx && el->ctx->context_id == context_id) {
-			return el->ctx;
+	if (!mstore_ctx->context_index) {
+		mstore_ctx->context_index = talloc_zero(mstore_ctx, struct backend_context_index);
+		MAPISTORE_RETVAL_IF(!mstore_ctx->context_index, MAPISTORE_ERR_NO_MEMORY, NULL);
+	}
+	index = mstore_ctx->context_index;
+
+	/* Step 1. Index by context identifier */
+	context_id = backend_list->ctx->context_id;
+	if (context_id >= index->id_size) {
+		size = index->id_size ? index->id_size : MAPISTORE_CONTEXT_INDEX_MIN;
+		while (context_id >= size) {
+			size *= 2;
 		}
+		by_id = talloc_realloc(index, index->by_id, struct backend_context_list *, size);
+		MAPISTORE_RETVAL_IF(!by_id, MAPISTORE_ERR_NO_MEMORY, NULL);
+		memset(by_id + index->id_size, 0, (size - index->id_size) * sizeof (struct backend_context_list *));
+		index->by_id = by_id;
+		index->id_size = size;
 	}
+	index->by_id[context_id] = backend_list;
 
-	return NULL;
+	/* Step 2. Index by URI */
+	if (!backend_list->ctx->uri) {
+		return MAPISTORE_SUCCESS;
+	}
+
+	if (index->count >= index->uri_size) {
+		retval = mapistore_backend_index_rehash(index, index->uri_size ? index->uri_size * 2 : MAPISTORE_CONTEXT_INDEX_MIN);
+		MAPISTORE_RETVAL_IF(retval, retval, NULL);
+	}
+
+	el = talloc_zero(index, struct backend_context_list);
+	MAPISTORE_RETVAL_IF(!el, MAPISTORE_ERR_NO_MEMORY, NULL);
+	el->ctx = backend_list->ctx;
+	bucket = mapistore_backend_uri_hash(el->ctx->uri) & (index->uri_size - 1);
+	DLIST_ADD_END(index->by_uri[bucket], el, struct backend_context_list *);
+	index->count++;
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Remove a context from the mapistore context index
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx the context to remove
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_backend_index_del(struct mapistore_context *mstore_ctx,
+						 struct backend_context *backend_ctx)
+{
+	struct backend_context_index	*index;
+	struct backend_context_list	*el;
+	uint32_t			bucket;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	index = mstore_ctx->context_index;
+	if (!index) return MAPISTORE_ERR_NOT_FOUND;
+
+	if (backend_ctx->context_id < index->id_size &&
+	    index->by_id[backend_ctx->context_id] &&
+	    index->by_id[backend_ctx->context_id]->ctx == backend_ctx) {
+		index->by_id[backend_ctx->context_id] = NULL;
+	}
+
+	if (!backend_ctx->uri || !index->uri_size) {
+		return MAPISTORE_SUCCESS;
+	}
+
+	bucket = mapistore_backend_uri_hash(backend_ctx->uri) & (index->uri_size - 1);
+	for (el = index->by_uri[bucket]; el; el = el->next) {
+		if (el->ctx == backend_ctx) {
+			DLIST_REMOVE(index->by_uri[bucket], el);
+			talloc_free(el);
+			index->count--;
+			break;
+		}
+	}
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details find the context list element matching given context identifier
+
+   \param mstore_ctx pointer to the mapistore context
+   \param context_id the context identifier to search
+
+   \return Pointer to the context list element on success, otherwise NULL
+ */
+struct backend_context_list *mapistore_backend_lookup_list(struct mapistore_context *mstore_ctx,
+							   uint32_t context_id)
+{
+	struct backend_context_index	*index;
+
+	/* Sanity checks */
+	if (!mstore_ctx || !mstore_ctx->context_index) return NULL;
+
+	index = mstore_ctx->context_index;
+	if (context_id >= index->id_size) return NULL;
+
+	return index->by_id[context_id];
+}
+
+/**
+   \details find the context matching given context identifier
+
+   \param mstore_ctx pointer to the mapistore context
+   \param context_id the context identifier to search
+
+   \return Pointer to the mapistore_backend context on success, otherwise NULL
+ */
+_PUBLIC_ struct backend_context *mapistore_backend_lookup(struct mapistore_context *mstore_ctx,
+							  uint32_t context_id)
+{
+	struct backend_context_list	*el;
+
+	el = mapistore_backend_lookup_list(mstore_ctx, context_id);
+	if (!el) return NULL;
+
+	return el->ctx;
 }
 
 /**
    \details find the context matching given uri string
 
-   \param backend_list_ctx pointer to the backend context list
+   \param mstore_ctx pointer to the mapistore context
    \param uri the uri string to search
 
    \return Pointer to the mapistore_backend context on success,
    otherwise NULL
  */
-_PUBLIC_ struct backend_context *mapistore_backend_lookup_by_uri(struct backend_context_list *backend_list_ctx,
+_PUBLIC_ struct backend_context *mapistore_backend_lookup_by_uri(struct mapistore_context *mstore_ctx,
 								 const char *uri)
 {
+	struct backend_context_index	*index;
 	struct backend_context_list	*el;
+	uint32_t			bucket;
 
 	/* sanity checks */
-	if (!backend_list_ctx) return NULL;
+	if (!mstore_ctx || !mstore_ctx->context_index) return NULL;
 	if (!uri) return NULL;
 
-	for (el = backend_list_ctx; el; el = el->next) {
-		if (el->ctx && el->ctx->uri &&
-		    !strcmp(el->ctx->uri, uri)) {
+	index = mstore_ctx->context_index;
+	if (!index->uri_size) return NULL;
+
+	bucket = mapistore_backend_uri_hash(uri) & (index->uri_size - 1);
+	for (el = index->by_uri[bucket]; el; el = el->next) {
+		if (!strcmp(el->ctx->uri, uri)) {
 			return el->ctx;
 		}
 	}
@@ -631,6 +812,16 @@ enum mapistore_error mapistore_backend_folder_get_child_fid_by_name(struct backe
 	return ret;
 }
 
+enum mapistore_error mapistore_backend_folder_get_child_fmids(struct backend_context *bctx, void *folder, TALLOC_CTX *mem_ctx,
+							     enum mapistore_table_type table_type, uint64_t **fmids, uint32_t *count)
+{
+	if (!bctx->backend->folder.get_child_fmids) {
+		return MAPISTORE_ERR_NOT_IMPLEMENTED;
+	}
+
+	return bctx->backend->folder.get_child_fmids(folder, mem_ctx, table_type, fmids, count);
+}
+
 enum mapistore_error mapistore_backend_folder_open_table(struct backend_context *bctx, void *folder,
 							 TALLOC_CTX *mem_ctx, enum mapistore_table_type table_type, uint32_t handle_id, void **table, uint32_t *row_count)
 {
@@ -648,6 +839,15 @@ enum mapistore_error mapistore_backend_folder_preload_message_bodies(struct back
         return bctx->backend->folder.preload_message_bodies(folder, table_type, mids);
 }
 
+enum mapistore_error mapistore_backend_folder_save_messages(struct backend_context *bctx, void *folder, TALLOC_CTX *mem_ctx, uint32_t count, void **messages)
+{
+	if (!bctx->backend->folder.save_messages) {
+		return MAPISTORE_ERR_NOT_IMPLEMENTED;
+	}
+
+	return bctx->backend->folder.save_messages(folder, mem_ctx, count, messages);
+}
+
 enum mapistore_error mapistore_backend_message_get_message_data(struct backend_context *bctx, void *message, TALLOC_CTX *mem_ctx, struct mapistore_message **msg)
 {
 	return bctx->backend->message.get_message_data(message, mem_ctx, msg);
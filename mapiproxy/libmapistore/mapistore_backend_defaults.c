@@ -165,6 +165,16 @@ static enum mapistore_error mapistore_op_defaults_get_child_count(void *folder_o
 	return MAPISTORE_ERR_NOT_IMPLEMENTED;
 }
 
+static enum mapistore_error mapistore_op_defaults_get_child_fmids(void *folder_object,
+								  TALLOC_CTX *mem_ctx,
+								  enum mapistore_table_type table_type,
+								  uint64_t **fmidsp,
+								  uint32_t *countp)
+{
+	DEBUG(3, ("[%s:%d] MAPISTORE defaults - MAPISTORE_ERR_NOT_IMPLEMENTED\n", __FUNCTION__, __LINE__));
+	return MAPISTORE_ERR_NOT_IMPLEMENTED;
+}
+
 static enum mapistore_error mapistore_op_defaults_open_table(void *folder_object,
 							     TALLOC_CTX *mem_ctx,
 							     enum mapistore_table_type table_type,
@@ -370,6 +380,7 @@ extern enum mapistore_error mapistore_backend_init_defaults(struct mapistore_bac
 	backend->folder.move_copy_messages = mapistore_op_defaults_move_copy_messages;
 	backend->folder.get_deleted_fmids = mapistore_op_defaults_get_deleted_fmids;
 	backend->folder.get_child_count = mapistore_op_defaults_get_child_count;
+	backend->folder.get_child_fmids = mapistore_op_defaults_get_child_fmids;
 	backend->folder.open_table = mapistore_op_defaults_open_table;
 	backend->folder.modify_permissions = mapistore_op_defaults_modify_permissions;
 
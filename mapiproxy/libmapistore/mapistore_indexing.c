@@ -38,6 +38,72 @@
 
 #include <tdb.h>
 
+/**
+   \details Start the write-back transaction of an indexing context
+   if the mode is enabled and no transaction is open yet
+
+   Failing to start it is not fatal: the write goes straight to the
+   database.
+
+   \param ictx pointer to the indexing context
+ */
+static void mapistore_indexing_write_begin(struct indexing_context_list *ictx)
+{
+	if (!ictx->write_back || ictx->transaction_depth || ictx->write_back_pending) return;
+
+	if (tdb_transaction_start(ictx->index_ctx->tdb) == -1) {
+		DEBUG(3, ("[%s:%d]: Unable to start write-back transaction: %s\n", __FUNCTION__, __LINE__,
+			  tdb_errorstr(ictx->index_ctx->tdb)));
+		return;
+	}
+	ictx->write_back_pending = true;
+	ictx->write_back_start = time(NULL);
+}
+
+/**
+   \details Commit the updates held by the write-back transaction of
+   an indexing context
+
+   Nothing is done while an indexing batch is open, or unless force
+   is set, before the write-back interval has elapsed.
+
+   \param ictx pointer to the indexing context
+   \param force whether the interval should be ignored
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+static enum mapistore_error mapistore_indexing_write_back(struct indexing_context_list *ictx, bool force)
+{
+	if (!ictx->write_back_pending || ictx->transaction_depth) return MAPISTORE_SUCCESS;
+	if (!force && (time(NULL) - ictx->write_back_start) < ictx->write_back) return MAPISTORE_SUCCESS;
+
+	ictx->write_back_pending = false;
+	if (tdb_transaction_commit(ictx->index_ctx->tdb) == -1) {
+		DEBUG(1, ("[%s:%d]: Unable to commit write-back transaction of %s: %s\n", __FUNCTION__, __LINE__,
+			  ictx->username, tdb_errorstr(ictx->index_ctx->tdb)));
+		return MAPISTORE_ERR_DATABASE_OPS;
+	}
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Write the pending updates before the indexing database
+   is closed
+ */
+static int mapistore_indexing_context_destructor(struct indexing_context_list *ictx)
+{
+	if (ictx->transaction_depth) {
+		DEBUG(1, ("[%s:%d]: indexing batch of %s left open, cancelled\n", __FUNCTION__, __LINE__, ictx->username));
+		tdb_transaction_cancel(ictx->index_ctx->tdb);
+	}
+	else {
+		mapistore_indexing_write_back(ictx, true);
+	}
+
+	return 0;
+}
+
 /**
    \details Search the indexing record matching the username
 
@@ -106,6 +172,8 @@ _PUBLIC_ enum mapistore_error mapistore_indexing_add(struct mapistore_context *m
 	}
 	ictx->username = talloc_strdup(ictx, username);
 	/* ictx->ref_count = 0; */
+	ictx->write_back = mstore_ctx->indexing_write_back;
+	talloc_set_destructor(ictx, mapistore_indexing_context_destructor);
 	DLIST_ADD_END(mstore_ctx->indexing_list, ictx, struct indexing_context_list *);
 
 	*ictxp = ictx;
@@ -213,6 +281,7 @@ enum mapistore_error mapistore_indexing_record_add(TALLOC_CTX *mem_ctx,
 	dbuf.dptr = (unsigned char *) talloc_strdup(mem_ctx, mapistore_URI);
 	dbuf.dsize = strlen((const char *) dbuf.dptr);
 
+	mapistore_indexing_write_begin(ictx);
 	ret = tdb_store(ictx->index_ctx->tdb, key, dbuf, TDB_INSERT);
 	talloc_free(key.dptr);
 	talloc_free(dbuf.dptr);
@@ -223,7 +292,7 @@ enum mapistore_error mapistore_indexing_record_add(TALLOC_CTX *mem_ctx,
 		return MAPISTORE_ERR_DATABASE_OPS;
 	}
 
-	return MAPISTORE_SUCCESS;
+	return mapistore_indexing_write_back(ictx, false);
 }
 
 /**
@@ -252,7 +321,7 @@ enum mapistore_error mapistore_indexing_record_add_fmid(struct mapistore_context
 	MAPISTORE_RETVAL_IF(!fmid, MAPISTORE_ERROR, NULL);
 
 	/* Ensure the context exists */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 	MAPISTORE_RETVAL_IF(!backend_ctx->indexing, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
@@ -305,7 +374,7 @@ enum mapistore_error mapistore_indexing_record_del_fmid(struct mapistore_context
 	MAPISTORE_RETVAL_IF(!fmid, MAPISTORE_ERROR, NULL);
 
 	/* Ensure the context exists */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 	MAPISTORE_RETVAL_IF(!backend_ctx->indexing, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
@@ -324,6 +393,7 @@ enum mapistore_error mapistore_indexing_record_del_fmid(struct mapistore_context
 	}
 	key.dsize = strlen((const char *) key.dptr);
 
+	mapistore_indexing_write_begin(ictx);
 	switch (flags) {
 	case MAPISTORE_SOFT_DELETE:
 		/* nothing to do if the record is already soft deleted */
@@ -346,10 +416,15 @@ enum mapistore_error mapistore_indexing_record_del_fmid(struct mapistore_context
 		ret = tdb_delete(ictx->index_ctx->tdb, key);
 		talloc_free(key.dptr);
 		MAPISTORE_RETVAL_IF(ret, MAPISTORE_ERR_DATABASE_OPS, NULL);
+		key.dptr = (unsigned char *) talloc_asprintf(mstore_ctx, "%s0x%.16"PRIx64,
+							     MAPISTORE_PROPERTY_GROUPS_TAG, fmid);
+		key.dsize = strlen((const char *) key.dptr);
+		tdb_delete(ictx->index_ctx->tdb, key);
+		talloc_free(key.dptr);
 		break;
 	}
 	
-	return MAPISTORE_SUCCESS;
+	return mapistore_indexing_write_back(ictx, false);
 }
 
 /**
@@ -441,6 +516,12 @@ static int tdb_get_fid_traverse(struct tdb_context *tdb_ctx, TDB_DATA key, TDB_D
 	TALLOC_CTX		*mem_ctx;
 	int			ret = 0;
 
+	/* per-message property group records don't hold URIs */
+	if (key.dsize >= strlen(MAPISTORE_PROPERTY_GROUPS_TAG)
+	    && !strncmp((const char *) key.dptr, MAPISTORE_PROPERTY_GROUPS_TAG, strlen(MAPISTORE_PROPERTY_GROUPS_TAG))) {
+		return 0;
+	}
+
 	mem_ctx = talloc_zero(NULL, void);
 	tdb_data = data;
 	cmp_uri = talloc_array(mem_ctx, char, value.dsize + 1);
@@ -469,6 +550,12 @@ static int tdb_get_fid_traverse_partial(struct tdb_context *tdb_ctx, TDB_DATA ke
 	TALLOC_CTX		*mem_ctx;
 	int			ret = 0;
 
+	/* per-message property group records don't hold URIs */
+	if (key.dsize >= strlen(MAPISTORE_PROPERTY_GROUPS_TAG)
+	    && !strncmp((const char *) key.dptr, MAPISTORE_PROPERTY_GROUPS_TAG, strlen(MAPISTORE_PROPERTY_GROUPS_TAG))) {
+		return 0;
+	}
+
 	mem_ctx = talloc_zero(NULL, void);
 	tdb_data = data;
 	cmp_uri = talloc_array(mem_ctx, char, value.dsize + 1);
@@ -567,6 +654,182 @@ _PUBLIC_ enum mapistore_error mapistore_indexing_record_get_fmid(struct mapistor
 	return ret;
 }
 
+/**
+   \details Start an indexing batch
+
+   Every indexing update made until the matching
+   mapistore_indexing_transaction_commit call is written in a single
+   TDB transaction, instead of one synchronous write each. Batches
+   can be nested: only the outermost commit reaches the database.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param username the name of the account where to look for the
+   indexing database
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_transaction_start(struct mapistore_context *mstore_ctx, const char *username)
+{
+	struct indexing_context_list	*ictx;
+	enum mapistore_error		ret;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!username, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+
+	ret = mapistore_indexing_add(mstore_ctx, username, &ictx);
+	MAPISTORE_RETVAL_IF(ret, MAPISTORE_ERROR, NULL);
+	MAPISTORE_RETVAL_IF(!ictx, MAPISTORE_ERROR, NULL);
+
+	/* pending write-back updates are committed first, so that
+	   cancelling the batch only discards its own updates */
+	if (!ictx->transaction_depth) {
+		ret = mapistore_indexing_write_back(ictx, true);
+		MAPISTORE_RETVAL_IF(ret, ret, NULL);
+
+		if (tdb_transaction_start(ictx->index_ctx->tdb) == -1) {
+			DEBUG(3, ("[%s:%d]: Unable to start transaction: %s\n", __FUNCTION__, __LINE__,
+				  tdb_errorstr(ictx->index_ctx->tdb)));
+			return MAPISTORE_ERR_DATABASE_OPS;
+		}
+		if (ictx->write_back) {
+			ictx->write_back_pending = true;
+			ictx->write_back_start = time(NULL);
+		}
+	}
+	ictx->transaction_depth++;
+
+	return MAPISTORE_SUCCESS;
+}
+
+
+/**
+   \details Commit an indexing batch
+
+   In write-back mode, the updates are kept with the other pending
+   ones and only written once the write-back interval has elapsed.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param username the name of the account where to look for the
+   indexing database
+
+   \return MAPISTORE_SUCCESS on success, MAPISTORE_ERR_DATABASE_OPS
+   if a nested batch was cancelled or the commit failed, otherwise
+   MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_transaction_commit(struct mapistore_context *mstore_ctx, const char *username)
+{
+	struct indexing_context_list	*ictx;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!username, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+
+	ictx = mapistore_indexing_search(mstore_ctx, username);
+	MAPISTORE_RETVAL_IF(!ictx, MAPISTORE_ERR_NOT_FOUND, NULL);
+	MAPISTORE_RETVAL_IF(!ictx->transaction_depth, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	ictx->transaction_depth--;
+	if (ictx->transaction_depth) return MAPISTORE_SUCCESS;
+
+	if (ictx->transaction_failed) {
+		ictx->transaction_failed = false;
+		ictx->write_back_pending = false;
+		tdb_transaction_cancel(ictx->index_ctx->tdb);
+		return MAPISTORE_ERR_DATABASE_OPS;
+	}
+
+	if (ictx->write_back_pending) {
+		return mapistore_indexing_write_back(ictx, false);
+	}
+
+	if (tdb_transaction_commit(ictx->index_ctx->tdb) == -1) {
+		DEBUG(3, ("[%s:%d]: Unable to commit transaction: %s\n", __FUNCTION__, __LINE__,
+			  tdb_errorstr(ictx->index_ctx->tdb)));
+		return MAPISTORE_ERR_DATABASE_OPS;
+	}
+
+	return MAPISTORE_SUCCESS;
+}
+
+
+/**
+   \details Cancel an indexing batch
+
+   Cancelling a nested batch makes the outermost commit fail. Only
+   the updates made within the batch are discarded: the write-back
+   updates pending when it was started have already been written.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param username the name of the account where to look for the
+   indexing database
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_transaction_cancel(struct mapistore_context *mstore_ctx, const char *username)
+{
+	struct indexing_context_list	*ictx;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!username, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+
+	ictx = mapistore_indexing_search(mstore_ctx, username);
+	MAPISTORE_RETVAL_IF(!ictx, MAPISTORE_ERR_NOT_FOUND, NULL);
+	MAPISTORE_RETVAL_IF(!ictx->transaction_depth, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	ictx->transaction_depth--;
+	if (ictx->transaction_depth) {
+		ictx->transaction_failed = true;
+		return MAPISTORE_SUCCESS;
+	}
+
+	ictx->transaction_failed = false;
+	ictx->write_back_pending = false;
+	tdb_transaction_cancel(ictx->index_ctx->tdb);
+
+	return MAPISTORE_SUCCESS;
+}
+
+
+/**
+   \details Write the updates held by the write-back mode of the
+   indexing databases
+
+   The write-back mode is enabled with the "mapistore:indexing_write_back"
+   parametric option, set to the number of seconds updates may stay
+   in memory. Pending updates are written by the first update or
+   flush made after the interval, and when the mapistore context is
+   released. They are lost if the process dies in between, and other
+   processes cannot write to the same indexing database until they
+   are written: callers should flush regularly, e.g. at the end of
+   each request and from a timer while the connection is idle.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param force whether pending updates should be written before the
+   interval has elapsed
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_flush(struct mapistore_context *mstore_ctx, bool force)
+{
+	struct indexing_context_list	*el;
+	enum mapistore_error		ret, retval = MAPISTORE_SUCCESS;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+
+	for (el = mstore_ctx->indexing_list; el; el = el->next) {
+		ret = mapistore_indexing_write_back(el, force);
+		if (ret != MAPISTORE_SUCCESS) {
+			retval = ret;
+		}
+	}
+
+	return retval;
+}
+
+
 /**
    \details Add a fid record to the indexing database
 
@@ -645,3 +908,136 @@ _PUBLIC_ enum mapistore_error mapistore_indexing_record_del_mid(struct mapistore
 {
 	return mapistore_indexing_record_del_fmid(mstore_ctx, context_id, username, mid, flags);
 }
+
+
+/**
+   \details Record the change number of the property groups modified
+   on a message
+
+   Each message may have a record holding one change number per
+   property group, used to send partial message changes to ICS
+   clients. Groups not in the mask keep their previous change
+   number. When the message has no record yet, they are set to 0,
+   which means "unknown" and forces a full message change.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param username the name of the account where to look for the
+   indexing database
+   \param mid the message identifier
+   \param group_count the number of property groups
+   \param groups bitmask of the property groups that changed
+   \param cn the change number the message was saved with
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_record_set_group_cns(struct mapistore_context *mstore_ctx, const char *username, uint64_t mid, uint32_t group_count, uint32_t groups, uint64_t cn)
+{
+	TALLOC_CTX			*mem_ctx;
+	struct indexing_context_list	*ictx;
+	struct UI8Array_r		*cns = NULL;
+	TDB_DATA			key, dbuf;
+	char				*value;
+	uint32_t			i;
+	int				ret;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!username, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!mid, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	MAPISTORE_RETVAL_IF(!group_count || group_count > 32, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	ret = mapistore_indexing_add(mstore_ctx, username, &ictx);
+	MAPISTORE_RETVAL_IF(ret, MAPISTORE_ERROR, NULL);
+	MAPISTORE_RETVAL_IF(!ictx, MAPISTORE_ERROR, NULL);
+
+	mem_ctx = talloc_named(NULL, 0, "mapistore_indexing_record_set_group_cns");
+
+	ret = mapistore_indexing_record_get_group_cns(mstore_ctx, username, mem_ctx, mid, &cns);
+	if (ret != MAPISTORE_SUCCESS || cns->cValues != group_count) {
+		cns = talloc_zero(mem_ctx, struct UI8Array_r);
+		cns->cValues = group_count;
+		cns->lpui8 = talloc_zero_array(cns, uint64_t, group_count);
+	}
+
+	value = talloc_strdup(mem_ctx, "");
+	for (i = 0; i < group_count; i++) {
+		if (groups & (1 << i)) {
+			cns->lpui8[i] = cn;
+		}
+		value = talloc_asprintf_append(value, "%s0x%.16"PRIx64, i ? "," : "", cns->lpui8[i]);
+	}
+
+	key.dptr = (unsigned char *) talloc_asprintf(mem_ctx, "%s0x%.16"PRIx64,
+						     MAPISTORE_PROPERTY_GROUPS_TAG, mid);
+	key.dsize = strlen((const char *) key.dptr);
+	dbuf.dptr = (unsigned char *) value;
+	dbuf.dsize = strlen(value);
+
+	mapistore_indexing_write_begin(ictx);
+	ret = tdb_store(ictx->index_ctx->tdb, key, dbuf, TDB_REPLACE);
+	talloc_free(mem_ctx);
+	if (ret == -1) {
+		DEBUG(3, ("[%s:%d]: Unable to store property groups of 0x%.16"PRIx64"\n", __FUNCTION__, __LINE__, mid));
+		return MAPISTORE_ERR_DATABASE_OPS;
+	}
+
+	return mapistore_indexing_write_back(ictx, false);
+}
+
+
+/**
+   \details Retrieve the change numbers of the property groups of a
+   message
+
+   \param mstore_ctx pointer to the mapistore context
+   \param username the name of the account where to look for the
+   indexing database
+   \param mem_ctx pointer to the memory context
+   \param mid the message identifier
+   \param cnsp pointer to the returned array of change numbers, one
+   per property group
+
+   \return MAPISTORE_SUCCESS on success, MAPISTORE_ERR_NOT_FOUND if
+   the message has no record, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_indexing_record_get_group_cns(struct mapistore_context *mstore_ctx, const char *username, TALLOC_CTX *mem_ctx, uint64_t mid, struct UI8Array_r **cnsp)
+{
+	struct indexing_context_list	*ictx;
+	struct UI8Array_r		*cns;
+	TDB_DATA			key, dbuf;
+	char				*value, *cur, *next;
+	int				ret;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!mstore_ctx, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!username, MAPISTORE_ERR_NOT_INITIALIZED, NULL);
+	MAPISTORE_RETVAL_IF(!cnsp, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	ret = mapistore_indexing_add(mstore_ctx, username, &ictx);
+	MAPISTORE_RETVAL_IF(ret, MAPISTORE_ERROR, NULL);
+	MAPISTORE_RETVAL_IF(!ictx, MAPISTORE_ERROR, NULL);
+
+	key.dptr = (unsigned char *) talloc_asprintf(mem_ctx, "%s0x%.16"PRIx64,
+						     MAPISTORE_PROPERTY_GROUPS_TAG, mid);
+	key.dsize = strlen((const char *) key.dptr);
+	dbuf = tdb_fetch(ictx->index_ctx->tdb, key);
+	talloc_free(key.dptr);
+	MAPISTORE_RETVAL_IF(!dbuf.dptr, MAPISTORE_ERR_NOT_FOUND, NULL);
+
+	value = talloc_strndup(mem_ctx, (const char *) dbuf.dptr, dbuf.dsize);
+	free(dbuf.dptr);
+
+	cns = talloc_zero(mem_ctx, struct UI8Array_r);
+	for (cur = value; cur && *cur; cur = next) {
+		cns->lpui8 = talloc_realloc(cns, cns->lpui8, uint64_t, cns->cValues + 1);
+		cns->lpui8[cns->cValues] = strtoull(cur, &next, 16);
+		cns->cValues++;
+		if (next == cur) break;
+		if (*next == ',') next++;
+	}
+	talloc_free(value);
+
+	*cnsp = cns;
+
+	return MAPISTORE_SUCCESS;
+}
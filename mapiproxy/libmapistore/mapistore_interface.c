@@ -86,11 +86,14 @@ _PUBLIC_ struct mapistore_context *mapistore_init(TALLOC_CTX *mem_ctx, struct lo
 	}
 
 	mstore_ctx->context_list = NULL;
+	mstore_ctx->context_index = NULL;
+	mstore_ctx->freebusy_cache = NULL;
 	mstore_ctx->indexing_list = talloc_zero(mstore_ctx, struct indexing_context_list);
 	mstore_ctx->replica_mapping_list = talloc_zero(mstore_ctx, struct replica_mapping_context_list);
 	mstore_ctx->notifications = NULL;
 	mstore_ctx->subscriptions = NULL;
 	mstore_ctx->conn_info = NULL;
+	mstore_ctx->indexing_write_back = lpcfg_parm_int(lp_ctx, NULL, "mapistore", "indexing_write_back", 0);
 
 	mstore_ctx->nprops_ctx = NULL;
 	retval = mapistore_namedprops_init(mstore_ctx, &(mstore_ctx->nprops_ctx));
@@ -134,6 +137,8 @@ _PUBLIC_ enum mapistore_error mapistore_release(struct mapistore_context *mstore
 	talloc_free(mstore_ctx->nprops_ctx);
 	talloc_free(mstore_ctx->processing_ctx);
 	talloc_free(mstore_ctx->context_list);
+	talloc_free(mstore_ctx->context_index);
+	mstore_ctx->context_index = NULL;
 
 	return MAPISTORE_SUCCESS;
 }
@@ -230,6 +235,12 @@ _PUBLIC_ enum mapistore_error mapistore_add_context(struct mapistore_context *ms
 			talloc_free(mem_ctx);
 			return MAPISTORE_ERR_CONTEXT_FAILED;
 		}
+		retval = mapistore_backend_index_add(mstore_ctx, backend_list);
+		if (retval != MAPISTORE_SUCCESS) {
+			mapistore_free_context_id(mstore_ctx->processing_ctx, backend_list->ctx->context_id);
+			talloc_free(mem_ctx);
+			return retval;
+		}
 		*context_id = backend_list->ctx->context_id;
 		*backend_object = backend_list->ctx->root_folder_object;
 		DLIST_ADD_END(mstore_ctx->context_list, backend_list, struct backend_context_list *);
@@ -266,7 +277,7 @@ _PUBLIC_ enum mapistore_error mapistore_add_context_ref_count(struct mapistore_c
 
 	/* Step 0. Ensure the context exists */
 	DEBUG(0, ("mapistore_add_context_ref_count: context_is to increment is %d\n", context_id));
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 1. Increment the ref count */
@@ -303,7 +314,7 @@ _PUBLIC_ enum mapistore_error mapistore_search_context_by_uri(struct mapistore_c
 
 	if (!uri) return MAPISTORE_ERROR;
 
-	backend_ctx = mapistore_backend_lookup_by_uri(mstore_ctx->context_list, uri);
+	backend_ctx = mapistore_backend_lookup_by_uri(mstore_ctx, uri);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_NOT_FOUND, NULL);
 
 	*context_id = backend_ctx->context_id;
@@ -328,7 +339,6 @@ _PUBLIC_ enum mapistore_error mapistore_del_context(struct mapistore_context *ms
 	struct backend_context_list	*backend_list;
 	struct backend_context		*backend_ctx;
 	int				retval;
-	bool				found = false;
 
 	/* Sanity checks */
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
@@ -337,19 +347,9 @@ _PUBLIC_ enum mapistore_error mapistore_del_context(struct mapistore_context *ms
 
 	/* Step 0. Ensure the context exists */
 	DEBUG(0, ("mapistore_del_context: context_id to del is %d\n", context_id));
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
-	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
-
-	/* search the backend_list item */
-	for (backend_list = mstore_ctx->context_list; backend_list; backend_list = backend_list->next) {
-		if (backend_list->ctx->context_id == context_id) {
-			found = true;
-			break;
-		}		
-	}
-	if (found == false) {
-		return MAPISTORE_ERROR;
-	}
+	backend_list = mapistore_backend_lookup_list(mstore_ctx, context_id);
+	MAPISTORE_RETVAL_IF(!backend_list, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	backend_ctx = backend_list->ctx;
 
 	/* Step 1. Release the indexing context within backend */
 	/* if (backend_ctx->indexing) {
@@ -362,7 +362,11 @@ _PUBLIC_ enum mapistore_error mapistore_del_context(struct mapistore_context *ms
 		}
 	} */
 
-	/* Step 2. Delete the context within backend */
+	/* Step 2. Delete the context within backend, the last reference
+	 * releases it and it must leave the index first */
+	if (backend_ctx->ref_count == 1) {
+		mapistore_backend_index_del(mstore_ctx, backend_ctx);
+	}
 	retval = mapistore_backend_delete_context(backend_ctx);
 	
 	switch (retval) {
@@ -491,7 +495,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_open_folder(struct mapistore_cont
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend open_folder */
@@ -520,7 +524,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_create_folder(struct mapistore_co
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);	
 	
 	/* Step 2. Call backend create_folder */
@@ -556,7 +560,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_delete(struct mapistore_context *
 	mem_ctx = talloc_zero(NULL, TALLOC_CTX);
 
 	/* Step 1. Find the backend context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	if (!backend_ctx) {
 		ret = MAPISTORE_ERR_INVALID_PARAMETER;
 		goto end;
@@ -657,7 +661,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_open_message(struct mapistore_con
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend open_message */
@@ -686,7 +690,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_create_message(struct mapistore_c
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 	
 	/* Step 2. Call backend create_message */
@@ -714,7 +718,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_delete_message(struct mapistore_c
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -733,7 +737,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_move_copy_messages(struct mapisto
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -752,7 +756,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_move_folder(struct mapistore_cont
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -772,7 +776,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_copy_folder(struct mapistore_cont
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -802,7 +806,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_get_deleted_fmids(struct mapistor
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -827,7 +831,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_get_child_count(struct mapistore_
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 0. Ensure the context exists */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend get_child_count */
@@ -835,21 +839,24 @@ _PUBLIC_ enum mapistore_error mapistore_folder_get_child_count(struct mapistore_
 }
 
 /**
-   \details Retrieve the folder IDs of child folders within a mapistore
-   folder
+   \details Retrieve the identifiers of the children of a mapistore
+   folder by reading them row by row from a table of the folder
+
+   This is the generic implementation of
+   mapistore_folder_get_child_fmids, used for backends which do not
+   implement the get_child_fmids folder operation.
 
    \param mstore_ctx pointer to the mapistore context
    \param context_id the context identifier referencing the backend
-   \param fid the folder identifier (for the parent folder)
-   \param child_fids pointer to where to return the array of child fids
-   \param child_fid_count pointer to the count result to return
+   \param folder pointer to the parent folder
+   \param table_type the type of children to enumerate
+   \param mem_ctx pointer to the memory context
+   \param child_fmids pointer to where to return the array of child fmids
+   \param child_fmid_count pointer to the count result to return
 
-   \note The caller is responsible for freeing the \p child_fids array
-   when it is no longer required.
-   
    \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE errors
  */
-_PUBLIC_ enum mapistore_error mapistore_folder_get_child_fmids(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, enum mapistore_table_type table_type, TALLOC_CTX *mem_ctx, uint64_t *child_fmids[], uint32_t *child_fmid_count)
+_PUBLIC_ enum mapistore_error mapistore_folder_get_child_fmids_from_table(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, enum mapistore_table_type table_type, TALLOC_CTX *mem_ctx, uint64_t *child_fmids[], uint32_t *child_fmid_count)
 {
 	TALLOC_CTX			*local_mem_ctx;
 	enum mapistore_error		ret;
@@ -889,16 +896,21 @@ _PUBLIC_ enum mapistore_error mapistore_folder_get_child_fmids(struct mapistore_
 		goto end;
 	}
 
-	*child_fmid_count = row_count;
 	fmids = talloc_array(mem_ctx, uint64_t, row_count);
-	*child_fmids = fmids;
 	current_fmid = fmids;
 	for (i = 0; i < row_count; i++) {
-		mapistore_table_get_row(mstore_ctx, context_id, backend_table, local_mem_ctx,
-					MAPISTORE_PREFILTERED_QUERY, i, &row_data);
+		ret = mapistore_table_get_row(mstore_ctx, context_id, backend_table, local_mem_ctx,
+					      MAPISTORE_PREFILTERED_QUERY, i, &row_data);
+		if (ret != MAPISTORE_SUCCESS || row_data->error != MAPISTORE_SUCCESS) {
+			continue;
+		}
 		*current_fmid = *(uint64_t *) row_data->data;
 		current_fmid++;
+		talloc_free(row_data);
 	}
+	*child_fmid_count = current_fmid - fmids;
+	*child_fmids = fmids;
+	ret = MAPISTORE_SUCCESS;
 
 end:
 	talloc_free(local_mem_ctx);
@@ -906,6 +918,49 @@ end:
 	return ret;
 }
 
+/**
+   \details Retrieve the identifiers of the children of a mapistore
+   folder
+
+   Backends implementing the get_child_fmids folder operation return the
+   whole array in one call. Otherwise the identifiers are read from a
+   table of the folder, see mapistore_folder_get_child_fmids_from_table.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param context_id the context identifier referencing the backend
+   \param folder pointer to the parent folder
+   \param table_type the type of children to enumerate
+   \param mem_ctx pointer to the memory context
+   \param child_fmids pointer to where to return the array of child fmids
+   \param child_fmid_count pointer to the count result to return
+
+   \note The caller is responsible for freeing the \p child_fmids array
+   when it is no longer required.
+   
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE errors
+ */
+_PUBLIC_ enum mapistore_error mapistore_folder_get_child_fmids(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, enum mapistore_table_type table_type, TALLOC_CTX *mem_ctx, uint64_t *child_fmids[], uint32_t *child_fmid_count)
+{
+	struct backend_context	*backend_ctx;
+	enum mapistore_error	ret;
+
+	/* Sanity checks */
+	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
+
+	/* Step 1. Search the context */
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
+	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	/* Step 2. Call backend operation */
+	ret = mapistore_backend_folder_get_child_fmids(backend_ctx, folder, mem_ctx, table_type, child_fmids, child_fmid_count);
+	if (ret != MAPISTORE_ERR_NOT_IMPLEMENTED) {
+		return ret;
+	}
+
+	/* Step 3. Fall back on reading a table */
+	return mapistore_folder_get_child_fmids_from_table(mstore_ctx, context_id, folder, table_type, mem_ctx, child_fmids, child_fmid_count);
+}
+
 _PUBLIC_ enum mapistore_error mapistore_folder_get_child_fid_by_name(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, const char *name, uint64_t *fidp)
 {
 	struct backend_context	*backend_ctx;
@@ -914,7 +969,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_get_child_fid_by_name(struct mapi
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -930,7 +985,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_open_table(struct mapistore_conte
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -945,7 +1000,7 @@ _PUBLIC_ enum mapistore_error mapistore_folder_modify_permissions(struct mapisto
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -960,13 +1015,67 @@ _PUBLIC_ enum mapistore_error mapistore_folder_preload_message_bodies(struct map
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
 	return mapistore_backend_folder_preload_message_bodies(backend_ctx, folder, table_type, mids);
 }
 
+/**
+   \details Tell whether the backend of a context can save several
+   messages of a folder at once
+
+   \param mstore_ctx pointer to the mapistore context
+   \param context_id the context identifier referencing the backend
+
+   \return true if mapistore_folder_save_messages is supported, false otherwise
+ */
+_PUBLIC_ bool mapistore_folder_can_save_messages(struct mapistore_context *mstore_ctx, uint32_t context_id)
+{
+	struct backend_context	*backend_ctx;
+
+	if (!mstore_ctx) return false;
+
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
+	if (!backend_ctx) return false;
+
+	return (backend_ctx->backend->folder.save_messages != NULL);
+}
+
+/**
+   \details Save several messages of a folder at once
+
+   This is the grouped counterpart of mapistore_message_save, used
+   for messages uploaded in bulk by ICS clients. Backends are free
+   to commit them in a single operation.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param context_id the context identifier referencing the backend
+   \param folder the folder holding the messages
+   \param mem_ctx pointer to the memory context
+   \param count the number of messages to save
+   \param messages array of backend message objects to save
+
+   \return MAPISTORE_SUCCESS on success, MAPISTORE_ERR_NOT_IMPLEMENTED
+   if the backend cannot save messages in bulk, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error mapistore_folder_save_messages(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, TALLOC_CTX *mem_ctx, uint32_t count, void **messages)
+{
+	struct backend_context	*backend_ctx;
+
+	/* Sanity checks */
+	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
+	MAPISTORE_RETVAL_IF(count && !messages, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	/* Step 1. Search the context */
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
+	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	/* Step 2. Call backend operation */
+	return mapistore_backend_folder_save_messages(backend_ctx, folder, mem_ctx, count, messages);
+}
+
 /* freebusy helper */
 static int mapistore_days_in_month(int month, int year)
 {
@@ -991,11 +1100,6 @@ static int mapistore_days_in_month(int month, int year)
 	return days;
 }
 
-static int mapistore_mins_in_ymon(uint32_t ymon)
-{
-	return mapistore_days_in_month((ymon & 0xf) - 1, ymon >> 4) * 24 * 60;
-}
-
 static inline void mapistore_freebusy_make_range(struct tm *start_time, struct tm *end_time)
 {
 	time_t							now;
@@ -1053,143 +1157,277 @@ static inline void mapistore_freebusy_make_range(struct tm *start_time, struct t
 	*end_time = time_data;
 }
 
-static void mapistore_freebusy_convert_filetime(struct FILETIME *ft_value, uint32_t *ymon, uint32_t *mins)
+/* Number of days between 1970-01-01 and the given date of the proleptic
+   Gregorian calendar, month being 1 to 12 */
+static int64_t mapistore_freebusy_days_from_civil(int64_t year, int64_t month, int64_t day)
 {
-	NTTIME		nt_time;
-	time_t		u_time;
-	struct tm	*gm_time;
+	int64_t		era, yoe, doy, doe;
 
-	nt_time = ((NTTIME) ft_value->dwHighDateTime << 32) | ft_value->dwLowDateTime;
-	u_time = nt_time_to_unix(nt_time);
-	gm_time = gmtime(&u_time);
+	year -= (month <= 2);
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = year - era * 400;
+	doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
 
-	*ymon = ((gm_time->tm_year + 1900) << 4) | (gm_time->tm_mon + 1);
-	*mins = gm_time->tm_min + (gm_time->tm_hour + ((gm_time->tm_mday - 1) * 24)) * 60;
+	return era * 146097 + doe - 719468;
 }
 
-static uint16_t mapistore_freebusy_find_month_range(uint32_t ymon, uint32_t *months_ranges, uint16_t nbr_months, bool *overflow)
+/* UTC counterpart of mktime, does not depend on the TZ environment */
+static time_t mapistore_freebusy_utc_time(const struct tm *tm)
 {
-	uint16_t	range;
+	int64_t		year, month, days;
 
-	if (nbr_months > 0) {
-		if (months_ranges[0] > ymon) {
-			*overflow = true;
-			return 0;
-		}
-		else {
-			if (months_ranges[nbr_months - 1] < ymon) {
-				*overflow = true;
-				return (nbr_months - 1);
-			}
-			else {
-				*overflow = false;
-				for (range = 0; range < nbr_months; range++) {
-					if (months_ranges[range] == ymon) {
-						return range;
-					}
-				}
-			}
-		}
+	year = tm->tm_year + 1900 + tm->tm_mon / 12;
+	month = tm->tm_mon % 12;
+	if (month < 0) {
+		month += 12;
+		year--;
 	}
+	days = mapistore_freebusy_days_from_civil(year, month + 1, 1) + tm->tm_mday - 1;
 
-	return (uint16_t) -1;
+	return (time_t) (((days * 24 + tm->tm_hour) * 60 + tm->tm_min) * 60 + tm->tm_sec);
+}
+
+/* Minutes since the epoch of the first day of a PidTagScheduleInfoMonths* month */
+static int64_t mapistore_freebusy_ymon_start(uint32_t ymon)
+{
+	return mapistore_freebusy_days_from_civil(ymon >> 4, ymon & 0xf, 1) * 24 * 60;
 }
 
-/* TODO: both following methods could be merged. This would certainly enhance performance by avoiding to wander through long arrays multiple times */
-static void mapistore_freebusy_fill_fbarray(uint8_t **minutes_array, uint32_t *months_ranges, uint16_t nbr_months, struct FILETIME *start, struct FILETIME *end)
+static int64_t mapistore_freebusy_ymon_end(uint32_t ymon)
 {
-	uint32_t	i, max, start_ymon, start_mins, end_ymon, end_mins;
-	uint16_t	start_mr_idx, end_mr_idx;
-	bool		start_range_overflow, end_range_overflow;
+	if ((ymon & 0xf) == 12) {
+		return mapistore_freebusy_days_from_civil((ymon >> 4) + 1, 1, 1) * 24 * 60;
+	}
+	return mapistore_freebusy_days_from_civil(ymon >> 4, (ymon & 0xf) + 1, 1) * 24 * 60;
+}
+
+struct mapistore_freebusy_interval {
+	int64_t		start;	/* minutes since the epoch, UTC */
+	int64_t		end;	/* excluded */
+};
 
-	mapistore_freebusy_convert_filetime(start, &start_ymon, &start_mins);
-	mapistore_freebusy_convert_filetime(end, &end_ymon, &end_mins);
+struct mapistore_freebusy_intervals {
+	struct mapistore_freebusy_interval	*intervals;
+	uint32_t				count;
+	uint32_t				size;
+};
 
-	start_mr_idx = mapistore_freebusy_find_month_range(start_ymon, months_ranges, nbr_months, &start_range_overflow);
-	if (start_range_overflow) {
-		start_mins = 0;
+static void mapistore_freebusy_add_interval(struct mapistore_freebusy_intervals *list, int64_t start, int64_t end)
+{
+	if (start >= end) {
+		return;
 	}
-	end_mr_idx = mapistore_freebusy_find_month_range(end_ymon, months_ranges, nbr_months, &end_range_overflow);
-	if (end_range_overflow) {
-		end_mins = mapistore_mins_in_ymon(end_ymon);
+
+	if (list->count == list->size) {
+		list->size = list->size ? list->size * 2 : 16;
+		list->intervals = talloc_realloc(list, list->intervals, struct mapistore_freebusy_interval, list->size);
 	}
+	list->intervals[list->count].start = start;
+	list->intervals[list->count].end = end;
+	list->count++;
+}
 
-	/* head */
-	if (end_mr_idx > start_mr_idx) {
-		/* end occurs after start range */
+static int mapistore_freebusy_interval_cmp(const void *a, const void *b)
+{
+	const struct mapistore_freebusy_interval	*ia = a;
+	const struct mapistore_freebusy_interval	*ib = b;
 
-		/* middle */
-		for (i = start_mr_idx + 1; i < end_mr_idx; i++) {
-			memset(minutes_array[i], 1, mapistore_mins_in_ymon(months_ranges[i]));
-		}
+	if (ia->start < ib->start) return -1;
+	if (ia->start > ib->start) return 1;
+	return 0;
+}
 
-		/* tail */
-		memset(minutes_array[end_mr_idx], 1, end_mins);
+/* Sort the intervals and merge the overlapping or adjacent ones, in place */
+static void mapistore_freebusy_merge_intervals(struct mapistore_freebusy_intervals *list)
+{
+	uint32_t	i, count;
 
-		max = mapistore_mins_in_ymon(start_ymon); /* = max chunk for first range */
+	if (list->count < 2) {
+		return;
 	}
-	else {
-		/* end occurs on same range as start */
 
-		max = end_mins;
+	qsort(list->intervals, list->count, sizeof (struct mapistore_freebusy_interval), mapistore_freebusy_interval_cmp);
+
+	count = 0;
+	for (i = 1; i < list->count; i++) {
+		if (list->intervals[i].start <= list->intervals[count].end) {
+			if (list->intervals[i].end > list->intervals[count].end) {
+				list->intervals[count].end = list->intervals[i].end;
+			}
+		}
+		else {
+			count++;
+			list->intervals[count] = list->intervals[i];
+		}
 	}
-	memset(minutes_array[start_mr_idx] + start_mins, 1, (max - start_mins));
+	list->count = count + 1;
 }
 
-static const int	max_mins_per_month = 31 * 24 * 60;
+/**
+   \details Encode merged intervals as PidTagScheduleInfoFreeBusy* blobs
+
+   Each month receives the list of its busy ranges as pairs of 16-bit
+   minute offsets from the start of the month, the end being inclusive.
 
-static void mapistore_freebusy_compile_fbarray(TALLOC_CTX *mem_ctx, uint8_t *minutes_array, struct Binary_r *fb_bin)
+   \param mem_ctx pointer to the memory context
+   \param list the merged intervals, sorted
+   \param months_ranges the months of the published range
+   \param nbr_months the number of months in the published range
+   \param fb_bins array of nbr_months binaries to fill
+ */
+static void mapistore_freebusy_compile_intervals(TALLOC_CTX *mem_ctx, struct mapistore_freebusy_intervals *list,
+						 uint32_t *months_ranges, uint16_t nbr_months, struct Binary_r *fb_bins)
 {
-	int			i;
-	bool			filled;
 	struct ndr_push		*ndr;
-	TALLOC_CTX		*local_mem_ctx;
-
-	local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+	int64_t			month_start, month_end, start, end;
+	uint32_t		i, month;
 
-	ndr = ndr_push_init_ctx(local_mem_ctx);
+	i = 0;
+	for (month = 0; month < nbr_months; month++) {
+		month_start = mapistore_freebusy_ymon_start(months_ranges[month]);
+		month_end = mapistore_freebusy_ymon_end(months_ranges[month]);
+
+		ndr = ndr_push_init_ctx(mem_ctx);
+		while (i < list->count && list->intervals[i].start < month_end) {
+			start = MAX(list->intervals[i].start, month_start);
+			end = MIN(list->intervals[i].end, month_end);
+			if (start < end) {
+				ndr_push_uint16(ndr, NDR_SCALARS, (uint16_t) (start - month_start));
+				ndr_push_uint16(ndr, NDR_SCALARS, (uint16_t) (end - month_start - 1));
+			}
+			if (list->intervals[i].end > month_end) {
+				/* continued on the next month */
+				break;
+			}
+			i++;
+		}
 
-	filled = (minutes_array[0] != 0);
-	if (filled) {
-		ndr_push_uint16(ndr, NDR_SCALARS, 0);
+		fb_bins[month].cb = ndr->offset;
+		fb_bins[month].lpb = ndr->data;
+		(void) talloc_steal(mem_ctx, ndr->data);
+		talloc_free(ndr);
 	}
+}
 
-	for (i = 1; i < max_mins_per_month; i++) {
-		if (filled && !minutes_array[i]) {
-			ndr_push_uint16(ndr, NDR_SCALARS, (i - 1));
-			filled = false;
-		}
-		else if (!filled && minutes_array[i]) {
-			ndr_push_uint16(ndr, NDR_SCALARS, i);
-			filled = true;
+static struct mapistore_freebusy_properties *mapistore_freebusy_copy(TALLOC_CTX *mem_ctx, struct mapistore_freebusy_properties *src)
+{
+	struct mapistore_freebusy_properties	*fb_props;
+	struct Binary_r				**dst_bins[5];
+	struct Binary_r				*src_bins[5];
+	uint16_t				i, j;
+
+	fb_props = talloc_memdup(mem_ctx, src, sizeof (struct mapistore_freebusy_properties));
+	if (!fb_props) return NULL;
+
+	fb_props->months_ranges = talloc_memdup(fb_props, src->months_ranges, src->nbr_months * sizeof (uint32_t));
+
+	dst_bins[0] = &fb_props->freebusy_free;
+	dst_bins[1] = &fb_props->freebusy_tentative;
+	dst_bins[2] = &fb_props->freebusy_busy;
+	dst_bins[3] = &fb_props->freebusy_away;
+	dst_bins[4] = &fb_props->freebusy_merged;
+	src_bins[0] = src->freebusy_free;
+	src_bins[1] = src->freebusy_tentative;
+	src_bins[2] = src->freebusy_busy;
+	src_bins[3] = src->freebusy_away;
+	src_bins[4] = src->freebusy_merged;
+	for (j = 0; j < 5; j++) {
+		*dst_bins[j] = talloc_array(fb_props, struct Binary_r, src->nbr_months);
+		for (i = 0; i < src->nbr_months; i++) {
+			(*dst_bins[j])[i].cb = src_bins[j][i].cb;
+			(*dst_bins[j])[i].lpb = talloc_memdup(*dst_bins[j], src_bins[j][i].lpb, src_bins[j][i].cb);
 		}
 	}
-	if (filled) {
-		ndr_push_uint16(ndr, NDR_SCALARS, (max_mins_per_month - 1));
-	}
 
-	fb_bin->cb = ndr->offset;
-	fb_bin->lpb = ndr->data;
-	(void) talloc_reference(mem_ctx, fb_bin->lpb);
+	return fb_props;
+}
 
+/**
+   \details Retrieve the identifier and the change number of a folder,
+   which key the free/busy cache
+
+   \return true if both are available, false otherwise
+ */
+static bool mapistore_freebusy_get_folder_version(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder,
+						  uint64_t *fid, uint64_t *change_number)
+{
+	TALLOC_CTX			*local_mem_ctx;
+	enum MAPITAGS			props[2] = { PidTagFolderId, PidTagChangeNumber };
+	struct mapistore_property_data	data[2];
+	bool				found = false;
+
+	local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+	memset(data, 0, sizeof (data));
+	if (mapistore_properties_get_properties(mstore_ctx, context_id, folder, local_mem_ctx, 2, props, data) == MAPISTORE_SUCCESS
+	    && data[0].error == MAPISTORE_SUCCESS && data[0].data
+	    && data[1].error == MAPISTORE_SUCCESS && data[1].data) {
+		*fid = *((uint64_t *) data[0].data);
+		*change_number = *((uint64_t *) data[1].data);
+		found = true;
+	}
 	talloc_free(local_mem_ctx);
+
+	return found;
 }
 
-static void mapistore_freebusy_merge_subarray(uint8_t *minutes_array, uint8_t *included_array)
+static struct mapistore_freebusy_cache *mapistore_freebusy_cache_lookup(struct mapistore_context *mstore_ctx, uint64_t fid,
+									time_t start_time, time_t end_time)
 {
-	int i;
+	struct mapistore_freebusy_cache	*el;
 
-	for (i = 0; i < max_mins_per_month; i++) {
-		if (included_array[i]) {
-			minutes_array[i] = 1;
+	for (el = mstore_ctx->freebusy_cache; el; el = el->next) {
+		if (el->fid == fid && el->start_time == start_time && el->end_time == end_time) {
+			return el;
 		}
 	}
+
+	return NULL;
+}
+
+static void mapistore_freebusy_cache_store(struct mapistore_context *mstore_ctx, uint64_t fid, uint64_t change_number,
+					   time_t start_time, time_t end_time, struct mapistore_freebusy_properties *fb_props)
+{
+	struct mapistore_freebusy_cache	*el;
+	uint32_t			count;
+
+	el = mapistore_freebusy_cache_lookup(mstore_ctx, fid, start_time, end_time);
+	if (el) {
+		DLIST_REMOVE(mstore_ctx->freebusy_cache, el);
+		talloc_free(el);
+	}
+
+	/* Drop the least recently used entries */
+	count = 0;
+	for (el = mstore_ctx->freebusy_cache; el; el = el->next) {
+		count++;
+	}
+	while (count >= MAPISTORE_FREEBUSY_CACHE_SIZE) {
+		for (el = mstore_ctx->freebusy_cache; el->next; el = el->next);
+		DLIST_REMOVE(mstore_ctx->freebusy_cache, el);
+		talloc_free(el);
+		count--;
+	}
+
+	el = talloc_zero(mstore_ctx, struct mapistore_freebusy_cache);
+	if (!el) return;
+	el->fid = fid;
+	el->change_number = change_number;
+	el->start_time = start_time;
+	el->end_time = end_time;
+	el->fb_props = mapistore_freebusy_copy(el, fb_props);
+	if (!el->fb_props) {
+		talloc_free(el);
+		return;
+	}
+	DLIST_ADD(mstore_ctx->freebusy_cache, el);
 }
 
 enum mapistore_error mapistore_folder_fetch_freebusy_properties(struct mapistore_context *mstore_ctx, uint32_t context_id, void *folder, struct tm *start_tm, struct tm *end_tm, TALLOC_CTX *mem_ctx, struct mapistore_freebusy_properties **fb_props_p)
 {
 	enum mapistore_error			ret;
 	struct mapistore_freebusy_properties	*fb_props;
+	struct mapistore_freebusy_cache		*cache;
 	struct backend_context			*backend_ctx;
 	TALLOC_CTX				*local_mem_ctx;
 	void					*table;
@@ -1203,25 +1441,17 @@ enum mapistore_error mapistore_folder_fetch_freebusy_properties(struct mapistore
 	NTTIME					nt_time;
 	struct mapi_SRestriction_and		time_restrictions[2];
 	int					i, month, nbr_months;
-	uint8_t					**minutes_array, **free_array, **tentative_array, **busy_array, **oof_array;
-	char					*tz;
+	struct mapistore_freebusy_intervals	*free_list, *tentative_list, *busy_list, *oof_list, *merged_list, *list;
+	int64_t					range_start, range_end, start, end;
+	uint64_t				fid, change_number;
+	bool					cacheable;
 
 	/* Sanity checks */
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
-	local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
-
-	/* fetch events from this month for 3 months: start + enddate + fbstatus */
-	ret = mapistore_folder_open_table(mstore_ctx, context_id, folder, local_mem_ctx, MAPISTORE_MESSAGE_TABLE, 0, &table, &row_count);
-	if (ret != MAPISTORE_SUCCESS) {
-		goto end;
-	}
-
-	fb_props = talloc_zero(local_mem_ctx, struct mapistore_freebusy_properties);
-
 	/* fetch freebusy range */
 	if (start_tm && end_tm) {
 		local_start_tm = *start_tm;
@@ -1230,24 +1460,35 @@ enum mapistore_error mapistore_folder_fetch_freebusy_properties(struct mapistore
 	else {
 		mapistore_freebusy_make_range(&local_start_tm, &local_end_tm);
 	}
+	start_time = mapistore_freebusy_utc_time(&local_start_tm);
+	end_time = mapistore_freebusy_utc_time(&local_end_tm);
+
+	/* Step 1. Return the cached properties if the folder did not change since they were computed */
+	cacheable = mapistore_freebusy_get_folder_version(mstore_ctx, context_id, folder, &fid, &change_number);
+	if (cacheable) {
+		cache = mapistore_freebusy_cache_lookup(mstore_ctx, fid, start_time, end_time);
+		if (cache && cache->change_number == change_number) {
+			DLIST_REMOVE(mstore_ctx->freebusy_cache, cache);
+			DLIST_ADD(mstore_ctx->freebusy_cache, cache);
+			*fb_props_p = mapistore_freebusy_copy(mem_ctx, cache->fb_props);
+			return (*fb_props_p) ? MAPISTORE_SUCCESS : MAPISTORE_ERR_NO_MEMORY;
+		}
+	}
+
+	local_mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+
+	/* Step 2. fetch events from this month for 3 months: start + enddate + fbstatus */
+	ret = mapistore_folder_open_table(mstore_ctx, context_id, folder, local_mem_ctx, MAPISTORE_MESSAGE_TABLE, 0, &table, &row_count);
+	if (ret != MAPISTORE_SUCCESS) {
+		goto end;
+	}
+
+	fb_props = talloc_zero(local_mem_ctx, struct mapistore_freebusy_properties);
 
 	unix_to_nt_time(&nt_time, time(NULL));
 	fb_props->timestamp.dwLowDateTime = (nt_time & 0xffffffff);
 	fb_props->timestamp.dwHighDateTime = nt_time >> 32;
 
-	tz = getenv("TZ");
-	setenv("TZ", "", 1);
-	tzset();
-	start_time = mktime(&local_start_tm);
-	end_time = mktime(&local_end_tm);
-	if (tz) {
-		setenv("TZ", tz, 1);
-	}
-	else {
-		unsetenv("TZ");
-	}
-	tzset();
-
 	/* setup restriction */
 	and_res.rt = RES_AND;
 	and_res.res.resAnd.cRes = 2;
@@ -1312,68 +1553,76 @@ enum mapistore_error mapistore_folder_fetch_freebusy_properties(struct mapistore
 		fb_props->months_ranges[i] = ((local_end_tm.tm_year + 1900) << 4) + month + 1;
 	}
 
-	/* fetch events and fill freebusy arrays */
-	free_array = talloc_array(local_mem_ctx, uint8_t *, nbr_months);
-	tentative_array = talloc_array(local_mem_ctx, uint8_t *, nbr_months);
-	busy_array = talloc_array(local_mem_ctx, uint8_t *, nbr_months);
-	oof_array = talloc_array(local_mem_ctx, uint8_t *, nbr_months);
-	for (i = 0; i < nbr_months; i++) {
-		free_array[i] = talloc_array(free_array, uint8_t, max_mins_per_month);
-		memset(free_array[i], 0, max_mins_per_month);
-		tentative_array[i] = talloc_array(tentative_array, uint8_t, max_mins_per_month);
-		memset(tentative_array[i], 0, max_mins_per_month);
-		busy_array[i] = talloc_array(tentative_array, uint8_t, max_mins_per_month);
-		memset(busy_array[i], 0, max_mins_per_month);
-		oof_array[i] = talloc_array(tentative_array, uint8_t, max_mins_per_month);
-		memset(oof_array[i], 0, max_mins_per_month);
-	}
+	/* Step 3. collect the events as intervals, clipped to the published months */
+	range_start = mapistore_freebusy_ymon_start(fb_props->months_ranges[0]);
+	range_end = mapistore_freebusy_ymon_end(fb_props->months_ranges[nbr_months - 1]);
+
+	free_list = talloc_zero(local_mem_ctx, struct mapistore_freebusy_intervals);
+	tentative_list = talloc_zero(local_mem_ctx, struct mapistore_freebusy_intervals);
+	busy_list = talloc_zero(local_mem_ctx, struct mapistore_freebusy_intervals);
+	oof_list = talloc_zero(local_mem_ctx, struct mapistore_freebusy_intervals);
+	merged_list = talloc_zero(local_mem_ctx, struct mapistore_freebusy_intervals);
 
 	i = 0;
 	while (mapistore_table_get_row(mstore_ctx, context_id, table, local_mem_ctx, MAPISTORE_PREFILTERED_QUERY, i, &row_data) == MAPISTORE_SUCCESS) {
 		if (row_data[0].error == MAPISTORE_SUCCESS && row_data[1].error == MAPISTORE_SUCCESS && row_data[2].error == MAPISTORE_SUCCESS) {
 			switch (*((uint32_t *) row_data[2].data)) {
 			case olFree:
-				minutes_array = free_array;
+				list = free_list;
 				break;
 			case olTentative:
-				minutes_array = tentative_array;
+				list = tentative_list;
 				break;
 			case olBusy:
-				minutes_array = busy_array;
+				list = busy_list;
 				break;
 			case olOutOfOffice:
-				minutes_array = oof_array;
+				list = oof_list;
 				break;
 			default:
-				minutes_array = NULL;
+				list = NULL;
 			}
-			if (minutes_array) {
-				mapistore_freebusy_fill_fbarray(minutes_array, fb_props->months_ranges, nbr_months, row_data[0].data, row_data[1].data);
+			if (list) {
+				nt_time = ((NTTIME) ((struct FILETIME *) row_data[0].data)->dwHighDateTime << 32) | ((struct FILETIME *) row_data[0].data)->dwLowDateTime;
+				start = nt_time_to_unix(nt_time) / 60;
+				nt_time = ((NTTIME) ((struct FILETIME *) row_data[1].data)->dwHighDateTime << 32) | ((struct FILETIME *) row_data[1].data)->dwLowDateTime;
+				end = nt_time_to_unix(nt_time) / 60;
+
+				start = MAX(start, range_start);
+				end = MIN(end, range_end);
+				mapistore_freebusy_add_interval(list, start, end);
+				if (list == busy_list || list == oof_list) {
+					mapistore_freebusy_add_interval(merged_list, start, end);
+				}
 			}
 		}
 		i++;
 	}
 
-        /* compile minutes array into arrays of ranges */
+	/* Step 4. merge the intervals and compile them into arrays of ranges */
+	mapistore_freebusy_merge_intervals(free_list);
+	mapistore_freebusy_merge_intervals(tentative_list);
+	mapistore_freebusy_merge_intervals(busy_list);
+	mapistore_freebusy_merge_intervals(oof_list);
+	mapistore_freebusy_merge_intervals(merged_list);
+
 	fb_props->nbr_months = nbr_months;
 	fb_props->freebusy_free = talloc_array(fb_props, struct Binary_r, nbr_months);
 	fb_props->freebusy_tentative = talloc_array(fb_props, struct Binary_r, nbr_months);
 	fb_props->freebusy_busy = talloc_array(fb_props, struct Binary_r, nbr_months);
 	fb_props->freebusy_away = talloc_array(fb_props, struct Binary_r, nbr_months);
 	fb_props->freebusy_merged = talloc_array(fb_props, struct Binary_r, nbr_months);
-	for (i = 0; i < nbr_months; i++) {
-		mapistore_freebusy_compile_fbarray(fb_props, free_array[i], fb_props->freebusy_free + i);
-		mapistore_freebusy_compile_fbarray(fb_props, tentative_array[i], fb_props->freebusy_tentative + i);
-		mapistore_freebusy_compile_fbarray(fb_props, busy_array[i], fb_props->freebusy_busy + i);
-		mapistore_freebusy_compile_fbarray(fb_props, oof_array[i], fb_props->freebusy_away + i);
-		mapistore_freebusy_merge_subarray(busy_array[i], oof_array[i]);
-		mapistore_freebusy_compile_fbarray(fb_props, busy_array[i], fb_props->freebusy_merged + i);
+	mapistore_freebusy_compile_intervals(fb_props->freebusy_free, free_list, fb_props->months_ranges, nbr_months, fb_props->freebusy_free);
+	mapistore_freebusy_compile_intervals(fb_props->freebusy_tentative, tentative_list, fb_props->months_ranges, nbr_months, fb_props->freebusy_tentative);
+	mapistore_freebusy_compile_intervals(fb_props->freebusy_busy, busy_list, fb_props->months_ranges, nbr_months, fb_props->freebusy_busy);
+	mapistore_freebusy_compile_intervals(fb_props->freebusy_away, oof_list, fb_props->months_ranges, nbr_months, fb_props->freebusy_away);
+	mapistore_freebusy_compile_intervals(fb_props->freebusy_merged, merged_list, fb_props->months_ranges, nbr_months, fb_props->freebusy_merged);
+
+	if (cacheable) {
+		mapistore_freebusy_cache_store(mstore_ctx, fid, change_number, start_time, end_time, fb_props);
 	}
 
-	*fb_props_p = fb_props;
-
-	/* we bind fb_props to mem_ctx, because it will be released with the local_mem_ctx */
-	(void) talloc_reference(mem_ctx, fb_props);
+	*fb_props_p = talloc_steal(mem_ctx, fb_props);
 
 	ret = MAPISTORE_SUCCESS;
 
@@ -1403,7 +1652,7 @@ enum mapistore_error mapistore_message_get_message_data(struct mapistore_context
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend modifyrecipients */
@@ -1430,7 +1679,7 @@ enum mapistore_error mapistore_message_modify_recipients(struct mapistore_contex
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend modifyrecipients */
@@ -1456,7 +1705,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_set_read_flag(struct mapistore_c
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend savechangesmessage */
@@ -1482,7 +1731,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_save(struct mapistore_context *m
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend savechangesmessage */
@@ -1510,7 +1759,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_submit(struct mapistore_context
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend submitmessage */
@@ -1526,7 +1775,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_get_attachment_table(struct mapi
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1542,7 +1791,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_open_attachment(struct mapistore
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1558,7 +1807,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_create_attachment(struct mapisto
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1573,7 +1822,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_attachment_open_embedded_message
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1588,7 +1837,7 @@ _PUBLIC_ enum mapistore_error mapistore_message_attachment_create_embedded_messa
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1603,7 +1852,7 @@ _PUBLIC_ enum mapistore_error mapistore_table_get_available_properties(struct ma
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1618,11 +1867,11 @@ _PUBLIC_ enum mapistore_error mapistore_table_set_columns(struct mapistore_conte
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
-	return mapistore_backend_table_set_columns(backend_ctx, table, count, properties);
+	return mapistore_table_view_set_columns(mstore_ctx, backend_ctx, table, count, properties);
 }
 
 _PUBLIC_ enum mapistore_error mapistore_table_set_restrictions(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, struct mapi_SRestriction *restrictions, uint8_t *table_status)
@@ -1633,11 +1882,11 @@ _PUBLIC_ enum mapistore_error mapistore_table_set_restrictions(struct mapistore_
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
-	return mapistore_backend_table_set_restrictions(backend_ctx, table, restrictions, table_status);
+	return mapistore_table_view_set_restrictions(mstore_ctx, backend_ctx, table, restrictions, table_status);
 }
 
 _PUBLIC_ enum mapistore_error mapistore_table_set_sort_order(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, struct SSortOrderSet *sort_order, uint8_t *table_status)
@@ -1648,11 +1897,11 @@ _PUBLIC_ enum mapistore_error mapistore_table_set_sort_order(struct mapistore_co
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
-	return mapistore_backend_table_set_sort_order(backend_ctx, table, sort_order, table_status);
+	return mapistore_table_view_set_sort_order(mstore_ctx, backend_ctx, table, sort_order, table_status);
 }
 
 _PUBLIC_ enum mapistore_error mapistore_table_get_row(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, TALLOC_CTX *mem_ctx,
@@ -1664,11 +1913,11 @@ _PUBLIC_ enum mapistore_error mapistore_table_get_row(struct mapistore_context *
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
-	return mapistore_backend_table_get_row(backend_ctx, table, mem_ctx, query_type, rowid, data);
+	return mapistore_table_view_get_row(mstore_ctx, backend_ctx, table, mem_ctx, query_type, rowid, data);
 }
 
 _PUBLIC_ enum mapistore_error mapistore_table_get_row_count(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, enum mapistore_query_type query_type, uint32_t *row_countp)
@@ -1679,11 +1928,41 @@ _PUBLIC_ enum mapistore_error mapistore_table_get_row_count(struct mapistore_con
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
-	return mapistore_backend_table_get_row_count(backend_ctx, table, query_type, row_countp);
+	return mapistore_table_view_get_row_count(mstore_ctx, backend_ctx, table, query_type, row_countp);
+}
+
+_PUBLIC_ enum mapistore_error mapistore_table_expand_row(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, uint64_t category_id, uint32_t *positionp, uint32_t *row_countp)
+{
+	struct backend_context	*backend_ctx;
+
+	/* Sanity checks */
+	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
+
+	/* Step 1. Search the context */
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
+	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	/* Step 2. Categories are kept by libmapistore */
+	return mapistore_table_view_expand_row(mstore_ctx, table, category_id, positionp, row_countp);
+}
+
+_PUBLIC_ enum mapistore_error mapistore_table_collapse_row(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, uint64_t category_id, uint32_t *positionp, uint32_t *row_countp)
+{
+	struct backend_context	*backend_ctx;
+
+	/* Sanity checks */
+	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
+
+	/* Step 1. Search the context */
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
+	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+
+	/* Step 2. Categories are kept by libmapistore */
+	return mapistore_table_view_collapse_row(mstore_ctx, table, category_id, positionp, row_countp);
 }
 
 _PUBLIC_ enum mapistore_error mapistore_table_handle_destructor(struct mapistore_context *mstore_ctx, uint32_t context_id, void *table, uint32_t handle_id)
@@ -1694,7 +1973,7 @@ _PUBLIC_ enum mapistore_error mapistore_table_handle_destructor(struct mapistore
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1709,7 +1988,7 @@ _PUBLIC_ enum mapistore_error mapistore_properties_get_available_properties(stru
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1728,7 +2007,7 @@ _PUBLIC_ enum mapistore_error mapistore_properties_get_properties(struct mapisto
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
@@ -1746,7 +2025,7 @@ _PUBLIC_ enum mapistore_error mapistore_properties_set_properties(struct mapisto
 	MAPISTORE_SANITY_CHECKS(mstore_ctx, NULL);
 
 	/* Step 1. Search the context */
-	backend_ctx = mapistore_backend_lookup(mstore_ctx->context_list, context_id);
+	backend_ctx = mapistore_backend_lookup(mstore_ctx, context_id);
 	MAPISTORE_RETVAL_IF(!backend_ctx, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
 
 	/* Step 2. Call backend operation */
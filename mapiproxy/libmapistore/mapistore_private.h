@@ -97,6 +97,41 @@ struct processing_context {
 };
 
 
+/**
+   Free/busy cache
+
+   Free/busy properties computed by
+   mapistore_folder_fetch_freebusy_properties, valid as long as the
+   change number of the folder is unchanged.
+ */
+#define	MAPISTORE_FREEBUSY_CACHE_SIZE	8
+
+struct mapistore_freebusy_cache {
+	uint64_t				fid;
+	uint64_t				change_number;
+	time_t					start_time;
+	time_t					end_time;
+	struct mapistore_freebusy_properties	*fb_props;
+	struct mapistore_freebusy_cache		*prev;
+	struct mapistore_freebusy_cache		*next;
+};
+
+
+/**
+   Backend context index
+
+   Contexts of the mapistore context list, indexed by context
+   identifier and by URI.
+ */
+struct backend_context_index {
+	struct backend_context_list	**by_id;	/* context list elements, indexed by context id */
+	uint32_t			id_size;
+	struct backend_context_list	**by_uri;	/* URI hash buckets */
+	uint32_t			uri_size;
+	uint32_t			count;
+};
+
+
 /**
    Indexing identifier list
  */
@@ -104,13 +139,69 @@ struct indexing_context_list {
 	struct tdb_wrap			*index_ctx;
 	char				*username;
 	// uint32_t			ref_count;
+	uint32_t			transaction_depth;
+	bool				transaction_failed;
+	uint32_t			write_back;
+	bool				write_back_pending;
+	time_t				write_back_start;
 	struct indexing_context_list	*prev;
 	struct indexing_context_list	*next;
 };
 
+/**
+   Sorted view of a backend table
+
+   Rows of the backend table, one per value of the multi-valued instance
+   column, sorted by libmapistore and interleaved with category header
+   rows.
+ */
+struct mapistore_table_view_row {
+	uint32_t			rowid;		/* position in the backend table */
+	uint32_t			instance;	/* 1-based multi-valued instance, 0 if none */
+	uint32_t			position;	/* position before sorting */
+	struct mapistore_property_data	*keys;		/* values of the sort columns */
+	struct mapistore_property_data	*aggregates;	/* category maximums, per category level */
+	struct mapistore_table_view	*view;
+};
+
+struct mapistore_table_view_node {
+	struct mapistore_table_view_row	*row;
+	bool				header;
+	uint16_t			depth;
+	uint64_t			category_id;
+	bool				collapsed;
+	uint32_t			leaf_count;	/* leaf rows of the category */
+	uint32_t			node_count;	/* header and leaf rows of the category */
+};
+
+struct mapistore_table_view {
+	void				*table;
+	struct mapistore_context	*mstore_ctx;
+	struct backend_context		*backend_ctx;
+	uint16_t			column_count;
+	enum MAPITAGS			*columns;
+	struct SSortOrderSet		*sort_order;
+	bool				dirty;
+	bool				restricted;		/* restriction set on the backend table */
+	bool				rows_restricted;	/* restriction set when the rows were read */
+	bool				restriction_changed;	/* rows read with another restriction */
+	uint32_t			backend_row_count;
+	TALLOC_CTX			*rows_ctx;
+	uint32_t			row_count;
+	struct mapistore_table_view_row	*rows;
+	uint32_t			node_count;
+	struct mapistore_table_view_node *nodes;
+	uint32_t			visible_count;
+	uint32_t			*visible;	/* nodes not hidden by a collapsed category */
+	uint64_t			last_category_id;
+	struct mapistore_table_view	*prev;
+	struct mapistore_table_view	*next;
+};
+
 #define	MAPISTORE_DB_NAMED		"named_properties.ldb"
 #define	MAPISTORE_DB_INDEXING		"indexing.tdb"
 #define	MAPISTORE_SOFT_DELETED_TAG	"SOFT_DELETED:"
+#define	MAPISTORE_PROPERTY_GROUPS_TAG	"PROPERTY_GROUPS:"
 
 struct replica_mapping_context_list {
 	struct tdb_context		*tdb;
@@ -159,6 +250,9 @@ enum mapistore_error mapistore_backend_create_context(TALLOC_CTX *, struct mapis
 enum mapistore_error mapistore_backend_create_root_folder(const char *, enum mapistore_context_role, uint64_t, const char *, TALLOC_CTX *, char **);
 enum mapistore_error mapistore_backend_add_ref_count(struct backend_context *);
 enum mapistore_error mapistore_backend_delete_context(struct backend_context *);
+enum mapistore_error mapistore_backend_index_add(struct mapistore_context *, struct backend_context_list *);
+enum mapistore_error mapistore_backend_index_del(struct mapistore_context *, struct backend_context *);
+struct backend_context_list *mapistore_backend_lookup_list(struct mapistore_context *, uint32_t);
 enum mapistore_error mapistore_backend_get_path(struct backend_context *, TALLOC_CTX *, uint64_t, char **);
 
 enum mapistore_error mapistore_backend_folder_open_folder(struct backend_context *, void *, TALLOC_CTX *, uint64_t, void **);
@@ -175,7 +269,9 @@ enum mapistore_error mapistore_backend_folder_get_child_count(struct backend_con
 enum mapistore_error mapistore_backend_folder_get_child_fid_by_name(struct backend_context *, void *, const char *, uint64_t *);
 enum mapistore_error mapistore_backend_folder_open_table(struct backend_context *, void *, TALLOC_CTX *, enum mapistore_table_type, uint32_t, void **, uint32_t *);
 enum mapistore_error mapistore_backend_folder_modify_permissions(struct backend_context *, void *, uint8_t, uint16_t, struct PermissionData *);
+enum mapistore_error mapistore_backend_folder_get_child_fmids(struct backend_context *, void *, TALLOC_CTX *, enum mapistore_table_type, uint64_t **, uint32_t *);
 enum mapistore_error mapistore_backend_folder_preload_message_bodies(struct backend_context *, void *, enum mapistore_table_type, const struct UI8Array_r *);
+enum mapistore_error mapistore_backend_folder_save_messages(struct backend_context *, void *, TALLOC_CTX *, uint32_t, void **);
 
 enum mapistore_error mapistore_backend_message_get_message_data(struct backend_context *, void *, TALLOC_CTX *, struct mapistore_message **);
 enum mapistore_error mapistore_backend_message_modify_recipients(struct backend_context *, void *, struct SPropTagArray *, uint16_t, struct mapistore_message_recipient *);
@@ -218,6 +314,16 @@ enum mapistore_error mapistore_indexing_record_del_fmid(struct mapistore_context
 // enum mapistore_error mapistore_indexing_add_ref_count(struct indexing_context_list *);
 // enum mapistore_error mapistore_indexing_del_ref_count(struct indexing_context_list *);
 
+/* definitions from mapistore_table_view.c */
+struct mapistore_table_view *mapistore_table_view_search(struct mapistore_context *, void *);
+enum mapistore_error mapistore_table_view_set_columns(struct mapistore_context *, struct backend_context *, void *, uint16_t, enum MAPITAGS *);
+enum mapistore_error mapistore_table_view_set_restrictions(struct mapistore_context *, struct backend_context *, void *, struct mapi_SRestriction *, uint8_t *);
+enum mapistore_error mapistore_table_view_set_sort_order(struct mapistore_context *, struct backend_context *, void *, struct SSortOrderSet *, uint8_t *);
+enum mapistore_error mapistore_table_view_get_row(struct mapistore_context *, struct backend_context *, void *, TALLOC_CTX *, enum mapistore_query_type, uint32_t, struct mapistore_property_data **);
+enum mapistore_error mapistore_table_view_get_row_count(struct mapistore_context *, struct backend_context *, void *, enum mapistore_query_type, uint32_t *);
+enum mapistore_error mapistore_table_view_expand_row(struct mapistore_context *, void *, uint64_t, uint32_t *, uint32_t *);
+enum mapistore_error mapistore_table_view_collapse_row(struct mapistore_context *, void *, uint64_t, uint32_t *, uint32_t *);
+
 /* definitions from mapistore_namedprops.c */
 enum mapistore_error mapistore_namedprops_init(TALLOC_CTX *, struct ldb_context **);
 
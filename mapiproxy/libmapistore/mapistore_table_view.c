@@ -0,0 +1,1022 @@
+/*
+   OpenChange Storage Abstraction Layer library
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mapistore_errors.h"
+#include "mapistore.h"
+#include "mapistore_private.h"
+#include <dlinklist.h>
+
+/**
+   \file mapistore_table_view.c
+
+   \brief Sorted and categorized views of backend tables
+
+   Backends which cannot sort a table return MAPISTORE_ERR_NOT_IMPLEMENTED
+   from set_sort_order. The sort columns of every row of such a table
+   are then read once, sorted and grouped into categories by
+   libmapistore, and the rows are served by position from this view.
+   Backends sorting their tables themselves return MAPISTORE_SUCCESS and
+   keep serving the rows, unless categories or multi-valued instances
+   are requested: the backend interface has no way to return category
+   header rows.
+
+   The view is allocated on the backend table and released with it.
+ */
+
+/**
+   \details Search the view of a backend table
+
+   \param mstore_ctx pointer to the mapistore context
+   \param table pointer to the backend table
+
+   \return pointer to the view on success, otherwise NULL
+ */
+struct mapistore_table_view *mapistore_table_view_search(struct mapistore_context *mstore_ctx, void *table)
+{
+	struct mapistore_table_view	*view;
+
+	for (view = mstore_ctx->table_views; view; view = view->next) {
+		if (view->table == table) {
+			return view;
+		}
+	}
+
+	return NULL;
+}
+
+static int mapistore_table_view_destructor(struct mapistore_table_view *view)
+{
+	DLIST_REMOVE(view->mstore_ctx->table_views, view);
+
+	return 0;
+}
+
+static struct mapistore_table_view *mapistore_table_view_get(struct mapistore_context *mstore_ctx,
+							     struct backend_context *backend_ctx,
+							     void *table)
+{
+	struct mapistore_table_view	*view;
+
+	view = mapistore_table_view_search(mstore_ctx, table);
+	if (view) {
+		return view;
+	}
+
+	view = talloc_zero(table, struct mapistore_table_view);
+	if (!view) {
+		return NULL;
+	}
+	view->table = table;
+	view->mstore_ctx = mstore_ctx;
+	view->backend_ctx = backend_ctx;
+	DLIST_ADD(mstore_ctx->table_views, view);
+	talloc_set_destructor(view, mapistore_table_view_destructor);
+
+	return view;
+}
+
+/**
+   \details Set the columns of the backend table, without the
+   multi-valued instance flag the backends do not know about
+ */
+static enum mapistore_error mapistore_table_view_backend_columns(struct mapistore_table_view *view,
+								 uint16_t count, enum MAPITAGS *properties)
+{
+	enum mapistore_error	ret;
+	enum MAPITAGS		*columns;
+	uint16_t		i;
+
+	for (i = 0; i < count; i++) {
+		if (properties[i] & MV_INSTANCE) break;
+	}
+	if (i == count) {
+		return mapistore_backend_table_set_columns(view->backend_ctx, view->table, count, properties);
+	}
+
+	columns = talloc_array(NULL, enum MAPITAGS, count);
+	MAPISTORE_RETVAL_IF(!columns, MAPISTORE_ERR_NO_MEMORY, NULL);
+	for (i = 0; i < count; i++) {
+		columns[i] = properties[i] & ~MV_INSTANCE;
+	}
+	ret = mapistore_backend_table_set_columns(view->backend_ctx, view->table, count, columns);
+	talloc_free(columns);
+
+	return ret;
+}
+
+static uint32_t mapistore_table_view_instance_count(uint16_t type, const void *data)
+{
+	if (!data) return 0;
+
+	switch (type) {
+	case PT_MV_LONG:
+		return ((const struct mapi_MV_LONG_STRUCT *) data)->cValues;
+	case PT_MV_STRING8:
+		return ((const struct mapi_SLPSTRArray *) data)->cValues;
+	case PT_MV_UNICODE:
+		return ((const struct mapi_SLPSTRArrayW *) data)->cValues;
+	case PT_MV_BINARY:
+		return ((const struct BinaryArray_r *) data)->cValues;
+	default:
+		DEBUG(5, ("[%s:%d]: unsupported multi-valued instance type 0x%.4x\n", __FUNCTION__, __LINE__, type));
+		return 0;
+	}
+}
+
+static void *mapistore_table_view_instance_value(uint16_t type, const void *data, uint32_t idx)
+{
+	switch (type) {
+	case PT_MV_LONG:
+		return &((struct mapi_MV_LONG_STRUCT *) data)->lpl[idx];
+	case PT_MV_STRING8:
+		return (void *) ((struct mapi_SLPSTRArray *) data)->strings[idx].lppszA;
+	case PT_MV_UNICODE:
+		return (void *) ((struct mapi_SLPSTRArrayW *) data)->strings[idx].lppszW;
+	case PT_MV_BINARY:
+		return &((struct BinaryArray_r *) data)->lpbin[idx];
+	default:
+		return NULL;
+	}
+}
+
+/**
+   \details Compare two property values of the same type. Missing
+   values sort before any other value.
+ */
+static int mapistore_table_view_compare_values(uint16_t type, const struct mapistore_property_data *a,
+					       const struct mapistore_property_data *b)
+{
+	bool			a_set, b_set;
+	const struct FILETIME	*fa, *fb;
+	const struct Binary_r	*ba, *bb;
+	int			ret;
+
+	a_set = (a->error == MAPISTORE_SUCCESS && a->data);
+	b_set = (b->error == MAPISTORE_SUCCESS && b->data);
+	if (!a_set || !b_set) {
+		return (int) a_set - (int) b_set;
+	}
+
+#define	MAPISTORE_TABLE_VIEW_COMPARE(t)	((*(const t *) a->data > *(const t *) b->data) - (*(const t *) a->data < *(const t *) b->data))
+
+	switch (type) {
+	case PT_SHORT:
+		return MAPISTORE_TABLE_VIEW_COMPARE(int16_t);
+	case PT_LONG:
+		return MAPISTORE_TABLE_VIEW_COMPARE(int32_t);
+	case PT_BOOLEAN:
+		return MAPISTORE_TABLE_VIEW_COMPARE(uint8_t);
+	case PT_I8:
+	case PT_CURRENCY:
+		return MAPISTORE_TABLE_VIEW_COMPARE(int64_t);
+	case PT_FLOAT:
+		return MAPISTORE_TABLE_VIEW_COMPARE(float);
+	case PT_DOUBLE:
+	case PT_APPTIME:
+		return MAPISTORE_TABLE_VIEW_COMPARE(double);
+	case PT_SYSTIME:
+		fa = (const struct FILETIME *) a->data;
+		fb = (const struct FILETIME *) b->data;
+		if (fa->dwHighDateTime != fb->dwHighDateTime) {
+			return (fa->dwHighDateTime > fb->dwHighDateTime) ? 1 : -1;
+		}
+		return (fa->dwLowDateTime > fb->dwLowDateTime) - (fa->dwLowDateTime < fb->dwLowDateTime);
+	case PT_STRING8:
+	case PT_UNICODE:
+		return strcasecmp((const char *) a->data, (const char *) b->data);
+	case PT_CLSID:
+		return memcmp(a->data, b->data, sizeof (struct GUID));
+	case PT_BINARY:
+	case PT_SVREID:
+		ba = (const struct Binary_r *) a->data;
+		bb = (const struct Binary_r *) b->data;
+		ret = memcmp(ba->lpb, bb->lpb, (ba->cb < bb->cb) ? ba->cb : bb->cb);
+		if (ret) {
+			return ret;
+		}
+		return (ba->cb > bb->cb) - (ba->cb < bb->cb);
+	default:
+		return 0;
+	}
+
+#undef	MAPISTORE_TABLE_VIEW_COMPARE
+}
+
+static inline uint16_t mapistore_table_view_key_type(struct SSortOrderSet *sort_order, uint16_t idx)
+{
+	uint32_t	proptag = sort_order->aSort[idx].ulPropTag;
+
+	if (proptag & MV_INSTANCE) {
+		return proptag & 0xFFFF & ~(MV_FLAG | MV_INSTANCE);
+	}
+
+	return proptag & 0xFFFF;
+}
+
+static int mapistore_table_view_compare_key(struct mapistore_table_view *view, uint16_t idx,
+					    const struct mapistore_table_view_row *a,
+					    const struct mapistore_table_view_row *b)
+{
+	int	ret;
+
+	ret = mapistore_table_view_compare_values(mapistore_table_view_key_type(view->sort_order, idx), &a->keys[idx], &b->keys[idx]);
+	if (view->sort_order->aSort[idx].ulOrder & TABLE_SORT_DESCEND) {
+		ret = -ret;
+	}
+
+	return ret;
+}
+
+/**
+   \details Stable multi-key comparison of two view rows. When the
+   categories are ordered by the maximum value of the first
+   non-category column, each category level compares this maximum
+   first.
+ */
+static int mapistore_table_view_compare_rows(const void *ap, const void *bp)
+{
+	const struct mapistore_table_view_row	*a = *(const struct mapistore_table_view_row **) ap;
+	const struct mapistore_table_view_row	*b = *(const struct mapistore_table_view_row **) bp;
+	struct mapistore_table_view		*view = a->view;
+	uint16_t				categories = view->sort_order->cCategories;
+	uint16_t				i;
+	int					ret;
+
+	for (i = 0; i < view->sort_order->cSorts; i++) {
+		if (a->aggregates && i < categories) {
+			ret = mapistore_table_view_compare_values(mapistore_table_view_key_type(view->sort_order, categories),
+								  &a->aggregates[i], &b->aggregates[i]);
+			if (view->sort_order->aSort[categories].ulOrder & TABLE_SORT_DESCEND) {
+				ret = -ret;
+			}
+			if (ret) return ret;
+		}
+		ret = mapistore_table_view_compare_key(view, i, a, b);
+		if (ret) return ret;
+	}
+
+	return (a->position > b->position) - (a->position < b->position);
+}
+
+static bool mapistore_table_view_same_category(struct mapistore_table_view *view, uint16_t depth,
+					       const struct mapistore_table_view_row *a,
+					       const struct mapistore_table_view_row *b)
+{
+	uint16_t	i;
+
+	for (i = 0; i <= depth; i++) {
+		if (mapistore_table_view_compare_values(mapistore_table_view_key_type(view->sort_order, i), &a->keys[i], &b->keys[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+   \details Store in each row the maximum value of the first
+   non-category column over each of its categories
+ */
+static enum mapistore_error mapistore_table_view_aggregate(struct mapistore_table_view *view,
+							   struct mapistore_table_view_row **sorted)
+{
+	uint16_t				categories = view->sort_order->cCategories;
+	uint16_t				type = mapistore_table_view_key_type(view->sort_order, categories);
+	struct mapistore_property_data		*max;
+	uint32_t				start, i, j;
+	uint16_t				depth;
+
+	for (i = 0; i < view->row_count; i++) {
+		sorted[i]->aggregates = talloc_array(view->rows_ctx, struct mapistore_property_data, categories);
+		MAPISTORE_RETVAL_IF(!sorted[i]->aggregates, MAPISTORE_ERR_NO_MEMORY, NULL);
+	}
+
+	for (depth = 0; depth < categories; depth++) {
+		for (start = 0; start < view->row_count; start = i) {
+			max = &sorted[start]->keys[categories];
+			for (i = start + 1; i < view->row_count && mapistore_table_view_same_category(view, depth, sorted[start], sorted[i]); i++) {
+				if (mapistore_table_view_compare_values(type, &sorted[i]->keys[categories], max) > 0) {
+					max = &sorted[i]->keys[categories];
+				}
+			}
+			for (j = start; j < i; j++) {
+				sorted[j]->aggregates[depth] = *max;
+			}
+		}
+	}
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Drop the rows of a view, they are read again the next time
+   the view is used
+ */
+static void mapistore_table_view_reset(struct mapistore_table_view *view)
+{
+	view->rows_ctx = NULL;
+	view->rows = NULL;
+	view->row_count = 0;
+	view->nodes = NULL;
+	view->node_count = 0;
+	view->visible = NULL;
+	view->visible_count = 0;
+	view->dirty = true;
+}
+
+static void mapistore_table_view_update_visible(struct mapistore_table_view *view)
+{
+	uint32_t	i, count;
+
+	for (i = 0, count = 0; i < view->node_count; count++) {
+		view->visible[count] = i;
+		if (view->nodes[i].header && view->nodes[i].collapsed) {
+			i += view->nodes[i].node_count + 1;
+		}
+		else {
+			i++;
+		}
+	}
+	view->visible_count = count;
+}
+
+/**
+   \details Carry the identifier of the category headers over to the
+   rebuilt view, with the collapse state changed by the client. The
+   headers of each level are only looked up under their matching
+   parent.
+ */
+static void mapistore_table_view_restore_state(struct mapistore_table_view *view,
+					       struct mapistore_table_view_node *old_nodes,
+					       uint32_t old_start, uint32_t old_end,
+					       uint32_t start, uint32_t end, uint16_t depth)
+{
+	struct mapistore_table_view_node	*old, *node;
+	uint32_t				i, j;
+
+	if (depth >= view->sort_order->cCategories) return;
+
+	for (i = old_start; i < old_end; i += old->node_count + 1) {
+		old = &old_nodes[i];
+		for (j = start; j < end; j += node->node_count + 1) {
+			node = &view->nodes[j];
+			if (mapistore_table_view_same_category(view, depth, node->row, old->row)) {
+				node->category_id = old->category_id;
+				if (old->collapsed != (depth >= view->sort_order->cExpanded)) {
+					node->collapsed = old->collapsed;
+				}
+				mapistore_table_view_restore_state(view, old_nodes, i + 1, i + 1 + old->node_count,
+								   j + 1, j + 1 + node->node_count, depth + 1);
+				break;
+			}
+		}
+	}
+}
+
+/**
+   \details Read the sort columns of every row of the backend table,
+   sort the rows and build the category header rows
+ */
+static enum mapistore_error mapistore_table_view_build(struct mapistore_table_view *view)
+{
+	enum mapistore_error			ret;
+	TALLOC_CTX				*old_ctx;
+	struct mapistore_table_view_node	*old_nodes;
+	uint32_t				old_node_count;
+	struct SSortOrderSet			*sort_order = view->sort_order;
+	enum MAPITAGS				*sort_columns;
+	struct mapistore_property_data		*data;
+	void					*values;
+	struct mapistore_table_view_row		*row;
+	struct mapistore_table_view_row		**sorted;
+	struct mapistore_table_view_node	*node;
+	uint32_t				*headers;
+	uint32_t				backend_count, instances, max_rows, i, j;
+	uint16_t				depth, start;
+	int					instance_idx = -1;
+
+	/* The previous rows stay around until the collapse state of
+	   the categories has been carried over */
+	old_ctx = view->rows_ctx;
+	old_nodes = view->nodes;
+	old_node_count = view->node_count;
+	mapistore_table_view_reset(view);
+
+	view->rows_ctx = talloc_new(view);
+	MAPISTORE_RETVAL_IF(!view->rows_ctx, MAPISTORE_ERR_NO_MEMORY, old_ctx);
+
+	ret = mapistore_backend_table_get_row_count(view->backend_ctx, view->table, MAPISTORE_PREFILTERED_QUERY, &backend_count);
+	if (ret != MAPISTORE_SUCCESS) {
+		goto end;
+	}
+
+	/* Step 1. Read the sort columns of each row, one view row per
+	   value of the multi-valued instance column */
+	sort_columns = talloc_array(view->rows_ctx, enum MAPITAGS, sort_order->cSorts);
+	if (!sort_columns) {
+		ret = MAPISTORE_ERR_NO_MEMORY;
+		goto end;
+	}
+	for (i = 0; i < sort_order->cSorts; i++) {
+		sort_columns[i] = sort_order->aSort[i].ulPropTag & ~MV_INSTANCE;
+		if (sort_order->aSort[i].ulPropTag & MV_INSTANCE) {
+			instance_idx = i;
+		}
+	}
+	ret = mapistore_backend_table_set_columns(view->backend_ctx, view->table, sort_order->cSorts, sort_columns);
+	if (ret != MAPISTORE_SUCCESS) {
+		goto end;
+	}
+
+	max_rows = backend_count;
+	view->rows = talloc_array(view->rows_ctx, struct mapistore_table_view_row, max_rows);
+	if (max_rows && !view->rows) {
+		ret = MAPISTORE_ERR_NO_MEMORY;
+		goto end;
+	}
+	for (i = 0; i < backend_count; i++) {
+		ret = mapistore_backend_table_get_row(view->backend_ctx, view->table, view->rows_ctx,
+						      MAPISTORE_PREFILTERED_QUERY, i, &data);
+		if (ret != MAPISTORE_SUCCESS) {
+			continue;
+		}
+
+		instances = 0;
+		values = NULL;
+		if (instance_idx >= 0 && data[instance_idx].error == MAPISTORE_SUCCESS) {
+			values = data[instance_idx].data;
+			instances = mapistore_table_view_instance_count(sort_columns[instance_idx] & 0xFFFF, values);
+		}
+		if (view->row_count + (instances ? instances : 1) > max_rows) {
+			max_rows = view->row_count + (instances ? instances : 1) + (backend_count - i);
+			view->rows = talloc_realloc(view->rows_ctx, view->rows, struct mapistore_table_view_row, max_rows);
+			if (!view->rows) {
+				ret = MAPISTORE_ERR_NO_MEMORY;
+				goto end;
+			}
+		}
+
+		j = 0;
+		do {
+			row = &view->rows[view->row_count];
+			row->view = view;
+			row->rowid = i;
+			row->position = view->row_count;
+			row->aggregates = NULL;
+			row->keys = data;
+			row->instance = 0;
+			if (instances) {
+				if (j) {
+					row->keys = talloc_memdup(view->rows_ctx, data, sizeof (struct mapistore_property_data) * sort_order->cSorts);
+					if (!row->keys) {
+						ret = MAPISTORE_ERR_NO_MEMORY;
+						goto end;
+					}
+				}
+				row->keys[instance_idx].data = mapistore_table_view_instance_value(sort_columns[instance_idx] & 0xFFFF, values, j);
+				row->instance = j + 1;
+			}
+			else if (instance_idx >= 0) {
+				row->keys[instance_idx].data = NULL;
+				row->keys[instance_idx].error = MAPISTORE_ERR_NOT_FOUND;
+			}
+			view->row_count++;
+		} while (++j < instances);
+	}
+
+	/* Step 2. Sort the rows */
+	sorted = talloc_array(view->rows_ctx, struct mapistore_table_view_row *, view->row_count);
+	if (view->row_count && !sorted) {
+		ret = MAPISTORE_ERR_NO_MEMORY;
+		goto end;
+	}
+	for (i = 0; i < view->row_count; i++) {
+		sorted[i] = &view->rows[i];
+	}
+	qsort(sorted, view->row_count, sizeof (struct mapistore_table_view_row *), mapistore_table_view_compare_rows);
+
+	if (sort_order->cCategories && sort_order->cSorts > sort_order->cCategories
+	    && (sort_order->aSort[sort_order->cCategories].ulOrder & TABLE_SORT_MAXIMUM_CATEGORY)) {
+		ret = mapistore_table_view_aggregate(view, sorted);
+		if (ret != MAPISTORE_SUCCESS) {
+			goto end;
+		}
+		qsort(sorted, view->row_count, sizeof (struct mapistore_table_view_row *), mapistore_table_view_compare_rows);
+	}
+
+	/* Step 3. Insert a header row before each category */
+	view->nodes = talloc_array(view->rows_ctx, struct mapistore_table_view_node, view->row_count * (sort_order->cCategories + 1));
+	view->visible = talloc_array(view->rows_ctx, uint32_t, view->row_count * (sort_order->cCategories + 1));
+	headers = talloc_array(view->rows_ctx, uint32_t, sort_order->cCategories);
+	if (view->row_count && (!view->nodes || !view->visible || !headers)) {
+		ret = MAPISTORE_ERR_NO_MEMORY;
+		goto end;
+	}
+	for (i = 0; i < view->row_count; i++) {
+		start = 0;
+		if (i) {
+			while (start < sort_order->cCategories && mapistore_table_view_same_category(view, start, sorted[i - 1], sorted[i])) {
+				start++;
+			}
+		}
+		for (depth = start; depth < sort_order->cCategories; depth++) {
+			if (i) {
+				node = &view->nodes[headers[depth]];
+				node->node_count = view->node_count - headers[depth] - 1;
+			}
+			headers[depth] = view->node_count;
+			node = &view->nodes[view->node_count++];
+			node->row = sorted[i];
+			node->header = true;
+			node->depth = depth;
+			node->category_id = ++view->last_category_id;
+			node->collapsed = (depth >= sort_order->cExpanded);
+			node->leaf_count = 0;
+			node->node_count = 0;
+		}
+		for (depth = 0; depth < sort_order->cCategories; depth++) {
+			view->nodes[headers[depth]].leaf_count++;
+		}
+		node = &view->nodes[view->node_count++];
+		node->row = sorted[i];
+		node->header = false;
+		node->depth = sort_order->cCategories;
+		node->category_id = 0;
+		node->collapsed = false;
+		node->leaf_count = 0;
+		node->node_count = 0;
+	}
+	for (depth = 0; view->row_count && depth < sort_order->cCategories; depth++) {
+		node = &view->nodes[headers[depth]];
+		node->node_count = view->node_count - headers[depth] - 1;
+	}
+
+	if (old_nodes) {
+		mapistore_table_view_restore_state(view, old_nodes, 0, old_node_count, 0, view->node_count, 0);
+	}
+	mapistore_table_view_update_visible(view);
+	view->backend_row_count = backend_count;
+	view->dirty = false;
+	view->rows_restricted = view->restricted;
+	view->restriction_changed = false;
+
+	DEBUG(5, ("[%s:%d]: %u backend rows sorted into %u rows, %u visible\n", __FUNCTION__, __LINE__,
+		  backend_count, view->row_count, view->visible_count));
+	ret = MAPISTORE_SUCCESS;
+
+end:
+	if (ret != MAPISTORE_SUCCESS) {
+		talloc_free(view->rows_ctx);
+		mapistore_table_view_reset(view);
+	}
+
+	/* Restore the columns of the client */
+	if (view->columns) {
+		mapistore_table_view_backend_columns(view, view->column_count, view->columns);
+	}
+	talloc_free(old_ctx);
+
+	return ret;
+}
+
+static enum mapistore_error mapistore_table_view_refresh(struct mapistore_table_view *view)
+{
+	enum mapistore_error	ret;
+	uint32_t		backend_count;
+
+	if (!view->dirty && !view->restriction_changed) {
+		ret = mapistore_backend_table_get_row_count(view->backend_ctx, view->table, MAPISTORE_PREFILTERED_QUERY, &backend_count);
+		if (ret == MAPISTORE_SUCCESS && backend_count == view->backend_row_count) {
+			return MAPISTORE_SUCCESS;
+		}
+	}
+
+	return mapistore_table_view_build(view);
+}
+
+static void *mapistore_table_view_uint32(TALLOC_CTX *mem_ctx, uint32_t value)
+{
+	uint32_t	*p;
+
+	p = talloc(mem_ctx, uint32_t);
+	if (p) {
+		*p = value;
+	}
+
+	return p;
+}
+
+static enum mapistore_error mapistore_table_view_header_row(struct mapistore_table_view *view,
+							    struct mapistore_table_view_node *node,
+							    TALLOC_CTX *mem_ctx,
+							    struct mapistore_property_data **datap)
+{
+	struct mapistore_property_data	*data;
+	struct SSortOrderSet		*sort_order = view->sort_order;
+	uint64_t			*category_id;
+	uint16_t			i, j;
+
+	data = talloc_array(mem_ctx, struct mapistore_property_data, view->column_count);
+	MAPISTORE_RETVAL_IF(view->column_count && !data, MAPISTORE_ERR_NO_MEMORY, NULL);
+
+	for (i = 0; i < view->column_count; i++) {
+		data[i].data = NULL;
+		data[i].error = MAPISTORE_ERR_NOT_FOUND;
+
+		switch (view->columns[i]) {
+		case PidTagInstID:
+			category_id = talloc(data, uint64_t);
+			MAPISTORE_RETVAL_IF(!category_id, MAPISTORE_ERR_NO_MEMORY, data);
+			*category_id = node->category_id;
+			data[i].data = category_id;
+			break;
+		case PidTagInstanceNum:
+			data[i].data = mapistore_table_view_uint32(data, 0);
+			break;
+		case PidTagRowType:
+			data[i].data = mapistore_table_view_uint32(data, node->collapsed ? TBL_COLLAPSED_CATEGORY : TBL_EXPANDED_CATEGORY);
+			break;
+		case PidTagDepth:
+			data[i].data = mapistore_table_view_uint32(data, node->depth);
+			break;
+		case PidTagContentCount:
+			data[i].data = mapistore_table_view_uint32(data, node->leaf_count);
+			break;
+		default:
+			/* Category columns up to the depth of the header */
+			for (j = 0; j <= node->depth; j++) {
+				if (view->columns[i] == sort_order->aSort[j].ulPropTag) {
+					data[i] = node->row->keys[j];
+					break;
+				}
+			}
+			/* Maximum value of the category */
+			if (j > node->depth && node->row->aggregates
+			    && view->columns[i] == sort_order->aSort[sort_order->cCategories].ulPropTag) {
+				data[i] = node->row->aggregates[node->depth];
+			}
+			continue;
+		}
+		MAPISTORE_RETVAL_IF(!data[i].data, MAPISTORE_ERR_NO_MEMORY, data);
+		data[i].error = MAPISTORE_SUCCESS;
+	}
+
+	*datap = data;
+
+	return MAPISTORE_SUCCESS;
+}
+
+static enum mapistore_error mapistore_table_view_leaf_row(struct mapistore_table_view *view,
+							  struct mapistore_table_view_node *node,
+							  TALLOC_CTX *mem_ctx,
+							  enum mapistore_query_type query_type,
+							  struct mapistore_property_data **datap)
+{
+	enum mapistore_error		ret;
+	struct mapistore_property_data	*data;
+	uint32_t			value = 0;
+	uint16_t			i;
+	bool				fixed;
+
+	ret = mapistore_backend_table_get_row(view->backend_ctx, view->table, mem_ctx, query_type, node->row->rowid, &data);
+	MAPISTORE_RETVAL_IF(ret, ret, NULL);
+
+	for (i = 0; i < view->column_count; i++) {
+		fixed = true;
+		switch (view->columns[i]) {
+		case PidTagInstanceNum:
+			if (!node->row->instance) {
+				fixed = false;
+			}
+			value = node->row->instance;
+			break;
+		case PidTagRowType:
+			value = TBL_LEAF_ROW;
+			break;
+		case PidTagDepth:
+			value = node->depth;
+			break;
+		default:
+			fixed = false;
+			if ((view->columns[i] & MV_INSTANCE) && data[i].error == MAPISTORE_SUCCESS) {
+				if (node->row->instance && node->row->instance <= mapistore_table_view_instance_count(view->columns[i] & 0xFFFF & ~MV_INSTANCE, data[i].data)) {
+					data[i].data = mapistore_table_view_instance_value(view->columns[i] & 0xFFFF & ~MV_INSTANCE, data[i].data, node->row->instance - 1);
+				}
+				else {
+					data[i].data = NULL;
+					data[i].error = MAPISTORE_ERR_NOT_FOUND;
+				}
+			}
+		}
+		if (fixed) {
+			data[i].data = mapistore_table_view_uint32(data, value);
+			MAPISTORE_RETVAL_IF(!data[i].data, MAPISTORE_ERR_NO_MEMORY, NULL);
+			data[i].error = MAPISTORE_SUCCESS;
+		}
+	}
+
+	*datap = data;
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Record the columns of a table and set them on the backend
+   table
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx pointer to the backend context of the table
+   \param table pointer to the backend table
+   \param count number of columns
+   \param properties array of column property tags
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_set_columns(struct mapistore_context *mstore_ctx,
+						      struct backend_context *backend_ctx,
+						      void *table, uint16_t count,
+						      enum MAPITAGS *properties)
+{
+	struct mapistore_table_view	*view;
+
+	view = mapistore_table_view_get(mstore_ctx, backend_ctx, table);
+	MAPISTORE_RETVAL_IF(!view, MAPISTORE_ERR_NO_MEMORY, NULL);
+
+	talloc_free(view->columns);
+	view->columns = NULL;
+	view->column_count = 0;
+	if (count) {
+		view->columns = talloc_memdup(view, properties, sizeof (enum MAPITAGS) * count);
+		MAPISTORE_RETVAL_IF(!view->columns, MAPISTORE_ERR_NO_MEMORY, NULL);
+		view->column_count = count;
+	}
+
+	return mapistore_table_view_backend_columns(view, count, properties);
+}
+
+/**
+   \details Set the restrictions of a backend table. A sorted view is
+   rebuilt the next time rows are counted or read, unless neither its
+   rows nor the table are restricted.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx pointer to the backend context of the table
+   \param table pointer to the backend table
+   \param restrictions pointer to the restrictions to apply
+   \param table_status pointer to the table status to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_set_restrictions(struct mapistore_context *mstore_ctx,
+							   struct backend_context *backend_ctx,
+							   void *table, struct mapi_SRestriction *restrictions,
+							   uint8_t *table_status)
+{
+	struct mapistore_table_view	*view;
+
+	view = mapistore_table_view_search(mstore_ctx, table);
+	if (view) {
+		/* FindRow restricts the table for the time of the search
+		   only, and clears the restriction afterwards: the rows
+		   read without restriction stay valid */
+		view->restricted = (restrictions != NULL);
+		view->restriction_changed = view->restricted || view->rows_restricted;
+	}
+
+	return mapistore_backend_table_set_restrictions(backend_ctx, table, restrictions, table_status);
+}
+
+/**
+   \details Set the sort order of a table
+
+   The sort order is handed to the backend first. The rows are sorted
+   by libmapistore when the backend cannot sort them, or when the sort
+   order requests categories or multi-valued instances.
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx pointer to the backend context of the table
+   \param table pointer to the backend table
+   \param sort_order pointer to the sort order
+   \param table_status pointer to the table status to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_set_sort_order(struct mapistore_context *mstore_ctx,
+							 struct backend_context *backend_ctx,
+							 void *table, struct SSortOrderSet *sort_order,
+							 uint8_t *table_status)
+{
+	enum mapistore_error		ret;
+	struct mapistore_table_view	*view;
+	bool				instance = false;
+	uint16_t			i;
+
+	/* Sanity checks */
+	MAPISTORE_RETVAL_IF(!sort_order, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	MAPISTORE_RETVAL_IF(sort_order->cCategories > sort_order->cSorts, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	MAPISTORE_RETVAL_IF(sort_order->cExpanded > sort_order->cCategories, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	for (i = 0; i < sort_order->cSorts; i++) {
+		if (sort_order->aSort[i].ulPropTag & MV_INSTANCE) {
+			MAPISTORE_RETVAL_IF(instance || !(sort_order->aSort[i].ulPropTag & MV_FLAG),
+					    MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+			instance = true;
+		}
+	}
+
+	ret = mapistore_backend_table_set_sort_order(backend_ctx, table, sort_order, table_status);
+
+	view = mapistore_table_view_get(mstore_ctx, backend_ctx, table);
+	MAPISTORE_RETVAL_IF(!view, MAPISTORE_ERR_NO_MEMORY, NULL);
+
+	/* The backend sorts the table itself */
+	if (!sort_order->cSorts || (ret == MAPISTORE_SUCCESS && !sort_order->cCategories && !instance)) {
+		if (view->sort_order) {
+			talloc_free(view->sort_order);
+			view->sort_order = NULL;
+			talloc_free(view->rows_ctx);
+			mapistore_table_view_reset(view);
+		}
+		return (ret == MAPISTORE_ERR_NOT_IMPLEMENTED) ? MAPISTORE_SUCCESS : ret;
+	}
+
+	/* The collapse state of the categories is lost with the sort order */
+	talloc_free(view->sort_order);
+	talloc_free(view->rows_ctx);
+	mapistore_table_view_reset(view);
+
+	view->sort_order = talloc_zero(view, struct SSortOrderSet);
+	MAPISTORE_RETVAL_IF(!view->sort_order, MAPISTORE_ERR_NO_MEMORY, NULL);
+	*view->sort_order = *sort_order;
+	view->sort_order->aSort = talloc_memdup(view->sort_order, sort_order->aSort, sizeof (struct SSortOrder) * sort_order->cSorts);
+	MAPISTORE_RETVAL_IF(!view->sort_order->aSort, MAPISTORE_ERR_NO_MEMORY, NULL);
+	if (table_status) {
+		*table_status = TBLSTAT_COMPLETE;
+	}
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Retrieve a row of a table by position
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx pointer to the backend context of the table
+   \param table pointer to the backend table
+   \param mem_ctx pointer to the memory context
+   \param query_type the type of query
+   \param rowid the position of the row
+   \param data pointer to the row values to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_get_row(struct mapistore_context *mstore_ctx,
+						  struct backend_context *backend_ctx,
+						  void *table, TALLOC_CTX *mem_ctx,
+						  enum mapistore_query_type query_type, uint32_t rowid,
+						  struct mapistore_property_data **data)
+{
+	enum mapistore_error			ret;
+	struct mapistore_table_view		*view;
+	struct mapistore_table_view_node	*node;
+
+	view = mapistore_table_view_search(mstore_ctx, table);
+	if (!view || !view->sort_order) {
+		return mapistore_backend_table_get_row(backend_ctx, table, mem_ctx, query_type, rowid, data);
+	}
+
+	/* Live queries (FindRow) are checked against the current view,
+	   with the restriction set for the search only */
+	if (!view->rows_ctx || ((view->dirty || view->restriction_changed) && query_type == MAPISTORE_PREFILTERED_QUERY)) {
+		ret = mapistore_table_view_build(view);
+		MAPISTORE_RETVAL_IF(ret, ret, NULL);
+	}
+	MAPISTORE_RETVAL_IF(rowid >= view->visible_count, MAPISTORE_ERR_NOT_FOUND, NULL);
+
+	node = &view->nodes[view->visible[rowid]];
+	if (node->header) {
+		/* Restrictions are evaluated by the backend, on its own
+		   rows: header rows never match a live-filtered query */
+		MAPISTORE_RETVAL_IF(query_type == MAPISTORE_LIVEFILTERED_QUERY, MAPISTORE_ERR_NOT_FOUND, NULL);
+		return mapistore_table_view_header_row(view, node, mem_ctx, data);
+	}
+
+	return mapistore_table_view_leaf_row(view, node, mem_ctx, query_type, data);
+}
+
+/**
+   \details Retrieve the number of rows of a table
+
+   \param mstore_ctx pointer to the mapistore context
+   \param backend_ctx pointer to the backend context of the table
+   \param table pointer to the backend table
+   \param query_type the type of query
+   \param row_countp pointer to the number of rows to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_get_row_count(struct mapistore_context *mstore_ctx,
+							struct backend_context *backend_ctx,
+							void *table, enum mapistore_query_type query_type,
+							uint32_t *row_countp)
+{
+	enum mapistore_error		ret;
+	struct mapistore_table_view	*view;
+
+	view = mapistore_table_view_search(mstore_ctx, table);
+	if (!view || !view->sort_order) {
+		return mapistore_backend_table_get_row_count(backend_ctx, table, query_type, row_countp);
+	}
+
+	ret = mapistore_table_view_refresh(view);
+	MAPISTORE_RETVAL_IF(ret, ret, NULL);
+
+	*row_countp = view->visible_count;
+
+	return MAPISTORE_SUCCESS;
+}
+
+static enum mapistore_error mapistore_table_view_toggle(struct mapistore_context *mstore_ctx, void *table,
+							uint64_t category_id, bool collapse,
+							uint32_t *positionp, uint32_t *row_countp)
+{
+	enum mapistore_error			ret;
+	struct mapistore_table_view		*view;
+	struct mapistore_table_view_node	*node = NULL;
+	uint32_t				i, old_count;
+
+	view = mapistore_table_view_search(mstore_ctx, table);
+	MAPISTORE_RETVAL_IF(!view || !view->sort_order || !view->sort_order->cCategories, MAPISTORE_ERR_INVALID_PARAMETER, NULL);
+	if (!view->rows_ctx) {
+		ret = mapistore_table_view_build(view);
+		MAPISTORE_RETVAL_IF(ret, ret, NULL);
+	}
+
+	for (i = 0; i < view->visible_count; i++) {
+		node = &view->nodes[view->visible[i]];
+		if (node->header && node->category_id == category_id) break;
+	}
+	MAPISTORE_RETVAL_IF(i == view->visible_count, MAPISTORE_ERR_NOT_FOUND, NULL);
+
+	*positionp = i;
+	*row_countp = 0;
+	if (node->collapsed == collapse) {
+		return MAPISTORE_SUCCESS;
+	}
+
+	old_count = view->visible_count;
+	node->collapsed = collapse;
+	mapistore_table_view_update_visible(view);
+	*row_countp = collapse ? (old_count - view->visible_count) : (view->visible_count - old_count);
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Expand a category of a categorized table
+
+   \param mstore_ctx pointer to the mapistore context
+   \param table pointer to the backend table
+   \param category_id the identifier of the category header row
+   \param positionp pointer to the position of the header row to return
+   \param row_countp pointer to the number of rows made visible to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_expand_row(struct mapistore_context *mstore_ctx, void *table,
+						     uint64_t category_id, uint32_t *positionp, uint32_t *row_countp)
+{
+	return mapistore_table_view_toggle(mstore_ctx, table, category_id, false, positionp, row_countp);
+}
+
+/**
+   \details Collapse a category of a categorized table
+
+   \param mstore_ctx pointer to the mapistore context
+   \param table pointer to the backend table
+   \param category_id the identifier of the category header row
+   \param positionp pointer to the position of the header row to return
+   \param row_countp pointer to the number of rows hidden to return
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+enum mapistore_error mapistore_table_view_collapse_row(struct mapistore_context *mstore_ctx, void *table,
+						       uint64_t category_id, uint32_t *positionp, uint32_t *row_countp)
+{
+	return mapistore_table_view_toggle(mstore_ctx, table, category_id, true, positionp, row_countp);
+}
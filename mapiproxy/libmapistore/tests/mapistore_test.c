@@ -26,6 +26,8 @@
 #include <popt.h>
 #include <param.h>
 #include <util/debug.h>
+#include <sys/time.h>
+#include <inttypes.h>
 
 /**
    \file mapistore_test.c
@@ -33,6 +35,65 @@
    \brief Test mapistore implementation
  */
 
+static double mapistore_test_elapsed(struct timeval *start)
+{
+	struct timeval	now;
+
+	gettimeofday(&now, NULL);
+
+	return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+/**
+   Enumerate the children of a folder with mapistore_folder_get_child_fmids
+   and with the generic row by row implementation, check both return the
+   same identifiers and report the time each one took.
+ */
+static int mapistore_test_child_fmids(TALLOC_CTX *mem_ctx, struct mapistore_context *mstore_ctx,
+				      uint32_t context_id, void *folder, enum mapistore_table_type table_type,
+				      const char *label)
+{
+	enum mapistore_error	retval;
+	struct timeval		start;
+	uint64_t		*fmids, *table_fmids;
+	uint32_t		count, table_count, i;
+	double			elapsed, table_elapsed;
+
+	gettimeofday(&start, NULL);
+	retval = mapistore_folder_get_child_fmids(mstore_ctx, context_id, folder, table_type, mem_ctx, &fmids, &count);
+	elapsed = mapistore_test_elapsed(&start);
+	if (retval != MAPISTORE_SUCCESS) {
+		DEBUG(0, ("%s: mapistore_folder_get_child_fmids: %s\n", label, mapistore_errstr(retval)));
+		return -1;
+	}
+
+	gettimeofday(&start, NULL);
+	retval = mapistore_folder_get_child_fmids_from_table(mstore_ctx, context_id, folder, table_type, mem_ctx, &table_fmids, &table_count);
+	table_elapsed = mapistore_test_elapsed(&start);
+	if (retval != MAPISTORE_SUCCESS) {
+		DEBUG(0, ("%s: mapistore_folder_get_child_fmids_from_table: %s\n", label, mapistore_errstr(retval)));
+		return -1;
+	}
+
+	DEBUG(0, ("%s: %d children, get_child_fmids: %.6fs, row by row: %.6fs\n", label, count, elapsed, table_elapsed));
+
+	if (count != table_count) {
+		DEBUG(0, ("%s: child count mismatch (%d != %d)\n", label, count, table_count));
+		return -1;
+	}
+	for (i = 0; i < count; i++) {
+		if (fmids[i] != table_fmids[i]) {
+			DEBUG(0, ("%s: fmid mismatch at %d (0x%.16"PRIx64" != 0x%.16"PRIx64")\n", label, i, fmids[i], table_fmids[i]));
+			return -1;
+		}
+	}
+
+	talloc_free(fmids);
+	talloc_free(table_fmids);
+
+	return 0;
+}
+
 
 int main(int argc, const char *argv[])
 {
@@ -43,16 +104,18 @@ int main(int argc, const char *argv[])
 	poptContext			pc;
 	int				opt;
 	const char			*opt_debug = NULL;
+	const char			*opt_uri = NULL;
 	uint32_t			context_id = 0;
 	uint32_t			context_id2 = 0;
 	uint32_t			context_id3 = 0;
 	void				*root_folder;
 
-	enum { OPT_DEBUG=1000 };
+	enum { OPT_DEBUG=1000, OPT_URI };
 
 	struct poptOption long_options[] = {
 		POPT_AUTOHELP
 		{ "debuglevel",	'd', POPT_ARG_STRING, NULL, OPT_DEBUG,	"set the debug level", NULL },
+		{ "uri",	'u', POPT_ARG_STRING, NULL, OPT_URI,	"compare child fmids enumeration on the root folder of this context", NULL },
 		{ NULL, 0, 0, NULL, 0, NULL, NULL }
 	};
 
@@ -66,6 +129,9 @@ int main(int argc, const char *argv[])
 		case OPT_DEBUG:
 			opt_debug = poptGetOptArg(pc);
 			break;
+		case OPT_URI:
+			opt_uri = poptGetOptArg(pc);
+			break;
 		}
 	}
 
@@ -87,6 +153,25 @@ int main(int argc, const char *argv[])
 		exit (1);
 	}
 
+	if (opt_uri) {
+		retval = mapistore_add_context(mstore_ctx, "openchange", opt_uri, -1, &context_id, &root_folder);
+		if (retval != MAPISTORE_SUCCESS) {
+			DEBUG(0, ("%s\n", mapistore_errstr(retval)));
+			exit (1);
+		}
+
+		if (mapistore_test_child_fmids(mem_ctx, mstore_ctx, context_id, root_folder, MAPISTORE_MESSAGE_TABLE, "messages") ||
+		    mapistore_test_child_fmids(mem_ctx, mstore_ctx, context_id, root_folder, MAPISTORE_FAI_TABLE, "FAI messages") ||
+		    mapistore_test_child_fmids(mem_ctx, mstore_ctx, context_id, root_folder, MAPISTORE_FOLDER_TABLE, "folders")) {
+			exit (1);
+		}
+
+		retval = mapistore_del_context(mstore_ctx, context_id);
+		retval = mapistore_release(mstore_ctx);
+
+		return 0;
+	}
+
 	retval = mapistore_add_context(mstore_ctx, "openchange", "sqlite:///tmp/test.db", -1, &context_id, &root_folder);
 	if (retval != MAPISTORE_SUCCESS) {
 		DEBUG(0, ("%s\n", mapistore_errstr(retval)));
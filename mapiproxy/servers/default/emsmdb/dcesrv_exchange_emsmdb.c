@@ -165,6 +165,7 @@ static enum MAPISTATUS dcesrv_EcDoConnect(struct dcesrv_call_state *dce_call,
 	OPENCHANGE_RETVAL_IF(!handle, MAPI_E_NOT_ENOUGH_RESOURCES, emsmdbp_ctx);
 	
 	handle->data = (void *) emsmdbp_ctx;
+	emsmdbp_indexing_flush_timer_init(emsmdbp_ctx, dce_call->event_ctx);
 	*r->out.handle = handle->wire_handle;
 
 	r->out.pcmsPollsMax = talloc_zero(mem_ctx, uint32_t);
@@ -643,7 +644,8 @@ end:
 
 static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx, 
 							 struct emsmdbp_context *emsmdbp_ctx,
-							 struct mapi_request *mapi_request)
+							 struct mapi_request *mapi_request,
+							 uint32_t max_size)
 {
 	enum MAPISTATUS				retval;
 	struct mapi_response			*mapi_response;
@@ -669,6 +671,18 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 	mapi_response = talloc_zero(mem_ctx, struct mapi_response);
 	mapi_response->handles = mapi_request->handles;
 
+	/* Room left to the ROP replies, used to size the buffers requested with 0xBABE */
+	handles_length = mapi_request->mapi_len - mapi_request->length;
+	if (max_size > EMSMDBP_MAX_ROP_BUFFER_SIZE) {
+		max_size = EMSMDBP_MAX_ROP_BUFFER_SIZE;
+	}
+	if (max_size > handles_length + sizeof (mapi_response->length)) {
+		emsmdbp_ctx->rop_buffer_size = max_size - handles_length - sizeof (mapi_response->length);
+	}
+	else {
+		emsmdbp_ctx->rop_buffer_size = 0;
+	}
+
 	/* Step 1. Handle Idle requests case */
 	if (mapi_request->mapi_len <= 2) {
 		mapi_response->mapi_len = 2;
@@ -685,6 +699,7 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 			mapi_response->mapi_repl = talloc_realloc(mem_ctx, mapi_response->mapi_repl,
 								  struct EcDoRpc_MAPI_REPL, idx + 2);
 		}
+		emsmdbp_ctx->rop_repl_idx = idx;
 
 		switch (mapi_request->mapi_req[i].opnum) {
 		case op_MAPI_Release: /* 0x01 */
@@ -821,9 +836,19 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 						    &(mapi_response->mapi_repl[idx]),
 						    mapi_response->handles, &size);
 			break;
-		/* op_MAPI_SeekRowBookmark: 0x19 */
+		case op_MAPI_SeekRowBookmark: /* 0x19 */
+			retval = EcDoRpc_RopSeekRowBookmark(mem_ctx, emsmdbp_ctx,
+							    &(mapi_request->mapi_req[i]),
+							    &(mapi_response->mapi_repl[idx]),
+							    mapi_response->handles, &size);
+			break;
 		/* op_MAPI_SeekRowApprox: 0x1a */
-		/* op_MAPI_CreateBookmark: 0x1b */
+		case op_MAPI_CreateBookmark: /* 0x1b */
+			retval = EcDoRpc_RopCreateBookmark(mem_ctx, emsmdbp_ctx,
+							   &(mapi_request->mapi_req[i]),
+							   &(mapi_response->mapi_repl[idx]),
+							   mapi_response->handles, &size);
+			break;
 		case op_MAPI_CreateFolder: /* 0x1c */
 			retval = EcDoRpc_RopCreateFolder(mem_ctx, emsmdbp_ctx,
 							 &(mapi_request->mapi_req[i]),
@@ -1070,8 +1095,18 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 						&(mapi_response->mapi_repl[idx]),
 						mapi_response->handles, &size);
 			break;
-		/* op_MAPI_ExpandRow: 0x59 */
-		/* op_MAPI_CollapseRow: 0x5a */
+		case op_MAPI_ExpandRow: /* 0x59 */
+			retval = EcDoRpc_RopExpandRow(mem_ctx, emsmdbp_ctx,
+						      &(mapi_request->mapi_req[i]),
+						      &(mapi_response->mapi_repl[idx]),
+						      mapi_response->handles, &size);
+			break;
+		case op_MAPI_CollapseRow: /* 0x5a */
+			retval = EcDoRpc_RopCollapseRow(mem_ctx, emsmdbp_ctx,
+							&(mapi_request->mapi_req[i]),
+							&(mapi_response->mapi_repl[idx]),
+							mapi_response->handles, &size);
+			break;
 		/* op_MAPI_LockRegionStream: 0x5b */
 		/* op_MAPI_UnlockRegionStream: 0x5c */
 		case op_MAPI_CommitStream: /* 0x5d */
@@ -1217,7 +1252,12 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 			break;
 		/* op_MAPI_OpenPublicFolderByName: 0x87 */
 		/* op_MAPI_SetSyncNotificationGuid: 0x88 */
-		/* op_MAPI_FreeBookmark: 0x89 */
+		case op_MAPI_FreeBookmark: /* 0x89 */
+			retval = EcDoRpc_RopFreeBookmark(mem_ctx, emsmdbp_ctx,
+							 &(mapi_request->mapi_req[i]),
+							 &(mapi_response->mapi_repl[idx]),
+							 mapi_response->handles, &size);
+			break;
 		/* op_MAPI_WriteAndCommitStream: 0x90 */
 		/* op_MAPI_HardDeleteMessages: 0x91 */
 		/* op_MAPI_HardDeleteMessagesAndSubfolders: 0x92 */
@@ -1247,6 +1287,11 @@ static struct mapi_response *EcDoRpc_process_transaction(TALLOC_CTX *mem_ctx,
 		}
 	}
 
+	/* Messages imported by the request are committed before notifications are collected */
+	emsmdbp_import_batch_flush(emsmdbp_ctx, mapi_response->mapi_repl, &size);
+	/* Index updates held in write-back mode are written once their interval elapsed */
+	mapistore_indexing_flush(emsmdbp_ctx->mstore_ctx, false);
+
 notif:
 	/* Step 3. Notifications/Pending calls should be processed here */
 	/* Note: GetProps and GetRows are filled with flag NDR_REMAINING, which may hide the content of the following replies. */
@@ -1299,7 +1344,6 @@ notif:
 	}
 	
 	/* Step 4. Fill mapi_response structure */
-	handles_length = mapi_request->mapi_len - mapi_request->length;
 	mapi_response->length = size + sizeof (mapi_response->length);
 	mapi_response->mapi_len = mapi_response->length + handles_length;
 
@@ -1323,6 +1367,7 @@ static enum MAPISTATUS dcesrv_EcDoRpc(struct dcesrv_call_state *dce_call,
 	struct emsmdbp_context		*emsmdbp_ctx = NULL;
 	struct mapi_request		*mapi_request;
 	struct mapi_response		*mapi_response;
+	TALLOC_CTX			*pool_ctx;
 
 	DEBUG(3, ("exchange_emsmdb: EcDoRpc (0x2)\n"));
 
@@ -1348,8 +1393,12 @@ static enum MAPISTATUS dcesrv_EcDoRpc(struct dcesrv_call_state *dce_call,
 	}
 
 	/* Step 1. Process EcDoRpc requests */
+	/* The response is marshalled after we return: the pool is
+	   released along with the call memory context */
 	mapi_request = r->in.mapi_request;
-	mapi_response = EcDoRpc_process_transaction(mem_ctx, emsmdbp_ctx, mapi_request);
+	pool_ctx = emsmdbp_request_pool_init(emsmdbp_ctx, mem_ctx);
+	mapi_response = EcDoRpc_process_transaction(pool_ctx, emsmdbp_ctx, mapi_request, r->in.max_data);
+	emsmdbp_request_pool_account(emsmdbp_ctx, pool_ctx);
 
 	/* Step 2. Fill EcDoRpc reply */
 	r->out.handle = r->in.handle;
@@ -1633,6 +1682,7 @@ static enum MAPISTATUS dcesrv_EcDoConnectEx(struct dcesrv_call_state *dce_call,
 	OPENCHANGE_RETVAL_IF(!handle, MAPI_E_NOT_ENOUGH_RESOURCES, emsmdbp_ctx);
 
 	handle->data = (void *) emsmdbp_ctx;
+	emsmdbp_indexing_flush_timer_init(emsmdbp_ctx, dce_call->event_ctx);
 	*r->out.handle = handle->wire_handle;
 
 	*r->out.pcmsPollsMax = EMSMDB_PCMSPOLLMAX;
@@ -1718,12 +1768,17 @@ static enum MAPISTATUS dcesrv_EcDoRpcExt2(struct dcesrv_call_state *dce_call,
 	struct ndr_push			*ndr_uncomp_rgbOut;
 	struct ndr_push			*ndr_comp_rgbOut;
 	struct ndr_push			*ndr_rgbOut;
+	TALLOC_CTX			*pool_ctx;
 	uint32_t			pulFlags = 0x0;
 	uint32_t			pulTransTime = 0;
+	uint32_t			cbOut;
 	DATA_BLOB			rgbIn;
 
 	DEBUG(3, ("exchange_emsmdb: EcDoRpcExt2 (0xB)\n"));
 
+	/* pcbOut is shared by the request and the reply */
+	cbOut = *r->in.pcbOut;
+
 	r->out.rgbOut = NULL;
 	*r->out.pcbOut = 0;
 	r->out.rgbAuxOut = NULL;
@@ -1756,7 +1811,10 @@ static enum MAPISTATUS dcesrv_EcDoRpcExt2(struct dcesrv_call_state *dce_call,
 	ndr_pull_mapi2k7_request(ndr_pull, NDR_SCALARS|NDR_BUFFERS, &mapi2k7_request);
 	talloc_free(ndr_pull);
 
-	mapi_response = EcDoRpc_process_transaction(mem_ctx, emsmdbp_ctx, mapi2k7_request.mapi_request);
+	pool_ctx = emsmdbp_request_pool_init(emsmdbp_ctx, mem_ctx);
+	mapi_response = EcDoRpc_process_transaction(pool_ctx, emsmdbp_ctx, mapi2k7_request.mapi_request,
+						    (cbOut > SIZE_RPC_HEADER_EXT) ? cbOut - SIZE_RPC_HEADER_EXT : 0);
+	emsmdbp_request_pool_account(emsmdbp_ctx, pool_ctx);
 	talloc_free(mapi2k7_request.mapi_request);
 
 	/* Fill EcDoRpcExt2 reply */
@@ -1767,7 +1825,7 @@ static enum MAPISTATUS dcesrv_EcDoRpcExt2(struct dcesrv_call_state *dce_call,
 	ndr_uncomp_rgbOut = ndr_push_init_ctx(mem_ctx);
 	ndr_set_flags(&ndr_uncomp_rgbOut->flags, LIBNDR_FLAG_NOALIGN);
 	ndr_push_mapi_response(ndr_uncomp_rgbOut, NDR_SCALARS|NDR_BUFFERS, mapi_response);
-	talloc_free(mapi_response);
+	talloc_free(pool_ctx);
 
 	/* TODO: compress if requested */
 	ndr_comp_rgbOut = ndr_uncomp_rgbOut;
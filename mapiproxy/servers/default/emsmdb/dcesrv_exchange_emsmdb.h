@@ -45,6 +45,21 @@
 #endif
 #endif
 
+/* Transient allocations made while processing an EcDoRpc transaction
+   come from a talloc pool, released in one operation at the end of
+   the call. The pool is sized from the recent request history of the
+   session, within the bounds below. */
+#define	EMSMDBP_REQUEST_POOL_MIN	(16 * 1024)
+#define	EMSMDBP_REQUEST_POOL_MAX	(256 * 1024)
+
+struct emsmdbp_request_stats {
+	uint64_t				requests;
+	uint64_t				retained_blocks; /* blocks still in the pool when transactions end */
+	uint64_t				overflows;	/* transactions outgrowing their pool */
+	size_t					average_size;
+	size_t					pool_size;	/* size of the next request pool */
+};
+
 struct emsmdbp_context {
 	char					*szUserDN;
 	char					*szDisplayName;
@@ -55,10 +70,72 @@ struct emsmdbp_context {
 	struct ldb_context			*samdb_ctx;
 	struct mapistore_context		*mstore_ctx;
 	struct mapi_handles_context		*handles_ctx;
+	struct emsmdbp_open_message		*open_messages;
+	struct emsmdbp_import_batch		*import_batches;
+	struct emsmdbp_request_stats		request_stats;
+	uint32_t				rop_buffer_size;
+	uint32_t				rop_repl_idx;	/* reply of the ROP being processed */
+	struct tevent_timer			*indexing_flush_timer;
 
 	TALLOC_CTX				*mem_ctx;
 };
 
+/* Largest ROP buffer (RopSize field, ROP replies and handle table)
+   returned by EcDoRpc or EcDoRpcExt2. rop_buffer_size is what is left
+   to the ROP replies of the current request once the client's own
+   limit, the RopSize field and the handle table are accounted for. */
+#define	EMSMDBP_MAX_ROP_BUFFER_SIZE	0x8000
+
+/* Smallest chunk returned to a FastTransferSourceGetBuffer request
+   using 0xBABE. With less space left in the response, the request is
+   answered with TransferStatus_NoRoom and an empty buffer */
+#define	EMSMDBP_MIN_FASTTRANSFER_BUFFER_SIZE	0x400
+
+/* Rows checked against the restriction of a FindRow request before
+   the memory used to read them is released */
+#define	EMSMDBP_FINDROW_BATCH_SIZE	64
+
+/* Bookmarks returned by RopCreateBookmark: record index and generation */
+#define	EMSMDBP_BOOKMARK_SIZE		8
+
+/* RPC_HEADER_EXT prepended to the EcDoRpcExt2 rgbOut buffer */
+#define	SIZE_RPC_HEADER_EXT		8
+
+/* Read-only messages opened in the session. Every message object
+   opened read-only on the same folder and message ids shares the
+   backend message, which lives as long as one of them references it.
+   Entries are only reused for EMSMDBP_OPEN_MESSAGE_TTL seconds, so
+   that changes made outside the session are eventually seen. */
+#define	EMSMDBP_OPEN_MESSAGE_TTL	10
+
+struct emsmdbp_open_message {
+	struct emsmdbp_context			*emsmdbp_ctx;
+	struct emsmdbp_object			*folder_object; /* backend_object was opened from it */
+	uint64_t				folderID;
+	uint64_t				messageID;
+	time_t					opened;
+	void					*backend_object;
+	struct mapistore_message		*msg;
+	uint32_t				cache_generation; /* bumped to invalidate every sharer's cache */
+	bool					listed;
+	struct emsmdbp_open_message		*prev;
+	struct emsmdbp_open_message		*next;
+};
+
+/* Messages imported with RopSyncImportMessageChange in the current
+   EcDoRpc request, grouped by folder. Their property group change
+   numbers are written together when the request completes, and so are
+   their saves when the backend can save several messages at once. */
+struct emsmdbp_import_batch {
+	struct emsmdbp_object			*folder_object;
+	uint32_t				count;
+	struct emsmdbp_object			**messages;
+	bool					*deferred; /* save left to mapistore_folder_save_messages */
+	uint32_t				*repl_idx; /* RopSaveChangesMessage reply of each message */
+	struct emsmdbp_import_batch		*prev;
+	struct emsmdbp_import_batch		*next;
+};
+
 struct exchange_emsmdb_session {
 	uint32_t			pullTimeStamp;
 	struct mpm_session		*session;
@@ -133,11 +210,66 @@ struct emsmdbp_object_folder {
 	struct SRow			*postponed_props; /* storage for properties set until PR_CONTAINER_CLASS_UNICODE is set */
 };
 
+/* Backend property values memoized on an open message, see
+   emsmdbp_object_get_properties. Values larger than
+   EMSMDBP_PROPERTY_CACHE_MAX_VALUE bytes (bodies, attachments) are
+   never kept, and the cache stops growing once it holds
+   EMSMDBP_PROPERTY_CACHE_MAX_ENTRIES entries or
+   EMSMDBP_PROPERTY_CACHE_MAX_SIZE bytes. */
+#define	EMSMDBP_PROPERTY_CACHE_MAX_ENTRIES	256
+#define	EMSMDBP_PROPERTY_CACHE_MAX_VALUE	4096
+#define	EMSMDBP_PROPERTY_CACHE_MAX_SIZE		65536
+
+struct emsmdbp_property_cache_entry {
+	enum MAPITAGS				proptag;
+	enum MAPISTATUS				retval;
+	void					*data;
+};
+
+struct emsmdbp_property_cache {
+	uint32_t				count;
+	size_t					size;
+	struct emsmdbp_property_cache_entry	*entries;
+};
+
+/* Property groups reported to ICS clients requesting partial message
+   changes (FastTransfer_PartialItem). Properties not listed in any
+   group belong to EMSMDBP_PROPERTY_GROUP_OTHER. */
+enum emsmdbp_property_group {
+	EMSMDBP_PROPERTY_GROUP_STATUS		= 0x0, /* flags, follow-up, icon */
+	EMSMDBP_PROPERTY_GROUP_BODY		= 0x1,
+	EMSMDBP_PROPERTY_GROUP_RECIPIENTS	= 0x2,
+	EMSMDBP_PROPERTY_GROUP_ATTACHMENTS	= 0x3,
+	EMSMDBP_PROPERTY_GROUP_OTHER		= 0x4,
+	EMSMDBP_PROPERTY_GROUP_COUNT		= 0x5
+};
+
+#define	EMSMDBP_PROPERTY_GROUP_MAPPING_ID	0x1
+#define	EMSMDBP_PROPERTY_GROUPS_ALL		((1 << EMSMDBP_PROPERTY_GROUP_COUNT) - 1)
+
 struct emsmdbp_object_message {
 	uint64_t				folderID;
 	uint64_t				messageID;
 	bool					read_write;
 	struct mapistore_freebusy_properties	*fb_properties;
+	struct emsmdbp_property_cache		*property_cache;
+	struct emsmdbp_open_message		*open_message; /* shared backend message, read-only only */
+	uint32_t				cache_generation; /* open_message generation of property_cache */
+	uint32_t				changed_groups; /* bitmask of emsmdbp_property_group */
+	bool					imported; /* opened by RopSyncImportMessageChange */
+};
+
+/* Row recorded by RopCreateBookmark. The bookmark returned to the
+   client is the index of the record in the table bookmark array,
+   followed by the generation of the record. */
+struct emsmdbp_table_bookmark {
+	bool					used;
+	uint32_t				generation;
+	bool					visible; /* false once the row was hidden by CollapseRow */
+	uint32_t				position;
+	bool					identified; /* false past the last row */
+	uint64_t				inst_id;
+	uint32_t				inst_num;
 };
 
 struct emsmdbp_object_table {
@@ -149,6 +281,9 @@ struct emsmdbp_object_table {
 	uint32_t				numerator;
 	uint32_t				denominator;
         struct mapistore_subscription_list	*subscription_list;
+	uint32_t				bookmark_count;
+	struct emsmdbp_table_bookmark		*bookmarks;
+	uint32_t				bookmark_generation; /* never reset, bookmarks stay unique */
 };
 
 struct emsmdbp_object_stream {
@@ -296,14 +431,21 @@ struct ldb_context *samdb_connect(TALLOC_CTX *, struct tevent_context *, struct
 struct emsmdbp_context	*emsmdbp_init(struct loadparm_context *, const char *, void *);
 void			*emsmdbp_openchange_ldb_init(struct loadparm_context *);
 bool			emsmdbp_destructor(void *);
+void			emsmdbp_indexing_flush_timer_init(struct emsmdbp_context *, struct tevent_context *);
 bool			emsmdbp_verify_user(struct dcesrv_call_state *, struct emsmdbp_context *);
 bool			emsmdbp_verify_userdn(struct dcesrv_call_state *, struct emsmdbp_context *, const char *, struct ldb_message **);
 enum MAPISTATUS		emsmdbp_resolve_recipient(TALLOC_CTX *, struct emsmdbp_context *, char *, struct mapi_SPropTagArray *, struct RecipientRow *);
+TALLOC_CTX		*emsmdbp_request_pool_init(struct emsmdbp_context *, TALLOC_CTX *);
+void			emsmdbp_request_pool_account(struct emsmdbp_context *, TALLOC_CTX *);
 
 const struct GUID *const	MagicGUIDp;
 int				emsmdbp_guid_to_replid(struct emsmdbp_context *, const char *username, const struct GUID *, uint16_t *);
 int				emsmdbp_replid_to_guid(struct emsmdbp_context *, const char *username, const uint16_t, struct GUID *);
 int				emsmdbp_source_key_from_fmid(TALLOC_CTX *, struct emsmdbp_context *, const char *username, uint64_t, struct Binary_r **);
+enum emsmdbp_property_group	emsmdbp_property_group(enum MAPITAGS);
+const enum MAPITAGS		*emsmdbp_property_group_tags(enum emsmdbp_property_group, uint32_t *);
+enum mapistore_error		emsmdbp_import_batch_save(struct emsmdbp_context *, struct emsmdbp_object *, TALLOC_CTX *);
+void				emsmdbp_import_batch_flush(struct emsmdbp_context *, struct EcDoRpc_MAPI_REPL *, uint16_t *);
 
 /* definitions from emsmdbp_object.c */
 const char	      *emsmdbp_getstr_type(struct emsmdbp_object *);
@@ -336,8 +478,14 @@ struct emsmdbp_object *emsmdbp_folder_open_table(TALLOC_CTX *, struct emsmdbp_ob
 struct emsmdbp_object *emsmdbp_object_table_init(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *);
 int emsmdbp_object_table_get_available_properties(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, struct SPropTagArray **);
 void **emsmdbp_object_table_get_row_props(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, uint32_t, enum mapistore_query_type, enum MAPISTATUS **);
+enum MAPISTATUS emsmdbp_object_table_create_bookmark(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, uint32_t, struct SBinary_short *);
+struct emsmdbp_table_bookmark *emsmdbp_object_table_get_bookmark(struct emsmdbp_object_table *, struct SBinary_short *);
+bool emsmdbp_object_table_seek_bookmark(struct emsmdbp_context *, struct emsmdbp_object *, struct emsmdbp_table_bookmark *, uint32_t *);
+void emsmdbp_object_table_shift_bookmarks(struct emsmdbp_object_table *, uint32_t, uint32_t, bool);
+void emsmdbp_object_table_reset_bookmarks(struct emsmdbp_object_table *);
 struct emsmdbp_object *emsmdbp_object_message_init(TALLOC_CTX *, struct emsmdbp_context *, uint64_t, struct emsmdbp_object *);
 enum mapistore_error emsmdbp_object_message_open(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, uint64_t, uint64_t, bool, struct emsmdbp_object **, struct mapistore_message **);
+void emsmdbp_object_message_forget(struct emsmdbp_context *, uint64_t);
 struct emsmdbp_object *emsmdbp_object_message_open_attachment_table(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *);
 struct emsmdbp_object *emsmdbp_object_stream_init(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *);
 int emsmdbp_object_stream_commit(struct emsmdbp_object *);
@@ -346,6 +494,9 @@ struct emsmdbp_object *emsmdbp_object_subscription_init(TALLOC_CTX *, struct ems
 int emsmdbp_object_get_available_properties(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, struct SPropTagArray **);
 int emsmdbp_object_set_properties(struct emsmdbp_context *, struct emsmdbp_object *, struct SRow *);
 void **emsmdbp_object_get_properties(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *, struct SPropTagArray *, enum MAPISTATUS **);
+void emsmdbp_object_message_invalidate_properties(struct emsmdbp_object *);
+void emsmdbp_object_message_touch_groups(struct emsmdbp_object *, uint32_t);
+void emsmdbp_object_message_commit_groups(struct emsmdbp_context *, struct emsmdbp_object *);
 struct emsmdbp_object *emsmdbp_object_synccontext_init(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *);
 struct emsmdbp_object *emsmdbp_object_ftcontext_init(TALLOC_CTX *, struct emsmdbp_context *, struct emsmdbp_object *);
 struct emsmdbp_stream_data *emsmdbp_stream_data_from_value(TALLOC_CTX *, enum MAPITAGS, void *value, bool);
@@ -424,8 +575,13 @@ enum MAPISTATUS EcDoRpc_RopRestrict(TALLOC_CTX *, struct emsmdbp_context *, stru
 enum MAPISTATUS EcDoRpc_RopQueryRows(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
 enum MAPISTATUS EcDoRpc_RopQueryPosition(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
 enum MAPISTATUS EcDoRpc_RopSeekRow(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
+enum MAPISTATUS EcDoRpc_RopSeekRowBookmark(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
+enum MAPISTATUS EcDoRpc_RopCreateBookmark(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
 enum MAPISTATUS EcDoRpc_RopFindRow(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
+enum MAPISTATUS EcDoRpc_RopExpandRow(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
+enum MAPISTATUS EcDoRpc_RopCollapseRow(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
 enum MAPISTATUS EcDoRpc_RopResetTable(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
+enum MAPISTATUS EcDoRpc_RopFreeBookmark(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
 
 /* definition from oxomsg.c */
 enum MAPISTATUS	EcDoRpc_RopSubmitMessage(TALLOC_CTX *, struct emsmdbp_context *, struct EcDoRpc_MAPI_REQ *, struct EcDoRpc_MAPI_REPL *, uint32_t *, uint16_t *);
@@ -110,6 +110,7 @@ _PUBLIC_ struct emsmdbp_context *emsmdbp_init(struct loadparm_context *lp_ctx,
 	}
 
 	emsmdbp_ctx->mem_ctx = mem_ctx;
+	emsmdbp_ctx->request_stats.pool_size = EMSMDBP_REQUEST_POOL_MIN;
 
 	ev = tevent_context_init(mem_ctx);
 	if (!ev) {
@@ -162,6 +163,62 @@ _PUBLIC_ struct emsmdbp_context *emsmdbp_init(struct loadparm_context *lp_ctx,
 }
 
 
+/**
+   \details Write the indexing updates held in write-back mode and
+   re-arm the timer
+ */
+static void emsmdbp_indexing_flush_handler(struct tevent_context *ev,
+					   struct tevent_timer *te,
+					   struct timeval current_time,
+					   void *private_data)
+{
+	struct emsmdbp_context	*emsmdbp_ctx = (struct emsmdbp_context *) private_data;
+	uint32_t		interval = emsmdbp_ctx->mstore_ctx->indexing_write_back;
+
+	mapistore_indexing_flush(emsmdbp_ctx->mstore_ctx, true);
+
+	emsmdbp_ctx->indexing_flush_timer = tevent_add_timer(ev, emsmdbp_ctx->mem_ctx,
+							     tevent_timeval_current_ofs(interval, 0),
+							     emsmdbp_indexing_flush_handler,
+							     emsmdbp_ctx);
+}
+
+
+/**
+   \details Periodically write the indexing updates held in
+   write-back mode
+
+   Requests only write the pending updates once the write-back
+   interval has elapsed: without this timer, the updates of a client
+   going idle would stay in memory until its next request.
+
+   \param emsmdbp_ctx pointer to the EMSMDBP context
+   \param ev pointer to the event context of the server
+
+   \note The timer is released with the EMSMDBP context. Nothing is
+   done unless the "mapistore:indexing_write_back" option is set.
+ */
+_PUBLIC_ void emsmdbp_indexing_flush_timer_init(struct emsmdbp_context *emsmdbp_ctx,
+						struct tevent_context *ev)
+{
+	uint32_t	interval;
+
+	/* Sanity checks */
+	if (!emsmdbp_ctx || !emsmdbp_ctx->mstore_ctx || !ev) return;
+
+	interval = emsmdbp_ctx->mstore_ctx->indexing_write_back;
+	if (!interval || emsmdbp_ctx->indexing_flush_timer) return;
+
+	emsmdbp_ctx->indexing_flush_timer = tevent_add_timer(ev, emsmdbp_ctx->mem_ctx,
+							     tevent_timeval_current_ofs(interval, 0),
+							     emsmdbp_indexing_flush_handler,
+							     emsmdbp_ctx);
+	if (!emsmdbp_ctx->indexing_flush_timer) {
+		DEBUG(1, ("[%s:%d]: Unable to schedule the indexing flush\n", __FUNCTION__, __LINE__));
+	}
+}
+
+
 /**
    \details Open openchange.ldb database
 
@@ -187,6 +244,9 @@ _PUBLIC_ bool emsmdbp_destructor(void *data)
 
 	if (!emsmdbp_ctx) return false;
 
+	/* message objects may be released after the context */
+	emsmdbp_object_message_forget(emsmdbp_ctx, 0);
+
 	talloc_unlink(emsmdbp_ctx, emsmdbp_ctx->oc_ctx);
 	talloc_free(emsmdbp_ctx->mem_ctx);
 
@@ -196,6 +256,104 @@ _PUBLIC_ bool emsmdbp_destructor(void *data)
 }
 
 
+/**
+   \details Create the memory context backing the transient
+   allocations of an EcDoRpc transaction
+
+   The context is a talloc pool sized from the session request
+   history, so that the many small allocations made by the ROP
+   handlers are carved out of a single chunk and released in one
+   operation when the context is freed.
+
+   \param emsmdbp_ctx pointer to the EMSMDBP context
+   \param mem_ctx pointer to the memory context of the call
+
+   \note talloc never releases part of a pool: memory stolen or
+   referenced out of it by an object outliving the transaction (a
+   handle, a FastTransfer or synchronization context) keeps the whole
+   pool chunk allocated until that object is released, hence the upper
+   bound on the pool size. The stream buffers of ftcontext and
+   synccontext objects (ndr->data in oxcfxics.c) are referenced by the
+   context, so they are pushed on NULL-rooted contexts and never carved
+   out of the pool.
+
+   \return Allocated memory context on success, otherwise NULL
+ */
+_PUBLIC_ TALLOC_CTX *emsmdbp_request_pool_init(struct emsmdbp_context *emsmdbp_ctx, TALLOC_CTX *mem_ctx)
+{
+	TALLOC_CTX	*pool_ctx;
+
+	/* Sanity checks */
+	if (!emsmdbp_ctx) return NULL;
+
+	pool_ctx = talloc_pool(mem_ctx, emsmdbp_ctx->request_stats.pool_size);
+	if (!pool_ctx) {
+		DEBUG(5, ("[%s:%d]: unable to allocate a %zu bytes pool\n", __FUNCTION__, __LINE__,
+			  emsmdbp_ctx->request_stats.pool_size));
+		return talloc_new(mem_ctx);
+	}
+	talloc_set_name_const(pool_ctx, "emsmdbp_request_pool");
+
+	return pool_ctx;
+}
+
+
+/**
+   \details Account for a processed EcDoRpc transaction and size the
+   pool of the next one
+
+   The size used by the transaction is measured on what is left in
+   the pool once the ROP handlers have run, which is essentially the
+   response. The next pool is sized to twice the running average of
+   this value. Blocks freed by the handlers are not counted: the
+   retained_blocks statistic is the number of blocks still in the pool
+   at that point, not the number of allocations made.
+
+   \param emsmdbp_ctx pointer to the EMSMDBP context
+   \param pool_ctx pointer to the context returned by
+   emsmdbp_request_pool_init
+ */
+_PUBLIC_ void emsmdbp_request_pool_account(struct emsmdbp_context *emsmdbp_ctx, TALLOC_CTX *pool_ctx)
+{
+	struct emsmdbp_request_stats	*stats;
+	size_t				used;
+	size_t				retained;
+
+	/* Sanity checks */
+	if (!emsmdbp_ctx || !pool_ctx) return;
+
+	stats = &emsmdbp_ctx->request_stats;
+
+	used = talloc_total_size(pool_ctx);
+	retained = talloc_total_blocks(pool_ctx) - 1;
+
+	stats->requests++;
+	stats->retained_blocks += retained;
+	if (used > stats->pool_size) {
+		stats->overflows++;
+	}
+
+	if (stats->requests == 1) {
+		stats->average_size = used;
+	}
+	else {
+		stats->average_size = (stats->average_size * 7 + used) / 8;
+	}
+
+	stats->pool_size = stats->average_size * 2;
+	if (stats->pool_size < EMSMDBP_REQUEST_POOL_MIN) {
+		stats->pool_size = EMSMDBP_REQUEST_POOL_MIN;
+	}
+	else if (stats->pool_size > EMSMDBP_REQUEST_POOL_MAX) {
+		stats->pool_size = EMSMDBP_REQUEST_POOL_MAX;
+	}
+
+	DEBUG(5, ("[%s:%d]: %zu bytes in %zu blocks, %"PRIu64" requests, %"PRIu64" retained blocks, %"PRIu64" overflows, next pool %zu bytes\n",
+		  __FUNCTION__, __LINE__, used, retained, stats->requests, stats->retained_blocks,
+		  stats->overflows, stats->pool_size));
+}
+
+
 /**
    \details Check if the authenticated user belongs to the Exchange
    organization and is enabled
@@ -527,3 +685,241 @@ _PUBLIC_ int emsmdbp_source_key_from_fmid(TALLOC_CTX *mem_ctx, struct emsmdbp_co
 
 	return MAPISTORE_SUCCESS;
 }
+
+/* Members of each property group, matched on the property ID only */
+static const enum MAPITAGS emsmdbp_property_group_status[] = {
+	PidTagMessageFlags,
+	PidTagMessageStatus,
+	PidTagFlagStatus,
+	PidTagFlagCompleteTime,
+	PidTagFollowupIcon,
+	PidTagIconIndex,
+	PidTagLastVerbExecuted,
+	PidTagLastVerbExecutionTime,
+	PidTagToDoItemFlags
+};
+
+static const enum MAPITAGS emsmdbp_property_group_body[] = {
+	PidTagBody,
+	PidTagBodyHtml,
+	PidTagRtfCompressed,
+	PidTagRtfInSync,
+	PidTagNativeBody
+};
+
+static const enum MAPITAGS emsmdbp_property_group_recipients[] = {
+	PidTagMessageRecipients
+};
+
+static const enum MAPITAGS emsmdbp_property_group_attachments[] = {
+	PidTagMessageAttachments,
+	PidTagHasAttachments
+};
+
+static const struct {
+	const enum MAPITAGS	*tags;
+	uint32_t		count;
+} emsmdbp_property_groups[EMSMDBP_PROPERTY_GROUP_COUNT] = {
+	{ emsmdbp_property_group_status, sizeof (emsmdbp_property_group_status) / sizeof (enum MAPITAGS) },
+	{ emsmdbp_property_group_body, sizeof (emsmdbp_property_group_body) / sizeof (enum MAPITAGS) },
+	{ emsmdbp_property_group_recipients, sizeof (emsmdbp_property_group_recipients) / sizeof (enum MAPITAGS) },
+	{ emsmdbp_property_group_attachments, sizeof (emsmdbp_property_group_attachments) / sizeof (enum MAPITAGS) },
+	{ NULL, 0 }
+};
+
+/**
+   \details Return the property group a message property belongs to
+
+   \param proptag the property tag to look up
+
+   \return the property group, EMSMDBP_PROPERTY_GROUP_OTHER for
+   properties not listed in any group
+ */
+_PUBLIC_ enum emsmdbp_property_group emsmdbp_property_group(enum MAPITAGS proptag)
+{
+	uint32_t	i, j;
+
+	for (i = 0; i < EMSMDBP_PROPERTY_GROUP_COUNT; i++) {
+		for (j = 0; j < emsmdbp_property_groups[i].count; j++) {
+			if ((emsmdbp_property_groups[i].tags[j] >> 16) == (proptag >> 16)) {
+				return (enum emsmdbp_property_group) i;
+			}
+		}
+	}
+
+	return EMSMDBP_PROPERTY_GROUP_OTHER;
+}
+
+/**
+   \details Return the properties listed in a property group
+
+   \param group the property group
+   \param countp pointer to the returned number of properties
+
+   \return array of property tags, NULL for EMSMDBP_PROPERTY_GROUP_OTHER
+ */
+_PUBLIC_ const enum MAPITAGS *emsmdbp_property_group_tags(enum emsmdbp_property_group group, uint32_t *countp)
+{
+	if (group >= EMSMDBP_PROPERTY_GROUP_COUNT) {
+		*countp = 0;
+		return NULL;
+	}
+
+	*countp = emsmdbp_property_groups[group].count;
+
+	return emsmdbp_property_groups[group].tags;
+}
+
+/**
+   \details Save a message imported with RopSyncImportMessageChange
+
+   The message joins the import batch of its folder. When the backend
+   can save several messages at once, the save itself is deferred to
+   emsmdbp_import_batch_flush, otherwise the message is saved right
+   away. In both cases its indexing record is written now, so that the
+   following ROPs of the request resolve its MID, and its property
+   groups are written when the batch is flushed. The reply of the
+   current ROP is recorded, to report a deferred save which fails.
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param message_object pointer to the imported message object
+   \param mem_ctx pointer to the memory context
+
+   \return MAPISTORE_SUCCESS on success, otherwise MAPISTORE error
+ */
+_PUBLIC_ enum mapistore_error emsmdbp_import_batch_save(struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *message_object, TALLOC_CTX *mem_ctx)
+{
+	struct emsmdbp_import_batch	*batch;
+	struct emsmdbp_object		*folder_object;
+	uint32_t			contextID;
+	char				*owner;
+	bool				deferred;
+	enum mapistore_error		ret;
+
+	/* Sanity checks */
+	if (!emsmdbp_ctx) return MAPISTORE_ERROR;
+	if (!message_object || message_object->type != EMSMDBP_OBJECT_MESSAGE) return MAPISTORE_ERROR;
+
+	folder_object = message_object->parent_object;
+	if (!folder_object || folder_object->type != EMSMDBP_OBJECT_FOLDER) return MAPISTORE_ERROR;
+
+	contextID = emsmdbp_get_contextID(message_object);
+	deferred = mapistore_folder_can_save_messages(emsmdbp_ctx->mstore_ctx, contextID);
+	if (!deferred) {
+		ret = mapistore_message_save(emsmdbp_ctx->mstore_ctx, contextID, message_object->backend_object, mem_ctx);
+		emsmdbp_object_message_invalidate_properties(message_object);
+		emsmdbp_object_message_forget(emsmdbp_ctx, message_object->object.message->messageID);
+		if (ret != MAPISTORE_SUCCESS) return ret;
+	}
+
+	owner = emsmdbp_get_owner(message_object);
+	mapistore_indexing_record_add_mid(emsmdbp_ctx->mstore_ctx, contextID, owner, message_object->object.message->messageID);
+
+	for (batch = emsmdbp_ctx->import_batches; batch; batch = batch->next) {
+		if (batch->folder_object == folder_object) break;
+	}
+	if (!batch) {
+		batch = talloc_zero(emsmdbp_ctx, struct emsmdbp_import_batch);
+		batch->folder_object = folder_object;
+		DLIST_ADD_END(emsmdbp_ctx->import_batches, batch, struct emsmdbp_import_batch *);
+	}
+
+	/* the message must survive the release of its handle until the batch is flushed */
+	batch->messages = talloc_realloc(batch, batch->messages, struct emsmdbp_object *, batch->count + 1);
+	batch->deferred = talloc_realloc(batch, batch->deferred, bool, batch->count + 1);
+	batch->repl_idx = talloc_realloc(batch, batch->repl_idx, uint32_t, batch->count + 1);
+	batch->messages[batch->count] = message_object;
+	batch->deferred[batch->count] = deferred;
+	batch->repl_idx[batch->count] = emsmdbp_ctx->rop_repl_idx;
+	(void) talloc_reference(batch, message_object);
+	batch->count++;
+
+	return MAPISTORE_SUCCESS;
+}
+
+/**
+   \details Commit the messages imported during the current request
+
+   Deferred saves are handed to the backend in one call per folder,
+   then the property group change numbers of every imported message
+   are written in a single transaction. A message whose deferred save
+   fails loses its indexing record, and the reply of its
+   RopSaveChangesMessage is turned into an error.
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_repl pointer to the replies of the request
+   \param size pointer to the mapi_response size to update
+ */
+_PUBLIC_ void emsmdbp_import_batch_flush(struct emsmdbp_context *emsmdbp_ctx, struct EcDoRpc_MAPI_REPL *mapi_repl, uint16_t *size)
+{
+	TALLOC_CTX			*mem_ctx;
+	struct emsmdbp_import_batch	*batch;
+	struct emsmdbp_object		*message_object;
+	struct EcDoRpc_MAPI_REPL	*reply;
+	void				**backend_objects;
+	bool				*saved;
+	uint32_t			i, count, contextID;
+	char				*owner;
+	enum mapistore_error		ret;
+
+	if (!emsmdbp_ctx) return;
+
+	while ((batch = emsmdbp_ctx->import_batches)) {
+		mem_ctx = talloc_new(NULL);
+		contextID = emsmdbp_get_contextID(batch->folder_object);
+		owner = emsmdbp_get_owner(batch->folder_object);
+
+		/* Step 1. Hand the deferred saves to the backend */
+		saved = talloc_array(mem_ctx, bool, batch->count);
+		backend_objects = talloc_array(mem_ctx, void *, batch->count);
+		for (i = 0, count = 0; i < batch->count; i++) {
+			saved[i] = !batch->deferred[i];
+			if (batch->deferred[i]) {
+				backend_objects[count++] = batch->messages[i]->backend_object;
+			}
+		}
+		if (count) {
+			ret = mapistore_folder_save_messages(emsmdbp_ctx->mstore_ctx, contextID, batch->folder_object->backend_object, mem_ctx, count, backend_objects);
+			for (i = 0; i < batch->count; i++) {
+				if (!batch->deferred[i]) continue;
+
+				message_object = batch->messages[i];
+				if (ret == MAPISTORE_SUCCESS) {
+					saved[i] = true;
+				}
+				else if (mapistore_message_save(emsmdbp_ctx->mstore_ctx, contextID, message_object->backend_object, mem_ctx) == MAPISTORE_SUCCESS) {
+					saved[i] = true;
+				}
+				else {
+					DEBUG(1, ("[%s:%d]: imported message 0x%.16"PRIx64" could not be saved\n", __FUNCTION__, __LINE__,
+						  message_object->object.message->messageID));
+					mapistore_indexing_record_del_mid(emsmdbp_ctx->mstore_ctx, contextID, owner,
+									  message_object->object.message->messageID,
+									  MAPISTORE_PERMANENT_DELETE);
+					reply = mapi_repl ? &mapi_repl[batch->repl_idx[i]] : NULL;
+					if (reply && size && reply->opnum == op_MAPI_SaveChangesMessage && !reply->error_code) {
+						*size -= libmapiserver_RopSaveChangesMessage_size(reply);
+						reply->error_code = MAPI_E_CALL_FAILED;
+						*size += libmapiserver_RopSaveChangesMessage_size(reply);
+					}
+				}
+				emsmdbp_object_message_invalidate_properties(message_object);
+				emsmdbp_object_message_forget(emsmdbp_ctx, message_object->object.message->messageID);
+			}
+		}
+		DEBUG(5, ("[%s:%d]: %d imported messages, %d saved in bulk\n", __FUNCTION__, __LINE__, batch->count, count));
+
+		/* Step 2. Record the property groups written by the client, in one transaction */
+		mapistore_indexing_transaction_start(emsmdbp_ctx->mstore_ctx, owner);
+		for (i = 0; i < batch->count; i++) {
+			if (saved[i]) {
+				emsmdbp_object_message_commit_groups(emsmdbp_ctx, batch->messages[i]);
+			}
+		}
+		mapistore_indexing_transaction_commit(emsmdbp_ctx->mstore_ctx, owner);
+
+		DLIST_REMOVE(emsmdbp_ctx->import_batches, batch);
+		talloc_free(batch);
+		talloc_free(mem_ctx);
+	}
+}
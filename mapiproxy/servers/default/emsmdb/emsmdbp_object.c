@@ -897,6 +897,7 @@ static inline int emsmdbp_copy_message_recipients_mapistore(struct emsmdbp_conte
 
 		/* Copy data into dest message */
 		mapistore_message_modify_recipients(emsmdbp_ctx->mstore_ctx, contextID, dest_object->backend_object, msg_data->columns, msg_data->recipients_count, msg_data->recipients);
+		emsmdbp_object_message_touch_groups(dest_object, (1 << EMSMDBP_PROPERTY_GROUP_RECIPIENTS));
 	}
 
 	talloc_free(mem_ctx);
@@ -967,6 +968,7 @@ static inline int emsmdbp_copy_message_attachments_mapistore(struct emsmdbp_cont
 			talloc_free(mem_ctx);
 			return MAPISTORE_ERROR;
 		}
+		emsmdbp_object_message_touch_groups(dest_object, (1 << EMSMDBP_PROPERTY_GROUP_ATTACHMENTS));
 
 		ret = emsmdbp_copy_properties(emsmdbp_ctx, source_attach, dest_attach, NULL);
 		if (ret != MAPI_E_SUCCESS) {
@@ -1464,6 +1466,9 @@ _PUBLIC_ struct emsmdbp_object *emsmdbp_object_table_init(TALLOC_CTX *mem_ctx,
 	object->object.table->ulType = 0;
 	object->object.table->restricted = false;
 	object->object.table->subscription_list = NULL;
+	object->object.table->bookmark_count = 0;
+	object->object.table->bookmarks = NULL;
+	object->object.table->bookmark_generation = 0;
 
 	return object;
 }
@@ -1747,51 +1752,344 @@ _PUBLIC_ void **emsmdbp_object_table_get_row_props(TALLOC_CTX *mem_ctx, struct e
         return data_pointers;
 }
 
+/**
+   \details Set the columns read by emsmdbp_object_table_row_identity
+   on a mapistore table, or restore the columns of the client
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param table_object pointer to the table object
+   \param identity whether the identity columns should be set
+ */
+static void emsmdbp_object_table_identity_columns(struct emsmdbp_context *emsmdbp_ctx,
+						  struct emsmdbp_object *table_object, bool identity)
+{
+	enum MAPITAGS	columns[] = { PidTagInstID, PidTagInstanceNum };
+	uint32_t	contextID;
+
+	if (!emsmdbp_is_mapistore(table_object)) return;
+
+	contextID = emsmdbp_get_contextID(table_object);
+	if (identity) {
+		mapistore_table_set_columns(emsmdbp_ctx->mstore_ctx, contextID, table_object->backend_object, 2, columns);
+	}
+	else {
+		mapistore_table_set_columns(emsmdbp_ctx->mstore_ctx, contextID, table_object->backend_object,
+					    table_object->object.table->prop_count, table_object->object.table->properties);
+	}
+}
+
+/**
+   \details Read the identity of a table row: its instance identifier
+   (PidTagInstID) and instance number (PidTagInstanceNum)
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param table_object pointer to the table object
+   \param position position of the row
+   \param inst_idp pointer to the instance identifier to return
+   \param inst_nump pointer to the instance number to return
+
+   \note On mapistore tables, the identity columns must have been set
+   with emsmdbp_object_table_identity_columns.
+
+   \return true on success, otherwise false
+ */
+static bool emsmdbp_object_table_row_identity(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx,
+					      struct emsmdbp_object *table_object, uint32_t position,
+					      uint64_t *inst_idp, uint32_t *inst_nump)
+{
+	struct mapistore_property_data	*row;
+	void				*inst_id;
+
+	/* openchangedb rows have a single instance */
+	if (!emsmdbp_is_mapistore(table_object)) {
+		if (openchangedb_table_get_property(mem_ctx, table_object->backend_object, emsmdbp_ctx->oc_ctx,
+						    PR_INST_ID, position, false, &inst_id) != MAPI_E_SUCCESS) {
+			return false;
+		}
+		*inst_idp = *(uint64_t *) inst_id;
+		*inst_nump = 0;
+		return true;
+	}
+
+	if (mapistore_table_get_row(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(table_object), table_object->backend_object,
+				    mem_ctx, MAPISTORE_PREFILTERED_QUERY, position, &row) != MAPISTORE_SUCCESS
+	    || row[0].error || !row[0].data) {
+		return false;
+	}
+
+	*inst_idp = *(uint64_t *) row[0].data;
+	*inst_nump = (row[1].error || !row[1].data) ? 0 : *(uint32_t *) row[1].data;
+
+	return true;
+}
+
+static bool emsmdbp_object_table_bookmark_matches(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx,
+						  struct emsmdbp_object *table_object, uint32_t position,
+						  struct emsmdbp_table_bookmark *bookmark)
+{
+	uint64_t	inst_id;
+	uint32_t	inst_num;
+
+	return (emsmdbp_object_table_row_identity(mem_ctx, emsmdbp_ctx, table_object, position, &inst_id, &inst_num)
+		&& inst_id == bookmark->inst_id && inst_num == bookmark->inst_num);
+}
+
+/**
+   \details Record a bookmark on a row of a table
+
+   Freed bookmark records are reused, so the bookmark array does not
+   grow with clients creating and freeing bookmarks while they browse
+   the table. The identity of the row is kept with its position, to
+   find the row again once it moved. The bookmark sent to the client
+   holds the index of the record and its generation, so a bookmark
+   whose record was freed or reused is not mistaken for another one.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param table_object pointer to the table object
+   \param position position of the bookmarked row
+   \param bookmark pointer to the bookmark to return to the client
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS emsmdbp_object_table_create_bookmark(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx,
+							      struct emsmdbp_object *table_object, uint32_t position,
+							      struct SBinary_short *bookmark)
+{
+	struct emsmdbp_object_table	*table;
+	struct emsmdbp_table_bookmark	*bookmarks;
+	struct emsmdbp_table_bookmark	*record;
+	TALLOC_CTX			*local_mem_ctx;
+	uint32_t			i;
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!table_object || table_object->type != EMSMDBP_OBJECT_TABLE, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!bookmark, MAPI_E_INVALID_PARAMETER, NULL);
+
+	table = table_object->object.table;
+	for (i = 0; i < table->bookmark_count; i++) {
+		if (!table->bookmarks[i].used) break;
+	}
+	if (i == table->bookmark_count) {
+		bookmarks = talloc_realloc(table, table->bookmarks, struct emsmdbp_table_bookmark, table->bookmark_count + 1);
+		OPENCHANGE_RETVAL_IF(!bookmarks, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+		table->bookmarks = bookmarks;
+		table->bookmark_count++;
+	}
+
+	bookmark->lpb = talloc_array(mem_ctx, uint8_t, EMSMDBP_BOOKMARK_SIZE);
+	OPENCHANGE_RETVAL_IF(!bookmark->lpb, MAPI_E_NOT_ENOUGH_MEMORY, NULL);
+
+	record = &table->bookmarks[i];
+	record->used = true;
+	record->visible = true;
+	record->position = position;
+	record->generation = ++table->bookmark_generation;
+
+	/* A bookmark past the last row has no identity */
+	local_mem_ctx = talloc_new(NULL);
+	emsmdbp_object_table_identity_columns(emsmdbp_ctx, table_object, true);
+	record->identified = (position < table->denominator)
+		&& emsmdbp_object_table_row_identity(local_mem_ctx, emsmdbp_ctx, table_object, position,
+						     &record->inst_id, &record->inst_num);
+	emsmdbp_object_table_identity_columns(emsmdbp_ctx, table_object, false);
+	talloc_free(local_mem_ctx);
+
+	bookmark->cb = EMSMDBP_BOOKMARK_SIZE;
+	bookmark->lpb[0] = i & 0xFF;
+	bookmark->lpb[1] = (i >> 8) & 0xFF;
+	bookmark->lpb[2] = (i >> 16) & 0xFF;
+	bookmark->lpb[3] = (i >> 24) & 0xFF;
+	bookmark->lpb[4] = record->generation & 0xFF;
+	bookmark->lpb[5] = (record->generation >> 8) & 0xFF;
+	bookmark->lpb[6] = (record->generation >> 16) & 0xFF;
+	bookmark->lpb[7] = (record->generation >> 24) & 0xFF;
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details Find the row recorded by a bookmark
+
+   The row is first checked at the position recorded by the bookmark.
+   When another row is found there, the row is looked up around that
+   position, closest rows first, and the bookmark follows it.
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param table_object pointer to the table object
+   \param bookmark pointer to the bookmark record
+   \param positionp pointer to the position to return
+
+   \return true if the row is still visible, otherwise false and
+   positionp is set to the position recorded by the bookmark
+ */
+_PUBLIC_ bool emsmdbp_object_table_seek_bookmark(struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *table_object,
+						 struct emsmdbp_table_bookmark *bookmark, uint32_t *positionp)
+{
+	struct emsmdbp_object_table	*table = table_object->object.table;
+	TALLOC_CTX			*batch_ctx;
+	int64_t				origin, distance, position = -1;
+	uint32_t			checked;
+
+	*positionp = bookmark->position;
+	if (!bookmark->visible || !bookmark->identified) {
+		return (bookmark->visible && bookmark->position < table->denominator);
+	}
+
+	/* The identity columns are set for the whole lookup */
+	emsmdbp_object_table_identity_columns(emsmdbp_ctx, table_object, true);
+
+	/* Step 1. The row did not move */
+	origin = (bookmark->position < table->denominator) ? bookmark->position : (int64_t) table->denominator - 1;
+	batch_ctx = talloc_new(NULL);
+	if (origin >= 0 && emsmdbp_object_table_bookmark_matches(batch_ctx, emsmdbp_ctx, table_object, origin, bookmark)) {
+		position = origin;
+	}
+	talloc_free(batch_ctx);
+
+	/* Step 2. Look the row up on both sides of its last position,
+	   in batches of rows released together */
+	for (distance = 1; position < 0 && (origin - distance >= 0 || origin + distance < table->denominator); ) {
+		batch_ctx = talloc_new(NULL);
+		for (checked = 0; checked < EMSMDBP_FINDROW_BATCH_SIZE && position < 0; distance++) {
+			if (origin - distance < 0 && origin + distance >= table->denominator) break;
+			if (origin + distance < table->denominator) {
+				checked++;
+				if (emsmdbp_object_table_bookmark_matches(batch_ctx, emsmdbp_ctx, table_object, origin + distance, bookmark)) {
+					position = origin + distance;
+					break;
+				}
+			}
+			if (origin - distance >= 0) {
+				checked++;
+				if (emsmdbp_object_table_bookmark_matches(batch_ctx, emsmdbp_ctx, table_object, origin - distance, bookmark)) {
+					position = origin - distance;
+					break;
+				}
+			}
+		}
+		talloc_free(batch_ctx);
+	}
+
+	emsmdbp_object_table_identity_columns(emsmdbp_ctx, table_object, false);
+
+	if (position < 0) {
+		DEBUG(5, ("[%s:%d]: bookmarked row 0x%"PRIx64"/%u no longer visible\n", __FUNCTION__, __LINE__,
+			  bookmark->inst_id, bookmark->inst_num));
+		return false;
+	}
+
+	bookmark->position = position;
+	*positionp = position;
+
+	return true;
+}
+
+/**
+   \details Retrieve the record of a bookmark returned by
+   RopCreateBookmark
+
+   \param table pointer to the table object
+   \param bookmark pointer to the bookmark sent by the client
+
+   \return pointer to the bookmark record on success, otherwise NULL
+   if the bookmark is malformed, freed or was created before the
+   bookmarks were reset
+ */
+_PUBLIC_ struct emsmdbp_table_bookmark *emsmdbp_object_table_get_bookmark(struct emsmdbp_object_table *table, struct SBinary_short *bookmark)
+{
+	uint32_t	idx, generation;
+
+	if (!table || !bookmark || bookmark->cb != EMSMDBP_BOOKMARK_SIZE) {
+		return NULL;
+	}
+
+	idx = bookmark->lpb[0] | (bookmark->lpb[1] << 8) | (bookmark->lpb[2] << 16) | ((uint32_t) bookmark->lpb[3] << 24);
+	generation = bookmark->lpb[4] | (bookmark->lpb[5] << 8) | (bookmark->lpb[6] << 16) | ((uint32_t) bookmark->lpb[7] << 24);
+	if (idx >= table->bookmark_count || !table->bookmarks[idx].used
+	    || table->bookmarks[idx].generation != generation) {
+		return NULL;
+	}
+
+	return &table->bookmarks[idx];
+}
+
+/**
+   \details Update the bookmarks of a table after the rows following a
+   category header row were shown or hidden by RopExpandRow or
+   RopCollapseRow
+
+   Bookmarks hidden with the category become visible again when it is
+   expanded. They point to the first row of the category, the row is
+   looked up by its identity on the next seek.
+
+   \param table pointer to the table object
+   \param position position of the category header row
+   \param count number of rows shown or hidden
+   \param hidden whether the rows were hidden
+ */
+_PUBLIC_ void emsmdbp_object_table_shift_bookmarks(struct emsmdbp_object_table *table, uint32_t position, uint32_t count, bool hidden)
+{
+	struct emsmdbp_table_bookmark	*bookmark;
+	uint32_t			i;
+
+	for (i = 0; i < table->bookmark_count; i++) {
+		bookmark = &table->bookmarks[i];
+		if (!bookmark->used || bookmark->position <= position) continue;
+
+		if (!hidden) {
+			if (!bookmark->visible && bookmark->position == position + 1) {
+				bookmark->visible = true;
+			}
+			else {
+				bookmark->position += count;
+			}
+		}
+		else if (bookmark->position > position + count) {
+			bookmark->position -= count;
+		}
+		else {
+			/* The row is gone: seeks resume on the row following
+			   the category */
+			bookmark->position = position + 1;
+			bookmark->visible = false;
+		}
+	}
+}
+
+/**
+   \details Invalidate the bookmarks of a table, once the rows were
+   sorted or restricted again
+
+   \param table pointer to the table object
+ */
+_PUBLIC_ void emsmdbp_object_table_reset_bookmarks(struct emsmdbp_object_table *table)
+{
+	talloc_free(table->bookmarks);
+	table->bookmarks = NULL;
+	table->bookmark_count = 0;
+}
+
 _PUBLIC_ void emsmdbp_fill_table_row_blob(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx,
 					  DATA_BLOB *table_row, uint16_t num_props,
 					  enum MAPITAGS *properties,
 					  void **data_pointers, enum MAPISTATUS *retvals)
 {
-        uint16_t i;
-        uint8_t flagged;
-        enum MAPITAGS property;
-        void *data;
-        uint32_t retval;
-
-        flagged = 0;
-
-        for (i = 0; !flagged && i < num_props; i++) {
-                if (retvals[i] != MAPI_E_SUCCESS) {
-                        flagged = 1;
-                }
-        }
+	struct ndr_push	*ndr;
 
-        if (flagged) {
-                libmapiserver_push_property(mem_ctx,
-                                            0x0000000b, (const void *)&flagged,
-                                            table_row, 0, 0, 0);
-        }
-        else {
-                libmapiserver_push_property(mem_ctx,
-                                            0x00000000, (const void *)&flagged,
-                                            table_row, 0, 1, 0);
-        }
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	if (table_row->length) {
+		ndr_push_bytes(ndr, table_row->data, table_row->length);
+	}
 
-        for (i = 0; i < num_props; i++) {
-                property = properties[i];
-                retval = retvals[i];
-                if (retval != MAPI_E_SUCCESS) {
-                        property = (property & 0xFFFF0000) + PT_ERROR;
-                        data = &retval;
-                }
-                else {
-                        data = data_pointers[i];
-                }
+	libmapiserver_push_PropertyRow(ndr, num_props, properties, data_pointers, retvals);
 
-                libmapiserver_push_property(mem_ctx,
-                                            property, data, table_row,
-                                            flagged?PT_ERROR:0, flagged, 0);
-        }
+	table_row->data = talloc_steal(mem_ctx, ndr->data);
+	table_row->length = ndr->offset;
+	talloc_free(ndr);
 }
 
 /**
@@ -1962,6 +2260,138 @@ end:
 	return;
 }
 
+static void emsmdbp_open_message_unlist(struct emsmdbp_open_message *open_message)
+{
+	if (open_message->listed) {
+		DLIST_REMOVE(open_message->emsmdbp_ctx->open_messages, open_message);
+		open_message->listed = false;
+	}
+}
+
+static int emsmdbp_open_message_destructor(void *data)
+{
+	struct emsmdbp_open_message	*open_message = (struct emsmdbp_open_message *) data;
+
+	emsmdbp_open_message_unlist(open_message);
+	if (open_message->folder_object) {
+		talloc_unlink(open_message, open_message->folder_object);
+		open_message->folder_object = NULL;
+	}
+
+	return 0;
+}
+
+static struct emsmdbp_open_message *emsmdbp_open_message_lookup(struct emsmdbp_context *emsmdbp_ctx, uint64_t folderID, uint64_t messageID)
+{
+	struct emsmdbp_open_message	*open_message, *next;
+	time_t				now;
+
+	now = time(NULL);
+	for (open_message = emsmdbp_ctx->open_messages; open_message; open_message = next) {
+		next = open_message->next;
+		if (now - open_message->opened > EMSMDBP_OPEN_MESSAGE_TTL) {
+			/* still used by its handles, but no longer shared */
+			emsmdbp_open_message_unlist(open_message);
+			continue;
+		}
+		if (open_message->folderID == folderID && open_message->messageID == messageID) {
+			return open_message;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+   \details Stop sharing the backend object of a read-only message
+
+   Handles that already hold the message keep using it, the next
+   read-only open asks the backend again. Must be called whenever the
+   message is saved, moved or deleted.
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param messageID the message identifier, or 0 to forget every message
+ */
+_PUBLIC_ void emsmdbp_object_message_forget(struct emsmdbp_context *emsmdbp_ctx, uint64_t messageID)
+{
+	struct emsmdbp_open_message	*open_message, *next;
+
+	if (!emsmdbp_ctx) return;
+
+	for (open_message = emsmdbp_ctx->open_messages; open_message; open_message = next) {
+		next = open_message->next;
+		if (!messageID || open_message->messageID == messageID) {
+			emsmdbp_open_message_unlist(open_message);
+		}
+	}
+}
+
+static enum mapistore_error emsmdbp_object_message_open_shared(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *folder_object, uint64_t folderID, uint64_t messageID, struct emsmdbp_object **messageP, struct mapistore_message **msgp)
+{
+	struct emsmdbp_object		*message_object;
+	struct emsmdbp_open_message	*open_message;
+	uint32_t			contextID;
+	enum mapistore_error		ret;
+
+	message_object = emsmdbp_object_message_init(mem_ctx, emsmdbp_ctx, messageID, folder_object);
+	if (!message_object) return MAPISTORE_ERR_NO_MEMORY;
+
+	contextID = emsmdbp_get_contextID(folder_object);
+	open_message = emsmdbp_open_message_lookup(emsmdbp_ctx, folderID, messageID);
+	if (open_message) {
+		DEBUG(5, ("[%s:%d]: sharing open message 0x%.16"PRIx64"\n", __FUNCTION__, __LINE__, messageID));
+		(void) talloc_reference(message_object, open_message);
+	}
+	else {
+		open_message = talloc_zero(message_object, struct emsmdbp_open_message);
+		if (!open_message) {
+			talloc_free(message_object);
+			return MAPISTORE_ERR_NO_MEMORY;
+		}
+		/* The backend message may outlive the handle that opened
+		   it, keep the folder it was opened from alive as long */
+		open_message->folder_object = talloc_reference(open_message, folder_object);
+		if (!open_message->folder_object) {
+			talloc_free(message_object);
+			return MAPISTORE_ERR_NO_MEMORY;
+		}
+		talloc_set_destructor((void *)open_message, (int (*)(void *))emsmdbp_open_message_destructor);
+		ret = mapistore_folder_open_message(emsmdbp_ctx->mstore_ctx, contextID, folder_object->backend_object, open_message, messageID, false, &open_message->backend_object);
+		if (ret != MAPISTORE_SUCCESS) {
+			talloc_free(message_object);
+			return ret;
+		}
+		open_message->emsmdbp_ctx = emsmdbp_ctx;
+		open_message->folderID = folderID;
+		open_message->messageID = messageID;
+		open_message->opened = time(NULL);
+		DLIST_ADD(emsmdbp_ctx->open_messages, open_message);
+		open_message->listed = true;
+	}
+	message_object->backend_object = open_message->backend_object;
+	message_object->object.message->open_message = open_message;
+	message_object->object.message->cache_generation = open_message->cache_generation;
+
+	if (msgp) {
+		if (!open_message->msg) {
+			ret = mapistore_message_get_message_data(emsmdbp_ctx->mstore_ctx, contextID, open_message->backend_object, open_message, &open_message->msg);
+			if (ret != MAPISTORE_SUCCESS) {
+				open_message->msg = NULL;
+				talloc_free(message_object);
+				return MAPISTORE_ERROR;
+			}
+		}
+		*msgp = open_message->msg;
+		if (mem_ctx) {
+			(void) talloc_reference(mem_ctx, open_message->msg);
+		}
+	}
+
+	*messageP = message_object;
+
+	return MAPISTORE_SUCCESS;
+}
+
 _PUBLIC_ enum mapistore_error emsmdbp_object_message_open(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *parent_object, uint64_t folderID, uint64_t messageID, bool read_write, struct emsmdbp_object **messageP, struct mapistore_message **msgp)
 {
 	struct emsmdbp_object *folder_object, *message_object = NULL;
@@ -1994,7 +2424,11 @@ _PUBLIC_ enum mapistore_error emsmdbp_object_message_open(TALLOC_CTX *mem_ctx, s
 		emsmdbp_object_message_fill_freebusy_properties(message_object);
 		break;
 	case true:
-		/* mapistore implementation goes here */
+		if (!read_write) {
+			ret = emsmdbp_object_message_open_shared(mem_ctx, emsmdbp_ctx, folder_object, folderID, messageID, &message_object, msgp);
+			break;
+		}
+		/* read-write opens get their own backend object */
 		message_object = emsmdbp_object_message_init(mem_ctx, emsmdbp_ctx, messageID, folder_object);
 		contextID = emsmdbp_get_contextID(folder_object);
 		ret = mapistore_folder_open_message(emsmdbp_ctx->mstore_ctx, contextID, folder_object->backend_object, message_object, messageID, read_write, &message_object->backend_object);
@@ -2480,39 +2914,234 @@ static int emsmdbp_object_get_properties_mailbox(TALLOC_CTX *mem_ctx, struct ems
 	return MAPISTORE_SUCCESS;
 }
 
+static struct emsmdbp_property_cache_entry *emsmdbp_property_cache_lookup(struct emsmdbp_property_cache *cache, enum MAPITAGS proptag)
+{
+	uint32_t	i;
+
+	for (i = 0; i < cache->count; i++) {
+		if (cache->entries[i].proptag == proptag) {
+			return cache->entries + i;
+		}
+	}
+
+	return NULL;
+}
+
+static void emsmdbp_property_cache_add(struct emsmdbp_property_cache *cache, enum MAPITAGS proptag, enum MAPISTATUS retval, void *data)
+{
+	struct emsmdbp_property_cache_entry	*entry;
+	size_t					size = 0;
+
+	if (cache->count >= EMSMDBP_PROPERTY_CACHE_MAX_ENTRIES) return;
+
+	if (data) {
+		size = talloc_total_size(data);
+		if (size > EMSMDBP_PROPERTY_CACHE_MAX_VALUE || cache->size + size > EMSMDBP_PROPERTY_CACHE_MAX_SIZE) {
+			return;
+		}
+	}
+
+	if (!cache->entries) {
+		cache->entries = talloc_array(cache, struct emsmdbp_property_cache_entry, EMSMDBP_PROPERTY_CACHE_MAX_ENTRIES);
+		if (!cache->entries) return;
+	}
+
+	entry = cache->entries + cache->count;
+	entry->proptag = proptag;
+	entry->retval = retval;
+	entry->data = NULL;
+	if (data) {
+		if (!talloc_reference(cache, data)) return;
+		entry->data = data;
+	}
+	cache->size += size;
+	cache->count++;
+}
+
+/**
+   \details Drop the property values memoized on a message object
+
+   Must be called whenever the backend message may have changed: after
+   setting properties, modifying recipients, changing the read flag or
+   saving the message. When the backend message is shared with other
+   read-only handles, their caches are dropped too, on their next use.
+
+   \param object pointer to the message object
+ */
+_PUBLIC_ void emsmdbp_object_message_invalidate_properties(struct emsmdbp_object *object)
+{
+	struct emsmdbp_open_message	*open_message;
+
+	if (!object || object->type != EMSMDBP_OBJECT_MESSAGE) return;
+
+	open_message = object->object.message->open_message;
+	if (open_message) {
+		open_message->cache_generation++;
+		object->object.message->cache_generation = open_message->cache_generation;
+	}
+
+	if (object->object.message->property_cache) {
+		talloc_free(object->object.message->property_cache);
+		object->object.message->property_cache = NULL;
+	}
+}
+
+/**
+   \details Record property groups modified on a message
+
+   Changes made through an attachment or an embedded message are
+   charged to the attachments group of the message holding them. The
+   groups are written to the indexing database by
+   emsmdbp_object_message_commit_groups.
+
+   \param object pointer to the message or attachment object
+   \param groups bitmask of emsmdbp_property_group values
+ */
+_PUBLIC_ void emsmdbp_object_message_touch_groups(struct emsmdbp_object *object, uint32_t groups)
+{
+	while (object) {
+		if (object->type == EMSMDBP_OBJECT_MESSAGE) {
+			object->object.message->changed_groups |= groups;
+		}
+		else if (object->type != EMSMDBP_OBJECT_ATTACHMENT) {
+			break;
+		}
+		groups = (1 << EMSMDBP_PROPERTY_GROUP_ATTACHMENTS);
+		object = object->parent_object;
+	}
+}
+
+/**
+   \details Store the change number of the property groups modified on
+   a message since it was opened or last saved
+
+   When nothing was recorded, every group is assumed to have changed.
+
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param object pointer to the message object
+ */
+_PUBLIC_ void emsmdbp_object_message_commit_groups(struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *object)
+{
+	TALLOC_CTX		*mem_ctx;
+	struct SPropTagArray	properties;
+	enum MAPITAGS		cn_property = PidTagChangeNumber;
+	void			**data_pointers;
+	enum MAPISTATUS		*retvals = NULL;
+	uint32_t		groups;
+
+	if (!object || object->type != EMSMDBP_OBJECT_MESSAGE) return;
+	if (!emsmdbp_is_mapistore(object)) return;
+
+	groups = object->object.message->changed_groups;
+	if (!groups) {
+		groups = EMSMDBP_PROPERTY_GROUPS_ALL;
+	}
+
+	mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+	properties.cValues = 1;
+	properties.aulPropTag = &cn_property;
+	data_pointers = emsmdbp_object_get_properties(mem_ctx, emsmdbp_ctx, object, &properties, &retvals);
+	if (data_pointers && retvals[0] == MAPI_E_SUCCESS) {
+		mapistore_indexing_record_set_group_cns(emsmdbp_ctx->mstore_ctx, emsmdbp_get_owner(object),
+							object->object.message->messageID, EMSMDBP_PROPERTY_GROUP_COUNT,
+							groups, *(uint64_t *) data_pointers[0]);
+	}
+	else {
+		DEBUG(5, ("[%s:%d]: no change number for message 0x%.16"PRIx64"\n", __FUNCTION__, __LINE__,
+			  object->object.message->messageID));
+	}
+	talloc_free(mem_ctx);
+
+	object->object.message->changed_groups = 0;
+}
+
 static int emsmdbp_object_get_properties_mapistore(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object *object, struct SPropTagArray *properties, void **data_pointers, enum MAPISTATUS *retvals)
 {
 	uint32_t		contextID = -1;
 	struct mapistore_property_data  *prop_data;
-	int			i, ret;
+	struct emsmdbp_property_cache	*cache = NULL;
+	struct emsmdbp_property_cache_entry *entry;
+	enum MAPITAGS		*query_tags;
+	uint32_t		*query_index = NULL;
+	uint32_t		query_count;
+	int			i, j, ret;
+
+	query_tags = properties->aulPropTag;
+	query_count = properties->cValues;
+
+	/* Serve what we can from the values the backend already
+	   returned for this message and only ask for the rest */
+	if (object && object->type == EMSMDBP_OBJECT_MESSAGE) {
+		if (object->object.message->open_message
+		    && object->object.message->cache_generation != object->object.message->open_message->cache_generation) {
+			/* another handle sharing the backend message changed it */
+			talloc_free(object->object.message->property_cache);
+			object->object.message->property_cache = NULL;
+			object->object.message->cache_generation = object->object.message->open_message->cache_generation;
+		}
+		cache = object->object.message->property_cache;
+		if (!cache) {
+			cache = talloc_zero(object->object.message, struct emsmdbp_property_cache);
+			object->object.message->property_cache = cache;
+		}
+	}
+	if (cache) {
+		query_index = talloc_array(NULL, uint32_t, properties->cValues);
+		query_tags = talloc_array(query_index, enum MAPITAGS, properties->cValues);
+		query_count = 0;
+		for (i = 0; i < properties->cValues; i++) {
+			entry = emsmdbp_property_cache_lookup(cache, properties->aulPropTag[i]);
+			if (entry) {
+				retvals[i] = entry->retval;
+				if (entry->data) {
+					data_pointers[i] = entry->data;
+					(void) talloc_reference(data_pointers, entry->data);
+				}
+			}
+			else {
+				query_index[query_count] = i;
+				query_tags[query_count] = properties->aulPropTag[i];
+				query_count++;
+			}
+		}
+		if (!query_count) {
+			talloc_free(query_index);
+			return MAPISTORE_SUCCESS;
+		}
+	}
 
 	contextID = emsmdbp_get_contextID(object);
-	prop_data = talloc_array(NULL, struct mapistore_property_data, properties->cValues);
-	memset(prop_data, 0, sizeof(struct mapistore_property_data) * properties->cValues);
+	prop_data = talloc_array(NULL, struct mapistore_property_data, query_count);
+	memset(prop_data, 0, sizeof(struct mapistore_property_data) * query_count);
 
 	ret = mapistore_properties_get_properties(emsmdbp_ctx->mstore_ctx, contextID,
 						  object->backend_object,
 						  prop_data,
-						  properties->cValues,
-						  properties->aulPropTag,
+						  query_count,
+						  query_tags,
 						  prop_data);
 	if (ret == MAPISTORE_SUCCESS) {
-		for (i = 0; i < properties->cValues; i++) {
-			if (prop_data[i].error) {
-				retvals[i] = mapistore_error_to_mapi(prop_data[i].error);
+		for (j = 0; j < query_count; j++) {
+			i = query_index ? query_index[j] : j;
+			if (prop_data[j].error) {
+				retvals[i] = mapistore_error_to_mapi(prop_data[j].error);
 			}
 			else {
-				if (prop_data[i].data == NULL) {
+				if (prop_data[j].data == NULL) {
 					retvals[i] = MAPI_E_NOT_FOUND;
 				}
 				else {
-					data_pointers[i] = prop_data[i].data;
-					(void) talloc_reference(data_pointers, prop_data[i].data);
+					data_pointers[i] = prop_data[j].data;
+					(void) talloc_reference(data_pointers, prop_data[j].data);
 				}
 			}
+			if (cache) {
+				emsmdbp_property_cache_add(cache, query_tags[j], retvals[i], data_pointers[i]);
+			}
 		}
 	}
 	talloc_free(prop_data);
+	talloc_free(query_index);
 
 	return ret;
 }
@@ -2596,6 +3225,7 @@ _PUBLIC_ int emsmdbp_object_set_properties(struct emsmdbp_context *emsmdbp_ctx,
 	enum mapistore_error	ret;
 	struct SRow		*postponed_props;
 	bool			soft_deleted;
+	uint32_t		groups, i;
 
 	/* Sanity checks */
 	if (!emsmdbp_ctx) return MAPI_E_CALL_FAILED;
@@ -2688,6 +3318,14 @@ _PUBLIC_ int emsmdbp_object_set_properties(struct emsmdbp_context *emsmdbp_ctx,
 			break;
 		case true:
 			mapistore_properties_set_properties(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, rowp);
+			emsmdbp_object_message_invalidate_properties(object);
+			if (object->type == EMSMDBP_OBJECT_MESSAGE || object->type == EMSMDBP_OBJECT_ATTACHMENT) {
+				groups = 0;
+				for (i = 0; i < rowp->cValues; i++) {
+					groups |= (1 << emsmdbp_property_group(rowp->lpProps[i].ulPropTag));
+				}
+				emsmdbp_object_message_touch_groups(object, groups);
+			}
 			break;
 		}
 	}
@@ -2704,6 +3342,7 @@ _PUBLIC_ void emsmdbp_fill_row_blob(TALLOC_CTX *mem_ctx,
 				    enum MAPISTATUS *retvals,
 				    bool *untyped_status)
 {
+	struct ndr_push	*ndr;
         uint16_t i;
         uint8_t flagged;
         enum MAPITAGS property;
@@ -2718,6 +3357,13 @@ _PUBLIC_ void emsmdbp_fill_row_blob(TALLOC_CTX *mem_ctx,
         }
 	*layout = flagged;
 
+	/* Encode every value into a single push context */
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	if (property_row->length) {
+		ndr_push_bytes(ndr, property_row->data, property_row->length);
+	}
+
         for (i = 0; i < properties->cValues; i++) {
                 retval = retvals[i];
                 if (retval != MAPI_E_SUCCESS) {
@@ -2728,10 +3374,13 @@ _PUBLIC_ void emsmdbp_fill_row_blob(TALLOC_CTX *mem_ctx,
                         property = properties->aulPropTag[i];
                         data = data_pointers[i];
                 }
-                libmapiserver_push_property(mem_ctx,
-                                            property, data, property_row,
-                                            flagged ? PT_ERROR : 0, flagged, untyped_status[i]);
+                libmapiserver_push_property_ndr(ndr, property, data,
+						flagged ? PT_ERROR : 0, flagged, untyped_status[i]);
         }
+
+	property_row->data = talloc_steal(mem_ctx, ndr->data);
+	property_row->length = ndr->offset;
+	talloc_free(ndr);
 }
 
 _PUBLIC_ struct emsmdbp_stream_data *emsmdbp_stream_data_from_value(TALLOC_CTX *mem_ctx, enum MAPITAGS prop_tag, void *value, bool read_write)
@@ -2745,8 +3394,14 @@ _PUBLIC_ struct emsmdbp_stream_data *emsmdbp_stream_data_from_value(TALLOC_CTX *
 	prop_type = prop_tag & 0xffff;
 	if (prop_type == PT_STRING8) {
 		stream_data->data.length = strlen(value) + 1;
-		stream_data->data.data = value;
-                (void) talloc_reference(stream_data, stream_data->data.data);
+		if (read_write) {
+			/* value may be shared with the message property cache */
+			stream_data->data.data = talloc_memdup(stream_data, value, stream_data->data.length);
+		}
+		else {
+			stream_data->data.data = value;
+			(void) talloc_reference(stream_data, stream_data->data.data);
+		}
 	}
 	else if (prop_type == PT_UNICODE) {
 		stream_data->data.length = strlen_m_ext((char *) value, CH_UTF8, CH_UTF16LE) * 2;
@@ -102,6 +102,72 @@ end:
 	return ret;
 }
 
+/* Bump whenever emsmdbp_mailbox_provision changes what it creates, so
+   that mailboxes provisioned by an older version are reconciled again */
+#define	EMSMDBP_PROVISIONING_VERSION	1
+
+static uint64_t emsmdbp_provisioning_hash(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t	*bytes = data;
+	size_t		i;
+
+	/* FNV-1a */
+	for (i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+static uint64_t emsmdbp_provisioning_hash_string(uint64_t hash, const char *str)
+{
+	if (str) {
+		hash = emsmdbp_provisioning_hash(hash, str, strlen(str));
+	}
+	/* keep ("ab", "c") and ("a", "bc") apart */
+	return emsmdbp_provisioning_hash(hash, "", 1);
+}
+
+/**
+   \details Compute the provisioning fingerprint of a mailbox
+
+   The fingerprint covers every field of the backend contexts that
+   emsmdbp_mailbox_provision uses, together with the provisioning
+   version. Entries are hashed separately and combined with an addition
+   so that the order in which backends list them does not matter.
+
+   \param contexts_list the contexts returned by the backends
+
+   \return the fingerprint
+ */
+static uint64_t emsmdbp_mailbox_provision_fingerprint(struct mapistore_contexts_list *contexts_list)
+{
+	struct mapistore_contexts_list	*current_entry;
+	uint64_t			entry_hash, fingerprint = 0;
+	uint32_t			count = 0, value;
+	uint8_t				main_folder;
+
+	for (current_entry = contexts_list; current_entry; current_entry = current_entry->next) {
+		entry_hash = 0xcbf29ce484222325ULL;
+		entry_hash = emsmdbp_provisioning_hash_string(entry_hash, current_entry->url);
+		entry_hash = emsmdbp_provisioning_hash_string(entry_hash, current_entry->name);
+		entry_hash = emsmdbp_provisioning_hash_string(entry_hash, current_entry->tag);
+		value = current_entry->role;
+		entry_hash = emsmdbp_provisioning_hash(entry_hash, &value, sizeof(uint32_t));
+		main_folder = current_entry->main_folder ? 1 : 0;
+		entry_hash = emsmdbp_provisioning_hash(entry_hash, &main_folder, sizeof(uint8_t));
+		fingerprint += entry_hash;
+		count++;
+	}
+
+	value = EMSMDBP_PROVISIONING_VERSION;
+	fingerprint = emsmdbp_provisioning_hash(fingerprint, &value, sizeof(uint32_t));
+	fingerprint = emsmdbp_provisioning_hash(fingerprint, &count, sizeof(uint32_t));
+
+	return fingerprint;
+}
+
 _PUBLIC_ enum MAPISTATUS emsmdbp_mailbox_provision(struct emsmdbp_context *emsmdbp_ctx, const char *username)
 {
 /* auto-provisioning:
@@ -216,11 +282,10 @@ FolderId: 0x67ca828f02000001      Display Name: "                        ";  Con
 	struct Binary_r				*entryId;
 	bool					exists, reminders_created;
 	void					*backend_object, *backend_table, *backend_message;
+	uint64_t				fingerprint, stored_fingerprint;
 
 	mem_ctx = talloc_zero(NULL, TALLOC_CTX);
 
-	ldb_transaction_start(emsmdbp_ctx->oc_ctx);
-
 	/* Retrieve list of folders from backends */
 	retval = mapistore_list_contexts_for_user(emsmdbp_ctx->mstore_ctx, username, mem_ctx, &contexts_list);
 	if (retval != MAPISTORE_SUCCESS) {
@@ -245,6 +310,20 @@ FolderId: 0x67ca828f02000001      Display Name: "                        ";  Con
 		current_entry = current_entry->next;
 	}
 
+	/* Nothing to reconcile if the backends still expose the same
+	   contexts as when the mailbox was last provisioned */
+	fingerprint = emsmdbp_mailbox_provision_fingerprint(contexts_list);
+	ret = openchangedb_get_ProvisioningFingerprint(emsmdbp_ctx->oc_ctx, username, &stored_fingerprint);
+	if (ret == MAPI_E_SUCCESS && stored_fingerprint == fingerprint) {
+		DEBUG(5, ("[%s:%d]: mailbox '%s' is up to date (fingerprint 0x%.16"PRIx64")\n",
+			  __FUNCTION__, __LINE__, username, fingerprint));
+		talloc_free(mem_ctx);
+		return MAPI_E_SUCCESS;
+	}
+
+	ldb_transaction_start(emsmdbp_ctx->oc_ctx);
+	mapistore_indexing_transaction_start(emsmdbp_ctx->mstore_ctx, username);
+
 	/* Retrieve list of existing entries */
 	ret = openchangedb_get_MAPIStoreURIs(emsmdbp_ctx->oc_ctx, username, mem_ctx, &existing_uris);
 	if (ret == MAPI_E_SUCCESS) {
@@ -310,6 +389,8 @@ FolderId: 0x67ca828f02000001      Display Name: "                        ";  Con
 	/* Fallback role MUST exist */
 	if (!main_entries[MAPISTORE_FALLBACK_ROLE]) {
 		DEBUG(5, ("No fallback provisioning role was found while such role is mandatory. Provisiong must be done manually.\n"));
+		mapistore_indexing_transaction_cancel(emsmdbp_ctx->mstore_ctx, username);
+		ldb_transaction_cancel(emsmdbp_ctx->oc_ctx);
 		talloc_free(mem_ctx);
 		return MAPI_E_DISK_ERROR;
 	}
@@ -639,8 +720,14 @@ FolderId: 0x67ca828f02000001      Display Name: "                        ";  Con
 		}
 	
 		mapistore_del_context(emsmdbp_ctx->mstore_ctx, context_id);
+
+		/* The owner-only steps above are done too: later logons,
+		   including delegate ones, can skip provisioning until the
+		   backend contexts change */
+		openchangedb_set_ProvisioningFingerprint(emsmdbp_ctx->oc_ctx, username, fingerprint);
 	}
 
+	mapistore_indexing_transaction_commit(emsmdbp_ctx->mstore_ctx, username);
 	ldb_transaction_commit(emsmdbp_ctx->oc_ctx);
 
 
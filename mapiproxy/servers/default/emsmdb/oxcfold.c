@@ -673,10 +673,12 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopDeleteMessages(TALLOC_CTX *mem_ctx,
 
 	contextID = emsmdbp_get_contextID(parent_object);
 	owner = emsmdbp_get_owner(parent_object);
+	mapistore_indexing_transaction_start(emsmdbp_ctx->mstore_ctx, owner);
 	for (i = 0; i < mapi_req->u.mapi_DeleteMessages.cn_ids; ++i) {
 		int ret;
 		uint64_t mid = mapi_req->u.mapi_DeleteMessages.message_ids[i];
 		DEBUG(0, ("MID %i to delete: 0x%.16"PRIx64"\n", i, mid));
+		emsmdbp_object_message_forget(emsmdbp_ctx, mid);
 		ret = mapistore_folder_delete_message(emsmdbp_ctx->mstore_ctx, contextID, parent_object->backend_object, mid, MAPISTORE_SOFT_DELETE);
 		if (ret != MAPISTORE_SUCCESS && ret != MAPISTORE_ERR_NOT_FOUND) {
 			if (ret == MAPISTORE_ERR_DENIED) {
@@ -685,15 +687,17 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopDeleteMessages(TALLOC_CTX *mem_ctx,
 			else {
 				mapi_repl->error_code = MAPI_E_CALL_FAILED;
 			}
-			goto delete_message_response;
+			break;
 		}
 
 		ret = mapistore_indexing_record_del_mid(emsmdbp_ctx->mstore_ctx, contextID, owner, mid, MAPISTORE_SOFT_DELETE);
 		if (ret != MAPISTORE_SUCCESS) {
 			mapi_repl->error_code = MAPI_E_CALL_FAILED;
-			goto delete_message_response;
+			break;
 		}
 	}
+	/* the records of the messages deleted before a failure are kept */
+	mapistore_indexing_transaction_commit(emsmdbp_ctx->mstore_ctx, owner);
 
 delete_message_response:
 	*size += libmapiserver_RopDeleteMessage_size(mapi_repl);
@@ -1015,6 +1019,11 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopMoveCopyMessages(TALLOC_CTX *mem_ctx,
 		}
 
 		/* We invoke the backend method */
+		if (!mapi_req->u.mapi_MoveCopyMessages.WantCopy) {
+			for (i = 0; i < mapi_req->u.mapi_MoveCopyMessages.count; i++) {
+				emsmdbp_object_message_forget(emsmdbp_ctx, mapi_req->u.mapi_MoveCopyMessages.message_id[i]);
+			}
+		}
 		mapistore_folder_move_copy_messages(emsmdbp_ctx->mstore_ctx, contextID, destination_object->backend_object, source_object->backend_object, mem_ctx, mapi_req->u.mapi_MoveCopyMessages.count, mapi_req->u.mapi_MoveCopyMessages.message_id, targetMIDs, NULL, mapi_req->u.mapi_MoveCopyMessages.WantCopy);
 		talloc_free(targetMIDs);
 
@@ -82,6 +82,8 @@ struct oxcfxics_sync_data {
 
 	struct rawidset			*deleted_eid_set;
 
+	struct Binary_r			*group_info;
+
 	struct oxcfxics_message_sync_data	*message_sync_data;
 };
 
@@ -492,6 +494,8 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFastTransferSourceCopyTo(TALLOC_CTX *mem_ctx
 				goto end;
 			}
 
+			/* Not on mem_ctx: the ftcontext references both
+			   buffers, which would pin the whole request pool */
 			ndr = ndr_push_init_ctx(NULL);
 			ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
 			ndr->offset = 0;
@@ -781,6 +785,90 @@ static void oxcfxics_table_set_cn_restriction(struct emsmdbp_context *emsmdbp_ct
 	mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(table_object), table_object->backend_object, &cn_restriction, &state);
 }
 
+/**
+   \details Build the PropertyGroupInfo blob describing the property
+   groups used in partial message changes
+ */
+static struct Binary_r *oxcfxics_make_group_info(TALLOC_CTX *mem_ctx)
+{
+	struct Binary_r		*group_info;
+	struct ndr_push		*ndr;
+	const enum MAPITAGS	*tags;
+	uint32_t		group, count, i;
+
+	ndr = ndr_push_init_ctx(NULL);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	ndr_push_uint32(ndr, NDR_SCALARS, EMSMDBP_PROPERTY_GROUP_MAPPING_ID);
+	ndr_push_uint32(ndr, NDR_SCALARS, 0); /* reserved */
+	ndr_push_uint32(ndr, NDR_SCALARS, EMSMDBP_PROPERTY_GROUP_COUNT);
+	for (group = 0; group < EMSMDBP_PROPERTY_GROUP_COUNT; group++) {
+		tags = emsmdbp_property_group_tags(group, &count);
+		ndr_push_uint32(ndr, NDR_SCALARS, count);
+		for (i = 0; i < count; i++) {
+			ndr_push_uint32(ndr, NDR_SCALARS, tags[i]);
+		}
+	}
+
+	group_info = talloc_zero(mem_ctx, struct Binary_r);
+	group_info->cb = ndr->offset;
+	group_info->lpb = talloc_memdup(group_info, ndr->data, ndr->offset);
+	talloc_free(ndr);
+
+	return group_info;
+}
+
+/**
+   \details Determine which property groups of a message must be sent
+
+   The message may be sent as a partial change only when the client
+   requested it, already has the message and has seen the change
+   numbers of the groups left untouched since. Otherwise, every group
+   is returned and the message is sent in full.
+ */
+static uint32_t oxcfxics_message_changed_groups(struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object_synccontext *synccontext, const char *owner, struct oxcfxics_sync_data *sync_data, struct idset *original_cnset_seen, struct GUID *replica_guid, uint64_t eid, uint64_t raw_cn)
+{
+	TALLOC_CTX		*mem_ctx;
+	struct UI8Array_r	*cns;
+	uint32_t		groups, i;
+	bool			cn_found;
+
+	if (!synccontext->request.partial_item) {
+		return EMSMDBP_PROPERTY_GROUPS_ALL;
+	}
+	if (!IDSET_includes_guid_glob(synccontext->idset_given, replica_guid, (eid >> 16) & 0x0000ffffffffffff)) {
+		return EMSMDBP_PROPERTY_GROUPS_ALL;
+	}
+
+	mem_ctx = talloc_zero(NULL, TALLOC_CTX);
+	groups = EMSMDBP_PROPERTY_GROUPS_ALL;
+	if (mapistore_indexing_record_get_group_cns(emsmdbp_ctx->mstore_ctx, owner, mem_ctx, eid, &cns) != MAPISTORE_SUCCESS
+	    || cns->cValues != EMSMDBP_PROPERTY_GROUP_COUNT) {
+		goto end;
+	}
+
+	/* the message was modified behind our back since the groups were recorded */
+	cn_found = false;
+	for (i = 0; !cn_found && i < cns->cValues; i++) {
+		cn_found = (cns->lpui8[i] == raw_cn);
+	}
+	if (!cn_found) {
+		goto end;
+	}
+
+	groups = 0;
+	for (i = 0; i < cns->cValues; i++) {
+		if (cns->lpui8[i] == 0
+		    || !IDSET_includes_guid_glob(original_cnset_seen, &sync_data->replica_guid, (cns->lpui8[i] >> 16) & 0x0000ffffffffffff)) {
+			groups |= (1 << i);
+		}
+	}
+
+end:
+	talloc_free(mem_ctx);
+
+	return groups;
+}
+
 static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, struct emsmdbp_object_synccontext *synccontext, const char *owner, struct oxcfxics_sync_data *sync_data, struct emsmdbp_object *folder_object)
 {
 	TALLOC_CTX			*mem_ctx, *msg_ctx;
@@ -805,6 +893,12 @@ static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, str
 	struct UI8Array_r		*deleted_eids;
 	struct SPropTagArray		*properties;
 	struct oxcfxics_message_sync_data	*message_sync_data;
+	uint32_t			changed_groups, group, group_id, j;
+	uint64_t			raw_cn;
+	struct SPropTagArray		group_props;
+	enum MAPITAGS			group_tags[2];
+	void				*group_data_pointers[2];
+	enum MAPISTATUS			group_retvals[2] = { MAPI_E_SUCCESS, MAPI_E_SUCCESS };
 
 
 	mem_ctx = talloc_zero(NULL, void);
@@ -827,8 +921,9 @@ static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, str
 		message_sync_data = talloc_zero(NULL, struct oxcfxics_message_sync_data);
 		sync_data->message_sync_data = message_sync_data;
 
-		/* we only push "messageChangeFull" since we don't handle property-based changes */
-		/* messageChangeFull = IncrSyncChg messageChangeHeader IncrSyncMessage propList messageChildren */
+		/* messageChangeFull = IncrSyncChg messageChangeHeader IncrSyncMessage propList messageChildren
+		   messageChangePartial = groupInfo [MetaTagIncrSyncGroupId] IncrSyncChgPartial messageChangeHeader
+		                          *(MetaTagIncrementalSyncMessagePartial propList) messageChildren */
 
 		table_object = emsmdbp_folder_open_table(mem_ctx, folder_object, sync_data->table_type, 0);
 		if (!table_object) {
@@ -943,7 +1038,8 @@ static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, str
 			DEBUG(5, (__location__": mandatory property PidTagChangeNumber not returned for message\n"));
 			abort();
 		}
-		cn = ((*(uint64_t *) data_pointers[sync_data->prop_index.change_number]) >> 16) & 0x0000ffffffffffff;
+		raw_cn = *(uint64_t *) data_pointers[sync_data->prop_index.change_number];
+		cn = (raw_cn >> 16) & 0x0000ffffffffffff;
 		if (IDSET_includes_guid_glob(original_cnset_seen, &sync_data->replica_guid, cn)) {
 			synccontext->skipped_objects++;
 			DEBUG(5, (__location__": message changes: cn %.16"PRIx64" already present\n", cn));
@@ -1021,21 +1117,71 @@ static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, str
 
 		query_props.cValues = i;
 
-		ndr_push_uint32(sync_data->ndr, NDR_SCALARS, IncrSyncChg);
-		ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, 0);
-		ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, sync_data->ndr->offset);
-		oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, header_data_pointers, (enum MAPISTATUS *) header_retvals);
+		changed_groups = EMSMDBP_PROPERTY_GROUPS_ALL;
+		if (folder_is_mapistore) {
+			changed_groups = oxcfxics_message_changed_groups(emsmdbp_ctx, synccontext, owner, sync_data, original_cnset_seen, &replica_guid, eid, raw_cn);
+		}
 
-		/** remaining props */
-		ndr_push_uint32(sync_data->ndr, NDR_SCALARS, IncrSyncMessage);
-		ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, 0);
-		ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, sync_data->ndr->offset);
+		if (changed_groups == EMSMDBP_PROPERTY_GROUPS_ALL) {
+			ndr_push_uint32(sync_data->ndr, NDR_SCALARS, IncrSyncChg);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, 0);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, sync_data->ndr->offset);
+			oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, header_data_pointers, (enum MAPISTATUS *) header_retvals);
+
+			/** remaining props */
+			ndr_push_uint32(sync_data->ndr, NDR_SCALARS, IncrSyncMessage);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, 0);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, sync_data->ndr->offset);
+
+			/* we shift the number of remaining properties to the amount of properties explicitly requested in RopSyncConfigure that were used above */
+			if (properties->cValues > message_properties_shift) {
+				query_props.cValues = properties->cValues - message_properties_shift;
+				query_props.aulPropTag = properties->aulPropTag + message_properties_shift;
+				oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, data_pointers + message_properties_shift, (enum MAPISTATUS *) retvals + message_properties_shift);
+			}
+		}
+		else {
+			/* groupInfo and group id, the mapping is the same for every message */
+			if (!sync_data->group_info) {
+				sync_data->group_info = oxcfxics_make_group_info(sync_data);
+			}
+			group_props.cValues = 2;
+			group_props.aulPropTag = group_tags;
+			group_tags[0] = IncrSyncGroupInfo;
+			group_data_pointers[0] = sync_data->group_info;
+			group_tags[1] = MetaTagIncrSyncGroupId;
+			group_data_pointers[1] = &group_id;
+			group_id = EMSMDBP_PROPERTY_GROUP_MAPPING_ID;
+			oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &group_props, group_data_pointers, group_retvals);
+
+			ndr_push_uint32(sync_data->ndr, NDR_SCALARS, IncrSyncChgPartial);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, 0);
+			ndr_push_uint32(sync_data->cutmarks_ndr, NDR_SCALARS, sync_data->ndr->offset);
+			oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, header_data_pointers, (enum MAPISTATUS *) header_retvals);
 
-		/* we shift the number of remaining properties to the amount of properties explicitly requested in RopSyncConfigure that were used above */
-		if (properties->cValues > message_properties_shift) {
-			query_props.cValues = properties->cValues - message_properties_shift;
-			query_props.aulPropTag = properties->aulPropTag + message_properties_shift;
-			oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, data_pointers + message_properties_shift, (enum MAPISTATUS *) retvals + message_properties_shift);
+			/** remaining props, one propList per changed group */
+			query_props.aulPropTag = talloc_array(header_data_pointers, enum MAPITAGS, properties->cValues);
+			header_data_pointers = talloc_array(header_data_pointers, void *, properties->cValues);
+			header_retvals = talloc_array(header_data_pointers, enum MAPISTATUS, properties->cValues);
+			group_props.cValues = 1;
+			group_tags[0] = MetaTagIncrementalSyncMessagePartial;
+			group_data_pointers[0] = &group;
+			for (group = 0; group < EMSMDBP_PROPERTY_GROUP_COUNT; group++) {
+				if (!(changed_groups & (1 << group))) continue;
+
+				oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &group_props, group_data_pointers, group_retvals);
+
+				query_props.cValues = 0;
+				for (j = message_properties_shift; j < properties->cValues; j++) {
+					if (emsmdbp_property_group(properties->aulPropTag[j]) != group) continue;
+					query_props.aulPropTag[query_props.cValues] = properties->aulPropTag[j];
+					header_data_pointers[query_props.cValues] = data_pointers[j];
+					header_retvals[query_props.cValues] = retvals[j];
+					query_props.cValues++;
+				}
+				oxcfxics_ndr_push_properties(sync_data->ndr, sync_data->cutmarks_ndr, emsmdbp_ctx->mstore_ctx->nprops_ctx, &query_props, header_data_pointers, (enum MAPISTATUS *) header_retvals);
+			}
+			DEBUG(5, ("message '%.16"PRIx64"' sent as a partial change (groups 0x%x)\n", eid, changed_groups));
 		}
 
 		/* messageChildren:
@@ -1043,8 +1189,12 @@ static bool oxcfxics_push_messageChange(struct emsmdbp_context *emsmdbp_ctx, str
 		   embeddedMessage:
 		   StartEmbed messageContent EndEmbed */
 
-		oxcfxics_push_messageChange_recipients(emsmdbp_ctx, sync_data, message_object, msg);
-		oxcfxics_push_messageChange_attachments(emsmdbp_ctx, synccontext, sync_data, message_object);
+		if (changed_groups & (1 << EMSMDBP_PROPERTY_GROUP_RECIPIENTS)) {
+			oxcfxics_push_messageChange_recipients(emsmdbp_ctx, sync_data, message_object, msg);
+		}
+		if (changed_groups & (1 << EMSMDBP_PROPERTY_GROUP_ATTACHMENTS)) {
+			oxcfxics_push_messageChange_attachments(emsmdbp_ctx, synccontext, sync_data, message_object);
+		}
 
 		synccontext->sent_objects++;
 	end_row:
@@ -1099,6 +1249,8 @@ static void oxcfxics_fill_synccontext_with_messageChange(struct emsmdbp_object_s
 
 	if (synccontext->sync_stage == 0) {
 		/* 1. we setup the mandatory properties indexes */
+		/* sync_data outlives the request: keep it and its ndr
+		   buffers out of the request pool */
 		sync_data = talloc_zero(NULL, struct oxcfxics_sync_data);
 		openchangedb_get_MailboxReplica(emsmdbp_ctx->oc_ctx, owner, NULL, &sync_data->replica_guid);
 		SPropTagArray_find(synccontext->properties, PidTagMid, &sync_data->prop_index.eid);
@@ -1754,6 +1906,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFastTransferSourceGetBuffer(TALLOC_CTX *mem_
 	struct FastTransferSourceGetBuffer_req	 *request;
 	struct FastTransferSourceGetBuffer_repl	 *response;
 	uint32_t				request_buffer_size;
+	uint32_t				available_size;
 	void					*data;
 
 	DEBUG(4, ("exchange_emsmdb: [OXCFXICS] FastTransferSourceGetBuffer (0x4e)\n"));
@@ -1790,9 +1943,50 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFastTransferSourceGetBuffer(TALLOC_CTX *mem_
 	request = &mapi_req->u.mapi_FastTransferSourceGetBuffer;
 	response = &mapi_repl->u.mapi_FastTransferSourceGetBuffer;
 
+	/* 0xBABE lets the server fill the space left in the response,
+	   up to MaximumBufferSize */
 	request_buffer_size = request->BufferSize;
 	if (request_buffer_size == 0xBABE) {
 		request_buffer_size = request->MaximumBufferSize.MaximumBufferSize;
+		available_size = SIZE_DFLT_MAPI_RESPONSE + SIZE_DFLT_ROPFASTTRANSFERSOURCEGETBUFFER + *size;
+		if (emsmdbp_ctx->rop_buffer_size > available_size) {
+			available_size = emsmdbp_ctx->rop_buffer_size - available_size;
+		}
+		else {
+			available_size = 0;
+		}
+		DEBUG(5, ("  0xBABE space left: %u bytes (maximum %u)\n", available_size,
+			  request->MaximumBufferSize.MaximumBufferSize));
+
+		/* too little space left: let the client ask again in
+		   its next request */
+		if (request_buffer_size > available_size && available_size < EMSMDBP_MIN_FASTTRANSFER_BUFFER_SIZE) {
+			switch (object->type) {
+			case EMSMDBP_OBJECT_FTCONTEXT:
+				response->TotalStepCount = object->object.ftcontext->total_steps;
+				response->InProgressCount = object->object.ftcontext->steps;
+				break;
+			case EMSMDBP_OBJECT_SYNCCONTEXT:
+				response->TotalStepCount = object->object.synccontext->total_steps;
+				response->InProgressCount = object->object.synccontext->steps;
+				break;
+			default:
+				mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+				DEBUG(5, ("  object type %d not supported\n", object->type));
+				goto end;
+			}
+			response->TransferStatus = TransferStatus_NoRoom;
+			response->TransferBuffer.length = 0;
+			response->TransferBuffer.data = NULL;
+			goto no_room;
+		}
+		if (request_buffer_size > available_size) {
+			request_buffer_size = available_size;
+		}
+	}
+	if (!request_buffer_size) {
+		mapi_repl->error_code = MAPI_E_INVALID_PARAMETER;
+		goto end;
 	}
 
 	/* Step 3. Perform the read operation */
@@ -1809,6 +2003,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFastTransferSourceGetBuffer(TALLOC_CTX *mem_
                 goto end;
 	}
 
+no_room:
 	response->TransferBufferSize = response->TransferBuffer.length;
 	response->Reserved = 0;
 
@@ -2182,6 +2377,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSyncImportMessageChange(TALLOC_CTX *mem_ctx,
 	}
 
 	mapi_handles_set_private_data(message_object_handle, message_object);
+	message_object->object.message->imported = true;
 
 	response->MessageId = 0; /* Must be set to 0 */
 
@@ -2448,10 +2644,12 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSyncImportDeletes(TALLOC_CTX *mem_ctx,
 
 		contextID = emsmdbp_get_contextID(synccontext_object);
 
+		mapistore_indexing_transaction_start(emsmdbp_ctx->mstore_ctx, owner);
 		object_array = &request->PropertyValues.lpProps[0].value.MVbin;
 		for (i = 0; i < object_array->cValues; i++) {
 			ret = oxcfxics_fmid_from_source_key(emsmdbp_ctx, owner, object_array->bin + i, &objectID);
 			if (ret == MAPISTORE_SUCCESS) {
+				emsmdbp_object_message_forget(emsmdbp_ctx, objectID);
 				ret = mapistore_folder_delete_message(emsmdbp_ctx->mstore_ctx, contextID, synccontext_object->parent_object->backend_object, objectID, delete_type);
 				if (ret != MAPISTORE_SUCCESS) {
 					DEBUG(5, ("message deletion failed for fmid: 0x%.16"PRIx64"\n", objectID));
@@ -2462,6 +2660,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSyncImportDeletes(TALLOC_CTX *mem_ctx,
 				}
 			}
 		}
+		mapistore_indexing_transaction_commit(emsmdbp_ctx->mstore_ctx, owner);
 	}
 
 end:
@@ -2880,6 +3079,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSyncImportMessageMove(TALLOC_CTX *mem_ctx,
 	change_key->lpb = request->ChangeNumber;
 	if (mapistore) {
 		/* We invoke the backend method */
+		emsmdbp_object_message_forget(emsmdbp_ctx, sourceMID);
 		mapistore_folder_move_copy_messages(emsmdbp_ctx->mstore_ctx, contextID, synccontext_object->parent_object->backend_object, source_folder_object->backend_object, mem_ctx, 1, &sourceMID, &destMID, &change_key, false);
 	}
 	else {
@@ -605,7 +605,26 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSaveChangesMessage(TALLOC_CTX *mem_ctx,
 	case true:
                 contextID = emsmdbp_get_contextID(object);
 		messageID = object->object.message->messageID;
+		if (object->object.message->imported) {
+			/* committed with the other messages imported in this request */
+			ret = emsmdbp_import_batch_save(emsmdbp_ctx, object, mem_ctx);
+			if (ret == MAPISTORE_ERR_DENIED) {
+				mapi_repl->error_code = MAPI_E_NO_ACCESS;
+				goto end;
+			}
+			else if (ret != MAPISTORE_SUCCESS) {
+				mapi_repl->error_code = mapistore_error_to_mapi(ret);
+				goto end;
+			}
+			break;
+		}
 		ret = mapistore_message_save(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, mem_ctx);
+		/* the backend may have computed properties on save */
+		emsmdbp_object_message_invalidate_properties(object);
+		if (ret == MAPISTORE_SUCCESS) {
+			emsmdbp_object_message_commit_groups(emsmdbp_ctx, object);
+		}
+		emsmdbp_object_message_forget(emsmdbp_ctx, messageID);
 		if (ret == MAPISTORE_ERR_DENIED) {
 			mapi_repl->error_code = MAPI_E_NO_ACCESS;
 			goto end;
@@ -687,6 +706,8 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopRemoveAllRecipients(TALLOC_CTX *mem_ctx,
 		contextID = emsmdbp_get_contextID(object);
 		memset(&columns, 0, sizeof(struct SPropTagArray));
 		mapistore_message_modify_recipients(emsmdbp_ctx->mstore_ctx, contextID, &columns, object->backend_object, 0, NULL);
+		emsmdbp_object_message_invalidate_properties(object);
+		emsmdbp_object_message_touch_groups(object, (1 << EMSMDBP_PROPERTY_GROUP_RECIPIENTS));
 	}
 	else {
 		DEBUG(0, ("Not implement yet - shouldn't occur\n"));
@@ -895,6 +916,8 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopModifyRecipients(TALLOC_CTX *mem_ctx,
 			oxcmsg_parse_ModifyRecipientRow(recipients, mapi_req->u.mapi_ModifyRecipients.RecipientRow + i, mapi_req->u.mapi_ModifyRecipients.prop_count, mapi_req->u.mapi_ModifyRecipients.properties, recipients + i);
 		}
 		mapistore_message_modify_recipients(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, columns, mapi_req->u.mapi_ModifyRecipients.cValues, recipients);
+		emsmdbp_object_message_invalidate_properties(object);
+		emsmdbp_object_message_touch_groups(object, (1 << EMSMDBP_PROPERTY_GROUP_RECIPIENTS));
 	}
 	else {
 		DEBUG(0, ("Not implement yet - shouldn't occur\n"));
@@ -1098,6 +1121,10 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSetMessageReadFlag(TALLOC_CTX *mem_ctx,
 	case true:
                 contextID = emsmdbp_get_contextID(message_object);
 		mapistore_message_set_read_flag(emsmdbp_ctx->mstore_ctx, contextID, message_object->backend_object, request->flags);
+		emsmdbp_object_message_invalidate_properties(message_object);
+		/* the read flag is saved by the backend right away */
+		emsmdbp_object_message_touch_groups(message_object, (1 << EMSMDBP_PROPERTY_GROUP_STATUS));
+		emsmdbp_object_message_commit_groups(emsmdbp_ctx, message_object);
 		break;
 	}
 
@@ -1384,6 +1411,11 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopCreateAttach(TALLOC_CTX *mem_ctx,
 				DEBUG(5, ("could not open nor create mapistore message\n"));
 				mapi_repl->error_code = MAPI_E_NOT_FOUND;
 			}
+			else {
+				emsmdbp_object_message_touch_groups(message_object, (1 << EMSMDBP_PROPERTY_GROUP_ATTACHMENTS));
+				/* PidTagHasAttachments and PidTagMessageSize change */
+				emsmdbp_object_message_invalidate_properties(message_object);
+			}
 			retval = mapi_handles_set_private_data(attachment_rec, attachment_object);
 		}
         }
@@ -1415,6 +1447,12 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSaveChangesAttachment(TALLOC_CTX *mem_ctx,
                                                           struct EcDoRpc_MAPI_REPL *mapi_repl,
                                                           uint32_t *handles, uint16_t *size)
 {
+	enum MAPISTATUS		retval;
+	uint32_t		handle;
+	struct mapi_handles	*rec = NULL;
+	struct emsmdbp_object	*attachment_object = NULL;
+	void			*data;
+
 	DEBUG(4, ("exchange_emsmdb: [OXCMSG] SaveChangesAttachment (0x25) -- valid stub\n"));
 
 	/* Sanity checks */
@@ -1428,6 +1466,27 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSaveChangesAttachment(TALLOC_CTX *mem_ctx,
 	mapi_repl->error_code = MAPI_E_SUCCESS;
 	mapi_repl->handle_idx = mapi_req->u.mapi_SaveChangesAttachment.handle_idx;
 
+	/* Attachment properties are written through to the backend, but
+	   the values memoized on the parent message are now stale */
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &rec);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(rec, &data);
+	attachment_object = (struct emsmdbp_object *) data;
+	if (retval || !attachment_object || attachment_object->type != EMSMDBP_OBJECT_ATTACHMENT) {
+		DEBUG(5, ("  no object or object is not an attachment\n"));
+		mapi_repl->error_code = MAPI_E_NO_SUPPORT;
+		goto end;
+	}
+
+	emsmdbp_object_message_invalidate_properties(attachment_object->parent_object);
+
+end:
 	*size += libmapiserver_RopSaveChangesAttachment_size(mapi_repl);
 
 	return MAPI_E_SUCCESS;	
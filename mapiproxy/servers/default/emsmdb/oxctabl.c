@@ -213,7 +213,8 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSortTable(TALLOC_CTX *mem_ctx,
         /* we reset the cursor to the beginning of the table */
         table->numerator = 0;
 
-        /* TODO: we should invalidate current bookmarks on the table */
+	/* Bookmarked positions are meaningless once the rows are sorted again */
+	emsmdbp_object_table_reset_bookmarks(table);
 
 	/* If parent folder has a mapistore context */
 	request = &mapi_req->u.mapi_SortTable;
@@ -225,6 +226,9 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopSortTable(TALLOC_CTX *mem_ctx,
 			goto end;
 		}
 		mapi_repl->u.mapi_SortTable.TableStatus = status;
+
+		/* Category header rows change the number of rows */
+		mapistore_table_get_row_count(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object, MAPISTORE_PREFILTERED_QUERY, &table->denominator);
 	} else {
 		/* Parent folder doesn't have any mapistore context associated */
 		status = TBLSTAT_COMPLETE;
@@ -331,6 +335,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopRestrict(TALLOC_CTX *mem_ctx,
 		}
 
 		mapistore_table_get_row_count(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, MAPISTORE_PREFILTERED_QUERY, &object->object.table->denominator);
+		emsmdbp_object_table_reset_bookmarks(table);
 		
 		mapi_repl->u.mapi_Restrict.TableStatus = status;
 
@@ -374,6 +379,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopQueryRows(TALLOC_CTX *mem_ctx,
 	void				*data;
 	enum MAPISTATUS			*retvals;
 	void				**data_pointers;
+	struct ndr_push			*ndr;
 	uint32_t			count, max;
 	uint32_t			handle;
 	uint32_t			i = 0;
@@ -441,21 +447,30 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopQueryRows(TALLOC_CTX *mem_ctx,
 	if (max > table->denominator) {
 		max = table->denominator;
 	}
+
+	/* Rows are encoded straight into the reply buffer, RowData
+	   length is then given by the write cursor */
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
         for (i = table->numerator; i < max; i++) {
 		data_pointers = emsmdbp_object_table_get_row_props(mem_ctx, emsmdbp_ctx, object, i, MAPISTORE_PREFILTERED_QUERY, &retvals);
 		if (data_pointers) {
-			emsmdbp_fill_table_row_blob(mem_ctx, emsmdbp_ctx,
-						    &response->RowData, table->prop_count,
-						    table->properties, data_pointers, retvals);
+			libmapiserver_push_PropertyRow(ndr, table->prop_count,
+						       table->properties, data_pointers, retvals);
 			talloc_free(retvals);
 			talloc_free(data_pointers);
 			count++;
 		}
 		else {
 			count = 0;
-			goto finish;
+			break;
 		}
 	}
+	if (count) {
+		response->RowData.data = talloc_steal(mem_ctx, ndr->data);
+		response->RowData.length = ndr->offset;
+	}
+	talloc_free(ndr);
 
 finish:
 	if ((request->QueryRowsFlags & TBL_NOADVANCE) != TBL_NOADVANCE) {
@@ -674,9 +689,238 @@ end:
 }
 
 
+/**
+   \details EcDoRpc SeekRowBookmark (0x19) Rop. This operation moves the
+   cursor to a position relative to a bookmark created with
+   CreateBookmark.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_req pointer to the SeekRowBookmark EcDoRpc_MAPI_REQ
+   structure
+   \param mapi_repl pointer to the SeekRowBookmark EcDoRpc_MAPI_REPL
+   structure
+   \param handles pointer to the MAPI handles array
+   \param size pointer to the mapi_response size to update
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS EcDoRpc_RopSeekRowBookmark(TALLOC_CTX *mem_ctx,
+						    struct emsmdbp_context *emsmdbp_ctx,
+						    struct EcDoRpc_MAPI_REQ *mapi_req,
+						    struct EcDoRpc_MAPI_REPL *mapi_repl,
+						    uint32_t *handles, uint16_t *size)
+{
+	enum MAPISTATUS			retval;
+	struct mapi_handles		*parent;
+	struct emsmdbp_object		*object;
+	struct emsmdbp_object_table	*table;
+	struct SeekRowBookmark_req	*request;
+	struct SeekRowBookmark_repl	*response;
+	struct emsmdbp_table_bookmark	*bookmark;
+	void				*data;
+	uint32_t			handle, bookmark_position;
+	int64_t				position, next_position;
+
+	DEBUG(4, ("exchange_emsmdb: [OXCTABL] SeekRowBookmark (0x19)\n"));
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_req, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_repl, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
+
+	request = &mapi_req->u.mapi_SeekRowBookmark;
+	response = &mapi_repl->u.mapi_SeekRowBookmark;
+
+	mapi_repl->opnum = mapi_req->opnum;
+	mapi_repl->handle_idx = mapi_req->handle_idx;
+	mapi_repl->error_code = MAPI_E_SUCCESS;
+	response->RowNoLongerVisible = 0;
+	response->HasSoughtLess = 0;
+	response->RowsSought = 0;
+
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &parent);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(parent, &data);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		DEBUG(5, ("  handle data not found, idx = %x\n", mapi_req->handle_idx));
+		goto end;
+	}
+	object = (struct emsmdbp_object *) data;
+
+	/* Ensure object exists and is table type */
+	if (!object || (object->type != EMSMDBP_OBJECT_TABLE)) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  no object or object is not a table\n"));
+		goto end;
+	}
+	table = object->object.table;
+
+	/* The bookmark record gives the position back, the rows are
+	 * only scanned when the bookmarked row moved */
+	bookmark = emsmdbp_object_table_get_bookmark(table, &request->Bookmark);
+	if (!bookmark) {
+		mapi_repl->error_code = MAPI_E_INVALID_BOOKMARK;
+		DEBUG(5, ("  invalid bookmark\n"));
+		goto end;
+	}
+
+	if (!emsmdbp_object_table_seek_bookmark(emsmdbp_ctx, object, bookmark, &bookmark_position)) {
+		response->RowNoLongerVisible = 1;
+	}
+	position = bookmark_position;
+	if (position > table->denominator) {
+		position = table->denominator;
+	}
+
+	/* RowCount is a signed number of rows */
+	next_position = position + (int32_t) request->RowCount;
+	if (next_position < 0) {
+		next_position = 0;
+		response->HasSoughtLess = 1;
+	}
+	else if (next_position > table->denominator) {
+		next_position = table->denominator;
+		response->HasSoughtLess = 1;
+	}
+
+	if (request->WantRowMovedCount) {
+		response->RowsSought = (int32_t) (next_position - position);
+	}
+	table->numerator = next_position;
+
+end:
+	*size += libmapiserver_RopSeekRowBookmark_size(mapi_repl);
+
+	return MAPI_E_SUCCESS;
+}
+
+
+/**
+   \details EcDoRpc CreateBookmark (0x1b) Rop. This operation records the
+   position of the cursor of a table.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_req pointer to the CreateBookmark EcDoRpc_MAPI_REQ
+   structure
+   \param mapi_repl pointer to the CreateBookmark EcDoRpc_MAPI_REPL
+   structure
+   \param handles pointer to the MAPI handles array
+   \param size pointer to the mapi_response size to update
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS EcDoRpc_RopCreateBookmark(TALLOC_CTX *mem_ctx,
+						   struct emsmdbp_context *emsmdbp_ctx,
+						   struct EcDoRpc_MAPI_REQ *mapi_req,
+						   struct EcDoRpc_MAPI_REPL *mapi_repl,
+						   uint32_t *handles, uint16_t *size)
+{
+	enum MAPISTATUS			retval;
+	struct mapi_handles		*parent;
+	struct emsmdbp_object		*object;
+	struct emsmdbp_object_table	*table;
+	struct SBinary_short		*bookmark;
+	void				*data;
+	uint32_t			handle;
+
+	DEBUG(4, ("exchange_emsmdb: [OXCTABL] CreateBookmark (0x1b)\n"));
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_req, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_repl, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
+
+	mapi_repl->opnum = mapi_req->opnum;
+	mapi_repl->handle_idx = mapi_req->handle_idx;
+	mapi_repl->error_code = MAPI_E_SUCCESS;
+	bookmark = &mapi_repl->u.mapi_CreateBookmark.bookmark;
+	bookmark->cb = 0;
+	bookmark->lpb = NULL;
+
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &parent);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(parent, &data);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		DEBUG(5, ("  handle data not found, idx = %x\n", mapi_req->handle_idx));
+		goto end;
+	}
+	object = (struct emsmdbp_object *) data;
+
+	/* Ensure object exists and is table type */
+	if (!object || (object->type != EMSMDBP_OBJECT_TABLE)) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  no object or object is not a table\n"));
+		goto end;
+	}
+	table = object->object.table;
+
+	retval = emsmdbp_object_table_create_bookmark(mem_ctx, emsmdbp_ctx, object, table->numerator, bookmark);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		goto end;
+	}
+
+end:
+	*size += libmapiserver_RopCreateBookmark_size(mapi_repl);
+
+	return MAPI_E_SUCCESS;
+}
+
+
+/**
+   \details Check whether a row of a table matches the restriction set
+   on the table. openchangedb rows are checked on their identifier
+   only, instead of opening the underlying folder or message.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param object pointer to the table object
+   \param row_id position of the row
+
+   \return true if the row matches, otherwise false
+ */
+static bool oxctabl_row_matches(TALLOC_CTX *mem_ctx, struct emsmdbp_context *emsmdbp_ctx,
+				struct emsmdbp_object *object, uint32_t row_id)
+{
+	struct mapistore_property_data	*row;
+	enum MAPITAGS			id_tag;
+	void				*fmid;
+
+	if (emsmdbp_is_mapistore(object)) {
+		return (mapistore_table_get_row(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object,
+						mem_ctx, MAPISTORE_LIVEFILTERED_QUERY, row_id, &row) == MAPISTORE_SUCCESS);
+	}
+
+	id_tag = (object->object.table->ulType == MAPISTORE_FOLDER_TABLE) ? PR_FID : PR_MID;
+	return (openchangedb_table_get_property(mem_ctx, object->backend_object, emsmdbp_ctx->oc_ctx,
+						id_tag, row_id, true, &fmid) == MAPI_E_SUCCESS);
+}
+
 /**
    \details EcDoRpc FindRow (0x4f) Rop. This operation moves the
    cursor to a row in a table that matches specific search criteria.
+   The search starts from the beginning, the end or the cursor of the
+   table, or from a bookmark, and goes forward or backward.
 
    \param mem_ctx pointer to the memory context
    \param emsmdbp_ctx pointer to the emsmdb provider context
@@ -696,17 +940,19 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFindRow(TALLOC_CTX *mem_ctx,
 	struct mapi_handles		*parent;
 	struct emsmdbp_object		*object;
 	struct emsmdbp_object_table	*table;
-	struct FindRow_req		request;
+	struct FindRow_req		*request;
+	struct emsmdbp_table_bookmark	*bookmark;
 	enum MAPISTATUS			retval;
 	void				*data = NULL;
 	enum MAPISTATUS			*retvals;
 	void				**data_pointers;
-	uint32_t			handle;
-	DATA_BLOB			row;
-	uint32_t			property;
-	uint8_t				flagged;
+	struct ndr_push			*ndr;
+	TALLOC_CTX			*batch_ctx;
+	uint32_t			handle, bookmark_position;
 	uint8_t				status = 0;
+	int64_t				position;
 	uint32_t			i;
+	bool				forward;
 	bool				found = false;
 
 	DEBUG(4, ("exchange_emsmdb: [OXCTABL] FindRow (0x4f)\n"));
@@ -718,7 +964,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFindRow(TALLOC_CTX *mem_ctx,
 	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
 	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
 
-	request = mapi_req->u.mapi_FindRow;
+	request = &mapi_req->u.mapi_FindRow;
 	
 	mapi_repl->opnum = mapi_req->opnum;
 	mapi_repl->handle_idx = mapi_req->handle_idx;
@@ -751,163 +997,336 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopFindRow(TALLOC_CTX *mem_ctx,
 		goto end;
 	}
 
-	/* We don't handle backward/forward yet , just go through the
-	 * entire table, nor do we handle bookmarks */
-
 	table = object->object.table;
 	if (table->ulType == MAPISTORE_RULE_TABLE) {
 		DEBUG(5, ("  query on rules table are all faked right now\n"));
 		goto end;
 	}
 
-	if (mapi_req->u.mapi_FindRow.origin == BOOKMARK_BEGINNING) {
-		table->numerator = 0;
+	/* Step 1. Find the first row to check. Backward searches from
+	 * the end of the table start on its last row. */
+	forward = !(request->ulFlags & DIR_BACKWARD);
+	switch (request->origin) {
+	case BOOKMARK_BEGINNING:
+		position = forward ? 0 : -1;
+		break;
+	case BOOKMARK_CURRENT:
+		position = table->numerator;
+		break;
+	case BOOKMARK_END:
+		position = forward ? table->denominator : (int64_t) table->denominator - 1;
+		break;
+	case BOOKMARK_USER:
+		bookmark = emsmdbp_object_table_get_bookmark(table, &request->bookmark);
+		if (!bookmark) {
+			mapi_repl->error_code = MAPI_E_INVALID_BOOKMARK;
+			DEBUG(5, ("  invalid bookmark\n"));
+			goto end;
+		}
+		if (!emsmdbp_object_table_seek_bookmark(emsmdbp_ctx, object, bookmark, &bookmark_position)) {
+			mapi_repl->u.mapi_FindRow.RowNoLongerVisible = 1;
+		}
+		position = bookmark_position;
+		break;
+	default:
+		mapi_repl->error_code = MAPI_E_INVALID_PARAMETER;
+		DEBUG(5, ("  unhandled 'origin' type: %d\n", request->origin));
+		goto end;
 	}
-	if (mapi_req->u.mapi_FindRow.ulFlags == DIR_BACKWARD) {
-		DEBUG(5, ("  only DIR_FORWARD is supported right now, using work-around\n"));
-		table->numerator = 0;
+	if (!forward && position >= table->denominator) {
+		position = (int64_t) table->denominator - 1;
 	}
 
-	memset (&row, 0, sizeof(DATA_BLOB));
-
-	switch (emsmdbp_is_mapistore(object)) {
-	case true:
-		/* Restrict rows to be fetched */
-		retval = mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object, &request.res, &status);
-		/* Then fetch rows */
-		/* Lookup the properties and check if we need to flag the PropertyRow blob */
-
-		while (!found && table->numerator < table->denominator) {
-                        flagged = 0;
+	/* Step 2. Restrict the rows for the time of the search */
+	if (emsmdbp_is_mapistore(object)) {
+		retval = mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object, &request->res, &status);
+	}
+	else {
+		retval = openchangedb_table_set_restrictions(object->backend_object, &request->res);
+	}
 
-			data_pointers = emsmdbp_object_table_get_row_props(NULL, emsmdbp_ctx, object, table->numerator, MAPISTORE_LIVEFILTERED_QUERY, &retvals);
-			if (data_pointers) {
+	/* Step 3. Check the restriction on batches of rows, released
+	 * together. The columns are only pushed for the matching row. */
+	while (!found && position >= 0 && position < table->denominator) {
+		batch_ctx = talloc_new(NULL);
+		for (i = 0; i < EMSMDBP_FINDROW_BATCH_SIZE && position >= 0 && position < table->denominator; i++) {
+			if (oxctabl_row_matches(batch_ctx, emsmdbp_ctx, object, position)) {
 				found = true;
-				for (i = 0; i < table->prop_count; i++) {
-					if (retvals[i] != MAPI_E_SUCCESS) {
-						flagged = 1;
-					}
-				}
-
-				if (flagged) {
-					libmapiserver_push_property(mem_ctx, 
-								    0x0000000b, (const void *)&flagged,
-								    &row, 0, 0, 0);
-				}
-				else {
-					libmapiserver_push_property(mem_ctx, 
-								    0x00000000, (const void *)&flagged,
-								    &row, 0, 1, 0);
-				}
-                                
-				/* Push the properties */
-				for (i = 0; i < table->prop_count; i++) {
-					property = table->properties[i];
-					retval = retvals[i];
-					if (retval == MAPI_E_NOT_FOUND) {
-						property = (property & 0xFFFF0000) + PT_ERROR;
-						data = &retval;
-					}
-					else {
-						data = data_pointers[i];
-					}
-                                
-					libmapiserver_push_property(mem_ctx,
-								    property, data, &row,
-								    flagged?PT_ERROR:0, flagged, 0);
-				}
-				talloc_free(retvals);
-				talloc_free(data_pointers);
-                        }
-                        else {
-				table->numerator++;
+				break;
 			}
+			position += forward ? 1 : -1;
 		}
+		talloc_free(batch_ctx);
+	}
 
-		retval = mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object, NULL, &status);
-
-		/* Adjust parameters */
-		if (found) {
+	/* Step 4. Read the columns of the matching row */
+	if (found) {
+		data_pointers = emsmdbp_object_table_get_row_props(mem_ctx, emsmdbp_ctx, object, position, MAPISTORE_LIVEFILTERED_QUERY, &retvals);
+		if (data_pointers) {
+			ndr = ndr_push_init_ctx(mem_ctx);
+			ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+			libmapiserver_push_PropertyRow(ndr, table->prop_count, table->properties, data_pointers, retvals);
+			mapi_repl->u.mapi_FindRow.row.data = talloc_steal(mem_ctx, ndr->data);
+			mapi_repl->u.mapi_FindRow.row.length = ndr->offset;
 			mapi_repl->u.mapi_FindRow.HasRowData = 1;
+			talloc_free(ndr);
+			talloc_free(retvals);
+			talloc_free(data_pointers);
 		}
 		else {
-                        mapi_repl->error_code = MAPI_E_NOT_FOUND;
+			found = false;
 		}
+	}
 
-		mapi_repl->u.mapi_FindRow.row.length = row.length;
-		mapi_repl->u.mapi_FindRow.row.data = row.data;
-
-		break;
-	case false:
-		memset (&row, 0, sizeof(DATA_BLOB));
-		DEBUG(0, ("FindRow for openchangedb\n"));
-		/* Restrict rows to be fetched */
-		retval = openchangedb_table_set_restrictions(object->backend_object, &request.res);
-		/* Then fetch rows */
-		/* Lookup the properties and check if we need to flag the PropertyRow blob */
-		while (!found && table->numerator < table->denominator) {
-                        flagged = 0;
-
-			data_pointers = emsmdbp_object_table_get_row_props(NULL, emsmdbp_ctx, object, table->numerator, MAPISTORE_LIVEFILTERED_QUERY, &retvals);
-			if (data_pointers) {
-				found = true;
-				for (i = 0; i < table->prop_count; i++) {
-					if (retvals[i] != MAPI_E_SUCCESS) {
-						flagged = 1;
-					}
-				}
-
-				if (flagged) {
-					libmapiserver_push_property(mem_ctx, 
-								    0x0000000b, (const void *)&flagged,
-								    &row, 0, 0, 0);
-				}
-				else {
-					libmapiserver_push_property(mem_ctx, 
-								    0x00000000, (const void *)&flagged,
-								    &row, 0, 1, 0);
-				}
-                                
-				/* Push the properties */
-				for (i = 0; i < table->prop_count; i++) {
-					property = table->properties[i];
-					retval = retvals[i];
-					if (retval == MAPI_E_NOT_FOUND) {
-						property = (property & 0xFFFF0000) + PT_ERROR;
-						data = &retval;
-					}
-					else {
-						data = data_pointers[i];
-					}
-                                
-					libmapiserver_push_property(mem_ctx,
-								    property, data, &row,
-								    flagged?PT_ERROR:0, flagged, 0);
-				}
-				talloc_free(retvals);
-				talloc_free(data_pointers);
-                        } else {
-				table->numerator++;
-			}
-		}
-		/* Reset restrictions */
+	/* Reset restrictions */
+	if (emsmdbp_is_mapistore(object)) {
+		retval = mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object, NULL, &status);
+	}
+	else {
 		openchangedb_table_set_restrictions(object->backend_object, NULL);
+	}
 
-		/* Adjust parameters */
-		if (found) {
-			mapi_repl->u.mapi_FindRow.HasRowData = 1;
-		}
-		else {
-                        mapi_repl->error_code = MAPI_E_NOT_FOUND;
+	/* Adjust parameters: the cursor is left at the end of the table
+	 * searched when no row matches */
+	if (found) {
+		table->numerator = position;
+	}
+	else {
+		table->numerator = forward ? table->denominator : 0;
+		mapi_repl->error_code = MAPI_E_NOT_FOUND;
+	}
+
+end:
+	*size += libmapiserver_RopFindRow_size(mapi_repl);
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details EcDoRpc ExpandRow (0x59) Rop. This operation expands a
+   collapsed category of a categorized table and returns the rows made
+   visible.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_req pointer to the ExpandRow EcDoRpc_MAPI_REQ
+   structure
+   \param mapi_repl pointer to the ExpandRow EcDoRpc_MAPI_REPL
+   structure
+   \param handles pointer to the MAPI handles array
+   \param size pointer to the mapi_response size to update
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS EcDoRpc_RopExpandRow(TALLOC_CTX *mem_ctx,
+					      struct emsmdbp_context *emsmdbp_ctx,
+					      struct EcDoRpc_MAPI_REQ *mapi_req,
+					      struct EcDoRpc_MAPI_REPL *mapi_repl,
+					      uint32_t *handles, uint16_t *size)
+{
+	enum MAPISTATUS			retval;
+	enum mapistore_error		ret;
+	struct mapi_handles		*parent;
+	struct emsmdbp_object		*object;
+	struct emsmdbp_object_table	*table;
+	struct ExpandRow_req		*request;
+	struct ExpandRow_repl		*response;
+	void				*data;
+	enum MAPISTATUS			*retvals;
+	void				**data_pointers;
+	struct ndr_push			*ndr;
+	uint32_t			handle, position, expanded, max, i;
+
+	DEBUG(4, ("exchange_emsmdb: [OXCTABL] ExpandRow (0x59)\n"));
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_req, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_repl, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
+
+	request = &mapi_req->u.mapi_ExpandRow;
+	response = &mapi_repl->u.mapi_ExpandRow;
+
+	mapi_repl->opnum = mapi_req->opnum;
+	mapi_repl->handle_idx = mapi_req->handle_idx;
+	mapi_repl->error_code = MAPI_E_SUCCESS;
+	response->ExpandedRowCount = 0;
+	response->RowCount = 0;
+	response->RowData.length = 0;
+	response->RowData.data = NULL;
+
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &parent);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(parent, &data);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		DEBUG(5, ("  handle data not found, idx = %x\n", mapi_req->handle_idx));
+		goto end;
+	}
+	object = (struct emsmdbp_object *) data;
+
+	/* Ensure referring object exists and is a table */
+	if (!object || (object->type != EMSMDBP_OBJECT_TABLE)) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  missing object or not table\n"));
+		goto end;
+	}
+	table = object->object.table;
+
+	/* Categories are only kept for mapistore tables */
+	if (!emsmdbp_is_mapistore(object)) {
+		mapi_repl->error_code = MAPI_E_NO_SUPPORT;
+		DEBUG(5, ("  categories not supported on openchangedb tables\n"));
+		goto end;
+	}
+
+	ret = mapistore_table_expand_row(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object,
+					 request->CategoryId, &position, &expanded);
+	if (ret != MAPISTORE_SUCCESS) {
+		mapi_repl->error_code = mapistore_error_to_mapi(ret);
+		goto end;
+	}
+	response->ExpandedRowCount = expanded;
+
+	/* Rows are inserted after the header row */
+	table->denominator += expanded;
+	if (table->numerator > position) {
+		table->numerator += expanded;
+	}
+	emsmdbp_object_table_shift_bookmarks(table, position, expanded, false);
+
+	max = (request->MaxRowCount < expanded) ? request->MaxRowCount : expanded;
+	if (!max) {
+		goto end;
+	}
+
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	for (i = position + 1; i <= position + max; i++) {
+		data_pointers = emsmdbp_object_table_get_row_props(mem_ctx, emsmdbp_ctx, object, i, MAPISTORE_PREFILTERED_QUERY, &retvals);
+		if (!data_pointers) {
+			break;
 		}
+		libmapiserver_push_PropertyRow(ndr, table->prop_count, table->properties, data_pointers, retvals);
+		talloc_free(retvals);
+		talloc_free(data_pointers);
+		response->RowCount++;
+	}
+	if (response->RowCount) {
+		response->RowData.data = talloc_steal(mem_ctx, ndr->data);
+		response->RowData.length = ndr->offset;
+	}
+	talloc_free(ndr);
 
-		mapi_repl->u.mapi_FindRow.row.length = row.length;
-		mapi_repl->u.mapi_FindRow.row.data = row.data;
-		break;
+end:
+	*size += libmapiserver_RopExpandRow_size(mapi_repl);
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details EcDoRpc CollapseRow (0x5a) Rop. This operation collapses
+   an expanded category of a categorized table.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_req pointer to the CollapseRow EcDoRpc_MAPI_REQ
+   structure
+   \param mapi_repl pointer to the CollapseRow EcDoRpc_MAPI_REPL
+   structure
+   \param handles pointer to the MAPI handles array
+   \param size pointer to the mapi_response size to update
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS EcDoRpc_RopCollapseRow(TALLOC_CTX *mem_ctx,
+						struct emsmdbp_context *emsmdbp_ctx,
+						struct EcDoRpc_MAPI_REQ *mapi_req,
+						struct EcDoRpc_MAPI_REPL *mapi_repl,
+						uint32_t *handles, uint16_t *size)
+{
+	enum MAPISTATUS			retval;
+	enum mapistore_error		ret;
+	struct mapi_handles		*parent;
+	struct emsmdbp_object		*object;
+	struct emsmdbp_object_table	*table;
+	void				*data;
+	uint32_t			handle, position, collapsed;
+
+	DEBUG(4, ("exchange_emsmdb: [OXCTABL] CollapseRow (0x5a)\n"));
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_req, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_repl, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
+
+	mapi_repl->opnum = mapi_req->opnum;
+	mapi_repl->handle_idx = mapi_req->handle_idx;
+	mapi_repl->error_code = MAPI_E_SUCCESS;
+	mapi_repl->u.mapi_CollapseRow.CollapsedRowCount = 0;
+
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &parent);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(parent, &data);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		DEBUG(5, ("  handle data not found, idx = %x\n", mapi_req->handle_idx));
+		goto end;
+	}
+	object = (struct emsmdbp_object *) data;
+
+	/* Ensure referring object exists and is a table */
+	if (!object || (object->type != EMSMDBP_OBJECT_TABLE)) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  missing object or not table\n"));
+		goto end;
+	}
+	table = object->object.table;
+
+	/* Categories are only kept for mapistore tables */
+	if (!emsmdbp_is_mapistore(object)) {
+		mapi_repl->error_code = MAPI_E_NO_SUPPORT;
+		DEBUG(5, ("  categories not supported on openchangedb tables\n"));
+		goto end;
+	}
+
+	ret = mapistore_table_collapse_row(emsmdbp_ctx->mstore_ctx, emsmdbp_get_contextID(object), object->backend_object,
+					   mapi_req->u.mapi_CollapseRow.CategoryId, &position, &collapsed);
+	if (ret != MAPISTORE_SUCCESS) {
+		mapi_repl->error_code = mapistore_error_to_mapi(ret);
+		goto end;
+	}
+	mapi_repl->u.mapi_CollapseRow.CollapsedRowCount = collapsed;
+
+	/* A cursor on one of the hidden rows moves to the row following
+	   the category */
+	table->denominator -= collapsed;
+	if (table->numerator > position + collapsed) {
+		table->numerator -= collapsed;
 	}
+	else if (table->numerator > position) {
+		table->numerator = position + 1;
+	}
+	emsmdbp_object_table_shift_bookmarks(table, position, collapsed, true);
 
 end:
-	*size += libmapiserver_RopFindRow_size(mapi_repl);
+	*size += libmapiserver_RopCollapseRow_size(mapi_repl);
 
 	return MAPI_E_SUCCESS;
 }
@@ -915,8 +1334,8 @@ end:
 /**
    \details EcDoRpc ResetTable (0x81) Rop. This operation resets the
    table as follows:
-     - Removes the existing column set, restriction, and sort order (ignored) from the table.
-     - Invalidates bookmarks. (ignored)
+     - Removes the existing column set, restriction, and sort order from the table.
+     - Invalidates bookmarks.
      - Resets the cursor to the beginning of the table.
 
    \param mem_ctx pointer to the memory context
@@ -941,6 +1360,7 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopResetTable(TALLOC_CTX *mem_ctx,
 	struct emsmdbp_object		*object;
 	struct emsmdbp_object_table	*table;
 	void				*data;
+	struct SSortOrderSet		sort_order;
 	uint32_t			handle, contextID;
 	uint8_t				status; /* ignored */
 
@@ -995,10 +1415,12 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopResetTable(TALLOC_CTX *mem_ctx,
 			table->prop_count = 0;
 		}
 
-		/* 1.2. empty restrictions */
+		/* 1.2. empty restrictions and sort order */
 		if (emsmdbp_is_mapistore(object)) {
 			contextID = emsmdbp_get_contextID(object);
 			retval = mapistore_table_set_restrictions(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, NULL, &status);
+			memset(&sort_order, 0, sizeof (struct SSortOrderSet));
+			mapistore_table_set_sort_order(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, &sort_order, &status);
 			mapistore_table_get_row_count(emsmdbp_ctx->mstore_ctx, contextID, object->backend_object, MAPISTORE_PREFILTERED_QUERY, &object->object.table->denominator);
 		} else {
 			DEBUG(0, ("  mapistore Restrict: Not implemented yet\n"));
@@ -1007,9 +1429,90 @@ _PUBLIC_ enum MAPISTATUS EcDoRpc_RopResetTable(TALLOC_CTX *mem_ctx,
 
 		/* 3. reset the cursor to the beginning of the table. */
 		table->numerator = 0;
+		emsmdbp_object_table_reset_bookmarks(table);
+	}
+
+end:
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details EcDoRpc FreeBookmark (0x89) Rop. This operation releases a
+   bookmark created with CreateBookmark.
+
+   \param mem_ctx pointer to the memory context
+   \param emsmdbp_ctx pointer to the emsmdb provider context
+   \param mapi_req pointer to the FreeBookmark EcDoRpc_MAPI_REQ
+   structure
+   \param mapi_repl pointer to the FreeBookmark EcDoRpc_MAPI_REPL
+   structure
+   \param handles pointer to the MAPI handles array
+   \param size pointer to the mapi_response size to update
+
+   \return MAPI_E_SUCCESS on success, otherwise MAPI error
+ */
+_PUBLIC_ enum MAPISTATUS EcDoRpc_RopFreeBookmark(TALLOC_CTX *mem_ctx,
+						 struct emsmdbp_context *emsmdbp_ctx,
+						 struct EcDoRpc_MAPI_REQ *mapi_req,
+						 struct EcDoRpc_MAPI_REPL *mapi_repl,
+						 uint32_t *handles, uint16_t *size)
+{
+	enum MAPISTATUS			retval;
+	struct mapi_handles		*parent;
+	struct emsmdbp_object		*object;
+	struct emsmdbp_object_table	*table;
+	struct emsmdbp_table_bookmark	*bookmark;
+	void				*data;
+	uint32_t			handle;
+
+	DEBUG(4, ("exchange_emsmdb: [OXCTABL] FreeBookmark (0x89)\n"));
+
+	/* Sanity checks */
+	OPENCHANGE_RETVAL_IF(!emsmdbp_ctx, MAPI_E_NOT_INITIALIZED, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_req, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!mapi_repl, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!handles, MAPI_E_INVALID_PARAMETER, NULL);
+	OPENCHANGE_RETVAL_IF(!size, MAPI_E_INVALID_PARAMETER, NULL);
+
+	mapi_repl->opnum = mapi_req->opnum;
+	mapi_repl->handle_idx = mapi_req->handle_idx;
+	mapi_repl->error_code = MAPI_E_SUCCESS;
+
+	handle = handles[mapi_req->handle_idx];
+	retval = mapi_handles_search(emsmdbp_ctx->handles_ctx, handle, &parent);
+	if (retval) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  handle (%x) not found: %x\n", handle, mapi_req->handle_idx));
+		goto end;
+	}
+
+	retval = mapi_handles_get_private_data(parent, &data);
+	if (retval) {
+		mapi_repl->error_code = retval;
+		DEBUG(5, ("  handle data not found, idx = %x\n", mapi_req->handle_idx));
+		goto end;
+	}
+	object = (struct emsmdbp_object *) data;
+
+	/* Ensure object exists and is table type */
+	if (!object || (object->type != EMSMDBP_OBJECT_TABLE)) {
+		mapi_repl->error_code = MAPI_E_INVALID_OBJECT;
+		DEBUG(5, ("  no object or object is not a table\n"));
+		goto end;
+	}
+	table = object->object.table;
+
+	bookmark = emsmdbp_object_table_get_bookmark(table, &mapi_req->u.mapi_FreeBookmark.bookmark);
+	if (!bookmark) {
+		mapi_repl->error_code = MAPI_E_INVALID_BOOKMARK;
+		DEBUG(5, ("  invalid bookmark\n"));
+		goto end;
 	}
+	bookmark->used = false;
 
 end:
+	*size += libmapiserver_RopFreeBookmark_size(mapi_repl);
 
 	return MAPI_E_SUCCESS;
 }
@@ -21,7 +21,7 @@ DemoApp::DemoApp()
     
     addFolderDockWidget();
     addMessagesDockWidget();
-    openMessage( 0 );
+    openMessage( m_messagesModel->index( 0, 0 ) );
       
     resize( 1100, 900 );
 }
@@ -90,11 +90,11 @@ void DemoApp::addMessagesDockWidget()
 
     // Open Inbox Folder
     m_folder = new folder(m_mapi_session->get_message_store(), inbox_id);
-    MessagesModel *messages = new MessagesModel( m_folder );
     
     m_messagesDockView = new QTableView( messagesDock );
-    m_messagesModel = messages->buildModel();
+    m_messagesModel = new MessagesModel( m_folder, this );
     m_messagesDockView->setModel( m_messagesModel );
+    m_messagesDockView->setSortingEnabled( true );
     m_messagesDockView->setShowGrid( false );
     m_messagesDockView->resizeColumnsToContents();
     m_messagesDockView->resizeRowsToContents();
@@ -109,38 +109,25 @@ void DemoApp::folderChanged(const QModelIndex &index)
     QStandardItem *item = m_folderModel->itemFromIndex( index );
     if (item) {
 	qlonglong folderId = item->data().toLongLong();
+	MessagesModel *previousModel = m_messagesModel;
+	folder *previousFolder = m_folder;
 	m_folder = new folder(m_mapi_session->get_message_store(), folderId);
-	MessagesModel *messages = new MessagesModel( m_folder );
-	m_messagesModel = messages->buildModel();
+	m_messagesModel = new MessagesModel( m_folder, this );
 	m_messagesDockView->setModel( m_messagesModel );
+	delete previousModel;
+	delete previousFolder;
     }
 }
 
 void DemoApp::messageChanged( const QModelIndex &index )
 {
-    QStandardItem *item = m_messagesModel->itemFromIndex( index );
-    if ( item ) {
-	quint32 messageNumber = item->data().toUInt();
-	openMessage( messageNumber );
-    }
+    openMessage( index );
 }
 
-void DemoApp::openMessage( quint32 messageNumber )
+void DemoApp::openMessage( const QModelIndex &index )
 {
-    libmapipp::folder::message_container_type messages = m_folder->fetch_messages();
-    // std::cout << "Folder contains " << messages.size() << " messages" << std::endl;
-
-    // Get the properties we are interested in
-    libmapipp::property_container msg_props = messages[messageNumber]->get_property_container();
-    msg_props << PR_BODY_HTML;
-    msg_props.fetch();
-
-    if ( msg_props[PR_BODY_HTML] ) {
-	QString body = QString( (const char*)msg_props[PR_BODY_HTML] );
-	m_textEdit->setHtml( body );
-    } else {
-	m_textEdit->setHtml( QString() );
-    }
+    // Only the selected message is opened, the model holds table rows only
+    m_textEdit->setHtml( m_messagesModel->messageBody( index ) );
 }
 
 #include "demoapp.moc"
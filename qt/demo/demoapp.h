@@ -9,6 +9,7 @@ class QMenu;
 class QTextEdit;
 class QStandardItem;
 class QTableView;
+class MessagesModel;
 
 namespace libmapipp
 {
@@ -37,7 +38,7 @@ class DemoApp : public QMainWindow
     void addFolderDockWidget();
     void addMessagesDockWidget();
     
-    void openMessage( quint32 messageNumber );
+    void openMessage( const QModelIndex &index );
 
     QMenu *m_fileMenu;
     QMenu *m_helpMenu;
@@ -49,7 +50,7 @@ class DemoApp : public QMainWindow
     QStandardItemModel *m_folderModel;
     
     QTableView *m_messagesDockView;
-    QStandardItemModel *m_messagesModel;
+    MessagesModel *m_messagesModel;
     
     libmapipp::folder *m_folder;
     QTextEdit *m_textEdit;
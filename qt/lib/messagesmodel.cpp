@@ -1,55 +1,283 @@
 #include "messagesmodel.h"
 
+#include <QFont>
+
+#include <iostream>
+
 #include <libmapi++/libmapi++.h>
 
 using namespace libmapipp;
 
-MessagesModel::MessagesModel( libmapipp::folder *folder ):
-  m_mapi_folder( folder )
+// Rows requested per QueryRows when the view needs more data
+static const int windowSize = 100;
+
+// Maximum number of rows kept in memory
+static const int cacheSize = 2000;
+
+static QDateTime fromFileTime( const struct FILETIME *filetime )
+{
+    if ( !filetime ) {
+	return QDateTime();
+    }
+
+    quint64 nt = ( (quint64) filetime->dwHighDateTime << 32 ) | filetime->dwLowDateTime;
+    // 100ns intervals since 1601-01-01
+    return QDateTime::fromTime_t( (uint) ( nt / 10000000ULL - 11644473600ULL ) );
+}
+
+MessagesModel::MessagesModel( libmapipp::folder *folder, QObject *parent ):
+  QAbstractTableModel( parent ),
+  m_mapi_folder( folder ),
+  m_contents_table( new table( *folder, table::contents_table ) ),
+  m_fetched_rows( 0 ),
+  m_fetch_failed( false ),
+  m_fetch_complete( false ),
+  m_rows( cacheSize )
+{
+    SPropTagArray *property_tag_array = set_SPropTagArray( folder->get_session().get_memory_ctx(), 0x6,
+							   PR_MID, PR_SUBJECT_UNICODE, PR_SENDER_NAME_UNICODE,
+							   PR_MESSAGE_DELIVERY_TIME, PR_MESSAGE_SIZE, PR_MESSAGE_FLAGS );
+    try {
+	m_contents_table->set_columns( property_tag_array );
+    } catch ( mapi_exception e ) {
+	MAPIFreeBuffer( property_tag_array );
+	delete m_contents_table;
+	throw;
+    }
+    MAPIFreeBuffer( property_tag_array );
+}
+
+MessagesModel::~MessagesModel()
+{
+    delete m_contents_table;
+}
+
+int MessagesModel::rowCount( const QModelIndex &parent ) const
+{
+    if ( parent.isValid() ) {
+	return 0;
+    }
+    return m_fetched_rows;
+}
+
+int MessagesModel::columnCount( const QModelIndex &parent ) const
 {
+    if ( parent.isValid() ) {
+	return 0;
+    }
+    return ColumnCount;
+}
+
+bool MessagesModel::canFetchMore( const QModelIndex &parent ) const
+{
+    if ( parent.isValid() || m_fetch_failed || m_fetch_complete ) {
+	return false;
+    }
+    return (quint32) m_fetched_rows < m_contents_table->get_row_count();
+}
+
+void MessagesModel::fetchMore( const QModelIndex &parent )
+{
+    if ( parent.isValid() ) {
+	return;
+    }
+
+    int remaining = m_contents_table->get_row_count() - m_fetched_rows;
+    if ( remaining <= 0 ) {
+	return;
+    }
+
+    // Only the rows actually read are shown, the table may have shrunk
+    int count;
+    try {
+	count = readWindow( m_fetched_rows );
+    } catch ( mapi_exception e ) {
+	// Stop fetching, the rows read so far stay visible
+	fetchFailed( e );
+	return;
+    }
+    if ( count == 0 ) {
+	m_fetch_complete = true;
+	return;
+    }
+
+    beginInsertRows( QModelIndex(), m_fetched_rows, m_fetched_rows + count - 1 );
+    m_fetched_rows += count;
+    endInsertRows();
 }
-    
-QStandardItemModel* MessagesModel::buildModel()
+
+unsigned int MessagesModel::readWindow( int position ) const
 {
-    // Fetch messages in Inbox Folder
-    folder::message_container_type messages = m_mapi_folder->fetch_messages();
+    SRowSet row_set;
+    unsigned int count;
+
+    m_contents_table->read_rows( position, windowSize, row_set );
+
+    for ( unsigned int i = 0; i < row_set.cRows; ++i ) {
+	SRow *aRow = &row_set.aRow[i];
+	MessageRow *messageRow = new MessageRow;
+
+	const uint64_t *mid = static_cast< const uint64_t * >( find_SPropValue_data( aRow, PR_MID ) );
+	const char *subject = static_cast< const char * >( find_SPropValue_data( aRow, PR_SUBJECT_UNICODE ) );
+	const char *from = static_cast< const char * >( find_SPropValue_data( aRow, PR_SENDER_NAME_UNICODE ) );
+	const uint32_t *size = static_cast< const uint32_t * >( find_SPropValue_data( aRow, PR_MESSAGE_SIZE ) );
+	const uint32_t *flags = static_cast< const uint32_t * >( find_SPropValue_data( aRow, PR_MESSAGE_FLAGS ) );
+
+	messageRow->mid = mid ? *mid : 0;
+	messageRow->subject = QString::fromUtf8( subject ? subject : "" );
+	messageRow->from = QString::fromUtf8( from ? from : "" );
+	messageRow->date = fromFileTime( static_cast< const struct FILETIME * >( find_SPropValue_data( aRow, PR_MESSAGE_DELIVERY_TIME ) ) );
+	messageRow->size = size ? *size : 0;
+	messageRow->flags = flags ? *flags : 0;
 
-    QStandardItemModel *messagesModel = new QStandardItemModel();
-    QStringList messagesModelHeaders;
-    messagesModelHeaders << QString( "Topic" ) << QString( "To" ) << QString( "From" );
-    messagesModel->setHorizontalHeaderLabels( messagesModelHeaders );
+	m_rows.insert( position + i, messageRow );
+    }
+
+    count = row_set.cRows;
+    MAPIFreeBuffer( row_set.aRow );
+
+    return count;
+}
+
+const MessagesModel::MessageRow *MessagesModel::row( int position ) const
+{
+    if ( !m_rows.contains( position ) ) {
+	if ( m_fetch_failed ) {
+	    return 0;
+	}
+	readWindow( position );
+    }
+    return m_rows.object( position );
+}
 
-    for ( unsigned int i = 0; i < messages.size(); ++i ) {
-	property_container message_property_container = messages[i]->get_property_container();
+void MessagesModel::fetchFailed( const mapi_exception &e ) const
+{
+    std::cout << "MAPI Exception @ MessagesModel: " << e.what() << std::endl;
+    m_fetch_failed = true;
+}
 
-	// Add Property Tags to be fetched and then fetch the properties.
-	message_property_container << PR_DISPLAY_TO << PR_CONVERSATION_TOPIC << PR_SENDER_NAME;
-	message_property_container.fetch_all();
+QVariant MessagesModel::data( const QModelIndex &index, int role ) const
+{
+    if ( !index.isValid() || index.row() >= m_fetched_rows ) {
+	return QVariant();
+    }
 
-	std::string to;
-	std::string subject;
-	std::string from;
+    const MessageRow *messageRow;
+    try {
+	messageRow = row( index.row() );
+    } catch ( mapi_exception e ) {
+	// Don't hit the server again on every repaint
+	fetchFailed( e );
+	return QVariant();
+    }
+    if ( !messageRow ) {
+	return QVariant();
+    }
 
-	for (property_container::iterator Iter = message_property_container.begin(); Iter != message_property_container.end(); Iter++)
-	{
-		if (Iter.get_tag() == PR_DISPLAY_TO)
-			to = (const char*) *Iter;
-		else if (Iter.get_tag() == PR_CONVERSATION_TOPIC)
-			subject = (const char*) *Iter;
-		else if (Iter.get_tag() == PR_SENDER_NAME)
-			from = (const char*) *Iter;
+    if ( role == Qt::DisplayRole ) {
+	switch ( index.column() ) {
+	case SubjectColumn:
+	    return messageRow->subject;
+	case FromColumn:
+	    return messageRow->from;
+	case DateColumn:
+	    return messageRow->date;
+	case SizeColumn:
+	    return messageRow->size;
 	}
-	QList< QStandardItem * > row;
-	row << new QStandardItem( QString::fromStdString( subject ) );
-	row[0]->setData( (quint32) i );
-	row << new QStandardItem( QString::fromStdString( to ) );
-	row << new QStandardItem( QString::fromStdString( from ) );
-	messagesModel->appendRow( row );
+    } else if ( role == Qt::FontRole ) {
+	if ( !( messageRow->flags & MSGFLAG_READ ) ) {
+	    QFont font;
+	    font.setBold( true );
+	    return font;
+	}
+    } else if ( role == Qt::UserRole ) {
+	return messageRow->mid;
+    }
+
+    return QVariant();
+}
+
+QVariant MessagesModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+    if ( orientation != Qt::Horizontal || role != Qt::DisplayRole ) {
+	return QVariant();
+    }
+
+    switch ( section ) {
+    case SubjectColumn:
+	return QString( "Subject" );
+    case FromColumn:
+	return QString( "From" );
+    case DateColumn:
+	return QString( "Date" );
+    case SizeColumn:
+	return QString( "Size" );
+    }
+    return QVariant();
+}
+
+void MessagesModel::sort( int column, Qt::SortOrder order )
+{
+    uint32_t sortTag;
+
+    switch ( column ) {
+    case SubjectColumn:
+	sortTag = PR_SUBJECT_UNICODE;
+	break;
+    case FromColumn:
+	sortTag = PR_SENDER_NAME_UNICODE;
+	break;
+    case DateColumn:
+	sortTag = PR_MESSAGE_DELIVERY_TIME;
+	break;
+    case SizeColumn:
+	sortTag = PR_MESSAGE_SIZE;
+	break;
+    default:
+	return;
+    }
+
+    struct SSortOrderSet *sortOrderSet = talloc_zero( m_mapi_folder->get_session().get_memory_ctx(), struct SSortOrderSet );
+    sortOrderSet->cSorts = 1;
+    sortOrderSet->aSort = talloc_zero( sortOrderSet, struct SSortOrder );
+    sortOrderSet->aSort[0].ulPropTag = (enum MAPITAGS) sortTag;
+    sortOrderSet->aSort[0].ulOrder = ( order == Qt::AscendingOrder ) ? TABLE_SORT_ASCEND : TABLE_SORT_DESCEND;
+
+    emit layoutAboutToBeChanged();
+    try {
+	m_contents_table->sort( sortOrderSet );
+    } catch ( mapi_exception e ) {
+	// keep the previous order
     }
-    
-    return messagesModel;
+    talloc_free( sortOrderSet );
+
+    // Positions no longer match the cached rows
+    m_rows.clear();
+    emit layoutChanged();
 }
 
+QString MessagesModel::messageBody( const QModelIndex &index ) const
+{
+    QVariant mid = data( index, Qt::UserRole );
+    if ( !mid.isValid() ) {
+	return QString();
+    }
+
+    try {
+	message mapi_message( m_mapi_folder->get_session(), m_mapi_folder->get_id(), mid.toULongLong() );
 
+	property_container msg_props = mapi_message.get_property_container();
+	msg_props << PR_BODY_HTML;
+	msg_props.fetch();
+
+	if ( msg_props[PR_BODY_HTML] ) {
+	    return QString::fromUtf8( (const char*)msg_props[PR_BODY_HTML] );
+	}
+    } catch ( mapi_exception e ) {
+    }
+
+    return QString();
+}
 
 #include "messagesmodel.moc"
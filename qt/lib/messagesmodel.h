@@ -1,27 +1,89 @@
 #ifndef MESSAGESMODEL_H
 #define MESSAGESMODEL_H
 
-class QStandardItem;
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QDateTime>
+#include <QString>
 
 namespace libmapipp
 {
 class folder;
+class mapi_exception;
 class session;
+class table;
 }
 
+/*
+  Messages in a folder, read lazily from the folder's contents table.
 
-class MessagesModel : public QStandardItemModel
+  Only a narrow set of columns (subject, sender, date, size, flags) is
+  requested, one window of rows at a time as the view scrolls
+  (canFetchMore/fetchMore). Row data is kept in a bounded LRU cache and
+  evicted rows are read again from the table on demand. Message bodies
+  are only fetched by messageBody(), when a message is selected.
+*/
+class MessagesModel : public QAbstractTableModel
 {
     Q_OBJECT
-    
+
   public:
-    MessagesModel( libmapipp::folder *folder );
-    
-    QStandardItemModel *buildModel();
-    
+    enum Column {
+      SubjectColumn = 0,
+      FromColumn,
+      DateColumn,
+      SizeColumn,
+      ColumnCount
+    };
+
+    MessagesModel( libmapipp::folder *folder, QObject *parent = 0 );
+    ~MessagesModel();
+
+    int rowCount( const QModelIndex &parent = QModelIndex() ) const;
+    int columnCount( const QModelIndex &parent = QModelIndex() ) const;
+    QVariant data( const QModelIndex &index, int role = Qt::DisplayRole ) const;
+    QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
+
+    bool canFetchMore( const QModelIndex &parent ) const;
+    void fetchMore( const QModelIndex &parent );
+
+    // Delegated to the server with SortTable
+    void sort( int column, Qt::SortOrder order = Qt::AscendingOrder );
+
+    // Opens the message and fetches its body. Returns an empty string on failure.
+    QString messageBody( const QModelIndex &index ) const;
+
   private:
+    struct MessageRow {
+      quint64 mid;
+      QString subject;
+      QString from;
+      QDateTime date;
+      quint32 size;
+      quint32 flags;
+    };
+
+    // Both throw libmapipp::mapi_exception if the rows can't be read.
+    // readWindow returns the number of rows actually read.
+    const MessageRow *row( int position ) const;
+    unsigned int readWindow( int position ) const;
+
+    // Reports a failed read and stops reading from the table
+    void fetchFailed( const libmapipp::mapi_exception &e ) const;
+
     libmapipp::folder *m_mapi_folder;
+    libmapipp::table *m_contents_table;
+
+    // Rows made visible to the view so far, at most the table row count
+    int m_fetched_rows;
+
+    // Set once a read from the table failed, no more rows are read then
+    mutable bool m_fetch_failed;
+
+    // Set once a read returned no row, the table shrank since it was counted
+    bool m_fetch_complete;
+
+    mutable QCache< int, MessageRow > m_rows;
 };
 
 #endif
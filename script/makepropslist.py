@@ -888,7 +888,7 @@ int pymapi_add_properties(PyObject *m)
 	f.close()
 
 	# write canonical properties out for openchangedb - probably remove this later
-	proplines = []
+	pidtags = []
 	previous_idl_proptags = []
 	previous_idl_pidtags = []
 	f = open('mapiproxy/libmapiproxy/openchangedb_property.c', 'w')
@@ -904,6 +904,7 @@ struct pidtags {
 	const char	*pidtag;
 };
 
+/* sorted by property tag */
 static struct pidtags pidtags[] = {
 """)
 	for entry in properties:
@@ -914,41 +915,54 @@ static struct pidtags pidtags[] = {
 			print "Section", entry["OXPROPS_Sect"], "has no data type entry"
 			continue
 		if entry.has_key("PropertyId"):
-			if entry["PropertyId"] in previous_idl_proptags:
-				pidtag = format(entry["PropertyId"], "04X") + knowndatatypes[entry["DataTypeName"]][2:]
-				if pidtag in previous_idl_pidtags:
-					print "Skipping output of pidtags entry for", entry["CanonicalName"], "(duplicate)"
-					continue
-				else:
-					propline = "\t{ " + string.ljust(entry["CanonicalName"] + ",", 68)
-					propline += "\"" + entry["CanonicalName"] + "\" },\n"
-					proplines.append(propline)
-					continue
-			propline = "\t{ " + string.ljust(entry["CanonicalName"] + ",", 68)
-			propline += "\"" + entry["CanonicalName"] + "\" },\n"
-			proplines.append(propline)
+			pidtag = format(entry["PropertyId"], "04X") + knowndatatypes[entry["DataTypeName"]][2:]
+			if pidtag in previous_idl_pidtags:
+				print "Skipping output of pidtags entry for", entry["CanonicalName"], "(duplicate)"
+				continue
+			pidtags.append((entry["CanonicalName"], int(pidtag, 16)))
 			previous_idl_proptags.append(entry["PropertyId"])
-			previous_idl_pidtags.append(format(entry["PropertyId"], "04X") + knowndatatypes[entry["DataTypeName"]][2:])
-	sortedproplines = sorted(proplines)
-	for propline in sortedproplines:
-		f.write(propline)
+			previous_idl_pidtags.append(pidtag)
+	# pidtags[] is binary searched by property tag
+	for (name, proptag) in sorted(pidtags, key=lambda pidtag: pidtag[1]):
+		f.write("\t{ " + string.ljust(name + ",", 68) + "\"" + name + "\" },\n")
 	f.write("""\t{ 0,                                                                   NULL         }
 };
 
+#define	PIDTAGS_COUNT	(ARRAY_SIZE(pidtags) - 1)
+
+/**
+   \details Return the LDB attribute name used to store a property
+
+   pidtags[] is sorted by property tag, so the lookup is a
+   binary search.
+
+   \param proptag the property tag to look up
+
+   \\return the attribute name on success, otherwise NULL
+ */
 _PUBLIC_ const char *openchangedb_property_get_attribute(uint32_t proptag)
 {
-	uint32_t i;
-	
-	for (i = 0; pidtags[i].pidtag; i++) {
-		if (pidtags[i].proptag == proptag) {
-			return pidtags[i].pidtag;
+	uint32_t	low = 0;
+	uint32_t	high = PIDTAGS_COUNT;
+	uint32_t	middle;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (pidtags[middle].proptag == proptag) {
+			return pidtags[middle].pidtag;
+		}
+		if (pidtags[middle].proptag < proptag) {
+			low = middle + 1;
+		} else {
+			high = middle;
 		}
 	}
-	DEBUG(0, ("[%s:%d]: Unsupported property tag '0x%.8x'\\n", __FUNCTION__, __LINE__, proptag));
-	
+	DEBUG(5, ("[%s:%d]: Unsupported property tag '0x%.8x'\\n", __FUNCTION__, __LINE__, proptag));
+
 	return NULL;
 }
 """)
+	f.close()
 
 previous_canonical_names = {}
 def check_duplicate_canonical_names():
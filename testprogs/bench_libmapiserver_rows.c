@@ -0,0 +1,271 @@
+/*
+   Benchmark for libmapiserver QueryRows reply encoding
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "libmapi/libmapi.h"
+#include "mapiproxy/libmapiserver/libmapiserver.h"
+#include "gen_ndr/ndr_exchange.h"
+
+#include <popt.h>
+#include <sys/time.h>
+
+#define	DEFAULT_ITERATIONS	200
+#define	DEFAULT_ROWS		100
+
+/* Columns Outlook typically sets on a message contents table */
+static enum MAPITAGS bench_columns[] = {
+	PidTagFolderId,
+	PidTagMid,
+	PidTagInstanceNum,
+	PidTagMessageFlags,
+	PidTagMessageSize,
+	PidTagHasAttachments,
+	PidTagLastModificationTime,
+	PidTagChangeKey,
+	PidTagMessageClass,
+	PidTagSubject
+};
+
+#define	BENCH_COLUMNS	(sizeof (bench_columns) / sizeof (bench_columns[0]))
+
+struct bench_row {
+	void			*data_pointers[BENCH_COLUMNS];
+	enum MAPISTATUS		retvals[BENCH_COLUMNS];
+};
+
+static double bench_elapsed(struct timeval *start)
+{
+	struct timeval	end;
+
+	gettimeofday(&end, NULL);
+	return (end.tv_sec - start->tv_sec) * 1000000.0 + (end.tv_usec - start->tv_usec);
+}
+
+static struct bench_row *bench_build_rows(TALLOC_CTX *mem_ctx, uint32_t count)
+{
+	struct bench_row	*rows;
+	struct Binary_r		*bin;
+	struct FILETIME		*ft;
+	uint64_t		*i8;
+	uint32_t		*l;
+	uint8_t			*b;
+	uint32_t		i;
+	uint32_t		j;
+
+	rows = talloc_array(mem_ctx, struct bench_row, count);
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < BENCH_COLUMNS; j++) {
+			rows[i].retvals[j] = MAPI_E_SUCCESS;
+			switch (bench_columns[j] & 0xFFFF) {
+			case PT_I8:
+				i8 = talloc(rows, uint64_t);
+				*i8 = ((uint64_t) (i + 1) << 16) | 0x1;
+				rows[i].data_pointers[j] = i8;
+				break;
+			case PT_LONG:
+				l = talloc(rows, uint32_t);
+				*l = i * 1024 + j;
+				rows[i].data_pointers[j] = l;
+				break;
+			case PT_BOOLEAN:
+				b = talloc(rows, uint8_t);
+				*b = i & 0x1;
+				rows[i].data_pointers[j] = b;
+				break;
+			case PT_SYSTIME:
+				ft = talloc(rows, struct FILETIME);
+				ft->dwLowDateTime = 0xd53e8000 + i;
+				ft->dwHighDateTime = 0x01cc0000;
+				rows[i].data_pointers[j] = ft;
+				break;
+			case PT_BINARY:
+				bin = talloc(rows, struct Binary_r);
+				bin->cb = 22;
+				bin->lpb = talloc_zero_array(bin, uint8_t, bin->cb);
+				bin->lpb[0] = i & 0xff;
+				rows[i].data_pointers[j] = bin;
+				break;
+			case PT_UNICODE:
+				rows[i].data_pointers[j] = talloc_asprintf(rows, "Synthetic message subject number %u", i);
+				break;
+			}
+		}
+		/* Flag one row out of four with a missing column */
+		if ((i % 4) == 3) {
+			rows[i].retvals[BENCH_COLUMNS - 2] = MAPI_E_NOT_FOUND;
+		}
+	}
+	return rows;
+}
+
+/* Previous encoding: one push context per value, blob reallocated each time */
+static void bench_push_legacy(TALLOC_CTX *mem_ctx, DATA_BLOB *blob, struct bench_row *row)
+{
+	uint32_t	i;
+	uint8_t		flagged = 0;
+	uint32_t	property;
+	uint32_t	retval;
+	void		*data;
+
+	for (i = 0; !flagged && i < BENCH_COLUMNS; i++) {
+		if (row->retvals[i] != MAPI_E_SUCCESS) {
+			flagged = 1;
+		}
+	}
+
+	if (flagged) {
+		libmapiserver_push_property(mem_ctx, 0x0000000b, (const void *)&flagged, blob, 0, 0, 0);
+	}
+	else {
+		libmapiserver_push_property(mem_ctx, 0x00000000, (const void *)&flagged, blob, 0, 1, 0);
+	}
+
+	for (i = 0; i < BENCH_COLUMNS; i++) {
+		property = bench_columns[i];
+		retval = row->retvals[i];
+		if (retval != MAPI_E_SUCCESS) {
+			property = (property & 0xFFFF0000) + PT_ERROR;
+			data = &retval;
+		}
+		else {
+			data = row->data_pointers[i];
+		}
+		libmapiserver_push_property(mem_ctx, property, data, blob, flagged ? PT_ERROR : 0, flagged, 0);
+	}
+}
+
+int main(int argc, const char *argv[])
+{
+	TALLOC_CTX			*mem_ctx;
+	TALLOC_CTX			*loop_ctx;
+	poptContext			pc;
+	int				opt;
+	int				opt_iterations = DEFAULT_ITERATIONS;
+	int				opt_rows = DEFAULT_ROWS;
+	struct bench_row		*rows;
+	struct EcDoRpc_MAPI_REPL	legacy_repl;
+	struct EcDoRpc_MAPI_REPL	repl;
+	struct ndr_push			*ndr;
+	struct timeval			start;
+	double				elapsed;
+	uint32_t			size;
+	int				i;
+	int				j;
+
+	enum {OPT_ITERATIONS=1000, OPT_ROWS};
+
+	struct poptOption long_options[] = {
+		POPT_AUTOHELP
+		{"iterations", 'n', POPT_ARG_INT, &opt_iterations, OPT_ITERATIONS, "number of QueryRows replies to encode", "COUNT"},
+		{"rows", 'r', POPT_ARG_INT, &opt_rows, OPT_ROWS, "number of rows per QueryRows reply", "COUNT"},
+		{ NULL, 0, POPT_ARG_NONE, NULL, 0, NULL, NULL }
+	};
+
+	pc = poptGetContext("bench_libmapiserver_rows", argc, argv, long_options, 0);
+
+	while ((opt = poptGetNextOpt(pc)) != -1);
+	poptFreeContext(pc);
+
+	if (opt_iterations <= 0) {
+		opt_iterations = DEFAULT_ITERATIONS;
+	}
+	if (opt_rows <= 0) {
+		opt_rows = DEFAULT_ROWS;
+	}
+
+	mem_ctx = talloc_named(NULL, 0, "bench_libmapiserver_rows");
+	rows = bench_build_rows(mem_ctx, opt_rows);
+
+	memset(&legacy_repl, 0, sizeof (struct EcDoRpc_MAPI_REPL));
+	legacy_repl.opnum = op_MAPI_QueryRows;
+	legacy_repl.error_code = MAPI_E_SUCCESS;
+	legacy_repl.u.mapi_QueryRows.RowCount = opt_rows;
+	repl = legacy_repl;
+
+	/* Both encoders must produce the same reply before timing anything */
+	for (j = 0; j < opt_rows; j++) {
+		bench_push_legacy(mem_ctx, &legacy_repl.u.mapi_QueryRows.RowData, &rows[j]);
+	}
+	ndr = ndr_push_init_ctx(mem_ctx);
+	ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+	size = 0;
+	for (j = 0; j < opt_rows; j++) {
+		libmapiserver_push_PropertyRow(ndr, BENCH_COLUMNS, bench_columns, rows[j].data_pointers, rows[j].retvals);
+		size += libmapiserver_PropertyRow_size(BENCH_COLUMNS, bench_columns, rows[j].data_pointers, rows[j].retvals);
+	}
+	repl.u.mapi_QueryRows.RowData.data = ndr->data;
+	repl.u.mapi_QueryRows.RowData.length = ndr->offset;
+
+	if (legacy_repl.u.mapi_QueryRows.RowData.length != repl.u.mapi_QueryRows.RowData.length
+	    || size != repl.u.mapi_QueryRows.RowData.length
+	    || memcmp(legacy_repl.u.mapi_QueryRows.RowData.data, repl.u.mapi_QueryRows.RowData.data,
+		      repl.u.mapi_QueryRows.RowData.length)) {
+		printf("FAILED: encoders disagree (%zu/%zu/%u bytes)\n",
+		       legacy_repl.u.mapi_QueryRows.RowData.length,
+		       repl.u.mapi_QueryRows.RowData.length, size);
+		talloc_free(mem_ctx);
+		return 1;
+	}
+
+	printf("%d replies of %d rows x %d columns, %d bytes per reply\n", opt_iterations, opt_rows,
+	       (int) BENCH_COLUMNS, libmapiserver_RopQueryRows_size(&repl));
+
+	/* Per-value push: one push context and one reallocation per value */
+	gettimeofday(&start, NULL);
+	for (i = 0; i < opt_iterations; i++) {
+		loop_ctx = talloc_new(mem_ctx);
+		memset(&legacy_repl.u.mapi_QueryRows.RowData, 0, sizeof (DATA_BLOB));
+		for (j = 0; j < opt_rows; j++) {
+			bench_push_legacy(loop_ctx, &legacy_repl.u.mapi_QueryRows.RowData, &rows[j]);
+		}
+		size = libmapiserver_RopQueryRows_size(&legacy_repl);
+		talloc_free(loop_ctx);
+	}
+	elapsed = bench_elapsed(&start);
+	printf("libmapiserver_push_property: %.3f us (%.1f us/reply)\n", elapsed, elapsed / opt_iterations);
+
+	/* Single pass: rows written at the cursor, size read from it */
+	gettimeofday(&start, NULL);
+	for (i = 0; i < opt_iterations; i++) {
+		ndr = ndr_push_init_ctx(mem_ctx);
+		ndr_set_flags(&ndr->flags, LIBNDR_FLAG_NOALIGN);
+		for (j = 0; j < opt_rows; j++) {
+			libmapiserver_push_PropertyRow(ndr, BENCH_COLUMNS, bench_columns, rows[j].data_pointers, rows[j].retvals);
+		}
+		repl.u.mapi_QueryRows.RowData.length = ndr->offset;
+		size = libmapiserver_RopQueryRows_size(&repl);
+		talloc_free(ndr);
+	}
+	elapsed = bench_elapsed(&start);
+	printf("libmapiserver_push_PropertyRow: %.3f us (%.1f us/reply)\n", elapsed, elapsed / opt_iterations);
+
+	/* Compatibility size wrapper, encodes into a scratch buffer */
+	gettimeofday(&start, NULL);
+	for (i = 0; i < opt_iterations; i++) {
+		size = 0;
+		for (j = 0; j < opt_rows; j++) {
+			size += libmapiserver_PropertyRow_size(BENCH_COLUMNS, bench_columns, rows[j].data_pointers, rows[j].retvals);
+		}
+	}
+	elapsed = bench_elapsed(&start);
+	printf("libmapiserver_PropertyRow_size: %.3f us (%.1f us/reply)\n", elapsed, elapsed / opt_iterations);
+
+	talloc_free(mem_ctx);
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+/*
+   Randomized checks for the libmapi IDSET range removal
+
+   OpenChange Project
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "libmapi/libmapi.h"
+
+#include <popt.h>
+#include <time.h>
+#include <sys/time.h>
+
+#define	DEFAULT_ITERATIONS	1000
+#define	DEFAULT_IDS		2000
+
+static double check_elapsed(struct timeval *start)
+{
+	struct timeval	end;
+
+	gettimeofday(&end, NULL);
+	return (end.tv_sec - start->tv_sec) * 1000000.0 + (end.tv_usec - start->tv_usec);
+}
+
+/* Previous implementation: each id removed by walking the ranges from the head */
+static void check_remove_globcnt(struct idset *idset, uint64_t eid)
+{
+	struct globset_range	*range, *new_range;
+	uint64_t		work_eid;
+
+	work_eid = exchange_globcnt(eid);
+
+	for (range = idset->ranges; range; range = range->next) {
+		if (range->low == eid) {
+			if (range->high == eid) {
+				if (range == idset->ranges) {
+					idset->ranges = range->next;
+					if (idset->ranges) {
+						idset->ranges->prev = range->prev;
+					}
+				}
+				else {
+					range->prev->next = range->next;
+					if (range->next) {
+						range->next->prev = range->prev;
+					}
+					else {
+						idset->ranges->prev = range->prev;
+					}
+				}
+				idset->range_count--;
+				talloc_free(range);
+			}
+			else {
+				range->low = exchange_globcnt(work_eid + 1);
+			}
+			return;
+		}
+		else if (range->high == eid) {
+			range->high = exchange_globcnt(work_eid - 1);
+			return;
+		}
+		else if ((exchange_globcnt(range->low) < work_eid) && (exchange_globcnt(range->high) > work_eid)) {
+			new_range = talloc_zero(idset, struct globset_range);
+			new_range->low = exchange_globcnt(work_eid + 1);
+			new_range->high = range->high;
+			range->high = exchange_globcnt(work_eid - 1);
+			new_range->prev = range;
+			new_range->next = range->next;
+			if (new_range->next) {
+				new_range->next->prev = new_range;
+			}
+			else {
+				idset->ranges->prev = new_range;
+			}
+			range->next = new_range;
+			idset->range_count++;
+			return;
+		}
+	}
+}
+
+static bool check_idset_equal(const struct idset *a, const struct idset *b)
+{
+	struct globset_range	*ra, *rb;
+
+	if (a->range_count != b->range_count) {
+		return false;
+	}
+	for (ra = a->ranges, rb = b->ranges; ra && rb; ra = ra->next, rb = rb->next) {
+		if (ra->low != rb->low || ra->high != rb->high) {
+			return false;
+		}
+	}
+
+	return (ra == NULL && rb == NULL);
+}
+
+/* Ids are pushed byte-swapped, the way they appear in Exchange ids */
+static struct rawidset *check_make_rawidset(TALLOC_CTX *mem_ctx, const struct GUID *guid, uint64_t universe, uint32_t count)
+{
+	struct rawidset	*rawidset;
+	uint32_t	i;
+
+	rawidset = RAWIDSET_make(mem_ctx, false, false);
+	for (i = 0; i < count; i++) {
+		RAWIDSET_push_guid_glob(rawidset, guid, exchange_globcnt(1 + (random() % universe)));
+	}
+
+	return rawidset;
+}
+
+int main(int argc, const char *argv[])
+{
+	TALLOC_CTX		*mem_ctx;
+	TALLOC_CTX		*loop_ctx;
+	poptContext		pc;
+	int			opt;
+	int			opt_iterations = DEFAULT_ITERATIONS;
+	int			opt_ids = DEFAULT_IDS;
+	int			opt_seed = 0;
+	struct GUID		guid;
+	struct rawidset		*given, *deleted;
+	struct idset		*expected, *result;
+	struct timeval		start;
+	double			elapsed_reference = 0, elapsed_merge = 0;
+	uint64_t		universe;
+	int			i, j;
+	int			errors = 0;
+
+	enum {OPT_ITERATIONS=1000, OPT_IDS, OPT_SEED};
+
+	struct poptOption long_options[] = {
+		POPT_AUTOHELP
+		{"iterations", 'n', POPT_ARG_INT, &opt_iterations, OPT_ITERATIONS, "number of random idsets to check", "COUNT"},
+		{"ids", 'i', POPT_ARG_INT, &opt_ids, OPT_IDS, "maximum number of ids in each idset", "COUNT"},
+		{"seed", 's', POPT_ARG_INT, &opt_seed, OPT_SEED, "random seed (defaults to the current time)", "SEED"},
+		{ NULL, 0, POPT_ARG_NONE, NULL, 0, NULL, NULL }
+	};
+
+	pc = poptGetContext("check_idset", argc, argv, long_options, 0);
+
+	while ((opt = poptGetNextOpt(pc)) != -1);
+	poptFreeContext(pc);
+
+	if (opt_iterations <= 0) {
+		opt_iterations = DEFAULT_ITERATIONS;
+	}
+	if (opt_ids <= 0) {
+		opt_ids = DEFAULT_IDS;
+	}
+	if (!opt_seed) {
+		opt_seed = time(NULL);
+	}
+	srandom(opt_seed);
+	printf("seed: %d\n", opt_seed);
+
+	mem_ctx = talloc_named(NULL, 0, "check_idset");
+	GUID_from_string("c4898b91-da9d-4f3e-9ae4-8a8bd5051b89", &guid);
+
+	for (i = 0; i < opt_iterations; i++) {
+		loop_ctx = talloc_new(mem_ctx);
+
+		/* dense universes produce long ranges, sparse ones many short ranges */
+		universe = 3 + (random() % (4 * opt_ids));
+		given = check_make_rawidset(loop_ctx, &guid, universe, 3 + (random() % opt_ids));
+		deleted = check_make_rawidset(loop_ctx, &guid, universe + 2, random() % opt_ids);
+
+		expected = RAWIDSET_convert_to_idset(loop_ctx, given);
+		result = RAWIDSET_convert_to_idset(loop_ctx, given);
+
+		gettimeofday(&start, NULL);
+		for (j = 0; j < deleted->count; j++) {
+			check_remove_globcnt(expected, deleted->globcnts[j]);
+		}
+		elapsed_reference += check_elapsed(&start);
+
+		gettimeofday(&start, NULL);
+		IDSET_remove_rawidset(result, deleted);
+		elapsed_merge += check_elapsed(&start);
+
+		if (!check_idset_equal(expected, result)) {
+			printf("FAILED: iteration %d, %d ids removed from a universe of %"PRIu64"\n", i, deleted->count, universe);
+			IDSET_dump(expected, "expected");
+			IDSET_dump(result, "result");
+			errors++;
+		}
+
+		talloc_free(loop_ctx);
+	}
+
+	printf("%d idsets checked, %d failures\n", opt_iterations, errors);
+	printf("per-id removal: %.3f us\n", elapsed_reference);
+	printf("IDSET_remove_rawidset: %.3f us\n", elapsed_merge);
+
+	talloc_free(mem_ctx);
+
+	return errors ? 1 : 0;
+}
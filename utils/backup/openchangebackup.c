@@ -137,6 +137,166 @@ uint32_t ocb_record_commit(struct ocb_context *ocb_ctx)
 }
 
 
+/**
+ * Delete a record along with the records stored below it (the
+ * attachments of a message for example)
+ */
+uint32_t ocb_record_delete(struct ocb_context *ocb_ctx, const char *dn)
+{
+	TALLOC_CTX		*mem_ctx;
+	struct ldb_context	*ldb_ctx;
+	struct ldb_result	*res;
+	struct ldb_dn		*basedn;
+	const char * const	attrs[] = { "cn", NULL };
+	unsigned int		i;
+	int			depth;
+	int			max_depth = 0;
+	int			ret;
+
+	/* sanity checks */
+	OCB_RETVAL_IF(!ocb_ctx, "Subsystem not initialized", NULL);
+	OCB_RETVAL_IF(!ocb_ctx->ldb_ctx, "LDB context not initialized", NULL);
+	OCB_RETVAL_IF(!dn, "Not a valid DN", NULL);
+
+	mem_ctx = talloc_named(ocb_ctx, 0, "ocb_record_delete");
+	ldb_ctx = ocb_ctx->ldb_ctx;
+
+	basedn = ldb_dn_new(mem_ctx, ldb_ctx, dn);
+	OCB_RETVAL_IF(!ldb_dn_validate(basedn), "Invalid DN", mem_ctx);
+
+	ret = ldb_search(ldb_ctx, mem_ctx, &res, basedn, LDB_SCOPE_SUBTREE, attrs, NULL);
+	if (ret != LDB_SUCCESS || !res->count) {
+		talloc_free(mem_ctx);
+		return 0;
+	}
+
+	for (i = 0; i < res->count; i++) {
+		depth = ldb_dn_get_comp_num(res->msgs[i]->dn);
+		if (depth > max_depth) max_depth = depth;
+	}
+
+	/* children first */
+	for (depth = max_depth; depth > 0; depth--) {
+		for (i = 0; i < res->count; i++) {
+			if (ldb_dn_get_comp_num(res->msgs[i]->dn) != depth) continue;
+			ret = ldb_delete(ldb_ctx, res->msgs[i]->dn);
+			if (ret != LDB_SUCCESS) {
+				DEBUG(3, ("LDB operation failed: %s\n", ldb_errstring(ldb_ctx)));
+				talloc_free(mem_ctx);
+				return -1;
+			}
+		}
+	}
+
+	talloc_free(mem_ctx);
+
+	return 0;
+}
+
+
+/**
+ * Retrieve the ICS state saved for a container by ocb_syncstate_set
+ *
+ * Returns -1 if no state was saved yet, in which case the next
+ * synchronization has to start from scratch.
+ */
+int ocb_syncstate_get(struct ocb_context *ocb_ctx, TALLOC_CTX *mem_ctx,
+		      const char *containerdn, DATA_BLOB *cnset_seen,
+		      DATA_BLOB *idset_given)
+{
+	struct ldb_context	*ldb_ctx;
+	struct ldb_result	*res;
+	struct ldb_dn		*basedn;
+	const char * const	attrs[] = { OCB_SYNCSTATE_CNSET_SEEN, OCB_SYNCSTATE_IDSET_GIVEN, NULL };
+	const char		*value;
+	int			ret;
+
+	/* sanity checks */
+	OCB_RETVAL_IF(!ocb_ctx, "Subsystem not initialized", NULL);
+	OCB_RETVAL_IF(!ocb_ctx->ldb_ctx, "LDB context not initialized", NULL);
+	OCB_RETVAL_IF(!containerdn, "Not a valid DN", NULL);
+	OCB_RETVAL_IF(!cnset_seen || !idset_given, "Invalid parameter", NULL);
+
+	ldb_ctx = ocb_ctx->ldb_ctx;
+
+	basedn = ldb_dn_new_fmt(mem_ctx, ldb_ctx, "cn=%s,%s", OCB_SYNCSTATE_CN, containerdn);
+	OCB_RETVAL_IF(!ldb_dn_validate(basedn), "Invalid DN", basedn);
+
+	ret = ldb_search(ldb_ctx, mem_ctx, &res, basedn, LDB_SCOPE_BASE, attrs, NULL);
+	talloc_free(basedn);
+	OCB_RETVAL_IF(ret != LDB_SUCCESS || res->count != 1, "No synchronization state", NULL);
+
+	value = ldb_msg_find_attr_as_string(res->msgs[0], OCB_SYNCSTATE_CNSET_SEEN, "");
+	cnset_seen->data = (uint8_t *) talloc_strdup(mem_ctx, value);
+	cnset_seen->length = ldb_base64_decode((char *) cnset_seen->data);
+
+	value = ldb_msg_find_attr_as_string(res->msgs[0], OCB_SYNCSTATE_IDSET_GIVEN, "");
+	idset_given->data = (uint8_t *) talloc_strdup(mem_ctx, value);
+	idset_given->length = ldb_base64_decode((char *) idset_given->data);
+
+	talloc_free(res);
+
+	return 0;
+}
+
+
+/**
+ * Save the ICS state reached for a container, replacing the previous one
+ */
+uint32_t ocb_syncstate_set(struct ocb_context *ocb_ctx, const char *containerdn,
+			   const DATA_BLOB *cnset_seen, const DATA_BLOB *idset_given)
+{
+	TALLOC_CTX		*mem_ctx;
+	struct ldb_context	*ldb_ctx;
+	struct ldb_result	*res;
+	struct ldb_message	*msg;
+	const char * const	attrs[] = { "cn", NULL };
+	bool			exists;
+	int			flags;
+	int			ret;
+
+	/* sanity checks */
+	OCB_RETVAL_IF(!ocb_ctx, "Subsystem not initialized", NULL);
+	OCB_RETVAL_IF(!ocb_ctx->ldb_ctx, "LDB context not initialized", NULL);
+	OCB_RETVAL_IF(!containerdn, "Not a valid DN", NULL);
+	OCB_RETVAL_IF(!cnset_seen || !idset_given, "Invalid parameter", NULL);
+
+	mem_ctx = talloc_named(ocb_ctx, 0, "ocb_syncstate_set");
+	ldb_ctx = ocb_ctx->ldb_ctx;
+
+	msg = ldb_msg_new(mem_ctx);
+	msg->dn = ldb_dn_new_fmt(msg, ldb_ctx, "cn=%s,%s", OCB_SYNCSTATE_CN, containerdn);
+	OCB_RETVAL_IF(!ldb_dn_validate(msg->dn), "Invalid DN", mem_ctx);
+
+	ret = ldb_search(ldb_ctx, mem_ctx, &res, msg->dn, LDB_SCOPE_BASE, attrs, NULL);
+	exists = (ret == LDB_SUCCESS && res->count == 1);
+
+	if (!exists) {
+		ldb_msg_add_string(msg, "cn", OCB_SYNCSTATE_CN);
+		ldb_msg_add_string(msg, "objectClass", OCB_OBJCLASS_SYNCSTATE);
+	}
+
+	flags = exists ? LDB_FLAG_MOD_REPLACE : 0;
+	ldb_msg_add_empty(msg, OCB_SYNCSTATE_CNSET_SEEN, flags, NULL);
+	ldb_msg_add_string(msg, OCB_SYNCSTATE_CNSET_SEEN,
+			   ldb_base64_encode(msg, (char *) cnset_seen->data, cnset_seen->length));
+	ldb_msg_add_empty(msg, OCB_SYNCSTATE_IDSET_GIVEN, flags, NULL);
+	ldb_msg_add_string(msg, OCB_SYNCSTATE_IDSET_GIVEN,
+			   ldb_base64_encode(msg, (char *) idset_given->data, idset_given->length));
+
+	ret = exists ? ldb_modify(ldb_ctx, msg) : ldb_add(ldb_ctx, msg);
+	if (ret != LDB_SUCCESS) {
+		DEBUG(3, ("LDB operation failed: %s\n", ldb_errstring(ldb_ctx)));
+		talloc_free(mem_ctx);
+		return -1;
+	}
+
+	talloc_free(mem_ctx);
+
+	return 0;
+}
+
+
 /**
  * Add a property (attr, value) couple to the current record
  */
@@ -65,6 +65,12 @@ int			ocb_record_init(struct ocb_context *, const char *,
 					const char *, const char *, struct mapi_SPropValue_array *);
 uint32_t		ocb_record_commit(struct ocb_context *);
 uint32_t		ocb_record_add_property(struct ocb_context *, struct mapi_SPropValue *);
+uint32_t		ocb_record_delete(struct ocb_context *, const char *);
+
+int			ocb_syncstate_get(struct ocb_context *, TALLOC_CTX *, const char *,
+					  DATA_BLOB *, DATA_BLOB *);
+uint32_t		ocb_syncstate_set(struct ocb_context *, const char *,
+					  const DATA_BLOB *, const DATA_BLOB *);
 
 char			*get_record_uuid(TALLOC_CTX *, const struct SBinary_short *);
 char			*get_MAPI_uuid(TALLOC_CTX *, const struct SBinary_short *);
@@ -94,5 +100,11 @@ do {						\
 #define	OCB_OBJCLASS_CONTAINER	"container"
 #define	OCB_OBJCLASS_MESSAGE	"message"
 #define	OCB_OBJCLASS_ATTACHMENT	"attachment"
+#define	OCB_OBJCLASS_SYNCSTATE	"syncstate"
+
+/* ICS state record, stored below the container it applies to */
+#define	OCB_SYNCSTATE_CN		"syncstate"
+#define	OCB_SYNCSTATE_CNSET_SEEN	"cnsetSeen"
+#define	OCB_SYNCSTATE_IDSET_GIVEN	"idsetGiven"
 
 #endif /* __OPENCHANGEBACKUP_H__ */
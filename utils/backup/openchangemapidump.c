@@ -159,6 +159,69 @@ static enum MAPISTATUS mapidump_walk_attachment(TALLOC_CTX *mem_ctx,
 	return MAPI_E_SUCCESS;
 }
 
+/**
+ * Retrieve a message with its attachments and write it to the database
+ *
+ * When replace is set, the message already stored (if any) is
+ * deleted first so that its new version gets written.
+ */
+static enum MAPISTATUS mapidump_dump_message(TALLOC_CTX *mem_ctx,
+					     struct ocb_context *ocb_ctx,
+					     mapi_object_t *obj_folder,
+					     mapi_id_t fid,
+					     mapi_id_t mid,
+					     const char *containerdn,
+					     bool replace)
+{
+	enum MAPISTATUS			retval;
+	struct mapi_SPropValue_array	props;
+	mapi_object_t			obj_message;
+	char				*uuid;
+	const struct SBinary_short     	*sbin;
+	const uint8_t			*has_attach;
+	char				*contentdn;
+
+	/* Open Message */
+	mapi_object_init(&obj_message);
+	retval = OpenMessage(obj_folder, fid, mid, &obj_message, 0);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	retval = GetPropsAll(&obj_message, MAPI_UNICODE, &props);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	/* extract unique identifier from PR_SOURCE_KEY */
+	sbin = (const struct SBinary_short *)find_mapi_SPropValue_data(&props, PR_SOURCE_KEY);
+	uuid = get_MAPI_uuid(mem_ctx, sbin);
+	if (!uuid) {
+		retval = MAPI_E_NOT_FOUND;
+		goto end;
+	}
+	contentdn = talloc_asprintf(mem_ctx, "cn=%s,%s", uuid, containerdn);
+	/* Do not write the new version over a record left in place */
+	if (replace && ocb_record_delete(ocb_ctx, contentdn)) {
+		talloc_free(uuid);
+		talloc_free(contentdn);
+		retval = MAPI_E_CALL_FAILED;
+		goto end;
+	}
+	mapidump_write_message(ocb_ctx, &props, contentdn, uuid);
+
+	/* If Message has attachments then process them */
+	has_attach = (const uint8_t *)find_mapi_SPropValue_data(&props, PR_HASATTACH);
+	if (has_attach && *has_attach) {
+		mapidump_walk_attachment(mem_ctx, ocb_ctx, &obj_message, contentdn);
+	}
+
+	/* free allocated strings */
+	talloc_free(uuid);
+	talloc_free(contentdn);
+
+end:
+	mapi_object_release(&obj_message);
+
+	return retval;
+}
+
 /**
  * Retrieve all the content within a folder
  */
@@ -169,18 +232,12 @@ static enum MAPISTATUS mapidump_walk_content(TALLOC_CTX *mem_ctx,
 {
 	enum MAPISTATUS			retval;
 	struct SPropTagArray		*SPropTagArray;
-	struct mapi_SPropValue_array	props;
 	struct SRowSet			rowset;
 	mapi_object_t			obj_ctable;
-	mapi_object_t			obj_message;
 	uint32_t			count = 0;
 	uint32_t			i;
 	const mapi_id_t			*fid;
 	const mapi_id_t			*mid;
-	char				*uuid;
-	const struct SBinary_short     	*sbin;
-	const uint8_t			*has_attach;
-	char				*contentdn;
 
 	/* Get Contents Table */
 	mapi_object_init(&obj_ctable);
@@ -200,32 +257,9 @@ static enum MAPISTATUS mapidump_walk_content(TALLOC_CTX *mem_ctx,
 
 	while ((retval = QueryRows(&obj_ctable, count, TBL_ADVANCE, &rowset)) != MAPI_E_NOT_FOUND && rowset.cRows) {
 		for (i = 0; i < rowset.cRows; i++) {
-			mapi_object_init(&obj_message);
 			fid = (const uint64_t *) get_SPropValue_SRow_data(&rowset.aRow[i], PR_FID);
 			mid = (const uint64_t *) get_SPropValue_SRow_data(&rowset.aRow[i], PR_MID);
-			/* Open Message */
-			retval = OpenMessage(obj_folder, *fid, *mid, &obj_message, 0);
-			if (GetLastError() == MAPI_E_SUCCESS) {
-				retval = GetPropsAll(&obj_message, MAPI_UNICODE, &props);
-				if (GetLastError() == MAPI_E_SUCCESS) {
-					/* extract unique identifier from PR_SOURCE_KEY */
-					sbin = (const struct SBinary_short *)find_mapi_SPropValue_data(&props, PR_SOURCE_KEY);
-					uuid = get_MAPI_uuid(mem_ctx, sbin);
-					contentdn = talloc_asprintf(mem_ctx, "cn=%s,%s", uuid, containerdn);
-					mapidump_write_message(ocb_ctx, &props, contentdn, uuid);
-
-					/* If Message has attachments then process them */
-					has_attach = (const uint8_t *)find_mapi_SPropValue_data(&props, PR_HASATTACH);
-					if (has_attach && *has_attach) {
-						mapidump_walk_attachment(mem_ctx, ocb_ctx, &obj_message, contentdn);
-					}
-
-					/* free allocated strings */
-					talloc_free(uuid);
-					talloc_free(contentdn);
-				}
-			}
-			mapi_object_release(&obj_message);
+			mapidump_dump_message(mem_ctx, ocb_ctx, obj_folder, *fid, *mid, containerdn, false);
 		}
 	}
 
@@ -235,6 +269,249 @@ static enum MAPISTATUS mapidump_walk_content(TALLOC_CTX *mem_ctx,
 }
 
 
+/**
+ * What an ICS contents download reported for a folder
+ */
+struct mapidump_sync {
+	TALLOC_CTX		*mem_ctx;
+	bool			in_header;	/* between IncrSyncChg and IncrSyncMessage */
+	mapi_id_t		*changed;
+	uint32_t		changed_count;
+	uint32_t		changed_size;
+	DATA_BLOB		deleted;
+	DATA_BLOB		cnset_seen;
+	DATA_BLOB		idset_given;
+	bool			have_state;
+};
+
+static enum MAPISTATUS mapidump_sync_marker(uint32_t marker, void *priv)
+{
+	struct mapidump_sync	*sync = (struct mapidump_sync *)priv;
+
+	switch (marker) {
+	case IncrSyncChg:
+		sync->in_header = true;
+		break;
+	case IncrSyncMessage:
+	case IncrSyncDel:
+	case IncrSyncStateBegin:
+		sync->in_header = false;
+		break;
+	case IncrSyncStateEnd:
+		sync->have_state = true;
+		break;
+	}
+
+	return MAPI_E_SUCCESS;
+}
+
+static enum MAPISTATUS mapidump_sync_property(struct SPropValue prop, void *priv)
+{
+	struct mapidump_sync	*sync = (struct mapidump_sync *)priv;
+	uint32_t		proptag = prop.ulPropTag;
+
+	if (proptag == PR_MID && sync->in_header) {
+		if (sync->changed_count == sync->changed_size) {
+			sync->changed_size = sync->changed_size ? sync->changed_size * 2 : 64;
+			sync->changed = talloc_realloc(sync->mem_ctx, sync->changed, mapi_id_t, sync->changed_size);
+		}
+		sync->changed[sync->changed_count++] = prop.value.d;
+	} else if (proptag == MetaTagIdsetDeleted) {
+		sync->deleted = data_blob_talloc(sync->mem_ctx, prop.value.bin.lpb, prop.value.bin.cb);
+	} else if (proptag == MetaTagCnsetSeen) {
+		sync->cnset_seen = data_blob_talloc(sync->mem_ctx, prop.value.bin.lpb, prop.value.bin.cb);
+	} else if (proptag == ((MetaTagIdsetGiven & 0xFFFF0000) | PT_BINARY)) {
+		sync->idset_given = data_blob_talloc(sync->mem_ctx, prop.value.bin.lpb, prop.value.bin.cb);
+	}
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+ * Upload one part of a previously saved ICS state
+ */
+static enum MAPISTATUS mapidump_sync_upload_state(mapi_object_t *obj_sync_context,
+						  enum StateProperty state_property,
+						  DATA_BLOB state)
+{
+	enum MAPISTATUS		retval;
+	DATA_BLOB		chunk;
+	uint32_t		offset;
+
+	retval = ICSSyncUploadStateBegin(obj_sync_context, state_property, state.length);
+	MAPI_RETVAL_IF(retval, retval, NULL);
+
+	/* keep each request well below the transport buffer size */
+	for (offset = 0; offset < state.length; offset += chunk.length) {
+		chunk.data = state.data + offset;
+		chunk.length = MIN(state.length - offset, 0x4000);
+		retval = ICSSyncUploadStateContinue(obj_sync_context, chunk);
+		MAPI_RETVAL_IF(retval, retval, NULL);
+	}
+
+	return ICSSyncUploadStateEnd(obj_sync_context);
+}
+
+/**
+ * Remove the messages listed in a MetaTagIdsetDeleted idset from the
+ * database.
+ *
+ * Message records are named after the global counter of their
+ * PR_SOURCE_KEY, so the deleted ranges are matched against the
+ * records stored for the folder rather than enumerated.
+ *
+ * Returns false if a deleted message could not be removed.
+ */
+static bool mapidump_sync_deletions(TALLOC_CTX *mem_ctx,
+				    struct ocb_context *ocb_ctx,
+				    const char *containerdn,
+				    DATA_BLOB deleted)
+{
+	struct idset			*idset;
+	struct idset			*current;
+	struct globset_range		*range;
+	struct ldb_result		*res;
+	struct ldb_dn			*basedn;
+	const char * const		attrs[] = { "cn", NULL };
+	const char			*cn;
+	uint64_t			globcnt;
+	unsigned int			i;
+	int				ret;
+	bool				removed = true;
+
+	idset = IDSET_parse(mem_ctx, deleted, true);
+	if (!idset) return false;
+
+	basedn = ldb_dn_new(mem_ctx, ocb_ctx->ldb_ctx, containerdn);
+	ret = ldb_search(ocb_ctx->ldb_ctx, mem_ctx, &res, basedn, LDB_SCOPE_ONELEVEL, attrs,
+			 "(objectClass=%s)", OCB_OBJCLASS_MESSAGE);
+	if (ret != LDB_SUCCESS) {
+		removed = false;
+		goto end;
+	}
+
+	for (i = 0; i < res->count; i++) {
+		cn = ldb_msg_find_attr_as_string(res->msgs[i], "cn", NULL);
+		if (!cn) continue;
+		/* the hex string is the globcnt in network byte order */
+		globcnt = strtoull(cn, NULL, 16);
+
+		for (current = idset; current; current = current->next) {
+			for (range = current->ranges; range; range = range->next) {
+				if (exchange_globcnt(range->low) <= globcnt && globcnt <= exchange_globcnt(range->high)) {
+					if (ocb_record_delete(ocb_ctx, ldb_dn_get_linearized(res->msgs[i]->dn))) {
+						removed = false;
+					}
+					break;
+				}
+			}
+			if (range) break;
+		}
+	}
+
+end:
+	talloc_free(basedn);
+
+	return removed;
+}
+
+/**
+ * Synchronize the content of a folder with ICS
+ *
+ * Starting from the state saved by the previous run, the server only
+ * reports the messages that changed or were deleted since then. The
+ * download is configured to only carry the message change headers:
+ * changed messages are then retrieved and written the same way
+ * mapidump_walk_content does. Without a saved state, every message is
+ * reported as changed.
+ */
+static enum MAPISTATUS mapidump_sync_content(TALLOC_CTX *mem_ctx,
+					     struct ocb_context *ocb_ctx,
+					     mapi_object_t *obj_folder,
+					     const char *containerdn)
+{
+	enum MAPISTATUS			retval;
+	TALLOC_CTX			*sync_ctx;
+	struct mapidump_sync		*sync;
+	struct fx_parser_context	*parser;
+	struct SPropTagArray		*SPropTagArray;
+	mapi_object_t			obj_sync_context;
+	DATA_BLOB			restriction;
+	DATA_BLOB			cnset_seen;
+	DATA_BLOB			idset_given;
+	DATA_BLOB			transferdata;
+	enum TransferStatus		transferStatus;
+	uint16_t			progressCount;
+	uint16_t			totalStepCount;
+	mapi_id_t			fid;
+	uint32_t			i;
+	bool				complete = true;
+
+	sync_ctx = talloc_named(mem_ctx, 0, "mapidump_sync_content");
+	sync = talloc_zero(sync_ctx, struct mapidump_sync);
+	sync->mem_ctx = sync_ctx;
+
+	mapi_object_init(&obj_sync_context);
+
+	SPropTagArray = set_SPropTagArray(sync_ctx, 0x0);
+	restriction.length = 0;
+	restriction.data = NULL;
+	retval = ICSSyncConfigure(obj_folder, Contents, FastTransfer_Unicode,
+				  SynchronizationFlag_Unicode | SynchronizationFlag_Normal |
+				  SynchronizationFlag_OnlySpecifiedProperties,
+				  Eid, restriction, SPropTagArray, &obj_sync_context);
+	if (retval != MAPI_E_SUCCESS) goto end;
+
+	if (ocb_syncstate_get(ocb_ctx, sync_ctx, containerdn, &cnset_seen, &idset_given) == 0) {
+		retval = mapidump_sync_upload_state(&obj_sync_context, MetaTagCnsetSeen, cnset_seen);
+		if (retval != MAPI_E_SUCCESS) goto end;
+		retval = mapidump_sync_upload_state(&obj_sync_context, MetaTagIdsetGiven, idset_given);
+		if (retval != MAPI_E_SUCCESS) goto end;
+	}
+
+	parser = fxparser_init(sync_ctx, sync);
+	fxparser_set_marker_callback(parser, mapidump_sync_marker);
+	fxparser_set_property_callback(parser, mapidump_sync_property);
+
+	do {
+		retval = FXGetBuffer(&obj_sync_context, 0, &transferStatus, &progressCount, &totalStepCount, &transferdata);
+		if (retval != MAPI_E_SUCCESS) goto end;
+		retval = fxparser_parse(parser, &transferdata);
+		talloc_free(transferdata.data);
+		if (retval != MAPI_E_SUCCESS) goto end;
+	} while (transferStatus == TransferStatus_Partial || transferStatus == TransferStatus_NoRoom);
+
+	if (transferStatus != TransferStatus_Done || !sync->have_state) {
+		retval = MAPI_E_CALL_FAILED;
+		goto end;
+	}
+
+	if (sync->deleted.length && !mapidump_sync_deletions(sync_ctx, ocb_ctx, containerdn, sync->deleted)) {
+		complete = false;
+	}
+
+	fid = mapi_object_get_id(obj_folder);
+	for (i = 0; i < sync->changed_count; i++) {
+		if (mapidump_dump_message(sync_ctx, ocb_ctx, obj_folder, fid, sync->changed[i], containerdn, true)) {
+			complete = false;
+		}
+	}
+
+	/* Only move the state forward once every change and deletion is
+	   stored: a message we failed to retrieve or remove is reported
+	   again next time */
+	if (complete) {
+		ocb_syncstate_set(ocb_ctx, containerdn, &sync->cnset_seen, &sync->idset_given);
+	}
+
+end:
+	mapi_object_release(&obj_sync_context);
+	talloc_free(sync_ctx);
+
+	return retval;
+}
+
+
 /**
  * Recursively retrieve folders
  */
@@ -243,7 +520,8 @@ static enum MAPISTATUS mapidump_walk_container(TALLOC_CTX *mem_ctx,
 					       mapi_object_t *obj_parent,
 					       mapi_id_t folder_id,
 					       char *parentdn,
-					       int count)
+					       int count,
+					       bool incremental)
 {
 	enum MAPISTATUS			retval;
 	struct SPropTagArray		*SPropTagArray;
@@ -286,8 +564,15 @@ static enum MAPISTATUS mapidump_walk_container(TALLOC_CTX *mem_ctx,
 	mapidump_write_container(ocb_ctx, &props, containerdn, uuid);
 	talloc_free(uuid);
 
-	/* Get Contents Table if PR_CONTENT_COUNT >= 1 */
-	if (child_content && *child_content >= 1) {
+	/* Synchronize the content even when the folder is now empty:
+	   deletions still have to be applied */
+	if (incremental) {
+		retval = mapidump_sync_content(mem_ctx, ocb_ctx, &obj_folder, containerdn);
+		if (retval != MAPI_E_SUCCESS) {
+			mapi_errstr("mapidump_sync_content", retval);
+		}
+	} else if (child_content && *child_content >= 1) {
+		/* Get Contents Table if PR_CONTENT_COUNT >= 1 */
 		retval = mapidump_walk_content(mem_ctx, ocb_ctx, &obj_folder, containerdn);
 	}
 
@@ -309,7 +594,7 @@ static enum MAPISTATUS mapidump_walk_container(TALLOC_CTX *mem_ctx,
 		while ((retval = QueryRows(&obj_htable, rcount, TBL_ADVANCE, &rowset) != MAPI_E_NOT_FOUND) && rowset.cRows) {
 			for (i = 0; i < rowset.cRows; i++) {
 				fid = (const uint64_t *)find_SPropValue_data(&rowset.aRow[i], PR_FID);
-				retval = mapidump_walk_container(mem_ctx, ocb_ctx, &obj_folder, *fid, containerdn, count + 1);
+				retval = mapidump_walk_container(mem_ctx, ocb_ctx, &obj_folder, *fid, containerdn, count + 1, incremental);
 			}
 		}
 	} 
@@ -326,7 +611,8 @@ static enum MAPISTATUS mapidump_walk_container(TALLOC_CTX *mem_ctx,
 
 static enum MAPISTATUS mapidump_walk(TALLOC_CTX *mem_ctx,
 					       struct ocb_context *ocb_ctx,
-					       mapi_object_t *obj_store)
+					       mapi_object_t *obj_store,
+					       bool incremental)
 {
 	enum MAPISTATUS			retval;
 	mapi_id_t			id_mailbox;
@@ -335,7 +621,7 @@ static enum MAPISTATUS mapidump_walk(TALLOC_CTX *mem_ctx,
 				  olFolderTopInformationStore);
 	MAPI_RETVAL_IF(retval, GetLastError(), NULL);
 
-	return mapidump_walk_container(mem_ctx, ocb_ctx, obj_store, id_mailbox, NULL, 0);
+	return mapidump_walk_container(mem_ctx, ocb_ctx, obj_store, id_mailbox, NULL, 0, incremental);
 }
 
 
@@ -356,10 +642,11 @@ int main(int argc, const char *argv[])
 	const char			*opt_backupdb = NULL;
 	const char			*opt_debug = NULL;
 	bool				opt_dumpdata = false;
+	bool				opt_incremental = false;
 
 	enum {OPT_PROFILE_DB=1000, OPT_PROFILE, OPT_PASSWORD, 
 	      OPT_MAILBOX, OPT_CONFIG, OPT_BACKUPDB, OPT_PF,
-	      OPT_DEBUG, OPT_DUMPDATA};
+	      OPT_DEBUG, OPT_DUMPDATA, OPT_INCREMENTAL};
 
 	struct poptOption long_options[] = {
 		POPT_AUTOHELP
@@ -369,6 +656,7 @@ int main(int argc, const char *argv[])
 		{"backup-db", 'b', POPT_ARG_STRING, NULL, OPT_BACKUPDB, "set the openchangebackup store path", NULL},
 		{"debuglevel", 0, POPT_ARG_STRING, NULL, OPT_DEBUG, "set the debug level", NULL},
 		{"dump-data", 0, POPT_ARG_NONE, NULL, OPT_DUMPDATA, "dump the hex data", NULL},
+		{"incremental", 'i', POPT_ARG_NONE, NULL, OPT_INCREMENTAL, "only fetch the changes since the previous incremental run", NULL},
 		POPT_OPENCHANGE_VERSION
 		{ NULL, 0, 0, NULL, 0, NULL, NULL }
 	};
@@ -385,6 +673,9 @@ int main(int argc, const char *argv[])
 		case OPT_DUMPDATA:
 			opt_dumpdata = true;
 			break;
+		case OPT_INCREMENTAL:
+			opt_incremental = true;
+			break;
 		case OPT_PROFILE_DB:
 			opt_profdb = poptGetOptArg(pc);
 			break;
@@ -458,7 +749,7 @@ int main(int argc, const char *argv[])
 		exit (1);
 	}
 
-	retval = mapidump_walk(mem_ctx, ocb_ctx, &obj_store);
+	retval = mapidump_walk(mem_ctx, ocb_ctx, &obj_store, opt_incremental);
 
 	/* Uninitialize MAPI and OCB subsystem */
 	mapi_object_release(&obj_store);
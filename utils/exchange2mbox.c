@@ -36,6 +36,7 @@
 
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #include "openchange-tools.h"
 
@@ -56,11 +57,12 @@
  */
 #define	MAX_READ_SIZE	12000
 
-static int message_error = 0;	/* did we get an error processing message */
+/* Per-thread: messages are rendered concurrently when --jobs > 1 */
+static __thread int message_error = 0;	/* did we get an error processing message */
 
 static bool opt_test = false;
 
-static char boundary_base[128] = DEFAULT_BOUNDARY_BASE;
+static __thread char boundary_base[128] = DEFAULT_BOUNDARY_BASE;
 
 static time_t start_time;
 
@@ -979,6 +981,362 @@ old_code:
 
 
 
+/**
+ * Export work items, one per message of the contents table
+ */
+
+enum export_status {
+	EXPORT_PENDING = 0,
+	EXPORT_OK,
+	EXPORT_MESSAGE_ERROR,	/* written, but message_error was raised */
+	EXPORT_FAILED,		/* written, but message2mbox failed */
+	EXPORT_OPEN_FAILED,	/* nothing written */
+	EXPORT_PROPS_FAILED	/* nothing written */
+};
+
+struct export_item {
+	mapi_id_t		fid;
+	mapi_id_t		mid;
+	char			*msgid;
+	char			*data;		/* rendered mbox entry (--jobs > 1) */
+	size_t			length;
+	enum export_status	status;
+};
+
+/*
+ * Items are handed out to the workers in table order, and written to
+ * the mbox in that same order by the main thread, so the output does
+ * not depend on the number of jobs. Workers never run more than
+ * `window' items ahead of the writer, which bounds memory usage.
+ */
+struct export_queue {
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	struct export_item	*items;
+	uint32_t		count;
+	uint32_t		next;		/* next item to hand out */
+	uint32_t		written;	/* items written to the mbox so far */
+	uint32_t		window;
+	int			workers;	/* workers still taking items */
+	const char		*profdb;
+	const char		*profname;
+	const char		*password;
+};
+
+static enum export_status export_message(TALLOC_CTX *mem_ctx, FILE *fp,
+					 mapi_object_t *obj_store,
+					 struct export_item *item)
+{
+	enum MAPISTATUS			retval;
+	mapi_object_t			obj_message;
+	struct SPropTagArray		*SPropTagArray = NULL;
+	struct SPropValue		*lpProps;
+	struct SRow			aRow;
+	uint32_t			count;
+	enum export_status		status;
+
+	mapi_object_init(&obj_message);
+	retval = OpenMessage(obj_store, item->fid, item->mid, &obj_message, 0);
+	if (retval != MAPI_E_SUCCESS) {
+		fprintf(stderr, "could not open message %s: retval=%d GetLastError=%d\n",
+			item->msgid, retval, GetLastError());
+		mapi_object_release(&obj_message);
+		return EXPORT_OPEN_FAILED;
+	}
+
+	SPropTagArray = set_SPropTagArray(mem_ctx, 0x1b,
+					  PR_INTERNET_MESSAGE_ID,
+					  PR_INTERNET_MESSAGE_ID_UNICODE,
+					  PR_CONVERSATION_TOPIC,
+					  PR_CONVERSATION_TOPIC_UNICODE,
+					  PR_MESSAGE_DELIVERY_TIME,
+					  PR_MSG_EDITOR_FORMAT,
+					  PR_BODY,
+					  PR_BODY_UNICODE,
+					  PR_HTML,
+					  PR_RTF_COMPRESSED,
+					  PR_RTF_IN_SYNC,
+					  PR_SENT_REPRESENTING_NAME,
+					  PR_SENT_REPRESENTING_NAME_UNICODE,
+					  PR_DISPLAY_TO,
+					  PR_DISPLAY_TO_UNICODE,
+					  PR_DISPLAY_CC,
+					  PR_DISPLAY_CC_UNICODE,
+					  PR_DISPLAY_BCC,
+					  PR_DISPLAY_BCC_UNICODE,
+					  PR_HASATTACH,
+					  PR_TRANSPORT_MESSAGE_HEADERS,
+					  PR_SUBJECT_PREFIX,
+					  PR_SUBJECT_PREFIX_UNICODE,
+					  PR_NORMALIZED_SUBJECT,
+					  PR_NORMALIZED_SUBJECT_UNICODE,
+					  PR_SUBJECT,
+					  PR_SUBJECT_UNICODE);
+	retval = GetProps(&obj_message, MAPI_UNICODE, SPropTagArray, &lpProps, &count);
+	MAPIFreeBuffer(SPropTagArray);
+	if (retval != MAPI_E_SUCCESS) {
+		fprintf(stderr, "Badness getting message %s attrs\n", item->msgid);
+		mapi_object_release(&obj_message);
+		return EXPORT_PROPS_FAILED;
+	}
+
+	/* Build a SRow structure */
+	aRow.ulAdrEntryPad = 0;
+	aRow.cValues = count;
+	aRow.lpProps = lpProps;
+
+	message_error = 0;
+	if (!message2mbox(mem_ctx, fp, &aRow, &obj_message, 0)) {
+		status = EXPORT_FAILED;
+	} else if (message_error) {
+		status = EXPORT_MESSAGE_ERROR;
+	} else {
+		status = EXPORT_OK;
+	}
+
+	talloc_free(lpProps);
+	mapi_object_release(&obj_message);
+	errno = 0;
+
+	return status;
+}
+
+/**
+ * Record the outcome of an exported message in the profile. Only
+ * called from the main thread.
+ */
+static void export_commit(struct mapi_profile *profile, struct export_item *item)
+{
+	switch (item->status) {
+	case EXPORT_FAILED:
+		printf("Message-ID: %s error, not added to %s\n", item->msgid, profile->profname);
+		break;
+	case EXPORT_MESSAGE_ERROR:
+		printf("Message-ID: %s error, ignoring\n", item->msgid);
+		fprintf(stderr, "Message-ID: %s error, ignoring message (check with OWA if you can, will retry next time)\n", item->msgid);
+		break;
+	case EXPORT_OK:
+		if (opt_test) {
+			printf("Message-ID: %s saved but not updated in %s\n", item->msgid, profile->profname);
+		} else if (mapi_profile_add_string_attr(profile->mapi_ctx, profile->profname, "Message-ID", item->msgid) != MAPI_E_SUCCESS) {
+			mapi_errstr("mapi_profile_add_string_attr", GetLastError());
+		} else {
+			printf("Message-ID: %s added to profile %s\n", item->msgid, profile->profname);
+		}
+		break;
+	case EXPORT_OPEN_FAILED:
+		printf("Message-ID: %s could not be opened, not added to %s\n", item->msgid, profile->profname);
+		break;
+	case EXPORT_PROPS_FAILED:
+		exit (1);
+	default:
+		break;
+	}
+}
+
+/**
+ * MAPIInitialize and MapiLogonEx set up process wide state (loadparm,
+ * gensec and DCE/RPC backends) and must not run concurrently
+ */
+static pthread_mutex_t export_logon_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Worker thread: opens its own MAPI session and renders the items it
+ * takes from the queue into memory buffers. A worker which cannot log
+ * on leaves the queue without taking any item.
+ */
+static void *export_worker(void *arg)
+{
+	struct export_queue	*queue = (struct export_queue *) arg;
+	TALLOC_CTX		*mem_ctx;
+	enum MAPISTATUS		retval;
+	struct mapi_context	*mapi_ctx = NULL;
+	struct mapi_session	*session = NULL;
+	mapi_object_t		obj_store;
+	struct export_item	*item;
+	enum export_status	status;
+	FILE			*out;
+	bool			connected = false;
+
+	mem_ctx = talloc_named(NULL, 0, "exchange2mbox_worker");
+	mapi_object_init(&obj_store);
+
+	pthread_mutex_lock(&export_logon_lock);
+	retval = MAPIInitialize(&mapi_ctx, queue->profdb);
+	if (retval == MAPI_E_SUCCESS) {
+		retval = MapiLogonEx(mapi_ctx, &session, queue->profname, queue->password);
+		if (retval == MAPI_E_SUCCESS) {
+			retval = OpenMsgStore(session, &obj_store);
+			connected = (retval == MAPI_E_SUCCESS);
+		}
+	}
+	pthread_mutex_unlock(&export_logon_lock);
+	if (!connected) {
+		mapi_errstr("export worker logon", GetLastError());
+	}
+
+	while (connected) {
+		pthread_mutex_lock(&queue->lock);
+		while (queue->next < queue->count && queue->next >= queue->written + queue->window) {
+			pthread_cond_wait(&queue->cond, &queue->lock);
+		}
+		if (queue->next >= queue->count) {
+			pthread_mutex_unlock(&queue->lock);
+			break;
+		}
+		item = &queue->items[queue->next++];
+		pthread_mutex_unlock(&queue->lock);
+
+		item->data = NULL;
+		item->length = 0;
+		out = open_memstream(&item->data, &item->length);
+		if (!out) {
+			status = EXPORT_OPEN_FAILED;
+		} else {
+			status = export_message(mem_ctx, out, &obj_store, item);
+		}
+		/* data and length are only final once the stream is closed */
+		if (out) {
+			fclose(out);
+		}
+
+		pthread_mutex_lock(&queue->lock);
+		item->status = status;
+		pthread_cond_broadcast(&queue->cond);
+		pthread_mutex_unlock(&queue->lock);
+	}
+
+	/* the writer takes over the items left once no worker remains */
+	pthread_mutex_lock(&queue->lock);
+	queue->workers--;
+	pthread_cond_broadcast(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+
+	mapi_object_release(&obj_store);
+	if (mapi_ctx) {
+		pthread_mutex_lock(&export_logon_lock);
+		MAPIUninitialize(mapi_ctx);
+		pthread_mutex_unlock(&export_logon_lock);
+	}
+	talloc_free(mem_ctx);
+
+	return NULL;
+}
+
+/**
+ * Export items one at a time with the main session
+ */
+static uint64_t export_sequential(TALLOC_CTX *mem_ctx, struct mapi_profile *profile, FILE *fp,
+				  mapi_object_t *obj_store, struct export_queue *queue)
+{
+	struct export_item	*item;
+	uint64_t		bytes = 0;
+	long			offset;
+	uint32_t		i;
+
+	for (i = 0; i < queue->count; i++) {
+		item = &queue->items[i];
+		fseek(fp, 0, SEEK_END);
+		offset = ftell(fp);
+		item->status = export_message(mem_ctx, fp, obj_store, item);
+		bytes += ftell(fp) - offset;
+		export_commit(profile, item);
+	}
+
+	return bytes;
+}
+
+/**
+ * Export items with opt_jobs sessions, writing them to fp in order.
+ * Returns false, with nothing exported, if no worker could be started.
+ * Once every worker has left, the items left are exported with the
+ * main session.
+ */
+static bool export_parallel(TALLOC_CTX *mem_ctx, struct mapi_profile *profile, FILE *fp,
+			    mapi_object_t *obj_store, struct export_queue *queue,
+			    int opt_jobs, uint64_t *bytes)
+{
+	pthread_t		*workers;
+	struct export_item	*item;
+	uint32_t		i;
+	long			offset;
+	int			started = 0;
+	bool			sequential = false;
+
+	pthread_mutex_init(&queue->lock, NULL);
+	pthread_cond_init(&queue->cond, NULL);
+	queue->next = 0;
+	queue->written = 0;
+	queue->window = opt_jobs * 4;
+	queue->workers = opt_jobs;
+
+	workers = talloc_array(queue->items, pthread_t, opt_jobs);
+	for (i = 0; i < opt_jobs; i++) {
+		if (pthread_create(&workers[started], NULL, export_worker, queue)) {
+			fprintf(stderr, "Failed to create export worker %d\n", i);
+			pthread_mutex_lock(&queue->lock);
+			queue->workers--;
+			pthread_mutex_unlock(&queue->lock);
+			continue;
+		}
+		started++;
+	}
+	if (!started) {
+		talloc_free(workers);
+		pthread_cond_destroy(&queue->cond);
+		pthread_mutex_destroy(&queue->lock);
+		return false;
+	}
+
+	*bytes = 0;
+
+	for (i = 0; i < queue->count; i++) {
+		item = &queue->items[i];
+
+		pthread_mutex_lock(&queue->lock);
+		while (item->status == EXPORT_PENDING && queue->workers) {
+			pthread_cond_wait(&queue->cond, &queue->lock);
+		}
+		if (item->status == EXPORT_PENDING) {
+			queue->next = queue->count;
+		}
+		pthread_mutex_unlock(&queue->lock);
+
+		if (item->status == EXPORT_PENDING) {
+			if (!sequential) {
+				fprintf(stderr, "No export worker left, exporting the remaining messages sequentially\n");
+				sequential = true;
+			}
+			fseek(fp, 0, SEEK_END);
+			offset = ftell(fp);
+			item->status = export_message(mem_ctx, fp, obj_store, item);
+			*bytes += ftell(fp) - offset;
+		} else if (item->data) {
+			fwrite(item->data, item->length, 1, fp);
+			*bytes += item->length;
+			free(item->data);
+			item->data = NULL;
+		}
+		export_commit(profile, item);
+
+		pthread_mutex_lock(&queue->lock);
+		queue->written = i + 1;
+		pthread_cond_broadcast(&queue->cond);
+		pthread_mutex_unlock(&queue->lock);
+	}
+
+	for (i = 0; i < started; i++) {
+		pthread_join(workers[i], NULL);
+	}
+
+	talloc_free(workers);
+	pthread_cond_destroy(&queue->cond);
+	pthread_mutex_destroy(&queue->lock);
+
+	return true;
+}
+
+
 int main(int argc, const char *argv[])
 {
 	TALLOC_CTX			*mem_ctx = NULL;
@@ -989,17 +1347,19 @@ int main(int argc, const char *argv[])
 	mapi_object_t			obj_store;
 	mapi_object_t			obj_inbox;
 	mapi_object_t			obj_table;
-	mapi_object_t			obj_message;
 	mapi_id_t			id_inbox;
 	uint32_t			count;
 	struct SPropTagArray		*SPropTagArray = NULL;
-	struct SPropValue		*lpProps;
-	struct SRow			aRow;
 	struct SRowSet			rowset;
+	struct export_queue		queue;
+	struct export_item		*item;
+	uint64_t			bytes = 0;
+	time_t				elapsed;
 	poptContext			pc;
 	int				opt;
 	FILE				*fp;
 	unsigned int			i;
+	uint32_t			exported;
 	const char			*opt_profdb = NULL;
 	char				*opt_profname = NULL;
 	const char			*opt_password = NULL;
@@ -1007,10 +1367,11 @@ int main(int argc, const char *argv[])
 	bool				opt_update = false;
 	bool				opt_dumpdata = false;
 	const char			*opt_debug = NULL;
+	int				opt_jobs = 1;
 	const char			*msgid;
 
 	enum {OPT_PROFILE_DB=1000, OPT_PROFILE, OPT_PASSWORD, OPT_MBOX, OPT_UPDATE,
-	      OPT_DEBUG, OPT_DUMPDATA, OPT_TEST};
+	      OPT_DEBUG, OPT_DUMPDATA, OPT_TEST, OPT_JOBS};
 
 	struct poptOption long_options[] = {
 		POPT_AUTOHELP
@@ -1022,6 +1383,7 @@ int main(int argc, const char *argv[])
 		{"update", 'u', POPT_ARG_NONE, 0, OPT_UPDATE, "mirror mbox changes back to the Exchange server", NULL},
 		{"debuglevel", 'd', POPT_ARG_STRING, NULL, OPT_DEBUG, "set the debug level", "LEVEL"},
 		{"dump-data", 0, POPT_ARG_NONE, NULL, OPT_DUMPDATA, "dump the hex data", NULL},
+		{"jobs", 'j', POPT_ARG_STRING, NULL, OPT_JOBS, "number of concurrent MAPI sessions used to export messages", "JOBS"},
 		POPT_OPENCHANGE_VERSION
 		{ NULL, 0, POPT_ARG_NONE, NULL, 0, NULL, NULL }
 	};
@@ -1058,6 +1420,9 @@ int main(int argc, const char *argv[])
 		case OPT_DUMPDATA:
 			opt_dumpdata = true;
 			break;
+		case OPT_JOBS:
+			opt_jobs = atoi(poptGetOptArg(pc));
+			break;
 		}
 	}
 
@@ -1073,6 +1438,10 @@ int main(int argc, const char *argv[])
 		opt_mbox = talloc_asprintf(mem_ctx, DEFAULT_MBOX, getenv("HOME"));
 	}
 
+	if (opt_jobs < 1) {
+		opt_jobs = 1;
+	}
+
 	/**
 	 * Open the MBOX
 	 */
@@ -1109,6 +1478,7 @@ int main(int argc, const char *argv[])
 	}
 	
 	retval = MapiLogonEx(mapi_ctx, &session, opt_profname, opt_password);
+	queue.profname = talloc_strdup(mem_ctx, opt_profname);
 	talloc_free(opt_profname);
 	if (retval != MAPI_E_SUCCESS) {
 		mapi_errstr("MapiLogonEx", GetLastError());
@@ -1158,90 +1528,66 @@ int main(int argc, const char *argv[])
 	MAPIFreeBuffer(SPropTagArray);
 	MAPI_RETVAL_IF(retval, retval, mem_ctx);
 
+	/* Build the list of messages not yet in the profile */
+	queue.items = talloc_array(mem_ctx, struct export_item, count);
+	queue.count = 0;
 	while ((retval = QueryRows(&obj_table, 0xa, TBL_ADVANCE, &rowset)) != MAPI_E_NOT_FOUND && rowset.cRows) {
 		for (i = 0; i < rowset.cRows; i++) {
-			mapi_object_init(&obj_message);
-			retval = OpenMessage(&obj_store, 
-					     rowset.aRow[i].lpProps[0].value.d, 
-					     rowset.aRow[i].lpProps[1].value.d, 
-					     &obj_message, 0);
-			if (retval == MAPI_E_SUCCESS) {
-				SPropTagArray = set_SPropTagArray(mem_ctx, 0x1b,
-								  PR_INTERNET_MESSAGE_ID,
-								  PR_INTERNET_MESSAGE_ID_UNICODE,
-								  PR_CONVERSATION_TOPIC,
-								  PR_CONVERSATION_TOPIC_UNICODE,
-								  PR_MESSAGE_DELIVERY_TIME,
-								  PR_MSG_EDITOR_FORMAT,
-								  PR_BODY,
-								  PR_BODY_UNICODE,
-								  PR_HTML,
-								  PR_RTF_COMPRESSED,
-								  PR_RTF_IN_SYNC,
-								  PR_SENT_REPRESENTING_NAME,
-								  PR_SENT_REPRESENTING_NAME_UNICODE,
-								  PR_DISPLAY_TO,
-								  PR_DISPLAY_TO_UNICODE,
-								  PR_DISPLAY_CC,
-								  PR_DISPLAY_CC_UNICODE,
-								  PR_DISPLAY_BCC,
-								  PR_DISPLAY_BCC_UNICODE,
-								  PR_HASATTACH,
-								  PR_TRANSPORT_MESSAGE_HEADERS,
-								  PR_SUBJECT_PREFIX,
-								  PR_SUBJECT_PREFIX_UNICODE,
-								  PR_NORMALIZED_SUBJECT,
-								  PR_NORMALIZED_SUBJECT_UNICODE,
-								  PR_SUBJECT,
-								  PR_SUBJECT_UNICODE);
-				retval = GetProps(&obj_message, MAPI_UNICODE, SPropTagArray, &lpProps, &count);
-				MAPIFreeBuffer(SPropTagArray);
-				if (retval != MAPI_E_SUCCESS) {
-					fprintf(stderr, "Badness getting row %d attrs\n", i);
-					exit (1);
-				}
+			msgid = (const char *) octool_get_propval(&rowset.aRow[i], PR_INTERNET_MESSAGE_ID);
+			if (!msgid) {
+				fprintf(stderr, "%s: message with no msgid cannot be downloaded\n", profile->profname);
+				continue;
+			}
 
-				/* Build a SRow structure */
-				aRow.ulAdrEntryPad = 0;
-				aRow.cValues = count;
-				aRow.lpProps = lpProps;
-
-				msgid = (const char *) octool_get_propval(&aRow, PR_INTERNET_MESSAGE_ID);
-				if (msgid) {
-					retval = FindProfileAttr(profile, "Message-ID", msgid);
-					if (GetLastError() == MAPI_E_NOT_FOUND) {
-						bool ok;
-						
-						message_error = 0;
-						ok = message2mbox(mem_ctx, fp, &aRow, &obj_message, 0);
-						if (!ok) {
-							printf("Message-ID: %s error, not added to %s\n", msgid, profile->profname);
-						} else if (message_error) {
-							printf("Message-ID: %s error, ignoring\n", msgid);
-							fprintf(stderr, "Message-ID: %s error, ignoring message (check with OWA if you can, will retry next time)\n", msgid);
-						} else if (opt_test) {
-							printf("Message-ID: %s saved but not updated in %s\n", msgid, profile->profname);
-						} else if
-						(mapi_profile_add_string_attr(profile->mapi_ctx, profile->profname, "Message-ID", msgid) != MAPI_E_SUCCESS) {
-							mapi_errstr("mapi_profile_add_string_attr", GetLastError());
-						} else {
-							printf("Message-ID: %s added to profile %s\n", msgid, profile->profname);
-						}
-					} else {
-						printf("Message-ID: %s already in profile %s\n", msgid, profile->profname);
-					}
-				} else {
-					fprintf(stderr, "%s: message with no msgid cannot be downloaded\n", profile->profname);
-				}
-				talloc_free(lpProps);
-			} else {
-				fprintf(stderr, "could not open row %d: retval=%d GetLastError=%d\n", i, retval, GetLastError());
+			retval = FindProfileAttr(profile, "Message-ID", msgid);
+			if (GetLastError() != MAPI_E_NOT_FOUND) {
+				printf("Message-ID: %s already in profile %s\n", msgid, profile->profname);
+				continue;
 			}
-			mapi_object_release(&obj_message);
 			errno = 0;
+
+			if (queue.count >= count) {
+				queue.items = talloc_realloc(mem_ctx, queue.items, struct export_item, queue.count + 1);
+			}
+			item = &queue.items[queue.count++];
+			item->fid = rowset.aRow[i].lpProps[0].value.d;
+			item->mid = rowset.aRow[i].lpProps[1].value.d;
+			item->msgid = talloc_strdup(queue.items, msgid);
+			item->data = NULL;
+			item->length = 0;
+			item->status = EXPORT_PENDING;
+		}
+		MAPIFreeBuffer(rowset.aRow);
+	}
+
+	queue.profdb = opt_profdb;
+	queue.password = opt_password;
+	if (opt_jobs < 2 || queue.count < 2 ||
+	    !export_parallel(mem_ctx, profile, fp, &obj_store, &queue, opt_jobs, &bytes)) {
+		if (opt_jobs > 1 && queue.count > 1) {
+			fprintf(stderr, "No export worker could be started, exporting sequentially\n");
+			opt_jobs = 1;
+		}
+		bytes = export_sequential(mem_ctx, profile, fp, &obj_store, &queue);
+	}
+
+	for (i = 0, exported = 0; i < queue.count; i++) {
+		if (queue.items[i].status == EXPORT_OK) {
+			exported++;
 		}
 	}
 
+	elapsed = time(0) - start_time;
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	printf("Exported %u messages (%llu bytes) in %lu seconds with %d session(s): %.1f messages/s, %.1f KB/s\n",
+	       exported, (unsigned long long) bytes, (unsigned long) elapsed, opt_jobs,
+	       (double) exported / elapsed, (double) bytes / 1024 / elapsed);
+	if (exported < queue.count) {
+		fprintf(stderr, "%u messages could not be exported\n", queue.count - exported);
+	}
+
 	fclose(fp);
 	mapi_object_release(&obj_table);
 	mapi_object_release(&obj_inbox);
@@ -1250,5 +1596,5 @@ int main(int argc, const char *argv[])
 
 	talloc_free(mem_ctx);
 
-	return 0;
+	return (exported < queue.count) ? 1 : 0;
 }
@@ -761,3 +761,117 @@ cleanup:
 	return ret;
 }
 
+
+static enum MAPISTATUS mapitest_oxcfxics_count_end(uint32_t marker, void *priv)
+{
+	uint32_t	*ends = (uint32_t *)priv;
+
+	if (marker == IncrSyncEnd) {
+		(*ends)++;
+	}
+
+	return MAPI_E_SUCCESS;
+}
+
+/**
+   \details Test the multiplexed download of several ICS streams
+   (RopSynchronizationConfigure (0x70) and several
+   FastTransferGetBuffer (0x4E) operations per request)
+
+   This function:
+   -# Log on private message store
+   -# Creates two test folders
+   -# Sets up a contents sync context on each folder
+   -# Downloads both streams through one multiplexer
+   -# Checks each stream reached its end marker
+   -# cleans up.
+ */
+_PUBLIC_ bool mapitest_oxcfxics_SyncMultiplex(struct mapitest *mt)
+{
+	enum MAPISTATUS			retval;
+	struct mt_common_tf_ctx		*context;
+	mapi_object_t			obj_htable;
+	mapi_object_t			obj_sync_context[2];
+	mapi_object_t			download_folder[2];
+	struct fxmultiplex_context	*fxmux = NULL;
+	struct fx_parser_context	*parser;
+	DATA_BLOB			restriction;
+	struct SPropTagArray		*property_tags;
+	uint32_t			ends[2] = { 0, 0 };
+	char				*name;
+	int				i;
+	bool				ret = true;
+
+	/* Logon */
+	if (! mapitest_common_setup(mt, &obj_htable, NULL)) {
+		return false;
+	}
+
+	context = mt->priv;
+
+	for (i = 0; i < 2; i++) {
+		mapi_object_init(&download_folder[i]);
+		mapi_object_init(&obj_sync_context[i]);
+	}
+
+	fxmux = fxmultiplex_init(mt->mem_ctx, 0);
+	property_tags = set_SPropTagArray(mt->mem_ctx, 0x0);
+	restriction.length = 0;
+	restriction.data = NULL;
+	for (i = 0; i < 2; i++) {
+		name = talloc_asprintf(mt->mem_ctx, "ICSMultiplexFolder%d", i + 1);
+		retval = CreateFolder(&(context->obj_test_folder), FOLDER_GENERIC,
+				      name, NULL /*folder comment*/,
+				      OPEN_IF_EXISTS, &download_folder[i]);
+		talloc_free(name);
+		mapitest_print_retval_clean(mt, "Create ICS Multiplex Folder", retval);
+		if (retval != MAPI_E_SUCCESS) {
+			ret = false;
+			goto cleanup;
+		}
+
+		retval = ICSSyncConfigure(&download_folder[i], Contents,
+					  FastTransfer_Unicode, SynchronizationFlag_Unicode,
+					  Eid | Cn, restriction, property_tags, &obj_sync_context[i]);
+		mapitest_print_retval_clean(mt, "ICSSyncConfigure", retval);
+		if (retval != MAPI_E_SUCCESS) {
+			ret = false;
+			goto cleanup;
+		}
+
+		parser = fxparser_init(fxmux, &ends[i]);
+		fxparser_set_marker_callback(parser, mapitest_oxcfxics_count_end);
+		retval = fxmultiplex_add(fxmux, &obj_sync_context[i], parser);
+		mapitest_print_retval_clean(mt, "fxmultiplex_add", retval);
+		if (retval != MAPI_E_SUCCESS) {
+			ret = false;
+			goto cleanup;
+		}
+	}
+
+	retval = fxmultiplex_run(fxmux);
+	mapitest_print_retval_clean(mt, "fxmultiplex_run", retval);
+	if (retval != MAPI_E_SUCCESS) {
+		ret = false;
+		goto cleanup;
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (ends[i] != 1) {
+			mapitest_print(mt, "stream %d: unexpected IncrSyncEnd count %u\n", i, ends[i]);
+			ret = false;
+		}
+	}
+
+cleanup:
+	/* Cleanup and release */
+	talloc_free(fxmux);
+	for (i = 0; i < 2; i++) {
+		mapi_object_release(&obj_sync_context[i]);
+		mapi_object_release(&download_folder[i]);
+	}
+	mapi_object_release(&obj_htable);
+	mapitest_common_cleanup(mt);
+
+	return ret;
+}